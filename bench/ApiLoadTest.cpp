@@ -0,0 +1,306 @@
+#include "MockGitLabServer.h"
+#include "api/GitLabApi.h"
+#include "utils/Logger.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <vector>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_UNIX)
+#include <sys/resource.h>
+#endif
+
+/**
+ * @brief GitLabApi 压测
+ * 启动本地 MockGitLabServer，让 GitLabApi 同时保持大量未完成的请求，轮流调用
+ * getCurrentUser / getProjects / listMergeRequests / listPipelines / listProjectMembers / getJobLog，
+ * 统计每个接口的 p50/p99 延迟、失败数、返回条目数是否正确，以及总吞吐量与进程峰值内存。
+ * 延迟从调用接口开始计到 future 完成（含分页、排队、解析与缓存）。
+ *
+ * 用法: gitpilot_api_loadtest [--requests N] [--concurrency N] [--latency ms] [--jitter ms]
+ *                             [--error-rate 0~1] [--drop-rate 0~1] [--no-total-pages] [--no-etag]
+ *                             [--cold] [--recordings 目录] [--mrs N] [--pipelines N] [--trace-kb N]
+ */
+
+namespace {
+
+QTextStream& out() {
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+qint64 peakMemoryKb() {
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return qint64(counters.PeakWorkingSetSize / 1024);
+    }
+    return 0;
+#elif defined(Q_OS_MACOS)
+    struct rusage usage;
+    return getrusage(RUSAGE_SELF, &usage) == 0 ? usage.ru_maxrss / 1024 : 0;  // macOS 以字节为单位
+#elif defined(Q_OS_UNIX)
+    struct rusage usage;
+    return getrusage(RUSAGE_SELF, &usage) == 0 ? usage.ru_maxrss : 0;
+#else
+    return 0;
+#endif
+}
+
+qint64 percentileNs(const std::vector<qint64>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t index = std::min(sorted.size() - 1, size_t(p * double(sorted.size())));
+    return sorted[index];
+}
+
+using Done = std::function<void(bool ok, int items, const QString& error)>;
+
+// future 完成（包括失败与取消）后回调 done；列表接口的条目数即结果数
+template <typename T>
+void track(QFuture<T> future, QObject* context, Done done) {
+    future.then(context, [done](QFuture<T> finished) {
+        try {
+            finished.waitForFinished();
+            done(!finished.isCanceled(), finished.resultCount(), QString());
+        } catch (const ApiError& error) {
+            done(false, 0, error.message());
+        } catch (...) {
+            done(false, 0, "unexpected exception");
+        }
+    });
+}
+
+struct Operation {
+    QString name;
+    int expectedItems;    // 成功时应返回的条目数
+    std::function<void(Done)> start;
+};
+
+struct OperationStats {
+    std::vector<qint64> latenciesNs;
+    int errors = 0;
+    int wrongCount = 0;   // 成功但条目数不对
+    QString lastError;
+};
+
+class LoadDriver {
+public:
+    LoadDriver(const std::vector<Operation>& operations, int totalRequests, int concurrency,
+               std::function<void()> beforeEach)
+        : m_operations(operations)
+        , m_totalRequests(totalRequests)
+        , m_concurrency(concurrency)
+        , m_beforeEach(std::move(beforeEach))
+    {
+    }
+
+    void run() {
+        m_clock.start();
+        while (m_issued < m_totalRequests && m_issued < m_concurrency) {
+            issue();
+        }
+        if (m_totalRequests > 0) {
+            QCoreApplication::exec();
+        }
+        m_wallNs = m_clock.nsecsElapsed();
+    }
+
+    const std::map<QString, OperationStats>& stats() const { return m_stats; }
+    qint64 wallNs() const { return m_wallNs; }
+    int peakInFlight() const { return m_peakInFlight; }
+
+private:
+    void issue() {
+        const Operation& operation = m_operations[m_issued % m_operations.size()];
+        ++m_issued;
+        ++m_inFlight;
+        m_peakInFlight = std::max(m_peakInFlight, m_inFlight);
+
+        if (m_beforeEach) {
+            m_beforeEach();
+        }
+        const qint64 startNs = m_clock.nsecsElapsed();
+        const QString name = operation.name;
+        const int expected = operation.expectedItems;
+        operation.start([this, name, expected, startNs](bool ok, int items, const QString& error) {
+            OperationStats& stats = m_stats[name];
+            stats.latenciesNs.push_back(m_clock.nsecsElapsed() - startNs);
+            if (!ok) {
+                ++stats.errors;
+                stats.lastError = error;
+            } else if (items != expected) {
+                ++stats.wrongCount;
+                stats.lastError = QString("expected %1 items, got %2").arg(expected).arg(items);
+            }
+
+            --m_inFlight;
+            ++m_completed;
+            if (m_issued < m_totalRequests) {
+                issue();
+            } else if (m_completed == m_totalRequests) {
+                QCoreApplication::quit();
+            }
+        });
+    }
+
+    std::vector<Operation> m_operations;
+    int m_totalRequests;
+    int m_concurrency;
+    std::function<void()> m_beforeEach;
+
+    QElapsedTimer m_clock;
+    int m_issued = 0;
+    int m_completed = 0;
+    int m_inFlight = 0;
+    int m_peakInFlight = 0;
+    qint64 m_wallNs = 0;
+    std::map<QString, OperationStats> m_stats;
+};
+
+}
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setOrganizationName("GitPilot");
+    QCoreApplication::setApplicationName("GitPilotApiLoadTest");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("GitLabApi load test against a local mock GitLab server");
+    parser.addHelpOption();
+    QCommandLineOption requestsOption("requests", "Total API calls.", "N", "1000");
+    QCommandLineOption concurrencyOption("concurrency", "API calls kept in flight.", "N", "200");
+    QCommandLineOption latencyOption("latency", "Server latency per response.", "ms", "20");
+    QCommandLineOption jitterOption("jitter", "Random extra latency.", "ms", "10");
+    QCommandLineOption errorRateOption("error-rate", "Fraction of responses replaced by HTTP 503.", "rate", "0");
+    QCommandLineOption dropRateOption("drop-rate", "Fraction of requests answered by closing the connection.", "rate", "0");
+    QCommandLineOption noTotalPagesOption("no-total-pages", "Omit X-Total-Pages so pages are followed one by one.");
+    QCommandLineOption noEtagOption("no-etag", "Do not send ETag headers (no 304 revalidation).");
+    QCommandLineOption coldOption("cold", "Clear the client response cache before every call.");
+    QCommandLineOption recordingsOption("recordings", "Directory with recorded responses.", "dir");
+    QCommandLineOption mrsOption("mrs", "Generated merge requests.", "N", "250");
+    QCommandLineOption pipelinesOption("pipelines", "Generated pipelines.", "N", "120");
+    QCommandLineOption traceKbOption("trace-kb", "Generated job log size.", "KB", "256");
+    parser.addOptions({requestsOption, concurrencyOption, latencyOption, jitterOption, errorRateOption,
+                       dropRateOption, noTotalPagesOption, noEtagOption, coldOption, recordingsOption,
+                       mrsOption, pipelinesOption, traceKbOption});
+    parser.process(app);
+
+    // 每个请求都写日志会成为瓶颈，只保留警告以上
+    Logger::instance().setMinLevel(Logger::Level::Warning);
+
+    MockGitLabServer server;
+    server.generate(parser.value(mrsOption).toInt(), parser.value(pipelinesOption).toInt(), 40, 30,
+                    parser.value(traceKbOption).toInt());
+    if (parser.isSet(recordingsOption)) {
+        server.loadRecordings(parser.value(recordingsOption));
+    }
+    server.setToken("bench-token");
+    server.setLatency(parser.value(latencyOption).toInt(), parser.value(jitterOption).toInt());
+    server.setErrorRate(parser.value(errorRateOption).toDouble());
+    server.setDropRate(parser.value(dropRateOption).toDouble());
+    server.setTotalPagesHeader(!parser.isSet(noTotalPagesOption));
+    server.setEtagEnabled(!parser.isSet(noEtagOption));
+    if (!server.listen()) {
+        out() << "Cannot start mock server" << Qt::endl;
+        return 1;
+    }
+
+    GitLabApi api;
+    api.setBaseUrl(server.baseUrl());
+    api.setApiToken("bench-token");
+    api.setProjectId("group/project");
+
+    const int pipelinesExpected = std::min(11, server.pipelineCount());  // listPipelines 默认只取11条
+    QObject* context = &app;
+    const std::vector<Operation> operations = {
+        {"getCurrentUser", 1, [&](Done done) { track(api.getCurrentUser(), context, done); }},
+        {"listMergeRequests", server.mergeRequestCount(), [&](Done done) { track(api.listMergeRequests(), context, done); }},
+        {"listPipelines", pipelinesExpected, [&](Done done) { track(api.listPipelines(), context, done); }},
+        {"listProjectMembers", server.memberCount(), [&](Done done) { track(api.listProjectMembers(), context, done); }},
+        {"getProjects", server.projectCount(), [&](Done done) { track(api.getProjects(), context, done); }},
+        {"getJobLog", 1, [&](Done done) { track(api.getJobLog(4242), context, done); }},
+    };
+
+    const int totalRequests = std::max(0, parser.value(requestsOption).toInt());
+    const int concurrency = std::max(1, parser.value(concurrencyOption).toInt());
+    std::function<void()> beforeEach;
+    if (parser.isSet(coldOption)) {
+        beforeEach = [&api]() { api.clearCache(); };
+    }
+
+    out() << QString("server: %1, requests: %2, concurrency: %3, latency: %4+%5 ms, error rate: %6, drop rate: %7")
+             .arg(server.baseUrl()).arg(totalRequests).arg(concurrency)
+             .arg(parser.value(latencyOption), parser.value(jitterOption),
+                  parser.value(errorRateOption), parser.value(dropRateOption))
+          << Qt::endl;
+    out() << QString("data: %1 MRs, %2 pipelines, %3 projects, %4 members, job log %5 KB")
+             .arg(server.mergeRequestCount()).arg(server.pipelineCount()).arg(server.projectCount())
+             .arg(server.memberCount()).arg(server.traceSize() / 1024)
+          << Qt::endl;
+
+    const qint64 memoryBefore = peakMemoryKb();
+    LoadDriver driver(operations, totalRequests, concurrency, beforeEach);
+    driver.run();
+
+    out() << QString("%1 %2 %3 %4 %5 %6 %7")
+             .arg("operation", -20)
+             .arg("calls", 7)
+             .arg("p50 ms", 9)
+             .arg("p99 ms", 9)
+             .arg("max ms", 9)
+             .arg("errors", 7)
+             .arg("wrong", 6)
+          << Qt::endl;
+
+    int failures = 0;
+    for (const auto& [name, stats] : driver.stats()) {
+        std::vector<qint64> sorted = stats.latenciesNs;
+        std::sort(sorted.begin(), sorted.end());
+        out() << QString("%1 %2 %3 %4 %5 %6 %7")
+                 .arg(name, -20)
+                 .arg(int(sorted.size()), 7)
+                 .arg(percentileNs(sorted, 0.50) / 1e6, 9, 'f', 2)
+                 .arg(percentileNs(sorted, 0.99) / 1e6, 9, 'f', 2)
+                 .arg(sorted.empty() ? 0.0 : sorted.back() / 1e6, 9, 'f', 2)
+                 .arg(stats.errors, 7)
+                 .arg(stats.wrongCount, 6)
+              << Qt::endl;
+        if (!stats.lastError.isEmpty()) {
+            out() << "    last error: " << stats.lastError << Qt::endl;
+        }
+        failures += stats.wrongCount;
+    }
+
+    const MockGitLabServer::Stats serverStats = server.stats();
+    const ApiResponseCache::Stats cacheStats = api.cacheStats();
+    const double seconds = driver.wallNs() / 1e9;
+    out() << QString("throughput: %1 calls/s (%2 HTTP requests/s), wall time %3 s, peak in flight %4")
+             .arg(seconds > 0 ? totalRequests / seconds : 0.0, 0, 'f', 1)
+             .arg(seconds > 0 ? serverStats.requests / seconds : 0.0, 0, 'f', 1)
+             .arg(seconds, 0, 'f', 2)
+             .arg(driver.peakInFlight())
+          << Qt::endl;
+    out() << QString("server: %1 requests, %2 not modified, %3 injected errors, %4 dropped, %5 KB sent, %6 connections")
+             .arg(serverStats.requests).arg(serverStats.notModified).arg(serverStats.injectedErrors)
+             .arg(serverStats.droppedConnections).arg(serverStats.bytesSent / 1024).arg(serverStats.peakConnections)
+          << Qt::endl;
+    out() << QString("client cache: %1 hits, %2 revalidated, %3 misses")
+             .arg(cacheStats.hits).arg(cacheStats.revalidated).arg(cacheStats.misses)
+          << Qt::endl;
+    out() << QString("peak memory: %1 MB (%2 MB before load)")
+             .arg(peakMemoryKb() / 1024.0, 0, 'f', 1)
+             .arg(memoryBefore / 1024.0, 0, 'f', 1)
+          << Qt::endl;
+
+    // 条目数不对说明分页或解析有问题，以非零退出码提示
+    return failures > 0 ? 2 : 0;
+}
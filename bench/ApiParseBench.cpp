@@ -0,0 +1,190 @@
+#include "api/ApiModels.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QTextStream>
+#include <functional>
+
+/**
+ * @brief GitLab 响应解析基准测试
+ * 分别测量 JSON 解码（QJsonDocument::fromJson）与模型构建（listFromJson）的耗时，
+ * 即 GitLabApi 放到解析线程中执行、不再阻塞UI线程的那部分工作。
+ *
+ * 用法: gitpilot_parse_bench [录制的响应目录] [迭代次数]
+ * 目录中可放 merge_requests.json / pipelines.json / projects.json（GitLab列表接口的原始响应），
+ * 缺少的文件用模拟数据代替。
+ */
+
+namespace {
+
+QTextStream& out() {
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+QString repeatedText(int length) {
+    const QString unit = QString::fromUtf8("修复登录页在弱网下的重试逻辑 Fix retry logic for login page. ");
+    QString text;
+    text.reserve(length);
+    while (text.size() < length) {
+        text += unit;
+    }
+    text.truncate(length);
+    return text;
+}
+
+QJsonObject userJson(int id) {
+    QJsonObject user;
+    user["id"] = id;
+    user["username"] = QString("user%1").arg(id);
+    user["name"] = QString::fromUtf8("开发者%1").arg(id);
+    user["state"] = "active";
+    user["avatar_url"] = QString("https://gitlab.example.com/uploads/-/system/user/avatar/%1/avatar.png").arg(id);
+    user["web_url"] = QString("https://gitlab.example.com/user%1").arg(id);
+    return user;
+}
+
+// 模拟 GET /projects/:id/merge_requests 的响应，字段与 GitLab 返回的一致（省略部分嵌套对象）
+QByteArray syntheticMergeRequests(int count, int descriptionLength) {
+    QJsonArray array;
+    for (int i = 0; i < count; ++i) {
+        QJsonObject mr;
+        mr["id"] = 100000 + i;
+        mr["iid"] = i + 1;
+        mr["project_id"] = 42;
+        mr["title"] = QString::fromUtf8("feature/%1: 优化构建流水线").arg(i);
+        mr["description"] = repeatedText(descriptionLength);
+        mr["state"] = "opened";
+        mr["created_at"] = "2024-05-10T08:30:00.000+08:00";
+        mr["updated_at"] = "2024-05-11T09:15:00.000+08:00";
+        mr["target_branch"] = "develop";
+        mr["source_branch"] = QString("feature/task-%1").arg(i);
+        mr["author"] = userJson(i % 20);
+        mr["assignees"] = QJsonArray{userJson((i + 1) % 20), userJson((i + 2) % 20)};
+        mr["labels"] = QJsonArray{"backend", "needs-review"};
+        mr["merge_status"] = "can_be_merged";
+        mr["sha"] = "8f3c2a1b9d7e6f5a4b3c2d1e0f9a8b7c6d5e4f3a";
+        mr["web_url"] = QString("https://gitlab.example.com/group/project/-/merge_requests/%1").arg(i + 1);
+        mr["user_notes_count"] = i % 7;
+        array.append(mr);
+    }
+    return QJsonDocument(array).toJson(QJsonDocument::Compact);
+}
+
+QByteArray syntheticPipelines(int count) {
+    QJsonArray array;
+    for (int i = 0; i < count; ++i) {
+        QJsonObject pipeline;
+        pipeline["id"] = 500000 + i;
+        pipeline["iid"] = i + 1;
+        pipeline["project_id"] = 42;
+        pipeline["sha"] = "8f3c2a1b9d7e6f5a4b3c2d1e0f9a8b7c6d5e4f3a";
+        pipeline["ref"] = (i % 3 == 0) ? "develop" : QString("feature/task-%1").arg(i);
+        pipeline["status"] = (i % 4 == 0) ? "failed" : "success";
+        pipeline["source"] = "push";
+        pipeline["created_at"] = "2024-05-10T08:30:00.000+08:00";
+        pipeline["updated_at"] = "2024-05-10T08:42:13.000+08:00";
+        pipeline["web_url"] = QString("https://gitlab.example.com/group/project/-/pipelines/%1").arg(500000 + i);
+        array.append(pipeline);
+    }
+    return QJsonDocument(array).toJson(QJsonDocument::Compact);
+}
+
+QByteArray syntheticProjects(int count) {
+    QJsonArray array;
+    for (int i = 0; i < count; ++i) {
+        QJsonObject project;
+        project["id"] = i + 1;
+        project["name"] = QString("project-%1").arg(i);
+        project["path_with_namespace"] = QString("group-%1/project-%2").arg(i % 10).arg(i);
+        project["description"] = repeatedText(300);
+        project["default_branch"] = "develop";
+        project["visibility"] = "private";
+        project["web_url"] = QString("https://gitlab.example.com/group-%1/project-%2").arg(i % 10).arg(i);
+        project["star_count"] = i % 5;
+        project["forks_count"] = 0;
+        project["last_activity_at"] = "2024-05-11T09:15:00.000+08:00";
+        project["namespace"] = QJsonObject{{"id", i % 10}, {"name", QString("group-%1").arg(i % 10)},
+                                           {"kind", "group"}};
+        array.append(project);
+    }
+    return QJsonDocument(array).toJson(QJsonDocument::Compact);
+}
+
+QByteArray loadPayload(const QString& dir, const QString& fileName, const std::function<QByteArray()>& fallback) {
+    if (!dir.isEmpty()) {
+        QFile file(QDir(dir).filePath(fileName));
+        if (file.open(QIODevice::ReadOnly)) {
+            return file.readAll();
+        }
+    }
+    return fallback();
+}
+
+template <typename T>
+void runCase(const QString& name, const QByteArray& payload, int iterations) {
+    qint64 decodeNs = 0;
+    qint64 buildNs = 0;
+    int items = 0;
+    
+    for (int i = 0; i < iterations; ++i) {
+        QElapsedTimer timer;
+        timer.start();
+        QJsonDocument doc = QJsonDocument::fromJson(payload);
+        decodeNs += timer.nsecsElapsed();
+    
+        timer.restart();
+        QList<T> list = listFromJson<T>(doc.array());
+        buildNs += timer.nsecsElapsed();
+        items = list.size();
+    }
+    
+    const double decodeMs = decodeNs / 1e6 / iterations;
+    const double buildMs = buildNs / 1e6 / iterations;
+    const double totalMs = decodeMs + buildMs;
+    const double mbPerSecond = totalMs > 0 ? (payload.size() / 1048576.0) / (totalMs / 1000.0) : 0.0;
+    
+    out() << QString("%1 %2 %3 %4 %5 %6 %7")
+             .arg(name, -22)
+             .arg(items, 7)
+             .arg(payload.size() / 1024.0, 10, 'f', 1)
+             .arg(decodeMs, 11, 'f', 3)
+             .arg(buildMs, 11, 'f', 3)
+             .arg(totalMs, 11, 'f', 3)
+             .arg(mbPerSecond, 9, 'f', 1)
+          << Qt::endl;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    
+    QString payloadDir = argc > 1 ? QString::fromLocal8Bit(argv[1]) : QString();
+    int iterations = argc > 2 ? QString::fromLocal8Bit(argv[2]).toInt() : 50;
+    
+    out() << "payloads: " << (payloadDir.isEmpty() ? QString("synthetic") : payloadDir)
+          << ", iterations: " << iterations << Qt::endl;
+    out() << QString("%1 %2 %3 %4 %5 %6 %7")
+             .arg("payload", -22)
+             .arg("items", 7)
+             .arg("size(KB)", 10)
+             .arg("decode(ms)", 11)
+             .arg("build(ms)", 11)
+             .arg("total(ms)", 11)
+             .arg("MB/s", 9)
+          << Qt::endl;
+    
+    // 一页MR（100条，每条约2KB描述）与完整拉取的较长列表
+    runCase<MrResponse>("merge_requests", loadPayload(payloadDir, "merge_requests.json",
+        []() { return syntheticMergeRequests(100, 2000); }), iterations);
+    runCase<MrResponse>("merge_requests(x10)", syntheticMergeRequests(1000, 2000), iterations);
+    runCase<PipelineStatus>("pipelines", loadPayload(payloadDir, "pipelines.json",
+        []() { return syntheticPipelines(100); }), iterations);
+    runCase<ProjectInfo>("projects", loadPayload(payloadDir, "projects.json",
+        []() { return syntheticProjects(100); }), iterations);
+    
+    return 0;
+}
@@ -0,0 +1,236 @@
+#include "service/GitService.h"
+#include "service/GitProcessPool.h"
+#include "service/RepositoryReader.h"
+#include "SyntheticRepo.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+/**
+ * @brief GitService 基准测试
+ *
+ * 后端对比模式（默认）：对比每次创建 git 进程、常驻 cat-file 进程池与进程内读取器三种方式的调用吞吐量
+ *   gitpilot_bench [仓库路径] [迭代次数]
+ *
+ * 合成仓库模式：按给定规模生成仓库（见 SyntheticRepo），以默认配置逐个测量界面依赖的
+ * GitService 操作，输出 p50/p99 延迟与吞吐量，便于对比改动前后的结果
+ *   gitpilot_bench --synthetic [--files N] [--commits N] [--branches N] [--tags N]
+ *                  [--refs packed|loose|mixed] [--iterations N] [--keep 目录]
+ */
+
+namespace {
+
+QTextStream& out() {
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+double measureCallsPerSecond(int iterations, const std::function<void()>& call) {
+    call(); // 预热（启动常驻进程等）
+    
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < iterations; ++i) {
+        call();
+    }
+    qint64 elapsedNs = timer.nsecsElapsed();
+    return elapsedNs > 0 ? iterations * 1e9 / elapsedNs : 0.0;
+}
+
+void runCase(const QString& name, int iterations, const std::function<void()>& call) {
+    GitProcessPool& pool = GitProcessPool::instance();
+    
+    RepositoryReader::setEnabled(false);
+    pool.setEnabled(false);
+    double spawn = measureCallsPerSecond(iterations, call);
+    
+    pool.setEnabled(true);
+    double pooled = measureCallsPerSecond(iterations, call);
+    
+    RepositoryReader::setEnabled(true);
+    double native = measureCallsPerSecond(iterations, call);
+    
+    out() << QString("%1 %2 %3 %4 %5x")
+             .arg(name, -28)
+             .arg(spawn, 12, 'f', 1)
+             .arg(pooled, 12, 'f', 1)
+             .arg(native, 12, 'f', 1)
+             .arg(spawn > 0 ? native / spawn : 0.0, 8, 'f', 1)
+          << Qt::endl;
+}
+
+qint64 percentileNs(const std::vector<qint64>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t index = std::min(sorted.size() - 1, size_t(p * double(sorted.size())));
+    return sorted[index];
+}
+
+void runLatencyCase(const QString& name, int iterations, const std::function<void()>& call) {
+    call(); // 预热
+    
+    std::vector<qint64> latencies;
+    latencies.reserve(iterations);
+    QElapsedTimer total;
+    total.start();
+    for (int i = 0; i < iterations; ++i) {
+        QElapsedTimer timer;
+        timer.start();
+        call();
+        latencies.push_back(timer.nsecsElapsed());
+    }
+    const qint64 totalNs = total.nsecsElapsed();
+    std::sort(latencies.begin(), latencies.end());
+    
+    out() << QString("%1 %2 %3 %4 %5")
+             .arg(name, -36)
+             .arg(percentileNs(latencies, 0.50) / 1e6, 10, 'f', 2)
+             .arg(percentileNs(latencies, 0.99) / 1e6, 10, 'f', 2)
+             .arg(latencies.back() / 1e6, 10, 'f', 2)
+             .arg(totalNs > 0 ? iterations * 1e9 / totalNs : 0.0, 10, 'f', 1)
+          << Qt::endl;
+}
+
+int runSynthetic(const SyntheticRepo::Options& options, int iterations, const QString& keepPath) {
+    QTemporaryDir tempDir;
+    const QString repoPath = keepPath.isEmpty() ? tempDir.path() : keepPath;
+    
+    out() << QString("generating: files=%1 commits=%2 branches=%3 tags=%4 refs=%5")
+             .arg(options.files).arg(options.commits).arg(options.branches).arg(options.tags)
+             .arg(SyntheticRepo::refStorageName(options.refs))
+          << Qt::endl;
+    
+    SyntheticRepo repo(options);
+    QElapsedTimer timer;
+    timer.start();
+    QString error;
+    if (!repo.generate(repoPath, &error)) {
+        out() << "Failed to generate repository: " << error << Qt::endl;
+        return 1;
+    }
+    out() << QString("repo: %1 (generated in %2 s), iterations: %3")
+             .arg(repoPath).arg(timer.elapsed() / 1000.0, 0, 'f', 1).arg(iterations)
+          << Qt::endl;
+    
+    GitService service;
+    service.setRepoPath(repoPath);
+    
+    const QStringList branches = repo.branchNames();
+    // 偶数分支与 main 冲突，奇数分支可以干净合并，两种情况各测一组
+    const QString conflicting = branches.value(0);
+    const QString clean = branches.value(1);
+    
+    out() << QString("%1 %2 %3 %4 %5")
+             .arg("operation", -36)
+             .arg("p50 ms", 10)
+             .arg("p99 ms", 10)
+             .arg("max ms", 10)
+             .arg("ops/s", 10)
+          << Qt::endl;
+    
+    // 冷：每次先清空 StatusCache，测完整的 git status；热：刷新计划为空时直接命中缓存
+    runLatencyCase("getFileStatus(cold)", iterations, [&]() {
+        service.invalidateStatusCache();
+        service.getFileStatus();
+    });
+    runLatencyCase("getFileStatus(warm)", iterations, [&]() { service.getFileStatus(); });
+    runLatencyCase("getAllBranches", iterations, [&]() { service.getAllBranches(); });
+    runLatencyCase("getTags(20)", iterations, [&]() { service.getTags(20); });
+    runLatencyCase("getGraphLog(50)", iterations, [&]() { service.getGraphLog(50); });
+    if (!conflicting.isEmpty()) {
+        QString info;
+        runLatencyCase("checkMergeConflict(conflict)", iterations, [&]() {
+            service.checkMergeConflict(conflicting, info);
+        });
+        runLatencyCase("checkCherryPickConflict(conflict)", iterations, [&]() {
+            service.checkCherryPickConflict(conflicting, "main");
+        });
+    }
+    if (!clean.isEmpty()) {
+        QString info;
+        runLatencyCase("checkMergeConflict(clean)", iterations, [&]() {
+            service.checkMergeConflict(clean, info);
+        });
+        runLatencyCase("checkCherryPickConflict(clean)", iterations, [&]() {
+            service.checkCherryPickConflict(clean, "main");
+        });
+    }
+    
+    return 0;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    
+    QCommandLineParser parser;
+    parser.setApplicationDescription("GitService benchmark");
+    parser.addHelpOption();
+    parser.addPositionalArgument("repo", "Repository to benchmark (backend comparison mode).", "[repo]");
+    parser.addPositionalArgument("iterations", "Calls per operation.", "[iterations]");
+    
+    const SyntheticRepo::Options defaults;
+    QCommandLineOption syntheticOption("synthetic", "Generate a synthetic repository and report p50/p99 latency.");
+    QCommandLineOption filesOption("files", "Files in the synthetic repository.", "N", QString::number(defaults.files));
+    QCommandLineOption commitsOption("commits", "Commits on main.", "N", QString::number(defaults.commits));
+    QCommandLineOption branchesOption("branches", "Feature branches.", "N", QString::number(defaults.branches));
+    QCommandLineOption tagsOption("tags", "Annotated tags.", "N", QString::number(defaults.tags));
+    QCommandLineOption refsOption("refs", "Ref storage: packed, loose or mixed.", "mode",
+                                  SyntheticRepo::refStorageName(defaults.refs));
+    QCommandLineOption iterationsOption("iterations", "Calls per operation (synthetic mode).", "N", "50");
+    QCommandLineOption keepOption("keep", "Generate into this directory and keep it.", "dir");
+    parser.addOptions({syntheticOption, filesOption, commitsOption, branchesOption, tagsOption,
+                       refsOption, iterationsOption, keepOption});
+    parser.process(app);
+    
+    if (parser.isSet(syntheticOption)) {
+        SyntheticRepo::Options options;
+        options.files = parser.value(filesOption).toInt();
+        options.commits = parser.value(commitsOption).toInt();
+        options.branches = parser.value(branchesOption).toInt();
+        options.tags = parser.value(tagsOption).toInt();
+        if (!SyntheticRepo::parseRefStorage(parser.value(refsOption), options.refs)) {
+            out() << "Unknown --refs mode: " << parser.value(refsOption) << Qt::endl;
+            return 1;
+        }
+        return runSynthetic(options, std::max(1, parser.value(iterationsOption).toInt()), parser.value(keepOption));
+    }
+    
+    const QStringList positional = parser.positionalArguments();
+    QString repoPath = positional.size() > 0 ? positional[0] : QDir::currentPath();
+    int iterations = positional.size() > 1 ? positional[1].toInt() : 200;
+    
+    GitService service;
+    service.setRepoPath(repoPath);
+    if (!service.isValidRepo()) {
+        out() << "Not a git repository: " << repoPath << Qt::endl;
+        return 1;
+    }
+    
+    out() << "repo: " << repoPath << ", iterations: " << iterations << Qt::endl;
+    out() << QString("%1 %2 %3 %4 %5")
+             .arg("operation", -28)
+             .arg("spawn/s", 12)
+             .arg("pool/s", 12)
+             .arg("native/s", 12)
+             .arg("speedup", 9)
+          << Qt::endl;
+    
+    runCase("getCurrentBranch", iterations, [&]() { service.getCurrentBranch(); });
+    runCase("getAllBranches", iterations, [&]() { service.getAllBranches(); });
+    runCase("getTags(20)", iterations, [&]() { service.getTags(20); });
+    runCase("getRemoteUrl", iterations, [&]() { service.getRemoteUrl(); });
+    runCase("getLastCommitMessage", iterations, [&]() { service.getLastCommitMessage(); });
+    runCase("hasUnpushedCommits", iterations, [&]() { service.hasUnpushedCommits(); });
+    runCase("getRecentCommits(10)", iterations, [&]() { service.getRecentCommits(10); });
+    
+    return 0;
+}
@@ -0,0 +1,138 @@
+#include "utils/Logger.h"
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QTextStream>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 日志吞吐量与调用方延迟基准测试
+ * 多个线程同时以接近 GitLabApi / GitService 的日志内容调用 LOG_INFO，
+ * 对比同步模式（每行刷新）与异步模式（后台线程批量写入）下单次调用的耗时分布与总吞吐量。
+ * 吞吐量按全部日志写入文件为止计算（异步模式包含最后的 flush）。
+ * 最后测量被级别过滤掉的 LOG_DEBUG 的单次开销。
+ *
+ * 用法: gitpilot_log_bench [每线程日志条数]
+ * 日志写入 应用数据目录/logs/gitpilot.log（应用名为 GitPilotLogBench，不影响正式日志）。
+ */
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+QTextStream& out() {
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+struct CaseResult {
+    std::vector<qint64> latenciesNs;
+    double wallMs = 0.0;
+};
+
+qint64 percentile(const std::vector<qint64>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t index = std::min(sorted.size() - 1, size_t(p * double(sorted.size())));
+    return sorted[index];
+}
+
+CaseResult runCase(int threadCount, int messagesPerThread) {
+    CaseResult result;
+    std::vector<std::vector<qint64>> perThread(threadCount);
+    std::vector<std::thread> threads;
+    
+    const Clock::time_point begin = Clock::now();
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([t, messagesPerThread, &perThread]() {
+            std::vector<qint64>& latencies = perThread[t];
+            latencies.reserve(messagesPerThread);
+            for (int i = 0; i < messagesPerThread; ++i) {
+                // 与实际调用一致：消息在调用方拼好后再交给Logger
+                QString message = QString("API请求完成: GET /projects/42/merge_requests?page=%1 (线程%2, 状态200)")
+                                      .arg(i).arg(t);
+                const Clock::time_point start = Clock::now();
+                if (i % 1000 == 999) {
+                    LOG_ERROR(message);
+                } else {
+                    LOG_INFO(message);
+                }
+                latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    Logger::instance().flush();
+    result.wallMs = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+    
+    for (const std::vector<qint64>& latencies : perThread) {
+        result.latenciesNs.insert(result.latenciesNs.end(), latencies.begin(), latencies.end());
+    }
+    std::sort(result.latenciesNs.begin(), result.latenciesNs.end());
+    return result;
+}
+
+// 低于最低级别的 LOG_DEBUG：宏在求值参数前返回，QString::arg 不会执行
+double filteredCallNs(int count) {
+    const Clock::time_point begin = Clock::now();
+    for (int i = 0; i < count; ++i) {
+        LOG_DEBUG(QString("调试信息: GET /projects/42/merge_requests?page=%1").arg(i));
+    }
+    return std::chrono::duration<double, std::nano>(Clock::now() - begin).count() / count;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setOrganizationName("GitPilot");
+    QCoreApplication::setApplicationName("GitPilotLogBench");
+    
+    int messagesPerThread = argc > 1 ? QString::fromLocal8Bit(argv[1]).toInt() : 100000;
+    
+    Logger& logger = Logger::instance();
+    logger.setEnabled(true);
+    
+    out() << "log file: " << logger.getLogFilePath() << ", messages per thread: " << messagesPerThread << Qt::endl;
+    out() << QString("%1 %2 %3 %4 %5 %6 %7")
+             .arg("mode", -6)
+             .arg("threads", 8)
+             .arg("p50(ns)", 10)
+             .arg("p99(ns)", 10)
+             .arg("max(us)", 10)
+             .arg("msgs/s", 12)
+             .arg("dropped", 9)
+          << Qt::endl;
+    
+    for (bool async : {false, true}) {
+        logger.setAsync(async);
+        for (int threadCount : {1, 4, 8}) {
+            logger.clearLogs();
+            const quint64 droppedBefore = logger.droppedCount();
+            
+            CaseResult result = runCase(threadCount, messagesPerThread);
+            const double total = double(threadCount) * messagesPerThread;
+            const double throughput = result.wallMs > 0 ? total / (result.wallMs / 1000.0) : 0.0;
+            
+            out() << QString("%1 %2 %3 %4 %5 %6 %7")
+                     .arg(async ? "async" : "sync", -6)
+                     .arg(threadCount, 8)
+                     .arg(percentile(result.latenciesNs, 0.50), 10)
+                     .arg(percentile(result.latenciesNs, 0.99), 10)
+                     .arg(result.latenciesNs.empty() ? 0.0 : result.latenciesNs.back() / 1000.0, 10, 'f', 1)
+                     .arg(throughput, 12, 'f', 0)
+                     .arg(logger.droppedCount() - droppedBefore, 9)
+                  << Qt::endl;
+        }
+    }
+    
+    logger.setMinLevel(Logger::Level::Info);
+    out() << "filtered LOG_DEBUG: " << QString::number(filteredCallNs(messagesPerThread), 'f', 1) << " ns/call" << Qt::endl;
+    out() << "log size after last case: " << QFileInfo(logger.getLogFilePath()).size() / 1024 << " KB" << Qt::endl;
+    return 0;
+}
@@ -0,0 +1,475 @@
+#include "MockGitLabServer.h"
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QRegularExpression>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QUrlQuery>
+#include <algorithm>
+
+namespace {
+
+const int MAX_HEADER_BYTES = 64 * 1024;
+const int DEFAULT_PER_PAGE = 20;   // 与 GitLab 相同
+const int MAX_PER_PAGE = 100;
+
+QByteArray reasonPhrase(int status) {
+    switch (status) {
+    case 200: return "OK";
+    case 201: return "Created";
+    case 206: return "Partial Content";
+    case 304: return "Not Modified";
+    case 400: return "Bad Request";
+    case 401: return "Unauthorized";
+    case 404: return "Not Found";
+    case 416: return "Range Not Satisfiable";
+    case 429: return "Too Many Requests";
+    case 500: return "Internal Server Error";
+    case 502: return "Bad Gateway";
+    case 503: return "Service Unavailable";
+    default: return "Unknown";
+    }
+}
+
+QJsonObject userJson(int id) {
+    QJsonObject user;
+    user["id"] = id;
+    user["username"] = QString("user%1").arg(id);
+    user["name"] = QString::fromUtf8("开发者%1").arg(id);
+    user["state"] = "active";
+    user["email"] = QString("user%1@example.com").arg(id);
+    user["avatar_url"] = QString("https://gitlab.example.com/uploads/-/system/user/avatar/%1/avatar.png").arg(id);
+    user["web_url"] = QString("https://gitlab.example.com/user%1").arg(id);
+    return user;
+}
+
+QString description(int index) {
+    const QString unit = QString::fromUtf8("修复登录页在弱网下的重试逻辑 Fix retry logic for login page. ");
+    return unit.repeated(1 + index % 8);
+}
+
+QJsonArray readArray(const QString& path, bool& ok) {
+    QFile file(path);
+    ok = false;
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QJsonArray();
+    }
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    ok = doc.isArray();
+    return doc.array();
+}
+
+bool matches(const QJsonObject& item, const QHash<QByteArray, QByteArray>& query,
+             const char* parameter, const char* field) {
+    const QByteArray value = query.value(parameter);
+    if (value.isEmpty() || value == "all") {
+        return true;
+    }
+    return item[field].toString() == QString::fromUtf8(value);
+}
+
+}
+
+MockGitLabServer::MockGitLabServer(QObject* parent)
+    : QObject(parent)
+    , m_random(QRandomGenerator::securelySeeded())
+{
+    connect(&m_server, &QTcpServer::newConnection, this, &MockGitLabServer::onNewConnection);
+    generate(250, 120, 40, 30, 256);
+}
+
+bool MockGitLabServer::listen(quint16 port) {
+    return m_server.listen(QHostAddress::LocalHost, port);
+}
+
+QString MockGitLabServer::baseUrl() const {
+    return QString("http://127.0.0.1:%1").arg(m_server.serverPort());
+}
+
+void MockGitLabServer::generate(int mergeRequests, int pipelines, int projects, int members, int traceKb) {
+    m_user = userJson(1);
+
+    m_projects = QJsonArray();
+    for (int i = 0; i < projects; ++i) {
+        QJsonObject project;
+        project["id"] = 1000 + i;
+        project["name"] = QString("project-%1").arg(i);
+        project["path_with_namespace"] = QString("group/project-%1").arg(i);
+        project["description"] = description(i);
+        project["web_url"] = QString("https://gitlab.example.com/group/project-%1").arg(i);
+        m_projects.append(project);
+    }
+
+    m_mergeRequests = QJsonArray();
+    const char* const states[] = {"opened", "opened", "merged", "closed"};
+    const char* const targets[] = {"develop", "main", "release"};
+    for (int i = 0; i < mergeRequests; ++i) {
+        QJsonObject mr;
+        mr["id"] = 100000 + i;
+        mr["iid"] = mergeRequests - i;  // 与 GitLab 相同，默认按创建时间倒序
+        mr["project_id"] = 42;
+        mr["title"] = QString::fromUtf8("feature/%1: 优化构建流水线").arg(i);
+        mr["description"] = description(i);
+        mr["state"] = states[i % 4];
+        mr["created_at"] = "2024-05-10T08:30:00.000+08:00";
+        mr["updated_at"] = "2024-05-11T09:15:00.000+08:00";
+        mr["target_branch"] = targets[i % 3];
+        mr["source_branch"] = QString("feature/task-%1").arg(i);
+        mr["author"] = userJson(i % 20);
+        mr["labels"] = QJsonArray{"backend", "needs-review"};
+        mr["merge_status"] = "can_be_merged";
+        mr["web_url"] = QString("https://gitlab.example.com/group/project/-/merge_requests/%1").arg(mergeRequests - i);
+        m_mergeRequests.append(mr);
+    }
+
+    m_pipelines = QJsonArray();
+    const char* const statuses[] = {"success", "failed", "running", "pending", "canceled"};
+    for (int i = 0; i < pipelines; ++i) {
+        QJsonObject pipeline;
+        pipeline["id"] = 500000 - i;
+        pipeline["status"] = statuses[i % 5];
+        pipeline["ref"] = i % 2 == 0 ? "develop" : QString("feature/task-%1").arg(i);
+        pipeline["sha"] = "8f3c2a1b9d7e6f5a4b3c2d1e0f9a8b7c6d5e4f3a";
+        pipeline["created_at"] = "2024-05-10T08:30:00.000+08:00";
+        pipeline["updated_at"] = "2024-05-10T08:42:10.000+08:00";
+        pipeline["web_url"] = QString("https://gitlab.example.com/group/project/-/pipelines/%1").arg(500000 - i);
+        m_pipelines.append(pipeline);
+    }
+
+    m_members = QJsonArray();
+    for (int i = 0; i < members; ++i) {
+        QJsonObject member = userJson(i + 1);
+        member["access_level"] = i == 0 ? 50 : 30;
+        m_members.append(member);
+    }
+
+    m_trace.clear();
+    int line = 0;
+    while (m_trace.size() < traceKb * 1024) {
+        m_trace += QString("[%1] Step %2: compiling src/module%3.cpp\n").arg(line, 6, 10, QChar('0'))
+                       .arg(line / 50).arg(line % 97).toUtf8();
+        ++line;
+    }
+}
+
+void MockGitLabServer::loadRecordings(const QString& directory) {
+    QDir dir(directory);
+    bool ok = false;
+
+    QFile userFile(dir.filePath("user.json"));
+    if (userFile.open(QIODevice::ReadOnly)) {
+        const QJsonDocument doc = QJsonDocument::fromJson(userFile.readAll());
+        if (doc.isObject()) {
+            m_user = doc.object();
+        }
+    }
+
+    const QJsonArray projects = readArray(dir.filePath("projects.json"), ok);
+    if (ok) {
+        m_projects = projects;
+    }
+    const QJsonArray mergeRequests = readArray(dir.filePath("merge_requests.json"), ok);
+    if (ok) {
+        m_mergeRequests = mergeRequests;
+    }
+    const QJsonArray pipelines = readArray(dir.filePath("pipelines.json"), ok);
+    if (ok) {
+        m_pipelines = pipelines;
+    }
+    const QJsonArray members = readArray(dir.filePath("members.json"), ok);
+    if (ok) {
+        m_members = members;
+    }
+
+    QFile traceFile(dir.filePath("trace.txt"));
+    if (traceFile.open(QIODevice::ReadOnly)) {
+        m_trace = traceFile.readAll();
+    }
+}
+
+// ========== 连接与请求解析 ==========
+
+void MockGitLabServer::onNewConnection() {
+    while (QTcpSocket* socket = m_server.nextPendingConnection()) {
+        m_buffers.insert(socket, QByteArray());
+        m_stats.peakConnections = std::max(m_stats.peakConnections, int(m_buffers.size()));
+
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { onReadyRead(socket); });
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            m_buffers.remove(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+void MockGitLabServer::onReadyRead(QTcpSocket* socket) {
+    QByteArray& buffer = m_buffers[socket];
+    buffer += socket->readAll();
+
+    Request request;
+    bool malformed = false;
+    while (parseRequest(buffer, request, malformed)) {
+        ++m_stats.requests;
+
+        if (m_dropRate > 0.0 && m_random.generateDouble() < m_dropRate) {
+            ++m_stats.droppedConnections;
+            socket->abort();
+            return;
+        }
+
+        QString routeName;
+        Response response;
+        if (m_errorRate > 0.0 && m_random.generateDouble() < m_errorRate) {
+            ++m_stats.injectedErrors;
+            response = error(m_errorStatus, "injected failure");
+            routeName = "injected error";
+        } else if (!m_token.isEmpty() && request.headers.value("private-token") != m_token) {
+            response = error(401, "401 Unauthorized");
+            routeName = "unauthorized";
+        } else {
+            response = route(request, routeName);
+        }
+        ++m_routeCounts[routeName];
+
+        const int delay = delayMs();
+        if (delay > 0) {
+            QTimer::singleShot(delay, socket, [this, socket, request, response]() { send(socket, request, response); });
+        } else {
+            send(socket, request, response);
+        }
+    }
+
+    if (malformed) {
+        Response response = error(400, "malformed request");
+        send(socket, Request(), response);
+        socket->disconnectFromHost();
+    }
+}
+
+bool MockGitLabServer::parseRequest(QByteArray& buffer, Request& request, bool& malformed) {
+    const int headerEnd = buffer.indexOf("\r\n\r\n");
+    if (headerEnd < 0) {
+        malformed = buffer.size() > MAX_HEADER_BYTES;
+        return false;
+    }
+
+    const QList<QByteArray> lines = buffer.left(headerEnd).split('\n');
+    const QList<QByteArray> requestLine = lines.value(0).trimmed().split(' ');
+    if (requestLine.size() != 3) {
+        malformed = true;
+        return false;
+    }
+
+    request = Request();
+    request.method = requestLine[0];
+    for (int i = 1; i < lines.size(); ++i) {
+        const int colon = lines[i].indexOf(':');
+        if (colon > 0) {
+            request.headers.insert(lines[i].left(colon).trimmed().toLower(), lines[i].mid(colon + 1).trimmed());
+        }
+    }
+
+    // 请求体（POST/PUT）不参与路由，只需跳过
+    const int bodyLength = request.headers.value("content-length").toInt();
+    const int total = headerEnd + 4 + bodyLength;
+    if (buffer.size() < total) {
+        return false;
+    }
+    buffer.remove(0, total);
+
+    const QByteArray target = requestLine[1];
+    const int questionMark = target.indexOf('?');
+    request.path = questionMark < 0 ? target : target.left(questionMark);
+    if (questionMark >= 0) {
+        const QUrlQuery query(QString::fromUtf8(target.mid(questionMark + 1)));
+        for (const auto& item : query.queryItems(QUrl::FullyDecoded)) {
+            request.query.insert(item.first.toUtf8(), item.second.toUtf8());
+        }
+    }
+    return true;
+}
+
+// ========== 路由 ==========
+
+MockGitLabServer::Response MockGitLabServer::route(const Request& request, QString& routeName) const {
+    static const QRegularExpression projectRoute("^/api/v4/projects/[^/]+/(merge_requests|pipelines|members/all)$");
+    static const QRegularExpression traceRoute("^/api/v4/projects/[^/]+/jobs/(\\d+)/trace$");
+    static const QRegularExpression jobRoute("^/api/v4/projects/[^/]+/jobs/(\\d+)$");
+
+    const QString path = QString::fromUtf8(request.path);
+    if (request.method != "GET") {
+        routeName = QString("%1 (unsupported)").arg(QString::fromUtf8(request.method));
+        return error(404, "404 Not Found");
+    }
+
+    if (path == "/api/v4/user") {
+        routeName = "/user";
+        return json(QJsonDocument(m_user));
+    }
+    if (path == "/api/v4/projects") {
+        routeName = "/projects";
+        return paged(m_projects, request);
+    }
+
+    const QRegularExpressionMatch projectMatch = projectRoute.match(path);
+    if (projectMatch.hasMatch()) {
+        const QString resource = projectMatch.captured(1);
+        routeName = "/" + resource;
+        if (resource == "merge_requests") {
+            QJsonArray filtered;
+            for (const QJsonValue& value : m_mergeRequests) {
+                const QJsonObject mr = value.toObject();
+                if (matches(mr, request.query, "state", "state")
+                    && matches(mr, request.query, "target_branch", "target_branch")) {
+                    filtered.append(mr);
+                }
+            }
+            return paged(filtered, request);
+        }
+        if (resource == "pipelines") {
+            QJsonArray filtered;
+            for (const QJsonValue& value : m_pipelines) {
+                if (matches(value.toObject(), request.query, "ref", "ref")) {
+                    filtered.append(value);
+                }
+            }
+            return paged(filtered, request);
+        }
+        return json(QJsonDocument(m_members));
+    }
+
+    const QRegularExpressionMatch jobMatch = jobRoute.match(path);
+    if (jobMatch.hasMatch()) {
+        routeName = "/jobs/:id";
+        QJsonObject job;
+        job["id"] = jobMatch.captured(1).toInt();
+        job["name"] = "build";
+        job["stage"] = "build";
+        job["status"] = "success";
+        job["web_url"] = "https://gitlab.example.com/mock/-/jobs/" + jobMatch.captured(1);
+        return json(QJsonDocument(job));
+    }
+
+    if (traceRoute.match(path).hasMatch()) {
+        routeName = "/jobs/:id/trace";
+        Response response;
+        response.contentType = "text/plain; charset=utf-8";
+        // 只支持 JobLogTailer 使用的 "bytes=<起点>-"
+        const QByteArray range = request.headers.value("range");
+        if (range.startsWith("bytes=") && range.endsWith('-')) {
+            const qint64 start = range.mid(6, range.size() - 7).toLongLong();
+            if (start >= m_trace.size()) {
+                response.status = 416;
+                response.headers.append({"Content-Range", "bytes */" + QByteArray::number(m_trace.size())});
+                return response;
+            }
+            response.status = 206;
+            response.headers.append({"Content-Range", "bytes " + QByteArray::number(start) + "-"
+                                     + QByteArray::number(m_trace.size() - 1) + "/" + QByteArray::number(m_trace.size())});
+            response.body = m_trace.mid(start);
+            return response;
+        }
+        response.body = m_trace;
+        return response;
+    }
+
+    routeName = "not found";
+    return error(404, "404 Not Found");
+}
+
+MockGitLabServer::Response MockGitLabServer::paged(const QJsonArray& items, const Request& request) const {
+    int perPage = request.query.value("per_page").toInt();
+    perPage = perPage > 0 ? std::min(perPage, MAX_PER_PAGE) : DEFAULT_PER_PAGE;
+    const int page = std::max(1, request.query.value("page").toInt());
+    const int totalPages = std::max(1, int((items.size() + perPage - 1) / perPage));
+
+    QJsonArray slice;
+    for (int i = (page - 1) * perPage; i < std::min(int(items.size()), page * perPage); ++i) {
+        slice.append(items[i]);
+    }
+
+    Response response = json(QJsonDocument(slice));
+    response.headers.append({"X-Page", QByteArray::number(page)});
+    response.headers.append({"X-Per-Page", QByteArray::number(perPage)});
+    response.headers.append({"X-Next-Page", page < totalPages ? QByteArray::number(page + 1) : QByteArray()});
+    if (m_totalPagesHeader) {
+        response.headers.append({"X-Total", QByteArray::number(items.size())});
+        response.headers.append({"X-Total-Pages", QByteArray::number(totalPages)});
+    }
+
+    // Link 头中的地址使用请求中的其余参数
+    QUrlQuery query;
+    for (auto it = request.query.constBegin(); it != request.query.constEnd(); ++it) {
+        if (it.key() != "page") {
+            query.addQueryItem(QString::fromUtf8(it.key()), QString::fromUtf8(it.value()));
+        }
+    }
+    auto pageUrl = [&](int target) {
+        QUrlQuery pageQuery = query;
+        pageQuery.addQueryItem("page", QString::number(target));
+        return QString("<%1%2?%3>").arg(baseUrl(), QString::fromUtf8(request.path), pageQuery.toString(QUrl::FullyEncoded));
+    };
+    QStringList links;
+    if (page < totalPages) {
+        links << pageUrl(page + 1) + "; rel=\"next\"";
+    }
+    links << pageUrl(1) + "; rel=\"first\"";
+    if (m_totalPagesHeader) {
+        links << pageUrl(totalPages) + "; rel=\"last\"";
+    }
+    response.headers.append({"Link", links.join(", ").toUtf8()});
+    return response;
+}
+
+MockGitLabServer::Response MockGitLabServer::json(const QJsonDocument& document, int status) {
+    Response response;
+    response.status = status;
+    response.body = document.toJson(QJsonDocument::Compact);
+    return response;
+}
+
+MockGitLabServer::Response MockGitLabServer::error(int status, const QString& message) {
+    return json(QJsonDocument(QJsonObject{{"message", message}}), status);
+}
+
+// ========== 发送响应 ==========
+
+void MockGitLabServer::send(QTcpSocket* socket, const Request& request, Response response) {
+    if (socket->state() != QAbstractSocket::ConnectedState) {
+        return;
+    }
+
+    if (m_etagEnabled && response.status == 200) {
+        const QByteArray etag = "W/\"" + QCryptographicHash::hash(response.body, QCryptographicHash::Md5).toHex() + "\"";
+        response.headers.append({"ETag", etag});
+        if (request.headers.value("if-none-match") == etag) {
+            ++m_stats.notModified;
+            response.status = 304;
+            response.body.clear();
+        }
+    }
+
+    QByteArray head = "HTTP/1.1 " + QByteArray::number(response.status) + " " + reasonPhrase(response.status) + "\r\n";
+    if (response.status != 304) {
+        head += "Content-Type: " + response.contentType + "\r\n";
+    }
+    head += "Content-Length: " + QByteArray::number(response.body.size()) + "\r\n";
+    head += "Connection: keep-alive\r\n";
+    for (const auto& header : response.headers) {
+        head += header.first + ": " + header.second + "\r\n";
+    }
+    head += "\r\n";
+
+    m_stats.bytesSent += head.size() + response.body.size();
+    socket->write(head);
+    socket->write(response.body);
+}
+
+int MockGitLabServer::delayMs() {
+    if (m_jitterMs <= 0) {
+        return m_latencyMs;
+    }
+    return m_latencyMs + int(m_random.bounded(m_jitterMs + 1));
+}
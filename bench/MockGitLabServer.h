@@ -0,0 +1,123 @@
+#ifndef MOCKGITLABSERVER_H
+#define MOCKGITLABSERVER_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QHash>
+#include <QMap>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QRandomGenerator>
+
+class QTcpSocket;
+
+/**
+ * @brief 本地模拟 GitLab 服务器（基准与压测用）
+ *
+ * 在 127.0.0.1 上监听，返回录制的或生成的响应，使 GitLabApi 可以离线压测：
+ *   GET /api/v4/user
+ *   GET /api/v4/projects                              分页
+ *   GET /api/v4/projects/:id/merge_requests           分页
+ *   GET /api/v4/projects/:id/pipelines                分页
+ *   GET /api/v4/projects/:id/members/all
+ *   GET /api/v4/projects/:id/jobs/:job_id             状态固定为 success
+ *   GET /api/v4/projects/:id/jobs/:job_id/trace       纯文本，支持 Range: bytes=<起点>-
+ * 分页按 page / per_page 切片，返回与 GitLab 相同的 X-Total / X-Total-Pages / X-Next-Page / Link 头；
+ * 可关闭 X-Total-Pages 以模拟大结果集（GitLab 超过一万条时不返回总数）。
+ * 每个响应带 ETag，请求携带匹配的 If-None-Match 时返回 304。
+ * 可配置固定延迟与随机抖动、按比例注入 HTTP 错误或直接断开连接。
+ * 只实现 GitLabApi 用到的 HTTP/1.1 子集：keep-alive、Content-Length 请求体，不支持分块上传。
+ */
+class MockGitLabServer : public QObject {
+    Q_OBJECT
+
+public:
+    struct Stats {
+        quint64 requests = 0;
+        quint64 notModified = 0;
+        quint64 injectedErrors = 0;
+        quint64 droppedConnections = 0;
+        quint64 bytesSent = 0;
+        int peakConnections = 0;
+    };
+
+    explicit MockGitLabServer(QObject* parent = nullptr);
+
+    // port 为 0 时由系统分配
+    bool listen(quint16 port = 0);
+    QString baseUrl() const;
+
+    // 从目录加载录制的响应：user.json、projects.json、merge_requests.json、
+    // pipelines.json、members.json（列表接口为完整数组）、trace.txt；缺少的文件保留生成的数据
+    void loadRecordings(const QString& directory);
+    // 生成指定条数的模拟数据（构造时已生成一份默认规模的数据）
+    void generate(int mergeRequests, int pipelines, int projects, int members, int traceKb);
+
+    void setToken(const QString& token) { m_token = token.toUtf8(); }     // 为空时不校验
+    void setLatency(int baseMs, int jitterMs) { m_latencyMs = baseMs; m_jitterMs = jitterMs; }
+    void setErrorRate(double rate, int status = 503) { m_errorRate = rate; m_errorStatus = status; }
+    void setDropRate(double rate) { m_dropRate = rate; }
+    void setTotalPagesHeader(bool enabled) { m_totalPagesHeader = enabled; }
+    void setEtagEnabled(bool enabled) { m_etagEnabled = enabled; }
+
+    int mergeRequestCount() const { return m_mergeRequests.size(); }
+    int pipelineCount() const { return m_pipelines.size(); }
+    int projectCount() const { return m_projects.size(); }
+    int memberCount() const { return m_members.size(); }
+    int traceSize() const { return m_trace.size(); }
+
+    Stats stats() const { return m_stats; }
+    QMap<QString, quint64> requestsByRoute() const { return m_routeCounts; }
+
+private:
+    struct Request {
+        QByteArray method;
+        QByteArray path;   // 不含查询参数
+        QHash<QByteArray, QByteArray> query;
+        QHash<QByteArray, QByteArray> headers;  // 名称已转为小写
+    };
+
+    struct Response {
+        int status = 200;
+        QByteArray contentType = "application/json";
+        QByteArray body;
+        QList<QPair<QByteArray, QByteArray>> headers;
+    };
+
+    void onNewConnection();
+    void onReadyRead(QTcpSocket* socket);
+    bool parseRequest(QByteArray& buffer, Request& request, bool& malformed);
+
+    Response route(const Request& request, QString& routeName) const;
+    Response paged(const QJsonArray& items, const Request& request) const;
+    static Response json(const QJsonDocument& document, int status = 200);
+    static Response error(int status, const QString& message);
+
+    void send(QTcpSocket* socket, const Request& request, Response response);
+    int delayMs();
+
+    QTcpServer m_server;
+    QHash<QTcpSocket*, QByteArray> m_buffers;
+
+    QJsonObject m_user;
+    QJsonArray m_projects;
+    QJsonArray m_mergeRequests;
+    QJsonArray m_pipelines;
+    QJsonArray m_members;
+    QByteArray m_trace;
+
+    QByteArray m_token;
+    int m_latencyMs = 0;
+    int m_jitterMs = 0;
+    double m_errorRate = 0.0;
+    int m_errorStatus = 503;
+    double m_dropRate = 0.0;
+    bool m_totalPagesHeader = true;
+    bool m_etagEnabled = true;
+
+    QRandomGenerator m_random;
+    Stats m_stats;
+    QMap<QString, quint64> m_routeCounts;
+};
+
+#endif // MOCKGITLABSERVER_H
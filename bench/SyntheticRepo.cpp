@@ -0,0 +1,225 @@
+#include "SyntheticRepo.h"
+#include <QDir>
+#include <QFile>
+#include <QProcess>
+#include <algorithm>
+
+namespace {
+
+const qint64 BASE_TIME = 1600000000;  // 提交时间从固定时刻开始，保证每次生成的对象完全相同
+const char* const IDENTITY = "GitPilot Bench <bench@example.com>";
+const int LINES_PER_FILE = 20;
+const int FORK_SPAN = 50;             // 分支从主干最后 FORK_SPAN 个提交中分出
+
+QString sourcePath(int index) {
+    return QString("src/m%1/file%2.txt").arg(index / 100).arg(index);
+}
+
+QString hotPath(int index) {
+    return QString("hot/h%1.txt").arg(index);
+}
+
+QByteArray fileContent(const QString& path, const QString& revision) {
+    QByteArray content = QString("revision %1\n").arg(revision).toUtf8();
+    for (int line = 0; line < LINES_PER_FILE; ++line) {
+        content += QString("line %1 of %2\n").arg(line).arg(path).toUtf8();
+    }
+    return content;
+}
+
+void appendData(QByteArray& stream, const QByteArray& data) {
+    stream += "data " + QByteArray::number(data.size()) + "\n";
+    stream += data;
+    stream += "\n";
+}
+
+void appendModify(QByteArray& stream, const QString& path, const QByteArray& content) {
+    stream += "M 100644 inline " + path.toUtf8() + "\n";
+    appendData(stream, content);
+}
+
+void appendCommitHeader(QByteArray& stream, const QString& ref, int mark, qint64 time, const QString& message) {
+    const QByteArray signature = QByteArray(IDENTITY) + " " + QByteArray::number(time) + " +0000\n";
+    stream += "commit " + ref.toUtf8() + "\n";
+    stream += "mark :" + QByteArray::number(mark) + "\n";
+    stream += "author " + signature;
+    stream += "committer " + signature;
+    appendData(stream, message.toUtf8());
+}
+
+}
+
+SyntheticRepo::SyntheticRepo(const Options& options)
+    : m_options(options)
+{
+    m_options.files = std::max(1, m_options.files);
+    m_options.commits = std::max(1, m_options.commits);
+    m_options.branches = std::max(0, m_options.branches);
+    m_options.tags = std::max(0, m_options.tags);
+    m_options.dirtyFiles = std::clamp(m_options.dirtyFiles, 0, m_options.files);
+}
+
+bool SyntheticRepo::parseRefStorage(const QString& text, RefStorage& storage) {
+    if (text == "packed") {
+        storage = RefStorage::Packed;
+    } else if (text == "loose") {
+        storage = RefStorage::Loose;
+    } else if (text == "mixed") {
+        storage = RefStorage::Mixed;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+QString SyntheticRepo::refStorageName(RefStorage storage) {
+    switch (storage) {
+    case RefStorage::Packed: return "packed";
+    case RefStorage::Loose: return "loose";
+    case RefStorage::Mixed: return "mixed";
+    }
+    return QString();
+}
+
+QStringList SyntheticRepo::branchNames() const {
+    QStringList names;
+    for (int i = 0; i < m_options.branches; ++i) {
+        names << QString("feature/bench-%1").arg(i);
+    }
+    return names;
+}
+
+QByteArray SyntheticRepo::historyStream() const {
+    QByteArray stream;
+
+    // 提交 c 的 mark 为 c + 1；提交 0 为包含全部文件的初始提交
+    appendCommitHeader(stream, "refs/heads/main", 1, BASE_TIME, "Initial import");
+    for (int i = 0; i < m_options.files; ++i) {
+        appendModify(stream, sourcePath(i), fileContent(sourcePath(i), "0"));
+    }
+    for (int i = 0; i < HOT_FILE_COUNT; ++i) {
+        appendModify(stream, hotPath(i), fileContent(hotPath(i), "0"));
+    }
+
+    for (int c = 1; c <= m_options.commits; ++c) {
+        appendCommitHeader(stream, "refs/heads/main", c + 1, BASE_TIME + c * 60, QString("Change %1").arg(c));
+        stream += "from :" + QByteArray::number(c) + "\n";
+        if (c == m_options.commits) {
+            // 最后一个提交修改全部 hot/ 文件，之前分出的偶数分支与之冲突
+            for (int i = 0; i < HOT_FILE_COUNT; ++i) {
+                appendModify(stream, hotPath(i), fileContent(hotPath(i), "main"));
+            }
+        } else {
+            const int index = int((qint64(c) * 7919) % m_options.files);
+            appendModify(stream, sourcePath(index), fileContent(sourcePath(index), QString::number(c)));
+        }
+    }
+
+    for (int t = 0; t < m_options.tags; ++t) {
+        const int commit = int(qint64(t) * m_options.commits / std::max(1, m_options.tags));
+        const QString name = QString("v%1.%2.%3").arg(t / 100).arg((t / 10) % 10).arg(t % 10);
+        stream += "tag " + name.toUtf8() + "\n";
+        stream += "from :" + QByteArray::number(commit + 1) + "\n";
+        stream += "tagger " + QByteArray(IDENTITY) + " " + QByteArray::number(BASE_TIME + commit * 60) + " +0000\n";
+        appendData(stream, QString("Release %1").arg(name).toUtf8());
+    }
+
+    return stream;
+}
+
+QByteArray SyntheticRepo::branchStream() const {
+    QByteArray stream;
+    const int lastMark = m_options.commits + 1;
+    const int span = std::min(FORK_SPAN, m_options.commits);
+    const QStringList names = branchNames();
+
+    for (int j = 0; j < names.size(); ++j) {
+        const int forkMark = lastMark - 1 - (j % span);
+        const int mark = lastMark + 1 + j;
+        appendCommitHeader(stream, "refs/heads/" + names[j], mark, BASE_TIME + (forkMark + 1) * 60,
+                           QString("Work on %1").arg(names[j]));
+        stream += "from :" + QByteArray::number(forkMark) + "\n";
+        if (j % 2 == 0) {
+            const QString path = hotPath(j % HOT_FILE_COUNT);
+            appendModify(stream, path, fileContent(path, names[j]));
+        } else {
+            const QString path = QString("feature/%1.txt").arg(j);
+            appendModify(stream, path, fileContent(path, names[j]));
+        }
+    }
+
+    return stream;
+}
+
+bool SyntheticRepo::generate(const QString& path, QString* error) {
+    QDir dir(path);
+    if (!dir.exists() && !QDir().mkpath(path)) {
+        *error = QString("cannot create %1").arg(path);
+        return false;
+    }
+    if (!dir.isEmpty()) {
+        *error = QString("%1 is not empty").arg(path);
+        return false;
+    }
+    m_path = dir.absolutePath();
+
+    const QString marks = QDir(m_path).filePath(".git/bench-marks");
+    const bool packHistory = m_options.refs != RefStorage::Loose;
+    const bool packAll = m_options.refs == RefStorage::Packed;
+
+    if (!runGit({"init", "-q"}, error)
+        || !runGit({"symbolic-ref", "HEAD", "refs/heads/main"}, error)
+        || !runGit({"config", "user.name", "GitPilot Bench"}, error)
+        || !runGit({"config", "user.email", "bench@example.com"}, error)
+        || !runGit({"fast-import", "--quiet", "--export-marks=" + marks}, error, historyStream())
+        || (packHistory && !runGit({"pack-refs", "--all"}, error))
+        || !runGit({"fast-import", "--quiet", "--import-marks=" + marks}, error, branchStream())
+        || !runGit({"remote", "add", "origin", m_path}, error)
+        || !runGit({"fetch", "-q", "origin"}, error)
+        || (packAll && !runGit({"pack-refs", "--all"}, error))
+        || !runGit({"reset", "-q", "--hard"}, error)) {
+        return false;
+    }
+
+    QFile::remove(marks);
+    return dirtyWorkingTree(error);
+}
+
+bool SyntheticRepo::dirtyWorkingTree(QString* error) const {
+    QDir root(m_path);
+    root.mkpath("scratch");
+
+    // 只改动 src/ 下靠后的文件，分支不会碰到，合并检查不受未提交修改影响
+    for (int k = 0; k < m_options.dirtyFiles; ++k) {
+        QFile modified(root.filePath(sourcePath(m_options.files - 1 - k)));
+        QFile untracked(root.filePath(QString("scratch/untracked%1.txt").arg(k)));
+        if (!modified.open(QIODevice::Append) || !untracked.open(QIODevice::WriteOnly)) {
+            *error = QString("cannot write working tree files under %1").arg(m_path);
+            return false;
+        }
+        modified.write("local edit\n");
+        untracked.write("untracked\n");
+    }
+    return true;
+}
+
+bool SyntheticRepo::runGit(const QStringList& args, QString* error, const QByteArray& input) const {
+    QProcess process;
+    process.setWorkingDirectory(m_path);
+    process.start("git", args);
+    if (!process.waitForStarted()) {
+        *error = QString("cannot start git %1").arg(args.value(0));
+        return false;
+    }
+
+    if (!input.isEmpty()) {
+        process.write(input);
+    }
+    process.closeWriteChannel();
+
+    if (!process.waitForFinished(-1) || process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0) {
+        *error = QString("git %1 failed: %2").arg(args.join(' '), QString::fromLocal8Bit(process.readAllStandardError()));
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,61 @@
+#ifndef SYNTHETICREPO_H
+#define SYNTHETICREPO_H
+
+#include <QString>
+#include <QStringList>
+
+/**
+ * @brief 基准测试用的合成仓库
+ *
+ * 用 git fast-import 一次性生成指定规模的仓库，不依赖真实项目：
+ *   主干 main：初始提交包含 files 个文件，之后 commits 个提交各修改一个文件（深历史）
+ *   标签：tags 个附注标签，均匀分布在主干历史上，命名 vX.Y.Z
+ *   分支：branches 个 feature/bench-N，从主干末尾附近分出，各有一个提交；
+ *         偶数分支修改主干最后一个提交也改过的 hot/ 文件（合并有冲突），奇数分支只新增文件
+ *   远程：origin 指向仓库自身并已 fetch，供需要 origin/<分支> 的冲突检测使用
+ *   工作区：检出 main 后修改 dirtyFiles 个文件并新增同样数量的未跟踪文件
+ * 引用存储方式由 refs 控制：packed（全部打包）、loose（全部松散）、
+ * mixed（主干与标签打包、分支松散，与长期使用的仓库相近）。
+ */
+class SyntheticRepo {
+public:
+    enum class RefStorage {
+        Packed,
+        Loose,
+        Mixed
+    };
+
+    struct Options {
+        int files = 2000;
+        int commits = 5000;
+        int branches = 200;
+        int tags = 100;
+        int dirtyFiles = 50;
+        RefStorage refs = RefStorage::Mixed;
+    };
+
+    static constexpr int HOT_FILE_COUNT = 8;
+
+    explicit SyntheticRepo(const Options& options);
+
+    // 在 path（须为空目录或不存在）下生成仓库，失败时返回 false 并写入 error
+    bool generate(const QString& path, QString* error);
+
+    // 生成的分支名（不含 refs/heads/ 前缀），偶数下标的分支与 main 冲突
+    QStringList branchNames() const;
+
+    static bool parseRefStorage(const QString& text, RefStorage& storage);
+    static QString refStorageName(RefStorage storage);
+
+private:
+    QByteArray historyStream() const;   // 主干与标签
+    QByteArray branchStream() const;    // 分支（与主干分两次导入，以便 mixed 模式下分支保持松散）
+    bool dirtyWorkingTree(QString* error) const;
+
+    bool runGit(const QStringList& args, QString* error, const QByteArray& input = QByteArray()) const;
+
+    Options m_options;
+    QString m_path;
+};
+
+#endif // SYNTHETICREPO_H
@@ -1,4 +1,79 @@
 #include "ApiModels.h"
 
-// 此文件暂时为空，所有数据结构都在头文件中定义
-// 如果将来需要添加方法实现，可以在这里添加
+ProjectMember ProjectMember::fromJson(const QJsonObject& json) {
+    ProjectMember member;
+    member.id = json["id"].toInt();
+    member.username = json["username"].toString();
+    member.name = json["name"].toString();
+    return member;
+}
+
+MrResponse MrResponse::fromJson(const QJsonObject& json) {
+    MrResponse mr;
+    mr.id = json["id"].toInt();
+    mr.iid = json["iid"].toInt();
+    mr.title = json["title"].toString();
+    mr.webUrl = json["web_url"].toString();
+    mr.state = json["state"].toString();
+    mr.createdAt = json["created_at"].toString();
+    mr.description = json["description"].toString();
+    
+    if (json.contains("author") && json["author"].isObject()) {
+        QJsonObject author = json["author"].toObject();
+        mr.authorName = author["name"].toString();
+    }
+    return mr;
+}
+
+PipelineStatus PipelineStatus::fromJson(const QJsonObject& json) {
+    PipelineStatus pipeline;
+    pipeline.id = json["id"].toInt();
+    pipeline.status = json["status"].toString();
+    pipeline.ref = json["ref"].toString();
+    pipeline.webUrl = json["web_url"].toString();
+    
+    QString createdAt = json["created_at"].toString();
+    pipeline.createdAt = QDateTime::fromString(createdAt, Qt::ISODate);
+    
+    QString updatedAt = json["updated_at"].toString();
+    pipeline.updatedAt = QDateTime::fromString(updatedAt, Qt::ISODate);
+    
+    return pipeline;
+}
+
+PipelineJob PipelineJob::fromJson(const QJsonObject& json) {
+    PipelineJob job;
+    job.id = json["id"].toInt();
+    job.name = json["name"].toString();
+    job.stage = json["stage"].toString();
+    job.status = json["status"].toString();
+    job.webUrl = json["web_url"].toString();
+    return job;
+}
+
+BuildArtifact BuildArtifact::fromJson(const QJsonObject& json) {
+    BuildArtifact artifact;
+    artifact.filename = json["filename"].toString();
+    artifact.fileType = json["file_type"].toString();
+    artifact.size = json["size"].toVariant().toLongLong();
+    return artifact;
+}
+
+ProjectInfo ProjectInfo::fromJson(const QJsonObject& json) {
+    ProjectInfo project;
+    project.id = json["id"].toInt();
+    project.name = json["name"].toString();
+    project.pathWithNamespace = json["path_with_namespace"].toString();
+    project.description = json["description"].toString();
+    project.webUrl = json["web_url"].toString();
+    return project;
+}
+
+UserInfo UserInfo::fromJson(const QJsonObject& json) {
+    UserInfo user;
+    user.id = json["id"].toInt();
+    user.username = json["username"].toString();
+    user.name = json["name"].toString();
+    user.email = json["email"].toString();
+    return user;
+}
@@ -4,6 +4,8 @@
 #include <QString>
 #include <QDateTime>
 #include <QList>
+#include <QJsonObject>
+#include <QJsonArray>
 
 /**
  * @brief 项目成员信息
@@ -14,6 +16,8 @@ struct ProjectMember {
     QString name;            // 显示名称
     
     ProjectMember() : id(0) {}
+    
+    static ProjectMember fromJson(const QJsonObject& json);
 };
 
 /**
@@ -48,6 +52,8 @@ struct MrResponse {
     QString authorName;         // 提交人名称
     
     MrResponse() : id(0), iid(0) {}
+    
+    static MrResponse fromJson(const QJsonObject& json);
 };
 
 /**
@@ -65,8 +71,36 @@ struct PipelineStatus {
     bool isRunning() const { return status == "running"; }
     bool isSuccess() const { return status == "success"; }
     bool isFailed() const { return status == "failed"; }
+    // 尚未结束（含排队、等待资源等阶段）
+    bool isActive() const {
+        return isPending() || isRunning() || status == "created" ||
+               status == "waiting_for_resource" || status == "preparing";
+    }
     
     PipelineStatus() : id(0) {}
+    
+    static PipelineStatus fromJson(const QJsonObject& json);
+};
+
+/**
+ * @brief Pipeline中的单个Job
+ */
+struct PipelineJob {
+    int id;                     // Job ID
+    QString name;               // 如 "build:android"
+    QString stage;
+    QString status;             // created/pending/running/success/failed/canceled/skipped/manual
+    QString webUrl;
+    
+    // 尚未结束，日志还会继续增长
+    bool isActive() const {
+        return status == "created" || status == "pending" || status == "running" ||
+               status == "waiting_for_resource" || status == "preparing";
+    }
+    
+    PipelineJob() : id(0) {}
+    
+    static PipelineJob fromJson(const QJsonObject& json);
 };
 
 /**
@@ -74,10 +108,13 @@ struct PipelineStatus {
  */
 struct BuildArtifact {
     QString filename;           // 文件名
-    QString downloadUrl;        // 下载链接
+    QString fileType;           // archive/metadata/junit 等
+    QString downloadUrl;        // 下载链接（只有 archive 有）
     qint64 size;                // 文件大小(字节)
     
     BuildArtifact() : size(0) {}
+    
+    static BuildArtifact fromJson(const QJsonObject& json);  // 不含 downloadUrl
 };
 
 /**
@@ -91,6 +128,8 @@ struct ProjectInfo {
     QString webUrl;             // 网页链接
     
     ProjectInfo() : id(0) {}
+    
+    static ProjectInfo fromJson(const QJsonObject& json);
 };
 
 /**
@@ -103,6 +142,22 @@ struct UserInfo {
     QString email;
     
     UserInfo() : id(0) {}
+    
+    static UserInfo fromJson(const QJsonObject& json);
 };
 
+/**
+ * @brief 将JSON数组逐个转换为模型
+ * fromJson 不依赖任何共享状态，可以在工作线程中调用
+ */
+template <typename T>
+QList<T> listFromJson(const QJsonArray& array) {
+    QList<T> list;
+    list.reserve(array.size());
+    for (const QJsonValue& val : array) {
+        list.append(T::fromJson(val.toObject()));
+    }
+    return list;
+}
+
 #endif // APIMODELS_H
@@ -0,0 +1,73 @@
+#include "ApiResponseCache.h"
+#include <QCryptographicHash>
+
+ApiResponseCache::ApiResponseCache(int maxEntries)
+    : m_maxEntries(maxEntries)
+{
+}
+
+QByteArray ApiResponseCache::makeKey(const QUrl& url, const QByteArray& token) {
+    // 键中只保留Token摘要，切换账号后不会读到他人的缓存
+    QByteArray tokenHash = QCryptographicHash::hash(token, QCryptographicHash::Sha256).toHex().left(16);
+    return tokenHash + ' ' + url.toEncoded();
+}
+
+const ApiResponseCache::Entry* ApiResponseCache::lookupFresh(const QByteArray& key) {
+    auto it = m_entries.constFind(key);
+    if (it == m_entries.constEnd() || !it->isFresh()) {
+        return nullptr;
+    }
+    ++m_stats.hits;
+    return &it.value();
+}
+
+QByteArray ApiResponseCache::etag(const QByteArray& key) const {
+    auto it = m_entries.constFind(key);
+    return it == m_entries.constEnd() ? QByteArray() : it->etag;
+}
+
+void ApiResponseCache::store(const QByteArray& key, const QJsonDocument& document,
+                             const QByteArray& etag, qint64 ttlMs,
+                             const QHash<QByteArray, QByteArray>& headers) {
+    if (etag.isEmpty() && ttlMs <= 0) {
+        m_entries.remove(key);
+        return;
+    }
+
+    if (!m_entries.contains(key) && m_entries.size() >= m_maxEntries) {
+        evictOldest();
+    }
+
+    Entry& entry = m_entries[key];
+    entry.document = document;
+    entry.etag = etag;
+    entry.headers = headers;
+    entry.ttlMs = ttlMs;
+    entry.fetchedAt.start();
+}
+
+const ApiResponseCache::Entry* ApiResponseCache::revalidate(const QByteArray& key) {
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        return nullptr;
+    }
+    it->fetchedAt.start();
+    ++m_stats.revalidated;
+    return &it.value();
+}
+
+void ApiResponseCache::clear() {
+    m_entries.clear();
+}
+
+void ApiResponseCache::evictOldest() {
+    auto oldest = m_entries.end();
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (oldest == m_entries.end() || it->fetchedAt.elapsed() > oldest->fetchedAt.elapsed()) {
+            oldest = it;
+        }
+    }
+    if (oldest != m_entries.end()) {
+        m_entries.erase(oldest);
+    }
+}
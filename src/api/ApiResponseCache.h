@@ -0,0 +1,72 @@
+#ifndef APIRESPONSECACHE_H
+#define APIRESPONSECACHE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonDocument>
+#include <QElapsedTimer>
+#include <QUrl>
+
+/**
+ * @brief GitLab API GET响应缓存
+ *
+ * 以 URL + Token 摘要为键保存解析后的 JSON 与 ETag。
+ * TTL 内的请求直接命中缓存不发网络请求；过期后带 If-None-Match 重新验证，
+ * 服务端返回 304 时复用缓存内容，省去下载与 JSON 解析。
+ * 仅在UI线程（GitLabApi 所在线程）使用，不加锁。
+ */
+class ApiResponseCache {
+public:
+    struct Entry {
+        QJsonDocument document;
+        QByteArray etag;
+        QHash<QByteArray, QByteArray> headers;  // 需要随内容保存的响应头（如分页信息）
+        qint64 ttlMs = 0;
+        QElapsedTimer fetchedAt;
+
+        bool isFresh() const { return ttlMs > 0 && fetchedAt.isValid() && !fetchedAt.hasExpired(ttlMs); }
+    };
+
+    struct Stats {
+        quint64 hits = 0;         // TTL内直接命中
+        quint64 revalidated = 0;  // 304 重新验证命中
+        quint64 misses = 0;       // 完整下载
+
+        double hitRate() const {
+            const quint64 total = hits + revalidated + misses;
+            return total == 0 ? 0.0 : double(hits + revalidated) / double(total);
+        }
+    };
+
+    explicit ApiResponseCache(int maxEntries = 256);
+
+    static QByteArray makeKey(const QUrl& url, const QByteArray& token);
+
+    // TTL内的有效缓存，命中时计入 hits；未命中返回 nullptr
+    const Entry* lookupFresh(const QByteArray& key);
+
+    // 用于发起条件请求的 ETag（没有时为空）
+    QByteArray etag(const QByteArray& key) const;
+
+    // 200 响应：保存内容（没有 ETag 且 TTL 为 0 时无需缓存）
+    void store(const QByteArray& key, const QJsonDocument& document, const QByteArray& etag, qint64 ttlMs,
+               const QHash<QByteArray, QByteArray>& headers = QHash<QByteArray, QByteArray>());
+
+    // 304 响应：刷新时间戳并返回缓存内容；缓存已被清理时返回 nullptr
+    const Entry* revalidate(const QByteArray& key);
+
+    void recordMiss() { ++m_stats.misses; }
+    void clear();
+
+    Stats stats() const { return m_stats; }
+    int size() const { return m_entries.size(); }
+
+private:
+    void evictOldest();
+
+    QHash<QByteArray, Entry> m_entries;
+    int m_maxEntries;
+    Stats m_stats;
+};
+
+#endif // APIRESPONSECACHE_H
@@ -1,22 +1,78 @@
 #include "GitLabApi.h"
 #include "utils/Logger.h"
+#include "utils/MetricsRegistry.h"
+#include "utils/TraceRecorder.h"
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QUrlQuery>
 #include <QDateTime>
 #include <QTimer>
-#include <QMessageBox>
+#include <QPromise>
+#include <QFutureWatcher>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <memory>
+
+namespace {
+
+constexpr int kMaxConcurrentPages = 4;
+
+QHash<QByteArray, QByteArray> pageHeadersOf(QNetworkReply* reply) {
+    QHash<QByteArray, QByteArray> headers;
+    for (const QByteArray& name : {QByteArray("X-Total-Pages"), QByteArray("X-Next-Page"), QByteArray("Link")}) {
+        if (reply->hasRawHeader(name)) {
+            headers.insert(name, reply->rawHeader(name));
+        }
+    }
+    return headers;
+}
+
+// 各GET接口的缓存有效期（毫秒）：
+// >0 有效期内不发请求；0 每次都带 If-None-Match 重新验证；<0 不缓存（日志、制品等大响应）
+qint64 cacheTtlMs(const QString& endpointName) {
+    if (endpointName == "listProjectMembers") {
+        return 60 * 60 * 1000;  // 成员很少变化
+    }
+    if (endpointName == "getProjects" || endpointName == "getProject") {
+        return 5 * 60 * 1000;
+    }
+    if (endpointName == "getCurrentUser" || endpointName == "listMergeRequests" ||
+        endpointName == "getMergeRequest" || endpointName == "listPipelines" ||
+        endpointName == "getPipelineStatus" || endpointName == "listPipelineJobs" ||
+        endpointName == "getJob") {
+        return 0;  // 状态会随时变化，只省去未变化时的下载与解析
+    }
+    return -1;
+}
+
+template <typename T>
+QFuture<T> projectIdMissing(const QString& endpointName) {
+    return QtFuture::makeExceptionalFuture<T>(ApiError(endpointName, QString::fromUtf8("项目ID未设置")));
+}
+
+template <typename T>
+PagedList<T> pagedProjectIdMissing(const QString& endpointName) {
+    return {projectIdMissing<T>(endpointName), projectIdMissing<bool>(endpointName)};
+}
+
+}
 
 GitLabApi::GitLabApi(QObject* parent)
     : QObject(parent)
     , m_networkManager(new QNetworkAccessManager(this))
+    , m_parseExecutor(new QThreadPool(this))
 {
+    m_parseExecutor->setMaxThreadCount(MAX_PARSE_THREADS);
+    
     connect(m_networkManager, &QNetworkAccessManager::finished,
             this, &GitLabApi::onReplyFinished);
 }
 
 GitLabApi::~GitLabApi() {
+    // 未完成的 promise 随处理函数一起析构，对应的 future 变为已取消
+    m_pendingReplies.clear();
+    m_pagedRequests.clear();
 }
 
 void GitLabApi::setBaseUrl(const QString& url) {
@@ -36,60 +92,146 @@ void GitLabApi::setProjectId(const QString& projectId) {
     LOG_INFO(QString("设置Project ID: '%1'").arg(projectId));
 }
 
+void GitLabApi::clearCache() {
+    m_responseCache.clear();
+}
+
+// ========== 请求与 future 的绑定 ==========
+
+template <typename T>
+QFuture<T> GitLabApi::request(HttpMethod method, const QString& endpointName, const QString& endpoint,
+                              const QJsonObject& data, std::function<T(const QJsonDocument&, const QByteArray&)> parse) {
+    auto promise = std::make_shared<QPromise<T>>();
+    promise->start();
+    
+    QNetworkReply* reply = sendRequest(method, endpointName, endpoint, data,
+        [this, promise, parse](const QJsonDocument& doc, const QByteArray& body, const ResponseHeaders&) {
+            QtConcurrent::run(m_parseExecutor, [promise, parse, doc, body]() {
+                TRACE_SCOPE("api", "GitLabApi::buildModel");
+                promise->addResult(parse(doc, body));
+                promise->finish();
+            });
+        },
+        [promise](const ApiError& error) {
+            promise->setException(error);
+            promise->finish();
+        });
+    
+    abortOnCancel(reply, QFuture<void>(promise->future()));
+    return promise->future();
+}
+
+template <typename T>
+QFuture<T> GitLabApi::requestList(const QString& endpointName, const QString& endpoint,
+                                  std::function<QList<T>(const QJsonDocument&)> parse) {
+    auto promise = std::make_shared<QPromise<T>>();
+    promise->start();
+    
+    QNetworkReply* reply = sendRequest(HttpMethod::Get, endpointName, endpoint, QJsonObject(),
+        [this, promise, parse](const QJsonDocument& doc, const QByteArray&, const ResponseHeaders&) {
+            QtConcurrent::run(m_parseExecutor, [promise, parse, doc]() {
+                TRACE_SCOPE("api", "GitLabApi::buildModels");
+                promise->addResults(parse(doc));
+                promise->finish();
+            });
+        },
+        [promise](const ApiError& error) {
+            promise->setException(error);
+            promise->finish();
+        });
+    
+    abortOnCancel(reply, QFuture<void>(promise->future()));
+    return promise->future();
+}
+
+template <typename T>
+PagedList<T> GitLabApi::requestPaged(const QString& endpointName, const QString& endpoint, int perPage, int maxItems) {
+    auto promise = std::make_shared<QPromise<T>>();
+    auto truncatedPromise = std::make_shared<QPromise<bool>>();
+    promise->start();
+    truncatedPromise->start();
+    
+    PagedRequest paged;
+    paged.endpointName = endpointName;
+    paged.endpoint = endpoint;
+    paged.perPage = perPage;
+    paged.maxItems = maxItems;
+    paged.future = QFuture<void>(promise->future());
+    auto parsing = std::make_shared<QFuture<void>>();
+    paged.onPage = [this, promise, truncatedPromise, parsing](const QJsonArray& items, int page, bool isLastPage,
+                                                              bool truncated) {
+        auto parsePage = [promise, truncatedPromise, items, isLastPage, truncated]() {
+            TRACE_SCOPE("api", "GitLabApi::buildModels");
+            promise->addResults(listFromJson<T>(items));
+            if (isLastPage) {
+                // 先给出 truncated，调用方在 items 完成时即可读取
+                truncatedPromise->addResult(truncated);
+                truncatedPromise->finish();
+                promise->finish();
+            }
+        };
+        // 各页的模型构建依次衔接，保证结果按页序加入
+        *parsing = (page == 1) ? QtConcurrent::run(m_parseExecutor, parsePage)
+                               : parsing->then(m_parseExecutor, parsePage);
+    };
+    paged.onError = [promise, truncatedPromise](const ApiError& error) {
+        truncatedPromise->setException(error);
+        truncatedPromise->finish();
+        promise->setException(error);
+        promise->finish();
+    };
+    
+    PagedList<T> result{promise->future(), truncatedPromise->future()};
+    startPagedRequest(std::move(paged));
+    return result;
+}
+
 // ========== 用户API ==========
 
-void GitLabApi::getCurrentUser() {
+QFuture<UserInfo> GitLabApi::getCurrentUser() {
     LOG_INFO("API调用: 获取当前用户信息");
-    sendGetRequest("/api/v4/user", "getCurrentUser");
+    return request<UserInfo>(HttpMethod::Get, "getCurrentUser", "/api/v4/user", QJsonObject(),
+        [](const QJsonDocument& doc, const QByteArray&) { return UserInfo::fromJson(doc.object()); });
 }
 
 // ========== 项目API ==========
 
-void GitLabApi::getProjects() {
+PagedList<ProjectInfo> GitLabApi::getProjects() {
     LOG_INFO("API调用: 获取项目列表");
-    sendGetRequest("/api/v4/projects?membership=true&per_page=100", "getProjects");
+    return requestPaged<ProjectInfo>("getProjects", "/api/v4/projects?membership=true&per_page=100", 100, 0);
 }
 
-void GitLabApi::getProject(const QString& projectId) {
+QFuture<ProjectInfo> GitLabApi::getProject(const QString& projectId) {
     LOG_INFO(QString("API调用: 获取项目信息 ID=%1").arg(projectId));
     QString endpoint = QString("/api/v4/projects/%1").arg(projectId);
-    sendGetRequest(endpoint, "getProject");
+    return request<ProjectInfo>(HttpMethod::Get, "getProject", endpoint, QJsonObject(),
+        [](const QJsonDocument& doc, const QByteArray&) { return ProjectInfo::fromJson(doc.object()); });
 }
 
-void GitLabApi::listProjectMembers() {
+QFuture<ProjectMember> GitLabApi::listProjectMembers() {
     LOG_INFO(QString("API调用: 获取项目成员"));
     
     if (m_projectId.isEmpty()) {
         LOG_ERROR("项目ID未设置，无法获取成员");
-        emit apiError("listProjectMembers", QString::fromUtf8("项目ID未设置"));
-        return;
-    }
-    
-    // Check cache (valid for 1 hour = 3600 seconds)
-    if (m_lastMembersFetchTime.isValid() && m_lastMembersFetchTime.secsTo(QDateTime::currentDateTime()) < 3600) {
-        LOG_INFO("命中缓存，直接返回项目成员列表");
-        // Use singleShot to mimic async behavior and avoid breaking calling code
-        QTimer::singleShot(0, this, [this]() {
-            emit projectMembersReceived(m_cachedMembers);
-        });
-        return;
+        return projectIdMissing<ProjectMember>("listProjectMembers");
     }
     
     QString encodedProjectId = QString(QUrl::toPercentEncoding(m_projectId));
     QString endpoint = QString("/api/v4/projects/%1/members/all").arg(encodedProjectId);
-    sendGetRequest(endpoint, "listProjectMembers");
+    return requestList<ProjectMember>("listProjectMembers", endpoint, [](const QJsonDocument& doc) {
+        return listFromJson<ProjectMember>(doc.array());
+    });
 }
 
 // ========== MR API ==========
 
-void GitLabApi::createMergeRequest(const MrParams& params) {
+QFuture<MrResponse> GitLabApi::createMergeRequest(const MrParams& params) {
     LOG_INFO(QString("API调用: 创建MR %1 -> %2")
              .arg(params.sourceBranch, params.targetBranch));
     
     if (m_projectId.isEmpty()) {
         LOG_ERROR("项目ID未设置，无法创建MR");
-        emit apiError("createMergeRequest", QString::fromUtf8("项目ID未设置"));
-        return;
+        return projectIdMissing<MrResponse>("createMergeRequest");
     }
     
     QJsonObject json;
@@ -113,30 +255,31 @@ void GitLabApi::createMergeRequest(const MrParams& params) {
         json["assignee_ids"] = assignees;
     }
     
-    LOG_INFO(QString("MR JSON: %1").arg(QString(QJsonDocument(json).toJson())));
+    LOG_DEBUG(QString("MR JSON: %1").arg(QString(QJsonDocument(json).toJson())));
     
     // URL编码项目ID（如果是路径格式 yanghaozhe/test -> yanghaozhe%2Ftest）
     QString encodedProjectId = QString(QUrl::toPercentEncoding(m_projectId));
     QString endpoint = QString("/api/v4/projects/%1/merge_requests").arg(encodedProjectId);
-    sendPostRequest(endpoint, json, "createMergeRequest");
+    return request<MrResponse>(HttpMethod::Post, "createMergeRequest", endpoint, json,
+        [](const QJsonDocument& doc, const QByteArray&) { return MrResponse::fromJson(doc.object()); });
 }
 
-void GitLabApi::getMergeRequest(int mrIid) {
+QFuture<MrResponse> GitLabApi::getMergeRequest(int mrIid) {
     QString encodedProjectId = QString(m_projectId).replace("/", "%2F");
     QString endpoint = "/api/v4/projects/" + encodedProjectId + "/merge_requests/" + QString::number(mrIid);
-    sendGetRequest(endpoint, "getMergeRequest");
+    return request<MrResponse>(HttpMethod::Get, "getMergeRequest", endpoint, QJsonObject(),
+        [](const QJsonDocument& doc, const QByteArray&) { return MrResponse::fromJson(doc.object()); });
 }
 
-void GitLabApi::listMergeRequests(int page, int perPage, const QString& state, const QString& targetBranch) {
-    LOG_INFO(QString("API调用: 列出MR, page=%1, perPage=%2, state=%3, targetBranch=%4")
-             .arg(page).arg(perPage).arg(state.isEmpty() ? "all" : state).arg(targetBranch.isEmpty() ? "all" : targetBranch));
-    
-    LOG_INFO(QString("Project ID: '%1' (isEmpty=%2)").arg(m_projectId).arg(m_projectId.isEmpty() ? "YES" : "NO"));
+PagedList<MrResponse> GitLabApi::listMergeRequests(const QString& state, const QString& targetBranch, int maxItems) {
+    LOG_INFO("API调用: 列出MR", {{"state", state.isEmpty() ? "all" : state},
+                                  {"target", targetBranch.isEmpty() ? "all" : targetBranch},
+                                  {"project", m_projectId}});
     
+    const int perPage = 100;
     QString encodedProjectId = QString(m_projectId).replace("/", "%2F");
     QString endpoint = "/api/v4/projects/" + encodedProjectId + 
-                       "/merge_requests?page=" + QString::number(page) + 
-                       "&per_page=" + QString::number(perPage);
+                       "/merge_requests?per_page=" + QString::number(perPage);
     
     if (!state.isEmpty()) {
         endpoint += QString("&state=%1").arg(state);
@@ -146,39 +289,36 @@ void GitLabApi::listMergeRequests(int page, int perPage, const QString& state, c
         endpoint += QString("&target_branch=%1").arg(targetBranch);
     }
     
-    LOG_INFO(QString("List MRs endpoint: %1").arg(endpoint));
-    LOG_INFO(QString("Base URL: %1").arg(m_baseUrl));
+    LOG_DEBUG("List MRs", {{"endpoint", endpoint}, {"base_url", m_baseUrl}});
                       
-    sendGetRequest(endpoint, "listMergeRequests");
+    return requestPaged<MrResponse>("listMergeRequests", endpoint, perPage, maxItems);
 }
 
-void GitLabApi::approveMergeRequest(int mrIid) {
+QFuture<MrResponse> GitLabApi::approveMergeRequest(int mrIid) {
     LOG_INFO(QString("API调用: 批准MR !%1").arg(mrIid));
     
     if (m_projectId.isEmpty()) {
         LOG_ERROR("项目ID未设置，无法批准MR");
-        emit apiError("approveMergeRequest", QString::fromUtf8("项目ID未设置"));
-        return;
+        return projectIdMissing<MrResponse>("approveMergeRequest");
     }
     
     QString encodedProjectId = QString(m_projectId).replace("/", "%2F");
     QString endpoint = "/api/v4/projects/" + encodedProjectId + 
                        "/merge_requests/" + QString::number(mrIid) + "/approve";
     
-    LOG_INFO(QString("Approve endpoint: %1").arg(endpoint));
-    LOG_INFO(QString("Project ID: %1, Encoded: %2").arg(m_projectId, encodedProjectId));
+    LOG_DEBUG("Approve MR", {{"endpoint", endpoint}, {"project", m_projectId}});
     
     QJsonObject json; // Empty body for approve
-    sendPostRequest(endpoint, json, QString("approveMergeRequest:%1").arg(mrIid));
+    return request<MrResponse>(HttpMethod::Post, "approveMergeRequest", endpoint, json,
+        [](const QJsonDocument& doc, const QByteArray&) { return MrResponse::fromJson(doc.object()); });
 }
 
-void GitLabApi::mergeMergeRequest(int mrIid, bool shouldRemoveSourceBranch) {
+QFuture<MrResponse> GitLabApi::mergeMergeRequest(int mrIid, bool shouldRemoveSourceBranch) {
     LOG_INFO(QString("API调用: 合并MR !%1").arg(mrIid));
     
     if (m_projectId.isEmpty()) {
         LOG_ERROR("项目ID未设置，无法合并MR");
-        emit apiError("mergeMergeRequest", QString::fromUtf8("项目ID未设置"));
-        return;
+        return projectIdMissing<MrResponse>("mergeMergeRequest");
     }
     
     QJsonObject json;
@@ -188,18 +328,18 @@ void GitLabApi::mergeMergeRequest(int mrIid, bool shouldRemoveSourceBranch) {
     QString endpoint = "/api/v4/projects/" + encodedProjectId + 
                        "/merge_requests/" + QString::number(mrIid) + "/merge";
     
-    LOG_INFO(QString("Merge endpoint: %1").arg(endpoint));
+    LOG_DEBUG("Merge MR", {{"endpoint", endpoint}});
     
-    sendPutRequest(endpoint, json, QString("mergeMergeRequest:%1").arg(mrIid));
+    return request<MrResponse>(HttpMethod::Put, "mergeMergeRequest", endpoint, json,
+        [](const QJsonDocument& doc, const QByteArray&) { return MrResponse::fromJson(doc.object()); });
 }
 
-void GitLabApi::closeMergeRequest(int mrIid) {
+QFuture<MrResponse> GitLabApi::closeMergeRequest(int mrIid) {
     LOG_INFO(QString("API调用: 关闭MR !%1").arg(mrIid));
     
     if (m_projectId.isEmpty()) {
         LOG_ERROR("项目ID未设置，无法关闭MR");
-        emit apiError("closeMergeRequest", QString::fromUtf8("项目ID未设置"));
-        return;
+        return projectIdMissing<MrResponse>("closeMergeRequest");
     }
     
     QJsonObject json;
@@ -209,14 +349,15 @@ void GitLabApi::closeMergeRequest(int mrIid) {
     QString endpoint = "/api/v4/projects/" + encodedProjectId + 
                        "/merge_requests/" + QString::number(mrIid);
     
-    LOG_INFO(QString("Close endpoint: %1").arg(endpoint));
+    LOG_DEBUG("Close MR", {{"endpoint", endpoint}});
     
-    sendPutRequest(endpoint, json, QString("closeMergeRequest:%1").arg(mrIid));
+    return request<MrResponse>(HttpMethod::Put, "closeMergeRequest", endpoint, json,
+        [](const QJsonDocument& doc, const QByteArray&) { return MrResponse::fromJson(doc.object()); });
 }
 
 // ========== Pipeline API ==========
 
-void GitLabApi::triggerPipeline(const QString& ref) {
+QFuture<PipelineStatus> GitLabApi::triggerPipeline(const QString& ref) {
     LOG_INFO(QString("API调用: 触发Pipeline ref=%1").arg(ref));
     
     QJsonObject json;
@@ -224,81 +365,202 @@ void GitLabApi::triggerPipeline(const QString& ref) {
     
     QString encodedProjectId = QString(QUrl::toPercentEncoding(m_projectId));
     QString endpoint = QString("/api/v4/projects/%1/pipeline").arg(encodedProjectId);
-    sendPostRequest(endpoint, json, "triggerPipeline");
+    return request<PipelineStatus>(HttpMethod::Post, "triggerPipeline", endpoint, json,
+        [](const QJsonDocument& doc, const QByteArray&) { return PipelineStatus::fromJson(doc.object()); });
 }
 
-void GitLabApi::getPipelineStatus(int pipelineId) {
+QFuture<PipelineStatus> GitLabApi::getPipelineStatus(int pipelineId) {
     QString encodedProjectId = QString(m_projectId).replace("/", "%2F");
     QString endpoint = "/api/v4/projects/" + encodedProjectId + "/pipelines/" + QString::number(pipelineId);
-    sendGetRequest(endpoint, "getPipelineStatus");
+    return request<PipelineStatus>(HttpMethod::Get, "getPipelineStatus", endpoint, QJsonObject(),
+        [](const QJsonDocument& doc, const QByteArray&) { return PipelineStatus::fromJson(doc.object()); });
 }
 
-void GitLabApi::listPipelines(const QString& ref) {
+PagedList<PipelineStatus> GitLabApi::listPipelines(const QString& ref, int maxItems) {
+    // 只需要少量记录时按需缩小每页条数，避免多下载
+    const int perPage = (maxItems > 0 && maxItems < 100) ? maxItems : 100;
     QString encodedProjectId = QString(QUrl::toPercentEncoding(m_projectId));
-    QString endpoint = QString("/api/v4/projects/%1/pipelines?per_page=11").arg(encodedProjectId);
+    QString endpoint = QString("/api/v4/projects/%1/pipelines?per_page=%2").arg(encodedProjectId).arg(perPage);
     if (!ref.isEmpty()) {
         endpoint += QString("&ref=%1").arg(ref);
     }
-    sendGetRequest(endpoint, "listPipelines");
+    return requestPaged<PipelineStatus>("listPipelines", endpoint, perPage, maxItems);
 }
 
-void GitLabApi::retryPipeline(int pipelineId) {
+QFuture<PipelineStatus> GitLabApi::retryPipeline(int pipelineId) {
     LOG_INFO(QString("API调用: 重试Pipeline #%1").arg(pipelineId));
     
     QString encodedProjectId = QString(m_projectId).replace("/", "%2F");
     QString endpoint = "/api/v4/projects/" + encodedProjectId + "/pipelines/" + QString::number(pipelineId) + "/retry";
     
     QJsonObject json; // Empty body
-    sendPostRequest(endpoint, json, QString("retryPipeline:%1").arg(pipelineId));
+    return request<PipelineStatus>(HttpMethod::Post, "retryPipeline", endpoint, json,
+        [](const QJsonDocument& doc, const QByteArray&) { return PipelineStatus::fromJson(doc.object()); });
 }
 
-void GitLabApi::cancelPipeline(int pipelineId) {
+QFuture<PipelineStatus> GitLabApi::cancelPipeline(int pipelineId) {
     LOG_INFO(QString("API调用: 取消Pipeline #%1").arg(pipelineId));
     
     QString encodedProjectId = QString(m_projectId).replace("/", "%2F");
     QString endpoint = "/api/v4/projects/" + encodedProjectId + "/pipelines/" + QString::number(pipelineId) + "/cancel";
     
     QJsonObject json; // Empty body
-    sendPostRequest(endpoint, json, QString("cancelPipeline:%1").arg(pipelineId));
+    return request<PipelineStatus>(HttpMethod::Post, "cancelPipeline", endpoint, json,
+        [](const QJsonDocument& doc, const QByteArray&) { return PipelineStatus::fromJson(doc.object()); });
 }
 
 // ========== Job API ==========
 
-void GitLabApi::getJobLog(int jobId) {
+PagedList<PipelineJob> GitLabApi::listPipelineJobs(int pipelineId) {
+    if (m_projectId.isEmpty()) {
+        return pagedProjectIdMissing<PipelineJob>("listPipelineJobs");
+    }
+    
+    QString encodedProjectId = QString(QUrl::toPercentEncoding(m_projectId));
+    QString endpoint = QString("/api/v4/projects/%1/pipelines/%2/jobs?per_page=100").arg(encodedProjectId).arg(pipelineId);
+    return requestPaged<PipelineJob>("listPipelineJobs", endpoint, 100, 0);
+}
+
+QFuture<PipelineJob> GitLabApi::getJob(int jobId) {
+    QString encodedProjectId = QString(m_projectId).replace("/", "%2F");
+    QString endpoint = "/api/v4/projects/" + encodedProjectId + "/jobs/" + QString::number(jobId);
+    return request<PipelineJob>(HttpMethod::Get, "getJob", endpoint, QJsonObject(),
+        [](const QJsonDocument& doc, const QByteArray&) { return PipelineJob::fromJson(doc.object()); });
+}
+
+QFuture<QString> GitLabApi::getJobLog(int jobId) {
     QString encodedProjectId = QString(m_projectId).replace("/", "%2F");
     QString endpoint = "/api/v4/projects/" + encodedProjectId + "/jobs/" + QString::number(jobId) + "/trace";
-    sendGetRequest(endpoint, QString("getJobLog:%1").arg(jobId));
+    // 日志是纯文本，直接使用响应体
+    return request<QString>(HttpMethod::Get, "getJobLog", endpoint, QJsonObject(),
+        [](const QJsonDocument&, const QByteArray& body) { return QString::fromUtf8(body); });
 }
 
-void GitLabApi::getJobArtifacts(int jobId) {
+QNetworkReply* GitLabApi::openJobTrace(int jobId, qint64 offset) {
+    if (m_projectId.isEmpty()) {
+        LOG_ERROR("项目ID未设置，无法读取Job日志");
+        return nullptr;
+    }
+    
     QString encodedProjectId = QString(m_projectId).replace("/", "%2F");
-    QString endpoint = "/api/v4/projects/" + encodedProjectId + "/jobs/" + QString::number(jobId) + "/artifacts";
-    sendGetRequest(endpoint, QString("getJobArtifacts:%1").arg(jobId));
+    QString endpoint = "/api/v4/projects/" + encodedProjectId + "/jobs/" + QString::number(jobId) + "/trace";
+    return openDownload(buildApiUrl(endpoint), offset);
 }
 
-// ========== HTTP请求方法 ==========
+QNetworkReply* GitLabApi::openDownload(const QString& url, qint64 offset) {
+    if (url.isEmpty()) {
+        return nullptr;
+    }
+    
+    QNetworkRequest request{QUrl(url)};
+    if (!m_baseUrl.isEmpty() && url.startsWith(m_baseUrl + "/")) {
+        request.setRawHeader("PRIVATE-TOKEN", m_apiToken.toUtf8());
+    }
+    if (offset > 0) {
+        request.setRawHeader("Range", "bytes=" + QByteArray::number(offset) + "-");
+    }
+    // 偏移量按未压缩的字节计算，不能让服务器压缩
+    request.setRawHeader("Accept-Encoding", "identity");
+    // /jobs/:id/artifacts 通常重定向到对象存储，由调用方重新请求，令牌是否附带按新地址判断
+    request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::ManualRedirectPolicy);
+    
+    // 不进入 m_pendingReplies：响应体不缓存、不整体交付，onReplyFinished 只负责释放
+    return m_networkManager->get(request);
+}
 
-void GitLabApi::sendGetRequest(const QString& endpoint, const QString& callbackId) {
-    QNetworkRequest request = createRequest(endpoint);
-    QNetworkReply* reply = m_networkManager->get(request);
-    reply->setProperty("callbackId", callbackId);
+QUrl GitLabApi::redirectTarget(QNetworkReply* reply) {
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (status < 300 || status >= 400) {
+        return QUrl();
+    }
+    const QUrl target = reply->url().resolved(reply->attribute(QNetworkRequest::RedirectionTargetAttribute).toUrl());
+    // 与 NoLessSafeRedirectPolicy 相同，不允许从 https 降级
+    if (!target.isValid() || (reply->url().scheme() == "https" && target.scheme() != "https")) {
+        return QUrl();
+    }
+    return target;
 }
 
-void GitLabApi::sendPostRequest(const QString& endpoint, const QJsonObject& data, const QString& callbackId) {
+QFuture<BuildArtifact> GitLabApi::getJobArtifacts(int jobId) {
+    // /jobs/:id/artifacts 返回的是压缩包本身，产物清单在Job详情的 artifacts 字段中
+    QString encodedProjectId = QString(m_projectId).replace("/", "%2F");
+    QString endpoint = "/api/v4/projects/" + encodedProjectId + "/jobs/" + QString::number(jobId);
+    const QString downloadUrl = buildApiUrl(endpoint + "/artifacts");
+    return requestList<BuildArtifact>("getJobArtifacts", endpoint, [downloadUrl](const QJsonDocument& doc) {
+        QList<BuildArtifact> artifacts;
+        for (const QJsonValue& val : doc.object()["artifacts"].toArray()) {
+            // trace 是Job日志本身，不算产物
+            if (val.toObject()["file_type"].toString() == "trace") {
+                continue;
+            }
+            BuildArtifact artifact = BuildArtifact::fromJson(val.toObject());
+            // 只有 archive（artifacts:paths 打成的压缩包）能通过 /artifacts 下载，报告类产物没有下载地址
+            if (artifact.fileType == "archive") {
+                artifact.downloadUrl = downloadUrl;
+            }
+            artifacts.append(artifact);
+        }
+        return artifacts;
+    });
+}
+
+// ========== HTTP请求方法 ==========
+
+QNetworkReply* GitLabApi::sendRequest(HttpMethod method, const QString& endpointName, const QString& endpoint,
+                                      const QJsonObject& data, SuccessHandler onSuccess, ErrorHandler onError) {
     QNetworkRequest request = createRequest(endpoint);
-    QNetworkReply* reply = m_networkManager->post(request, QJsonDocument(data).toJson());
-    reply->setProperty("callbackId", callbackId);
     
-    // 如果是创建MR的请求，设置标记
-    if (callbackId == "createMergeRequest") {
-        reply->setProperty("isCreate", true);
+    PendingReply pending;
+    pending.endpointName = endpointName;
+    pending.onSuccess = std::move(onSuccess);
+    pending.onError = std::move(onError);
+    pending.started.start();
+    if (TraceRecorder::instance().isEnabled()) {
+        pending.traceId = TraceRecorder::instance().nextId();
+        TraceRecorder::instance().asyncBegin("api", endpointName, pending.traceId, {{"endpoint", endpoint}});
     }
+    
+    QNetworkReply* reply = nullptr;
+    if (method == HttpMethod::Post) {
+        reply = m_networkManager->post(request, QJsonDocument(data).toJson());
+    } else if (method == HttpMethod::Put) {
+        reply = m_networkManager->put(request, QJsonDocument(data).toJson());
+    } else {
+        const qint64 ttlMs = cacheTtlMs(endpointName);
+        if (ttlMs >= 0) {
+            const QByteArray cacheKey = ApiResponseCache::makeKey(request.url(), m_apiToken.toUtf8());
+            if (const ApiResponseCache::Entry* cached = m_responseCache.lookupFresh(cacheKey)) {
+                LOG_INFO("API缓存命中", {{"endpoint", endpointName},
+                                         {"hit_rate", QString::number(m_responseCache.stats().hitRate() * 100, 'f', 1)}});
+                // 异步回调，保持与网络响应一致的调用时序
+                QTimer::singleShot(0, this, [handler = pending.onSuccess, doc = cached->document, headers = cached->headers]() {
+                    handler(doc, QByteArray(), headers);
+                });
+                return nullptr;
+            }
+            
+            const QByteArray etag = m_responseCache.etag(cacheKey);
+            if (!etag.isEmpty()) {
+                request.setRawHeader("If-None-Match", etag);
+            }
+            pending.cacheKey = cacheKey;
+            pending.cacheTtl = ttlMs;
+        }
+        reply = m_networkManager->get(request);
+    }
+    
+    m_pendingReplies.insert(reply, std::move(pending));
+    return reply;
 }
 
-void GitLabApi::sendPutRequest(const QString& endpoint, const QJsonObject& data, const QString& callbackId) {
-    QNetworkRequest request = createRequest(endpoint);
-    QNetworkReply* reply = m_networkManager->put(request, QJsonDocument(data).toJson());
-    reply->setProperty("callbackId", callbackId);
+void GitLabApi::abortOnCancel(QNetworkReply* reply, const QFuture<void>& future) {
+    if (!reply) {
+        return;
+    }
+    // 监视器随 reply 一起销毁
+    auto* watcher = new QFutureWatcher<void>(reply);
+    connect(watcher, &QFutureWatcher<void>::canceled, reply, &QNetworkReply::abort);
+    watcher->setFuture(future);
 }
 
 QNetworkRequest GitLabApi::createRequest(const QString& endpoint) {
@@ -313,25 +575,179 @@ QString GitLabApi::buildApiUrl(const QString& endpoint) {
     return m_baseUrl + endpoint;
 }
 
+// ========== 分页拉取 ==========
+
+void GitLabApi::startPagedRequest(PagedRequest request) {
+    const int requestId = m_nextPagedRequestId++;
+    const QString firstPage = request.endpoint + "&page=1";
+    m_pagedRequests.insert(requestId, std::move(request));
+    requestPage(requestId, 1, firstPage);
+}
+
+void GitLabApi::requestPage(int requestId, int page, const QString& endpoint) {
+    PagedRequest& request = m_pagedRequests[requestId];
+    ++request.inFlight;
+    
+    QNetworkReply* reply = sendRequest(HttpMethod::Get, request.endpointName, endpoint, QJsonObject(),
+        [this, requestId, page](const QJsonDocument& doc, const QByteArray&, const ResponseHeaders& pageHeaders) {
+            handlePageResponse(requestId, page, doc, pageHeaders);
+        },
+        [this, requestId](const ApiError& error) {
+            auto it = m_pagedRequests.find(requestId);
+            if (it == m_pagedRequests.end()) {
+                return;
+            }
+            const ErrorHandler onError = it->onError;
+            m_pagedRequests.erase(it);
+            onError(error);
+        });
+    abortOnCancel(reply, request.future);
+}
+
+void GitLabApi::handlePageResponse(int requestId, int page, const QJsonDocument& doc,
+                                   const ResponseHeaders& pageHeaders) {
+    auto it = m_pagedRequests.find(requestId);
+    if (it == m_pagedRequests.end()) {
+        return;  // 已完成（达到条目上限）或已失败
+    }
+    if (it->future.isCanceled()) {
+        LOG_INFO(QString("分页拉取已取消: %1").arg(it->endpointName));
+        m_pagedRequests.erase(it);
+        return;
+    }
+    PagedRequest& request = it.value();
+    --request.inFlight;
+    
+    if (page == 1) {
+        // 已知总页数时其余页可以并发请求（有条目上限时只需要有限的页）
+        const int reportedPages = pageHeaders.value("X-Total-Pages").toInt();
+        int totalPages = reportedPages;
+        if (totalPages > 0 && request.maxItems > 0) {
+            totalPages = qMin(totalPages, (request.maxItems + request.perPage - 1) / request.perPage);
+        }
+        request.truncated = totalPages > MAX_PAGES;
+        request.lastPage = qMin(totalPages, MAX_PAGES);
+    }
+    if (request.lastPage == 0) {
+        request.nextEndpoint = nextPageEndpoint(request, pageHeaders);
+        if (page >= MAX_PAGES && !request.nextEndpoint.isEmpty()) {
+            request.truncated = true;
+            request.nextEndpoint.clear();
+        }
+    }
+    request.buffered.insert(page, doc.array());
+    
+    // 按页序交付
+    while (request.buffered.contains(request.nextPageToDeliver)) {
+        const int deliveredPage = request.nextPageToDeliver++;
+        QJsonArray items = request.buffered.take(deliveredPage);
+        if (request.maxItems > 0) {
+            while (request.deliveredItems + items.size() > request.maxItems) {
+                items.removeLast();
+            }
+        }
+        request.deliveredItems += items.size();
+        
+        const bool isLastPage = items.isEmpty()
+            || (request.maxItems > 0 && request.deliveredItems >= request.maxItems)
+            || (request.lastPage > 0 ? deliveredPage >= request.lastPage : request.nextEndpoint.isEmpty());
+        
+        // 条目上限恰好在最后一页达到时不算截断
+        const bool truncated = isLastPage && request.truncated && !items.isEmpty()
+            && !(request.maxItems > 0 && request.deliveredItems >= request.maxItems);
+        request.onPage(items, deliveredPage, isLastPage, truncated);
+        
+        if (isLastPage) {
+            if (truncated) {
+                LOG_WARNING("分页拉取达到页数上限，列表不完整", {{"endpoint", request.endpointName},
+                                                               {"pages", deliveredPage}, {"items", request.deliveredItems}});
+            }
+            LOG_INFO("分页拉取完成", {{"endpoint", request.endpointName}, {"pages", deliveredPage},
+                                    {"items", request.deliveredItems}});
+            m_pagedRequests.erase(it);
+            return;
+        }
+    }
+    
+    // 继续请求后续页
+    if (request.lastPage > 0) {
+        while (request.inFlight < kMaxConcurrentPages && request.nextPageToRequest <= request.lastPage) {
+            const int nextPage = request.nextPageToRequest++;
+            requestPage(requestId, nextPage, request.endpoint + "&page=" + QString::number(nextPage));
+        }
+    } else if (request.inFlight == 0 && !request.nextEndpoint.isEmpty()) {
+        const QString nextEndpoint = request.nextEndpoint;
+        request.nextEndpoint.clear();
+        requestPage(requestId, request.nextPageToRequest++, nextEndpoint);
+    }
+}
+
+QString GitLabApi::nextPageEndpoint(const PagedRequest& request, const ResponseHeaders& pageHeaders) const {
+    const int nextPage = pageHeaders.value("X-Next-Page").toInt();
+    if (nextPage > 0) {
+        return request.endpoint + "&page=" + QString::number(nextPage);
+    }
+    
+    // Link: <https://gitlab.example.com/api/v4/projects?id_after=42&per_page=100>; rel="next", <...>; rel="first"
+    const QString link = QString::fromUtf8(pageHeaders.value("Link"));
+    for (const QString& part : link.split(',')) {
+        if (!part.contains("rel=\"next\"")) {
+            continue;
+        }
+        const int start = part.indexOf('<');
+        const int end = part.indexOf('>', start);
+        if (start < 0 || end < 0) {
+            continue;
+        }
+        const QString url = part.mid(start + 1, end - start - 1);
+        if (url.startsWith(m_baseUrl)) {
+            return url.mid(m_baseUrl.length());
+        }
+        LOG_WARNING(QString("分页链接不在当前GitLab地址下，停止翻页: %1").arg(url));
+    }
+    return QString();
+}
+
 // ========== 响应处理 ==========
 
 void GitLabApi::onReplyFinished(QNetworkReply* reply) {
-    QString callbackId = reply->property("callbackId").toString();
+    reply->deleteLater();
+    
+    auto it = m_pendingReplies.find(reply);
+    if (it == m_pendingReplies.end()) {
+        return;
+    }
+    const PendingReply pending = it.value();
+    m_pendingReplies.erase(it);
+    
+    const QString& endpointName = pending.endpointName;
     int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
     
-    LOG_INFO(QString("API响应: %1, HTTP %2").arg(callbackId).arg(statusCode));
+    LOG_INFO("API响应", {{"endpoint", endpointName}, {"status", statusCode}});
+    
+    TraceRecorder::instance().asyncEnd("api", endpointName, pending.traceId, {{"status", statusCode}});
+    
+    if (reply->error() == QNetworkReply::OperationCanceledError) {
+        // 调用方取消了 future，结果不会再被读取
+        LOG_INFO(QString("API请求已取消: %1").arg(endpointName));
+        pending.onError(ApiError(endpointName, QString::fromUtf8("请求已取消")));
+        return;
+    }
     
     // 关键修复：即使有网络错误，如果HTTP状态码有效（200-599），也应该处理响应
     // 因为像409这样的HTTP错误码是有效的业务逻辑错误，不是网络故障
     bool hasValidHttpStatus = (statusCode >= 200 && statusCode < 600);
     
+    const bool failed = (reply->error() != QNetworkReply::NoError && !hasValidHttpStatus) || statusCode >= 400;
+    MetricsRegistry::instance().record(QString("api %1").arg(endpointName), pending.started.nsecsElapsed() / 1000, !failed);
+    
     if (reply->error() != QNetworkReply::NoError && !hasValidHttpStatus) {
         // 真正的网络错误（连接失败、超时等）
         QString errorMsg = reply->errorString();
         QString detailedError = QString("API Error [%1]: %2\nHTTP Status: %3")
-            .arg(callbackId)
+            .arg(endpointName)
             .arg(errorMsg)
-            .arg(reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt());
+            .arg(statusCode);
         
         LOG_ERROR(detailedError);
         
@@ -342,22 +758,36 @@ void GitLabApi::onReplyFinished(QNetworkReply* reply) {
             if (!doc.isNull() && doc.isObject()) {
                 QJsonObject obj = doc.object();
                 if (obj.contains("message")) {
-                    detailedError += "\nGitLab Message: " + obj["message"].toString();
+                    errorMsg += "\nGitLab Message: " + obj["message"].toString();
                 }
             }
         }
         
-        emit apiError(callbackId, detailedError);
-        emit networkError(errorMsg);
-        reply->deleteLater();
+        pending.onError(ApiError(endpointName, errorMsg, statusCode, true));
+        return;
+    }
+    
+    // 304: 内容未变化，复用缓存
+    if (statusCode == 304 && !pending.cacheKey.isEmpty()) {
+        if (const ApiResponseCache::Entry* cached = m_responseCache.revalidate(pending.cacheKey)) {
+            LOG_INFO("API缓存重新验证", {{"endpoint", endpointName},
+                                       {"hit_rate", QString::number(m_responseCache.stats().hitRate() * 100, 'f', 1)}});
+            // 回调可能触发下一页请求并改动缓存，先复制出内容
+            const QJsonDocument doc = cached->document;
+            const ResponseHeaders headers = cached->headers;
+            pending.onSuccess(doc, QByteArray(), headers);
+        } else {
+            // 请求发出后缓存已被清理
+            pending.onError(ApiError(endpointName, QString::fromUtf8("缓存已失效，请重试"), statusCode));
+        }
         return;
     }
     
     QByteArray responseData = reply->readAll();
-    QJsonDocument doc = QJsonDocument::fromJson(responseData);
     
     // 检查业务逻辑错误（HTTP 4xx/5xx）
     if (statusCode >= 400) {
+        QJsonDocument doc = QJsonDocument::fromJson(responseData);
         QString errorMsg = QString("HTTP %1").arg(statusCode);
         QString detailedError;
         
@@ -384,206 +814,27 @@ void GitLabApi::onReplyFinished(QNetworkReply* reply) {
             detailedError = QString("%1: %2").arg(errorMsg, detailedError);
         }
         
-        LOG_ERROR(QString("API业务错误 [%1]: %2").arg(callbackId, detailedError));
-        emit apiError(callbackId, detailedError);
-        reply->deleteLater();
+        // 429/503 时 GitLab 用 Retry-After 给出等待秒数（HTTP日期格式按未提供处理）
+        const int retryAfterSeconds = reply->rawHeader("Retry-After").trimmed().toInt();
+        
+        LOG_ERROR("API业务错误", {{"endpoint", endpointName}, {"status", statusCode}, {"error", detailedError},
+                                 {"retryAfter", retryAfterSeconds}});
+        pending.onError(ApiError(endpointName, detailedError, statusCode, false, retryAfterSeconds));
         return;
     }
     
-    if (!doc.isNull()) {
-        
-        // 根据callbackId分发处理
-        if (callbackId == "getCurrentUser") {
-            handleUserInfoResponse(doc.object());
-        }
-        else if (callbackId == "getProjects") {
-            handleProjectsResponse(doc.array());
-        }
-        else if (callbackId == "getProject") {
-            handleProjectResponse(doc.object());
-        }
-        else if (callbackId == "listProjectMembers") {
-            handleProjectMembersResponse(doc.array());
+    const ResponseHeaders headers = pageHeadersOf(reply);
+    const QByteArray etag = reply->rawHeader("ETag");
+    
+    // 在解析线程中解码，完成后回到UI线程写入缓存并交付
+    QtConcurrent::run(m_parseExecutor, [responseData]() {
+        TRACE_SCOPE("api", "GitLabApi::decodeJson");
+        return QJsonDocument::fromJson(responseData);
+    }).then(this, [this, pending, responseData, headers, etag](const QJsonDocument& doc) {
+        if (!pending.cacheKey.isEmpty() && !doc.isNull()) {
+            m_responseCache.recordMiss();
+            m_responseCache.store(pending.cacheKey, doc, etag, pending.cacheTtl, headers);
         }
-        else if (callbackId == "createMergeRequest") {
-            // 提取isCreate属性并传递给handler
-            bool isCreate = reply->property("isCreate").toBool();
-            handleMergeRequestResponse(doc.object(), isCreate);
-        }
-        else if (callbackId == "getMergeRequest") {
-            handleMergeRequestResponse(doc.object(), false);  // 查询操作，不是创建
-        }
-        else if (callbackId == "listMergeRequests") {
-            handleMergeRequestsResponse(doc.array());
-        }
-        else if (callbackId.startsWith("approveMergeRequest:")) {
-            handleMergeRequestResponse(doc.object(), false);
-            emit mergeRequestApproved(parseMergeRequest(doc.object()));
-        }
-        else if (callbackId.startsWith("mergeMergeRequest:")) {
-            handleMergeRequestResponse(doc.object(), false);
-            emit mergeRequestMerged(parseMergeRequest(doc.object()));
-        }
-        else if (callbackId.startsWith("closeMergeRequest:")) {
-            handleMergeRequestResponse(doc.object(), false);
-            emit mergeRequestClosed(parseMergeRequest(doc.object()));
-        }
-        else if (callbackId == "triggerPipeline" || callbackId == "getPipelineStatus") {
-            handlePipelineResponse(doc.object(), (callbackId == "triggerPipeline"));
-        }
-        else if (callbackId == "listPipelines") {
-            handlePipelinesResponse(doc.array());
-        }
-        else if (callbackId.startsWith("retryPipeline:")) {
-            handlePipelineResponse(doc.object(), false);
-            emit pipelineRetried(parsePipeline(doc.object()));
-        }
-        else if (callbackId.startsWith("cancelPipeline:")) {
-            handlePipelineResponse(doc.object(), false);
-            emit pipelineCanceled(parsePipeline(doc.object()));
-        }
-        else if (callbackId.startsWith("getJobLog:")) {
-            int jobId = callbackId.split(':')[1].toInt();
-            handleJobLogResponse(jobId, QString::fromUtf8(responseData));
-        }
-    }
-    
-    reply->deleteLater();
-}
-
-void GitLabApi::handleUserInfoResponse(const QJsonObject& json) {
-    UserInfo user = parseUserInfo(json);
-    emit userInfoReceived(user);
-}
-
-void GitLabApi::handleProjectsResponse(const QJsonArray& jsonArray) {
-    QList<ProjectInfo> projects;
-    for (const QJsonValue& val : jsonArray) {
-        projects.append(parseProjectInfo(val.toObject()));
-    }
-    emit projectsReceived(projects);
-}
-
-void GitLabApi::handleProjectResponse(const QJsonObject& json) {
-    ProjectInfo project = parseProjectInfo(json);
-    emit projectReceived(project);
-}
-
-void GitLabApi::handleProjectMembersResponse(const QJsonArray& jsonArray) {
-    QList<ProjectMember> members;
-    for (const QJsonValue& val : jsonArray) {
-        members.append(parseProjectMember(val.toObject()));
-    }
-    
-    // Update cache
-    m_cachedMembers = members;
-    m_lastMembersFetchTime = QDateTime::currentDateTime();
-    
-    emit projectMembersReceived(members);
-}
-
-void GitLabApi::handleMergeRequestResponse(const QJsonObject& json, bool isCreate) {
-    MrResponse mr = parseMergeRequest(json);
-    
-    LOG_INFO(QString("handleMergeRequestResponse: isCreate=%1, iid=%2").arg(isCreate).arg(mr.iid));
-    
-    if (isCreate) {
-        LOG_INFO("Emitting mergeRequestCreated signal");
-        emit mergeRequestCreated(mr);
-    } else {
-        LOG_INFO("Emitting mergeRequestReceived signal");
-        emit mergeRequestReceived(mr);
-    }
-}
-
-void GitLabApi::handleMergeRequestsResponse(const QJsonArray& jsonArray) {
-    QList<MrResponse> mrs;
-    for (const QJsonValue& val : jsonArray) {
-        mrs.append(parseMergeRequest(val.toObject()));
-    }
-    emit mergeRequestsReceived(mrs);
-}
-
-void GitLabApi::handlePipelineResponse(const QJsonObject& json, bool isTrigger) {
-    PipelineStatus pipeline = parsePipeline(json);
-    
-    if (isTrigger) {
-        emit pipelineTriggered(pipeline);
-    } else {
-        emit pipelineStatusReceived(pipeline);
-    }
-}
-
-void GitLabApi::handlePipelinesResponse(const QJsonArray& jsonArray) {
-    QList<PipelineStatus> pipelines;
-    for (const QJsonValue& val : jsonArray) {
-        pipelines.append(parsePipeline(val.toObject()));
-    }
-    emit pipelinesReceived(pipelines);
-}
-
-void GitLabApi::handleJobLogResponse(int jobId, const QString& log) {
-    emit jobLogReceived(jobId, log);
-}
-
-// ========== 数据解析 ==========
-
-UserInfo GitLabApi::parseUserInfo(const QJsonObject& json) {
-    UserInfo user;
-    user.id = json["id"].toInt();
-    user.username = json["username"].toString();
-    user.name = json["name"].toString();
-    user.email = json["email"].toString();
-    return user;
-}
-
-ProjectInfo GitLabApi::parseProjectInfo(const QJsonObject& json) {
-    ProjectInfo project;
-    project.id = json["id"].toInt();
-    project.name = json["name"].toString();
-    project.pathWithNamespace = json["path_with_namespace"].toString();
-    project.description = json["description"].toString();
-    project.webUrl = json["web_url"].toString();
-    return project;
-}
-
-ProjectMember GitLabApi::parseProjectMember(const QJsonObject& json) {
-    ProjectMember member;
-    member.id = json["id"].toInt();
-    member.username = json["username"].toString();
-    member.name = json["name"].toString();
-    return member;
-}
-
-MrResponse GitLabApi::parseMergeRequest(const QJsonObject& json) {
-    MrResponse mr;
-    mr.id = json["id"].toInt();
-    mr.iid = json["iid"].toInt();
-    mr.title = json["title"].toString();
-    mr.webUrl = json["web_url"].toString();
-    mr.state = json["state"].toString();
-    mr.createdAt = json["created_at"].toString();
-    mr.description = json["description"].toString();
-    
-    if (json.contains("author") && json["author"].isObject()) {
-        QJsonObject author = json["author"].toObject();
-        mr.authorName = author["name"].toString();
-    }
-    return mr;
-}
-
-PipelineStatus GitLabApi::parsePipeline(const QJsonObject& json) {
-    PipelineStatus pipeline;
-    pipeline.id = json["id"].toInt();
-    pipeline.status = json["status"].toString();
-    pipeline.ref = json["ref"].toString();
-    pipeline.webUrl = json["web_url"].toString();
-    
-    QString createdAt = json["created_at"].toString();
-    pipeline.createdAt = QDateTime::fromString(createdAt, Qt::ISODate);
-    
-    QString updatedAt = json["updated_at"].toString();
-    pipeline.updatedAt = QDateTime::fromString(updatedAt, Qt::ISODate);
-    
-    return pipeline;
+        pending.onSuccess(doc, responseData, headers);
+    });
 }
@@ -2,14 +2,72 @@
 #define GITLABAPI_H
 
 #include <QObject>
+#include <QElapsedTimer>
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
-#include <QDateTime> // For caching timestamps
+#include <QHash>
+#include <QMap>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QFuture>
+#include <QException>
+#include <functional>
 #include "ApiModels.h"
+#include "ApiResponseCache.h"
+
+class QThreadPool;
+
+/**
+ * @brief GitLab API调用失败
+ * 通过 future.onFailed(context, [](const ApiError& error) {...}) 接收
+ */
+class ApiError : public QException {
+public:
+    ApiError(const QString& endpoint, const QString& message, int httpStatus = 0, bool networkError = false,
+             int retryAfterSeconds = 0)
+        : m_endpoint(endpoint), m_message(message), m_httpStatus(httpStatus), m_networkError(networkError)
+        , m_retryAfterSeconds(retryAfterSeconds) {}
+    
+    void raise() const override { throw *this; }
+    ApiError* clone() const override { return new ApiError(*this); }
+    
+    QString endpoint() const { return m_endpoint; }    // 接口名，如 "createMergeRequest"
+    QString message() const { return m_message; }
+    int httpStatus() const { return m_httpStatus; }     // 未收到HTTP响应时为 0
+    bool isNetworkError() const { return m_networkError; }
+    bool isRateLimited() const { return m_httpStatus == 429; }
+    int retryAfterSeconds() const { return m_retryAfterSeconds; }  // 响应的 Retry-After（秒），没有时为 0
+    
+private:
+    QString m_endpoint;
+    QString m_message;
+    int m_httpStatus;
+    bool m_networkError;
+    int m_retryAfterSeconds;
+};
+
+/**
+ * @brief 分页列表请求的结果
+ * items 每个结果对应一个条目，随分页到达依次加入；对 items 调用 cancel() 会中止拉取。
+ * truncated 在 items 完成之前给出结果：因 GitLabApi::MAX_PAGES 上限未取全时为 true。
+ * 拉取失败时两者带有同一个 ApiError；拉取被取消时 truncated 也被取消。
+ */
+template <typename T>
+struct PagedList {
+    QFuture<T> items;
+    QFuture<bool> truncated;
+};
 
 /**
  * @brief GitLab API客户端
- * 使用Qt Network模块实现RESTful API调用
+ * 使用Qt Network模块实现RESTful API调用。
+ *
+ * 每次调用返回只属于本次请求的 QFuture，调用方用 then(context, ...) / onFailed(context, ...)
+ * 在UI线程处理结果，不会收到其他视图发起的请求的响应。对 future 调用 cancel() 会中止网络请求。
+ * 列表接口的 future 每个结果对应一个条目，随分页到达依次加入：
+ * 可以用 QFutureWatcher::resultsReadyAt 逐页显示，也可以等 then() 后用 results() 取全部。
+ * 分页列表返回 PagedList，最多拉取 MAX_PAGES 页，超出时记录警告并通过 PagedList::truncated 报告。
+ * JSON解码与模型构建在内部线程池中完成，UI线程只负责收发请求。
  */
 class GitLabApi : public QObject {
     Q_OBJECT
@@ -23,93 +81,131 @@ public:
     void setApiToken(const QString& token);
     void setProjectId(const QString& projectId);
     
+    static constexpr int MAX_PAGES = 100;  // 防止异常响应导致无限翻页
+    
     // 用户API
-    void getCurrentUser(); // 获取当前用户信息（用于测试连接）
+    QFuture<UserInfo> getCurrentUser(); // 获取当前用户信息（用于测试连接）
     
     // 项目API
-    void getProjects();    // 获取用户有权限的项目列表
-    void getProject(const QString& projectId);
-    void listProjectMembers();  // 获取项目成员列表
+    PagedList<ProjectInfo> getProjects();    // 获取用户有权限的项目列表（自动翻页取全）
+    QFuture<ProjectInfo> getProject(const QString& projectId);
+    QFuture<ProjectMember> listProjectMembers();  // 获取项目成员列表
     
     // MR API
-    void createMergeRequest(const MrParams& params);
-    void getMergeRequest(int mrIid);
-    void listMergeRequests(int page = 1, int perPage = 20, const QString& state = QString(), const QString& targetBranch = QString());
-    void approveMergeRequest(int mrIid);
-    void mergeMergeRequest(int mrIid, bool shouldRemoveSourceBranch = true);
-    void closeMergeRequest(int mrIid);
+    QFuture<MrResponse> createMergeRequest(const MrParams& params);
+    QFuture<MrResponse> getMergeRequest(int mrIid);
+    // 自动翻页；maxItems 为 0 时取全部
+    PagedList<MrResponse> listMergeRequests(const QString& state = QString(), const QString& targetBranch = QString(), int maxItems = 0);
+    QFuture<MrResponse> approveMergeRequest(int mrIid);
+    QFuture<MrResponse> mergeMergeRequest(int mrIid, bool shouldRemoveSourceBranch = true);
+    QFuture<MrResponse> closeMergeRequest(int mrIid);
     
     // Pipeline API
-    void triggerPipeline(const QString& ref);
-    void getPipelineStatus(int pipelineId);
-    void listPipelines(const QString& ref = QString());
-    void retryPipeline(int pipelineId);
-    void cancelPipeline(int pipelineId);
+    QFuture<PipelineStatus> triggerPipeline(const QString& ref);
+    QFuture<PipelineStatus> getPipelineStatus(int pipelineId);
+    PagedList<PipelineStatus> listPipelines(const QString& ref = QString(), int maxItems = 11);  // 默认只取最近的11条
+    QFuture<PipelineStatus> retryPipeline(int pipelineId);
+    QFuture<PipelineStatus> cancelPipeline(int pipelineId);
     
     // Job API
-    void getJobLog(int jobId);
-    void getJobArtifacts(int jobId);
-    
-signals:
-    // 成功信号
-    void userInfoReceived(const UserInfo& user);
-    void projectsReceived(const QList<ProjectInfo>& projects);
-    void projectReceived(const ProjectInfo& project);
-    void projectMembersReceived(const QList<ProjectMember>& members);  // 项目成员列表
-    void mergeRequestCreated(const MrResponse& mr);
-    void mergeRequestReceived(const MrResponse& mr);
-    void mergeRequestsReceived(const QList<MrResponse>& mrs);
-    void mergeRequestApproved(const MrResponse& mr);
-    void mergeRequestMerged(const MrResponse& mr);
-    void mergeRequestClosed(const MrResponse& mr);
-    void pipelineTriggered(const PipelineStatus& pipeline);
-    void pipelineStatusReceived(const PipelineStatus& status);
-    void pipelinesReceived(const QList<PipelineStatus>& pipelines);
-    void pipelineRetried(const PipelineStatus& pipeline);
-    void pipelineCanceled(const PipelineStatus& pipeline);
-    void jobLogReceived(int jobId, const QString& log);
-    void jobArtifactsReceived(int jobId, const QList<BuildArtifact>& artifacts);
-    
-    // 错误信号
-    void apiError(const QString& endpoint, const QString& errorMessage);
-    void networkError(const QString& errorMessage);
+    PagedList<PipelineJob> listPipelineJobs(int pipelineId);
+    QFuture<PipelineJob> getJob(int jobId);
+    QFuture<QString> getJobLog(int jobId);  // 一次取回完整日志，大日志用 openJobTrace + JobLogTailer
+    // 从 offset 字节起流式读取Job日志（Range请求），调用方在 readyRead 中逐段读取；
+    // reply 在 finished 后自动释放。项目ID未设置时返回 nullptr
+    QNetworkReply* openJobTrace(int jobId, qint64 offset);
+    // 流式下载 url（如产物的 downloadUrl），offset > 0 时从该字节续传；
+    // 只对本实例 GitLab 地址下的 url 附带令牌。reply 在 finished 后自动释放。
+    // 不自动跟随重定向（Qt 跟随时沿用原请求头，令牌会发往对象存储等其他主机），
+    // 调用方在 finished 时用 redirectTarget() 取得目标地址，再以其重新 openDownload
+    QNetworkReply* openDownload(const QString& url, qint64 offset);
+    // reply 为重定向时返回解析后的目标地址；不是重定向或从 https 降级到 http 时返回空 QUrl
+    static QUrl redirectTarget(QNetworkReply* reply);
+    static constexpr int MAX_DOWNLOAD_REDIRECTS = 5;
+    QFuture<BuildArtifact> getJobArtifacts(int jobId);
+    
+    // 响应缓存统计（命中率）与清理
+    ApiResponseCache::Stats cacheStats() const { return m_responseCache.stats(); }
+    void clearCache();
     
 private slots:
     void onReplyFinished(QNetworkReply* reply);
     
 private:
+    using ResponseHeaders = QHash<QByteArray, QByteArray>;
+    using SuccessHandler = std::function<void(const QJsonDocument& doc, const QByteArray& body,
+                                              const ResponseHeaders& pageHeaders)>;
+    using ErrorHandler = std::function<void(const ApiError& error)>;
+    
+    enum class HttpMethod { Get, Post, Put };
+    
     QNetworkAccessManager* m_networkManager;
     QString m_baseUrl;      // 如: https://gitlab.example.com
     QString m_apiToken;
     QString m_projectId;
     
-    
-    // HTTP请求方法
-    void sendGetRequest(const QString& endpoint, const QString& callbackId);
-    void sendPostRequest(const QString& endpoint, const QJsonObject& data, const QString& callbackId);
-    void sendPutRequest(const QString& endpoint, const QJsonObject& data, const QString& callbackId);
-    
-    // 缓存数据
-    QList<ProjectMember> m_cachedMembers;
-    QDateTime m_lastMembersFetchTime;
-    
-    // 响应处理
-    void handleUserInfoResponse(const QJsonObject& json);
-    void handleProjectsResponse(const QJsonArray& jsonArray);
-    void handleProjectResponse(const QJsonObject& json);
-    void handleProjectMembersResponse(const QJsonArray& jsonArray);  // 处理成员响应
-    void handleMergeRequestResponse(const QJsonObject& json, bool isCreate);
-    void handleMergeRequestsResponse(const QJsonArray& jsonArray);
-    void handlePipelineResponse(const QJsonObject& json, bool isTrigger);
-    void handlePipelinesResponse(const QJsonArray& jsonArray);
-    void handleJobLogResponse(int jobId, const QString& log);
-    
-    // 数据解析
-    UserInfo parseUserInfo(const QJsonObject& json);
-    ProjectInfo parseProjectInfo(const QJsonObject& json);
-    ProjectMember parseProjectMember(const QJsonObject& json);  // 解析成员
-    MrResponse parseMergeRequest(const QJsonObject& json);
-    PipelineStatus parsePipeline(const QJsonObject& json);
+    // JSON解码与模型构建（项目列表、含长描述的MR列表可达数MB）
+    QThreadPool* m_parseExecutor;
+    static constexpr int MAX_PARSE_THREADS = 2;
+    
+    // 已发出、等待响应的请求，按 reply 直接查找处理函数
+    struct PendingReply {
+        QString endpointName;
+        QByteArray cacheKey;
+        qint64 cacheTtl = -1;
+        QElapsedTimer started;  // 请求耗时，记入性能指标
+        quint64 traceId = 0;    // 时间线中的异步区间（未记录时为0）
+        SuccessHandler onSuccess;
+        ErrorHandler onError;
+    };
+    QHash<QNetworkReply*, PendingReply> m_pendingReplies;
+    
+    // 发送请求；GET命中缓存时异步回调 onSuccess 并返回 nullptr
+    QNetworkReply* sendRequest(HttpMethod method, const QString& endpointName, const QString& endpoint,
+                               const QJsonObject& data, SuccessHandler onSuccess, ErrorHandler onError);
+    void abortOnCancel(QNetworkReply* reply, const QFuture<void>& future);
+    
+    // 单个结果的请求；parse 在解析线程中执行，不能访问本对象
+    template <typename T>
+    QFuture<T> request(HttpMethod method, const QString& endpointName, const QString& endpoint,
+                       const QJsonObject& data, std::function<T(const QJsonDocument&, const QByteArray&)> parse);
+    // 不分页的列表请求，每个条目一个结果
+    template <typename T>
+    QFuture<T> requestList(const QString& endpointName, const QString& endpoint,
+                           std::function<QList<T>(const QJsonDocument&)> parse);
+    // 分页列表请求，每个条目一个结果（由 T::fromJson 构建）
+    template <typename T>
+    PagedList<T> requestPaged(const QString& endpointName, const QString& endpoint, int perPage, int maxItems);
+    
+    // GET响应缓存（ETag重新验证 + 按接口的TTL）
+    ApiResponseCache m_responseCache;
+    
+    // 分页拉取：每页按序交付给 onPage。
+    // 首页带 X-Total-Pages 时其余页并发请求；否则沿 X-Next-Page / Link 逐页跟随。
+    struct PagedRequest {
+        QString endpointName;            // 如 "listMergeRequests"
+        QString endpoint;                // 已包含 per_page，不含 page
+        int perPage = 0;
+        int maxItems = 0;                // 0 表示不限
+        int lastPage = 0;                // 已知需要请求的最后一页，0 表示未知
+        int nextPageToRequest = 2;
+        int nextPageToDeliver = 1;
+        int inFlight = 0;
+        int deliveredItems = 0;
+        QString nextEndpoint;            // 总页数未知时下一页的地址
+        QMap<int, QJsonArray> buffered;  // 先到达、等待按序交付的页
+        bool truncated = false;          // 达到 MAX_PAGES 时仍有后续页
+        std::function<void(const QJsonArray& items, int page, bool isLastPage, bool truncated)> onPage;
+        ErrorHandler onError;
+        QFuture<void> future;            // 调用方取消后不再请求后续页
+    };
+    QHash<int, PagedRequest> m_pagedRequests;
+    int m_nextPagedRequestId = 1;
+    
+    void startPagedRequest(PagedRequest request);
+    void requestPage(int requestId, int page, const QString& endpoint);
+    void handlePageResponse(int requestId, int page, const QJsonDocument& doc, const ResponseHeaders& pageHeaders);
+    QString nextPageEndpoint(const PagedRequest& request, const ResponseHeaders& pageHeaders) const;
     
     // 辅助方法
     QNetworkRequest createRequest(const QString& endpoint);
@@ -0,0 +1,379 @@
+#include "ArtifactDownloader.h"
+#include "api/GitLabApi.h"
+#include "utils/Logger.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QTimer>
+
+namespace {
+
+// "bytes 100-199/200" 或 "bytes */200"；起点为 * 时 start 为 -1，总大小为 * 时 total 为 0
+bool parseContentRange(const QByteArray& value, qint64& start, qint64& total) {
+    if (!value.startsWith("bytes ")) {
+        return false;
+    }
+    const qsizetype slash = value.indexOf('/');
+    if (slash < 0) {
+        return false;
+    }
+    const QByteArray range = value.mid(6, slash - 6).trimmed();
+    const QByteArray size = value.mid(slash + 1).trimmed();
+    start = range == "*" ? -1 : range.left(range.indexOf('-')).toLongLong();
+    total = size == "*" ? 0 : size.toLongLong();
+    return true;
+}
+
+// 网络中断、超时、限流与服务端错误可以重试；4xx（如令牌无效、产物已过期）重试也不会成功
+bool isRetryable(QNetworkReply::NetworkError error, int httpStatus) {
+    if (httpStatus == 408 || httpStatus == 429 || httpStatus >= 500) {
+        return true;
+    }
+    return httpStatus == 0 && error != QNetworkReply::ContentNotFoundError
+           && error != QNetworkReply::AuthenticationRequiredError;
+}
+
+}
+
+ArtifactDownloader::ArtifactDownloader(GitLabApi* gitLabApi, QObject* parent)
+    : QObject(parent)
+    , m_gitLabApi(gitLabApi)
+    , m_speedTimer(new QTimer(this))
+{
+    m_speedTimer->setInterval(SPEED_SAMPLE_MS);
+    connect(m_speedTimer, &QTimer::timeout, this, &ArtifactDownloader::sampleSpeed);
+}
+
+ArtifactDownloader::~ArtifactDownloader() {
+    // 未完成的 .part 保留，下次下载到同一位置时续传
+    const QList<int> running = m_transfers.keys();
+    for (int id : running) {
+        releaseTransfer(id);
+    }
+}
+
+int ArtifactDownloader::enqueue(const BuildArtifact& artifact, const QString& destination) {
+    Task task;
+    task.id = m_nextId++;
+    task.artifact = artifact;
+    task.destination = destination;
+    task.total = artifact.size;
+    m_tasks.insert(task.id, task);
+    m_queue.append(task.id);
+
+    LOG_INFO("产物加入下载队列", {{"file", destination}, {"size", artifact.size}});
+    emit taskAdded(task.id);
+    startNext();
+    return task.id;
+}
+
+void ArtifactDownloader::cancel(int id) {
+    auto it = m_tasks.find(id);
+    if (it == m_tasks.end() || it->state == State::Finished || it->state == State::Failed
+        || it->state == State::Canceled) {
+        return;
+    }
+
+    m_queue.removeAll(id);
+    releaseTransfer(id);
+    it->state = State::Canceled;
+    it->bytesPerSecond = 0;
+    LOG_INFO("产物下载已取消", {{"file", it->destination}, {"received", it->received}});
+    emit taskChanged(id);
+    emit taskFinished(id, false);
+    startNext();
+}
+
+void ArtifactDownloader::cancelAll() {
+    const QList<int> ids = m_tasks.keys();
+    for (int id : ids) {
+        cancel(id);
+    }
+}
+
+void ArtifactDownloader::retry(int id) {
+    auto it = m_tasks.find(id);
+    if (it == m_tasks.end() || (it->state != State::Failed && it->state != State::Canceled)) {
+        return;
+    }
+    it->state = State::Queued;
+    it->attempts = 0;
+    it->errorMessage.clear();
+    m_queue.append(id);
+    emit taskChanged(id);
+    startNext();
+}
+
+qint64 ArtifactDownloader::bytesPerSecond() const {
+    qint64 total = 0;
+    for (auto it = m_transfers.constBegin(); it != m_transfers.constEnd(); ++it) {
+        total += m_tasks.value(it.key()).bytesPerSecond;
+    }
+    return total;
+}
+
+void ArtifactDownloader::startNext() {
+    while (m_transfers.size() < MAX_CONCURRENT && !m_queue.isEmpty()) {
+        begin(m_queue.takeFirst());
+    }
+    if (!m_transfers.isEmpty() && !m_speedTimer->isActive()) {
+        m_speedTimer->start();
+    }
+}
+
+void ArtifactDownloader::begin(int id) {
+    Task& task = m_tasks[id];
+    ++task.attempts;
+
+    QDir().mkpath(QFileInfo(task.destination).absolutePath());
+    QFile* file = new QFile(partialPath(task.destination), this);
+    if (!file->open(QIODevice::ReadWrite)) {
+        const QString message = file->errorString();
+        delete file;
+        fail(id, QString::fromUtf8("无法写入文件: ") + message, false);
+        return;
+    }
+
+    // 从已有的部分续传
+    const qint64 offset = file->size();
+    file->seek(offset);
+    QNetworkReply* reply = m_gitLabApi->openDownload(task.artifact.downloadUrl, offset);
+    if (!reply) {
+        delete file;
+        fail(id, QString::fromUtf8("产物没有下载地址"), false);
+        return;
+    }
+    Transfer transfer;
+    transfer.file = file;
+    transfer.offset = offset;
+    transfer.lastSampleBytes = offset;
+    transfer.started.start();
+    m_transfers.insert(id, transfer);
+
+    task.state = State::Running;
+    task.received = offset;
+    task.errorMessage.clear();
+    listen(id, reply);
+
+    if (offset > 0) {
+        LOG_INFO("续传产物", {{"file", task.destination}, {"offset", offset}, {"attempt", task.attempts}});
+    }
+    emit taskChanged(id);
+}
+
+void ArtifactDownloader::listen(int id, QNetworkReply* reply) {
+    Transfer& transfer = m_transfers[id];
+    transfer.reply = reply;
+    transfer.statusChecked = false;
+    // 限制 reply 的缓冲，写盘跟不上时由 TCP 流控暂停接收
+    reply->setReadBufferSize(READ_BUFFER_BYTES);
+    connect(reply, &QNetworkReply::readyRead, this, [this, id]() { onReadyRead(id); });
+    connect(reply, &QNetworkReply::finished, this, [this, id]() { onFinished(id); });
+}
+
+void ArtifactDownloader::onReadyRead(int id) {
+    auto transferIt = m_transfers.find(id);
+    if (transferIt == m_transfers.end()) {
+        return;
+    }
+    Transfer& transfer = transferIt.value();
+    Task& task = m_tasks[id];
+    QNetworkReply* reply = transfer.reply;
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+
+    if (!transfer.statusChecked) {
+        transfer.statusChecked = true;
+        qint64 start = 0;
+        qint64 total = 0;
+        if (status == 206 && parseContentRange(reply->rawHeader("Content-Range"), start, total)) {
+            if (start != transfer.offset) {
+                // 返回的区间与请求不符，丢弃已有部分从头下载
+                transfer.file->resize(0);
+                releaseTransfer(id);
+                fail(id, QString::fromUtf8("续传位置不一致"), true);
+                return;
+            }
+            if (total > 0) {
+                task.total = total;
+            }
+        } else if (status == 200) {
+            if (transfer.offset > 0) {
+                LOG_INFO("服务器不支持续传，重新下载", {{"file", task.destination}});
+                transfer.file->resize(0);
+                transfer.file->seek(0);
+                transfer.offset = 0;
+                transfer.lastSampleBytes = 0;
+                task.received = 0;
+            }
+            const qint64 length = reply->header(QNetworkRequest::ContentLengthHeader).toLongLong();
+            if (length > 0) {
+                task.total = length;
+            }
+        }
+    }
+
+    if (status != 200 && status != 206) {
+        reply->skip(reply->bytesAvailable());  // 错误响应的内容不写入文件，在 onFinished 中处理
+        return;
+    }
+
+    char buffer[64 * 1024];
+    qint64 read = 0;
+    while ((read = reply->read(buffer, sizeof(buffer))) > 0) {
+        if (transfer.file->write(buffer, read) != read) {
+            const QString message = transfer.file->errorString();
+            releaseTransfer(id);
+            fail(id, QString::fromUtf8("写入文件失败: ") + message, false);
+            return;
+        }
+        task.received += read;
+    }
+}
+
+void ArtifactDownloader::onFinished(int id) {
+    onReadyRead(id);  // 取走最后一段
+    auto transferIt = m_transfers.find(id);
+    if (transferIt == m_transfers.end()) {
+        return;  // 已在读取时失败
+    }
+    QNetworkReply* reply = transferIt->reply;
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+
+    // 产物通常重定向到对象存储：按新地址重新请求，令牌只发给 GitLab 本身
+    const QUrl target = GitLabApi::redirectTarget(reply);
+    if (target.isValid() && transferIt->redirects < GitLabApi::MAX_DOWNLOAD_REDIRECTS) {
+        ++transferIt->redirects;
+        disconnect(reply, nullptr, this, nullptr);
+        listen(id, m_gitLabApi->openDownload(target.toString(QUrl::FullyEncoded), transferIt->offset));
+        return;
+    }
+
+    if (status == 416) {
+        // 请求的起点不小于文件大小：已有部分可能就是完整文件
+        qint64 start = 0;
+        qint64 total = 0;
+        parseContentRange(reply->rawHeader("Content-Range"), start, total);
+        Task& task = m_tasks[id];
+        if (total > 0 && total == transferIt->offset) {
+            task.total = total;
+            complete(id);
+            return;
+        }
+        transferIt->file->resize(0);
+        fail(id, QString::fromUtf8("已下载部分与服务器文件不一致"), true);
+        return;
+    }
+
+    if (reply->error() != QNetworkReply::NoError || (status != 200 && status != 206)) {
+        const QString message = status > 0 ? QString("HTTP %1: %2").arg(status).arg(reply->errorString())
+                                           : reply->errorString();
+        fail(id, message, isRetryable(reply->error(), status));
+        return;
+    }
+
+    complete(id);
+}
+
+void ArtifactDownloader::complete(int id) {
+    Task& task = m_tasks[id];
+    const Transfer transfer = m_transfers.value(id);
+    transfer.file->flush();
+    const qint64 size = transfer.file->size();
+    const qint64 elapsedMs = transfer.started.elapsed();
+
+    if (task.total > 0 && size != task.total) {
+        // 连接提前断开时保留已下载部分续传；比预期大说明内容有误，从头下载
+        if (size > task.total) {
+            transfer.file->resize(0);
+        }
+        fail(id, QString::fromUtf8("文件大小不一致：%1 / %2 字节").arg(size).arg(task.total), true);
+        return;
+    }
+
+    releaseTransfer(id);
+    QFile::remove(task.destination);
+    if (!QFile::rename(partialPath(task.destination), task.destination)) {
+        fail(id, QString::fromUtf8("无法重命名下载文件"), false);
+        return;
+    }
+
+    task.state = State::Finished;
+    task.received = size;
+    task.total = size;
+    task.bytesPerSecond = 0;
+    const qint64 transferred = size - transfer.offset;
+    LOG_INFO("产物下载完成", {{"file", task.destination}, {"bytes", size}, {"ms", elapsedMs},
+                             {"bytes_per_sec", elapsedMs > 0 ? transferred * 1000 / elapsedMs : transferred}});
+    emit taskChanged(id);
+    emit taskFinished(id, true);
+    startNext();
+}
+
+void ArtifactDownloader::fail(int id, const QString& message, bool retryable) {
+    releaseTransfer(id);
+    Task& task = m_tasks[id];
+    task.errorMessage = message;
+    task.bytesPerSecond = 0;
+
+    if (retryable && task.attempts < MAX_ATTEMPTS) {
+        task.state = State::Retrying;
+        const int delayMs = RETRY_BASE_DELAY_MS << (task.attempts - 1);
+        LOG_WARNING("产物下载中断，稍后续传", {{"file", task.destination}, {"error", message},
+                                             {"attempt", task.attempts}, {"delay_ms", delayMs}});
+        QTimer::singleShot(delayMs, this, [this, id]() {
+            auto it = m_tasks.find(id);
+            if (it == m_tasks.end() || it->state != State::Retrying) {
+                return;  // 等待期间被取消
+            }
+            it->state = State::Queued;
+            m_queue.prepend(id);
+            startNext();
+        });
+        emit taskChanged(id);
+    } else {
+        task.state = State::Failed;
+        LOG_ERROR("产物下载失败", {{"file", task.destination}, {"error", message}, {"attempts", task.attempts}});
+        emit taskChanged(id);
+        emit taskFinished(id, false);
+    }
+    startNext();
+}
+
+void ArtifactDownloader::releaseTransfer(int id) {
+    auto it = m_transfers.find(id);
+    if (it == m_transfers.end()) {
+        return;
+    }
+    const Transfer transfer = it.value();
+    m_transfers.erase(it);
+
+    if (transfer.reply) {
+        // 断开后再中止，避免 finished 回到本对象；reply 由 GitLabApi 释放
+        disconnect(transfer.reply, nullptr, this, nullptr);
+        if (transfer.reply->isRunning()) {
+            transfer.reply->abort();
+        }
+    }
+    if (transfer.file) {
+        transfer.file->close();
+        delete transfer.file;
+    }
+    if (m_transfers.isEmpty()) {
+        m_speedTimer->stop();
+    }
+}
+
+void ArtifactDownloader::sampleSpeed() {
+    for (auto it = m_transfers.begin(); it != m_transfers.end(); ++it) {
+        Task& task = m_tasks[it.key()];
+        const qint64 current = (task.received - it->lastSampleBytes) * 1000 / SPEED_SAMPLE_MS;
+        // 与上一次取平均，减少抖动
+        task.bytesPerSecond = task.bytesPerSecond > 0 ? (task.bytesPerSecond + current) / 2 : current;
+        it->lastSampleBytes = task.received;
+    }
+    // 接收方可能在槽中取消任务，先取出ID再通知
+    const QList<int> ids = m_transfers.keys();
+    for (int id : ids) {
+        emit taskChanged(id);
+    }
+}
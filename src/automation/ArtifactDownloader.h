@@ -0,0 +1,108 @@
+#ifndef ARTIFACTDOWNLOADER_H
+#define ARTIFACTDOWNLOADER_H
+
+#include <QObject>
+#include <QMap>
+#include <QHash>
+#include <QList>
+#include <QElapsedTimer>
+#include "api/ApiModels.h"
+
+class GitLabApi;
+class QNetworkReply;
+class QFile;
+class QTimer;
+
+/**
+ * @brief 构建产物下载管理
+ *
+ * 响应体在 readyRead 中直接写入 <目标文件>.part（reply 缓冲上限 READ_BUFFER_BYTES，写盘慢时暂停接收），
+ * 下载完成并校验大小后再改名为目标文件，内存占用与文件大小无关。
+ * 最多同时下载 MAX_CONCURRENT 个，其余排队。
+ * 网络中断、5xx 等可恢复的错误按指数退避重试，用 Range 从 .part 的末尾续传；
+ * 服务器不支持续传（返回 200）时从头写。已有的 .part 文件（如上次退出时未完成）同样会被续传。
+ * 大小以 Content-Range / Content-Length 为准，都没有时使用产物清单中的大小。
+ */
+class ArtifactDownloader : public QObject {
+    Q_OBJECT
+
+public:
+    enum class State {
+        Queued,
+        Running,
+        Retrying,   // 等待重试
+        Finished,
+        Failed,
+        Canceled
+    };
+
+    struct Task {
+        int id = 0;
+        BuildArtifact artifact;
+        QString destination;
+        State state = State::Queued;
+        qint64 received = 0;        // 已写入磁盘的字节数（含续传前的部分）
+        qint64 total = 0;           // 未知时为 0
+        qint64 bytesPerSecond = 0;
+        int attempts = 0;
+        QString errorMessage;
+    };
+
+    explicit ArtifactDownloader(GitLabApi* gitLabApi, QObject* parent = nullptr);
+    ~ArtifactDownloader();
+
+    // 加入下载队列，返回任务ID
+    int enqueue(const BuildArtifact& artifact, const QString& destination);
+    // 取消后保留 .part，retry() 时续传
+    void cancel(int id);
+    void cancelAll();
+    void retry(int id);
+
+    QList<int> taskIds() const { return m_tasks.keys(); }
+    Task task(int id) const { return m_tasks.value(id); }
+    qint64 bytesPerSecond() const;  // 进行中任务的合计速度
+
+    static QString partialPath(const QString& destination) { return destination + ".part"; }
+
+    static constexpr int MAX_CONCURRENT = 3;
+    static constexpr int MAX_ATTEMPTS = 5;
+    static constexpr int RETRY_BASE_DELAY_MS = 1000;
+    static constexpr int READ_BUFFER_BYTES = 256 * 1024;
+    static constexpr int SPEED_SAMPLE_MS = 1000;
+
+signals:
+    void taskAdded(int id);
+    void taskChanged(int id);  // 状态变化，或进度更新（每 SPEED_SAMPLE_MS 一次）
+    void taskFinished(int id, bool success);
+
+private:
+    struct Transfer {
+        QNetworkReply* reply = nullptr;
+        QFile* file = nullptr;
+        qint64 offset = 0;          // 本次请求的起点
+        int redirects = 0;
+        qint64 lastSampleBytes = 0;
+        bool statusChecked = false;
+        QElapsedTimer started;
+    };
+
+    void startNext();
+    void begin(int id);
+    void listen(int id, QNetworkReply* reply);
+    void onReadyRead(int id);
+    void onFinished(int id);
+    void complete(int id);
+    void fail(int id, const QString& message, bool retryable);
+    void releaseTransfer(int id);
+    void sampleSpeed();
+
+    GitLabApi* m_gitLabApi;
+    QTimer* m_speedTimer;
+
+    QMap<int, Task> m_tasks;             // 按加入顺序
+    QHash<int, Transfer> m_transfers;    // 进行中的任务
+    QList<int> m_queue;
+    int m_nextId = 1;
+};
+
+#endif // ARTIFACTDOWNLOADER_H
@@ -0,0 +1,102 @@
+#include "ArtifactLinkExtractor.h"
+#include "config/ConfigManager.h"
+#include "utils/Logger.h"
+#include <QUrl>
+#include <QFileInfo>
+
+namespace {
+
+// 链接中不会出现的字节：空白与控制字符（含ANSI转义的 ESC）、引号、尖括号
+inline bool isDelimiter(char c) {
+    const uchar byte = uchar(c);
+    return byte <= 0x20 || byte == 0x7f || c == '"' || c == '\'' || c == '<' || c == '>' || c == '`';
+}
+
+inline bool isSchemeChar(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+           || c == '+' || c == '-' || c == '.';
+}
+
+BuildArtifact linkArtifact(const QString& url) {
+    BuildArtifact artifact;
+    artifact.downloadUrl = url;
+    artifact.fileType = "link";
+    artifact.filename = QFileInfo(QUrl(url).path()).fileName();
+    if (artifact.filename.isEmpty()) {
+        artifact.filename = url;
+    }
+    return artifact;
+}
+
+}
+
+ArtifactLinkExtractor::ArtifactLinkExtractor(const QString& pattern)
+    : m_pattern(pattern)
+    , m_schemeMatcher("://")
+{
+    if (pattern.isEmpty() || !m_pattern.isValid()) {
+        if (!pattern.isEmpty()) {
+            LOG_WARNING("产物链接正则无效，使用默认值", {{"pattern", pattern}, {"error", m_pattern.errorString()}});
+        }
+        m_pattern.setPattern(ConfigManager::DEFAULT_ARTIFACT_PATTERN);
+    }
+    m_pattern.optimize();
+}
+
+QList<BuildArtifact> ArtifactLinkExtractor::feed(const char* data, qint64 size) {
+    // 最后一个分隔符之前的候选都已完整
+    qint64 last = size - 1;
+    while (last >= 0 && !isDelimiter(data[last])) {
+        --last;
+    }
+    
+    if (last < 0) {
+        m_carry.append(data, size);
+        if (m_carry.size() > MAX_URL_BYTES) {
+            m_carry.remove(0, m_carry.size() - MAX_URL_BYTES);
+        }
+        return {};
+    }
+    
+    QByteArray text = m_carry;
+    text.append(data, last + 1);
+    const qint64 tail = qMin<qint64>(size - last - 1, MAX_URL_BYTES);
+    m_carry = QByteArray(data + size - tail, tail);
+    return scan(text);
+}
+
+QList<BuildArtifact> ArtifactLinkExtractor::finish() {
+    const QByteArray text = m_carry;
+    m_carry.clear();
+    return scan(text);
+}
+
+QList<BuildArtifact> ArtifactLinkExtractor::scan(const QByteArray& text) {
+    QList<BuildArtifact> found;
+    qsizetype pos = 0;
+    while ((pos = m_schemeMatcher.indexIn(text, pos)) >= 0) {
+        // 向前取 scheme，向后取到分隔符
+        qsizetype start = pos;
+        while (start > 0 && isSchemeChar(text[start - 1])) {
+            --start;
+        }
+        qsizetype end = pos + 3;
+        while (end < text.size() && !isDelimiter(text[end])) {
+            ++end;
+        }
+        
+        if (start < pos) {
+            const QString candidate = QString::fromUtf8(text.constData() + start, end - start);
+            QRegularExpressionMatchIterator it = m_pattern.globalMatch(candidate);
+            while (it.hasNext()) {
+                const QString url = it.next().captured(0);
+                if (!m_seen.contains(url)) {
+                    m_seen.insert(url);
+                    found.append(linkArtifact(url));
+                }
+            }
+        }
+        pos = end;
+    }
+    return found;
+}
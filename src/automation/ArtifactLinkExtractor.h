@@ -0,0 +1,40 @@
+#ifndef ARTIFACTLINKEXTRACTOR_H
+#define ARTIFACTLINKEXTRACTOR_H
+
+#include <QByteArray>
+#include <QByteArrayMatcher>
+#include <QRegularExpression>
+#include <QSet>
+#include <QList>
+#include "api/ApiModels.h"
+
+/**
+ * @brief 从分段到达的Job日志中提取产物下载链接
+ *
+ * 先用 "://" 预筛，只对命中位置所在的单个候选（不含空白、引号、控制字符的连续片段）执行
+ * 配置的产物正则（ConfigManager::getArtifactPattern），不对整段日志运行正则。
+ * 每段只扫描到最后一个分隔符为止，其后可能未完的片段与下一段拼接后再扫描，跨段的链接同样能识别；
+ * 保留的部分不超过 MAX_URL_BYTES。同一链接只返回一次。
+ */
+class ArtifactLinkExtractor {
+public:
+    // pattern 为空或无效时使用 ConfigManager::DEFAULT_ARTIFACT_PATTERN
+    explicit ArtifactLinkExtractor(const QString& pattern = QString());
+    
+    // 返回本段中新发现的链接（downloadUrl 为链接，size 未知为 0）
+    QList<BuildArtifact> feed(const char* data, qint64 size);
+    // 日志结束：扫描保留的最后一段
+    QList<BuildArtifact> finish();
+    
+    static constexpr int MAX_URL_BYTES = 4096;
+    
+private:
+    QList<BuildArtifact> scan(const QByteArray& text);
+    
+    QRegularExpression m_pattern;
+    QByteArrayMatcher m_schemeMatcher;
+    QByteArray m_carry;     // 上一段最后一个分隔符之后的部分
+    QSet<QString> m_seen;
+};
+
+#endif // ARTIFACTLINKEXTRACTOR_H
@@ -1,4 +1,229 @@
 #include "BuildMonitor.h"
+#include "api/GitLabApi.h"
+#include "config/ConfigManager.h"
+#include "utils/Logger.h"
+#include <QTimer>
+#include <algorithm>
 
-BuildMonitor::BuildMonitor(QObject* parent) : QObject(parent) {
-}
\ No newline at end of file
+BuildMonitor::BuildMonitor(GitLabApi* gitLabApi, QObject* parent)
+    : QObject(parent)
+    , m_gitLabApi(gitLabApi)
+    , m_listTimer(new QTimer(this))
+    , m_activeTimer(new QTimer(this))
+{
+    m_listTimer->setSingleShot(true);
+    m_activeTimer->setSingleShot(true);
+    connect(m_listTimer, &QTimer::timeout, this, &BuildMonitor::fetchList);
+    connect(m_activeTimer, &QTimer::timeout, this, &BuildMonitor::pollActive);
+}
+
+void BuildMonitor::start(const QString& ref) {
+    ++m_generation;
+    m_ref = ref;
+    m_running = true;
+    m_pipelines.clear();
+    m_active.clear();
+    m_statusInFlight.clear();
+    m_listInFlight = false;
+    m_listIntervalMs = LIST_MIN_INTERVAL_MS;
+    fetchList();
+}
+
+void BuildMonitor::stop() {
+    m_running = false;
+    m_listTimer->stop();
+    m_activeTimer->stop();
+}
+
+void BuildMonitor::refreshNow() {
+    if (!m_running) {
+        start(m_ref);
+        return;
+    }
+    m_listIntervalMs = LIST_MIN_INTERVAL_MS;
+    fetchList();
+    pollActive();
+}
+
+void BuildMonitor::trackPipeline(const PipelineStatus& pipeline) {
+    if (pipeline.id == 0) {
+        return;
+    }
+    if (mergeStatus(pipeline)) {
+        emit pipelinesUpdated(m_pipelines);
+    }
+    if (pipeline.isActive()) {
+        m_active.insert(pipeline.id);
+        m_fastPollsLeft = FAST_POLL_COUNT;
+        m_activeTimer->start(FAST_POLL_MS);
+    }
+    // 新 Pipeline 可能伴随其他变化（如同时触发的下游），列表也尽快复查
+    m_listIntervalMs = LIST_MIN_INTERVAL_MS;
+    if (m_running && !m_listInFlight) {
+        m_listTimer->start(m_listIntervalMs);
+    }
+}
+
+// ========== 列表轮询 ==========
+
+void BuildMonitor::fetchList() {
+    if (!m_running || m_listInFlight) {
+        return;
+    }
+    m_listTimer->stop();
+    m_listInFlight = true;
+    
+    const int generation = m_generation;
+    m_gitLabApi->listPipelines(m_ref, LIST_SIZE).items.then(this, [this, generation](QFuture<PipelineStatus> future) {
+        if (generation != m_generation) {
+            return;
+        }
+        m_listInFlight = false;
+        try {
+            const QList<PipelineStatus> list = future.results();  // 失败时抛出 ApiError
+            if (!future.isCanceled()) {
+                onListReceived(list);
+                return;
+            }
+        } catch (const ApiError& error) {
+            LOG_WARNING(QString("获取Pipeline列表失败: %1").arg(error.message()));
+        }
+        scheduleListPoll(false);
+    });
+}
+
+void BuildMonitor::onListReceived(const QList<PipelineStatus>& list) {
+    if (!m_running) {
+        return;
+    }
+    
+    bool changed = m_pipelines.size() != list.size();
+    for (const PipelineStatus& pipeline : list) {
+        changed |= mergeStatus(pipeline);
+        if (pipeline.isActive() && !m_active.contains(pipeline.id)) {
+            m_active.insert(pipeline.id);
+        }
+    }
+    
+    // 只保留列表范围内的条目（更早的已滚出最近列表）
+    QSet<int> listed;
+    for (const PipelineStatus& pipeline : list) {
+        listed.insert(pipeline.id);
+    }
+    m_pipelines.erase(std::remove_if(m_pipelines.begin(), m_pipelines.end(), [&](const PipelineStatus& p) {
+        return !listed.contains(p.id) && !m_active.contains(p.id);
+    }), m_pipelines.end());
+    
+    if (changed) {
+        emit pipelinesUpdated(m_pipelines);
+    }
+    
+    scheduleListPoll(changed);
+    scheduleActivePoll();
+}
+
+void BuildMonitor::scheduleListPoll(bool changed) {
+    if (!m_running) {
+        return;
+    }
+    // 有变化或仍有进行中的 Pipeline 时保持较短间隔，否则指数退避
+    if (changed || !m_active.isEmpty()) {
+        m_listIntervalMs = LIST_MIN_INTERVAL_MS;
+    } else {
+        m_listIntervalMs = qMin(m_listIntervalMs * 2, LIST_MAX_INTERVAL_MS);
+    }
+    m_listTimer->start(m_listIntervalMs);
+}
+
+// ========== 进行中 Pipeline 的轮询 ==========
+
+void BuildMonitor::scheduleActivePoll() {
+    if (!m_running || m_active.isEmpty() || m_activeTimer->isActive()) {
+        return;
+    }
+    const int configuredMs = qMax(1, ConfigManager::instance().getPipelinePollInterval()) * 1000;
+    m_activeTimer->start(m_fastPollsLeft > 0 ? FAST_POLL_MS : configuredMs);
+}
+
+void BuildMonitor::pollActive() {
+    if (!m_running) {
+        return;
+    }
+    if (m_fastPollsLeft > 0) {
+        --m_fastPollsLeft;
+    }
+    
+    const int generation = m_generation;
+    for (int pipelineId : m_active) {
+        if (m_statusInFlight.contains(pipelineId)) {
+            continue;
+        }
+        m_statusInFlight.insert(pipelineId);
+        m_gitLabApi->getPipelineStatus(pipelineId).then(this, [this, generation, pipelineId](const PipelineStatus& pipeline) {
+            if (generation != m_generation) {
+                return;
+            }
+            m_statusInFlight.remove(pipelineId);
+            onStatusReceived(pipeline);
+        }).onFailed(this, [this, generation, pipelineId](const ApiError& error) {
+            if (generation != m_generation) {
+                return;
+            }
+            m_statusInFlight.remove(pipelineId);
+            LOG_WARNING(QString("查询Pipeline #%1 状态失败: %2").arg(pipelineId).arg(error.message()));
+            if (error.httpStatus() == 404) {
+                m_active.remove(pipelineId);  // 已被删除
+            }
+            scheduleActivePoll();
+        });
+    }
+    
+    scheduleActivePoll();
+}
+
+void BuildMonitor::onStatusReceived(const PipelineStatus& pipeline) {
+    if (!m_running) {
+        return;
+    }
+    if (mergeStatus(pipeline)) {
+        emit pipelinesUpdated(m_pipelines);
+    }
+    
+    if (!pipeline.isActive()) {
+        m_active.remove(pipeline.id);
+        emit pipelineFinished(pipeline);
+        // 构建结束常伴随新的提交或下游 Pipeline，尽快复查列表
+        m_listIntervalMs = LIST_MIN_INTERVAL_MS;
+        if (!m_listInFlight) {
+            m_listTimer->start(m_listIntervalMs);
+        }
+    }
+    scheduleActivePoll();
+}
+
+bool BuildMonitor::mergeStatus(const PipelineStatus& pipeline) {
+    auto it = std::find_if(m_pipelines.begin(), m_pipelines.end(), [&](const PipelineStatus& p) {
+        return p.id == pipeline.id;
+    });
+    
+    if (it == m_pipelines.end()) {
+        // 按ID降序插入
+        auto pos = std::find_if(m_pipelines.begin(), m_pipelines.end(), [&](const PipelineStatus& p) {
+            return p.id < pipeline.id;
+        });
+        m_pipelines.insert(pos, pipeline);
+        return true;
+    }
+    
+    if (it->status == pipeline.status && it->updatedAt == pipeline.updatedAt) {
+        return false;
+    }
+    
+    const QString oldStatus = it->status;
+    *it = pipeline;
+    if (oldStatus != pipeline.status) {
+        LOG_INFO(QString("Pipeline #%1 状态变化: %2 -> %3").arg(pipeline.id).arg(oldStatus, pipeline.status));
+        emit pipelineStatusChanged(pipeline, oldStatus);
+    }
+    return true;
+}
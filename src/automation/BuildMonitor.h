@@ -2,11 +2,76 @@
 #define BUILDMONITOR_H
 
 #include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QList>
+#include "api/ApiModels.h"
 
+class GitLabApi;
+class QTimer;
+
+/**
+ * @brief Pipeline监控引擎
+ *
+ * 两类轮询：
+ * - 进行中（pending/running 等）的 Pipeline 按 ID 单独查询状态，间隔为配置的
+ *   Build/PollInterval（刚触发或重试的 Pipeline 先以 FAST_POLL_MS 间隔查询）；
+ * - 最近的 Pipeline 列表只用于发现新 Pipeline：没有变化时间隔按指数退避，
+ *   从 LIST_MIN_INTERVAL_MS 增长到 LIST_MAX_INTERVAL_MS，有变化或有进行中的 Pipeline 时复位。
+ * 状态变化时发出 pipelineStatusChanged，进入终态时另发 pipelineFinished。
+ */
 class BuildMonitor : public QObject {
     Q_OBJECT
 public:
-    explicit BuildMonitor(QObject* parent = nullptr);
+    explicit BuildMonitor(GitLabApi* gitLabApi, QObject* parent = nullptr);
+    
+    // 开始监控 ref 的最近 Pipeline（空表示所有分支），立即拉取一次列表
+    void start(const QString& ref = QString());
+    void stop();
+    
+    // 手动刷新：立即拉取列表与进行中 Pipeline 的状态，并复位退避
+    void refreshNow();
+    
+    // 刚触发/重试的 Pipeline，立即进入快速轮询
+    void trackPipeline(const PipelineStatus& pipeline);
+    
+    // 最近一次的列表（按ID降序）
+    QList<PipelineStatus> pipelines() const { return m_pipelines; }
+    bool hasActivePipelines() const { return !m_active.isEmpty(); }
+    
+    static constexpr int LIST_SIZE = 11;
+    static constexpr int FAST_POLL_MS = 3000;
+    static constexpr int FAST_POLL_COUNT = 5;   // 快速轮询的次数，之后按配置的间隔
+    static constexpr int LIST_MIN_INTERVAL_MS = 30 * 1000;
+    static constexpr int LIST_MAX_INTERVAL_MS = 10 * 60 * 1000;
+    
+signals:
+    void pipelinesUpdated(const QList<PipelineStatus>& pipelines);
+    void pipelineStatusChanged(const PipelineStatus& pipeline, const QString& oldStatus);
+    void pipelineFinished(const PipelineStatus& pipeline);
+    
+private:
+    void fetchList();
+    void onListReceived(const QList<PipelineStatus>& list);
+    void pollActive();
+    void onStatusReceived(const PipelineStatus& pipeline);
+    void scheduleListPoll(bool changed);
+    void scheduleActivePoll();
+    bool mergeStatus(const PipelineStatus& pipeline);
+    
+    GitLabApi* m_gitLabApi;
+    QTimer* m_listTimer;
+    QTimer* m_activeTimer;
+    
+    QString m_ref;
+    bool m_running = false;
+    QList<PipelineStatus> m_pipelines;
+    QSet<int> m_active;              // 进行中的 Pipeline ID
+    QSet<int> m_statusInFlight;      // 正在查询状态的 Pipeline ID，避免重复请求
+    bool m_listInFlight = false;
+    int m_generation = 0;            // start() 后丢弃旧 ref 的响应
+    int m_listIntervalMs = LIST_MIN_INTERVAL_MS;
+    int m_fastPollsLeft = 0;
 };
 
-#endif
\ No newline at end of file
+#endif
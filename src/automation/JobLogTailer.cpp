@@ -0,0 +1,268 @@
+#include "JobLogTailer.h"
+#include "api/GitLabApi.h"
+#include "config/ConfigManager.h"
+#include "utils/Logger.h"
+#include <QTemporaryFile>
+#include <QTimer>
+#include <QDir>
+#include <QRegularExpression>
+#include <cstring>
+
+namespace {
+
+// 原始日志行 -> 显示文本
+QString displayText(QByteArray raw) {
+    // GitLab 折叠段标记，如 "section_start:1700000000:build_script\r\e[0K"
+    static const QRegularExpression sectionMarker("section_(?:start|end):\\d+:[^\\r]*\\r");
+    static const QRegularExpression ansiEscape("\\x1b\\[[0-9;?]*[A-Za-z]");
+
+    if (raw.endsWith('\r')) {
+        raw.chop(1);  // CRLF
+    }
+    QString text = QString::fromUtf8(raw);
+    text.remove(sectionMarker);
+    // 进度条等用回车反复覆盖同一行，只显示最后一次输出
+    const int lastReturn = text.lastIndexOf('\r');
+    if (lastReturn >= 0) {
+        text = text.mid(lastReturn + 1);
+    }
+    text.remove(ansiEscape);
+    return text;
+}
+
+}
+
+JobLogTailer::JobLogTailer(GitLabApi* gitLabApi, QObject* parent)
+    : QObject(parent)
+    , m_gitLabApi(gitLabApi)
+    , m_pollTimer(new QTimer(this))
+    , m_lineCache(LINE_CACHE_SIZE)
+{
+    m_pollTimer->setSingleShot(true);
+    connect(m_pollTimer, &QTimer::timeout, this, &JobLogTailer::poll);
+}
+
+JobLogTailer::~JobLogTailer() {
+    stop();
+}
+
+bool JobLogTailer::start(int jobId) {
+    stop();
+
+    delete m_file;
+    m_file = new QTemporaryFile(QDir::temp().filePath("gitpilot-job-XXXXXX.log"), this);
+    if (!m_file->open()) {
+        LOG_ERROR("无法创建Job日志临时文件", {{"error", m_file->errorString()}});
+        delete m_file;
+        m_file = nullptr;
+        return false;
+    }
+
+    m_jobId = jobId;
+    m_jobStatus.clear();
+    m_finalFetch = false;
+    m_pollIntervalMs = POLL_MS;
+    m_size = 0;
+    m_notifiedLines = 0;
+    m_notifiedSize = 0;
+    m_lineStarts.clear();
+    m_lineCache.clear();
+    m_linkExtractor = ArtifactLinkExtractor(ConfigManager::instance().getArtifactPattern());
+
+    m_running = true;
+    LOG_INFO("开始跟踪Job日志", {{"job", jobId}});
+    poll();
+    return true;
+}
+
+void JobLogTailer::stop() {
+    ++m_generation;
+    m_running = false;
+    m_pollTimer->stop();
+    if (m_reply) {
+        // 断开后再中止，避免 finished 回到本对象
+        disconnect(m_reply, nullptr, this, nullptr);
+        m_reply->abort();
+        m_reply = nullptr;
+    }
+}
+
+int JobLogTailer::lineCount() const {
+    if (m_lineStarts.isEmpty()) {
+        return 0;
+    }
+    // 以换行结尾时最后一个起始偏移还没有内容
+    return m_lineStarts.last() == m_size ? m_lineStarts.size() - 1 : m_lineStarts.size();
+}
+
+QString JobLogTailer::line(int index) {
+    if (!m_file || index < 0 || index >= lineCount()) {
+        return QString();
+    }
+    if (const QString* cached = m_lineCache.object(index)) {
+        return *cached;
+    }
+
+    const qint64 start = m_lineStarts[index];
+    const qint64 end = index + 1 < m_lineStarts.size() ? m_lineStarts[index + 1] - 1 : m_size;  // 不含换行符
+    m_file->seek(start);
+    const QString text = displayText(m_file->read(qMin(end - start, qint64(MAX_LINE_BYTES))));
+    m_lineCache.insert(index, new QString(text));
+    return text;
+}
+
+void JobLogTailer::poll() {
+    // 先确认Job状态再拉日志：Job已结束时本次拉到的就是完整日志
+    const int generation = m_generation;
+    m_gitLabApi->getJob(m_jobId).then(this, [this, generation](const PipelineJob& job) {
+        if (generation != m_generation) {
+            return;
+        }
+        if (job.status != m_jobStatus) {
+            m_jobStatus = job.status;
+            emit jobStatusChanged(m_jobStatus);
+        }
+        m_finalFetch = !job.isActive();
+        fetch();
+    }).onFailed(this, [this, generation](const ApiError& error) {
+        if (generation != m_generation) {
+            return;
+        }
+        LOG_WARNING("获取Job状态失败", {{"job", m_jobId}, {"error", error.message()}});
+        emit errorOccurred(error.message());
+        fetch();
+    });
+}
+
+void JobLogTailer::fetch() {
+    m_reply = m_gitLabApi->openJobTrace(m_jobId, m_size);
+    if (!m_reply) {
+        m_running = false;
+        emit errorOccurred(QString::fromUtf8("项目ID未设置"));
+        return;
+    }
+
+    m_fetchStartSize = m_size;
+    m_redirects = 0;
+    listen();
+}
+
+void JobLogTailer::listen() {
+    m_skip = 0;
+    m_statusChecked = false;
+    connect(m_reply, &QNetworkReply::readyRead, this, &JobLogTailer::onReadyRead);
+    connect(m_reply, &QNetworkReply::finished, this, &JobLogTailer::onFetchFinished);
+}
+
+void JobLogTailer::onReadyRead() {
+    const int status = m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (!m_statusChecked) {
+        m_statusChecked = true;
+        if (status == 200 && m_fetchStartSize > 0) {
+            m_skip = m_fetchStartSize;  // 服务器忽略了 Range，返回的是完整日志
+        }
+    }
+
+    // 错误响应（如 416 没有新内容）的响应体不是日志
+    const bool isLog = status == 200 || status == 206;
+    char buffer[64 * 1024];
+    qint64 read = 0;
+    while ((read = m_reply->read(buffer, sizeof(buffer))) > 0) {
+        if (!isLog) {
+            continue;
+        }
+        const char* data = buffer;
+        if (m_skip > 0) {
+            const qint64 skipped = qMin(m_skip, read);
+            m_skip -= skipped;
+            data += skipped;
+            read -= skipped;
+        }
+        if (read > 0 && !append(data, read)) {
+            return;  // 写入失败，已停止
+        }
+    }
+
+    notifyAppended();
+}
+
+void JobLogTailer::onFetchFinished() {
+    onReadyRead();  // 取走最后一段
+    if (!m_reply) {
+        return;
+    }
+    QNetworkReply* reply = m_reply;
+    m_reply = nullptr;  // 由 GitLabApi 统一释放
+
+    // 重定向时按新地址重新请求，令牌只发给 GitLab 本身
+    const QUrl target = GitLabApi::redirectTarget(reply);
+    if (target.isValid() && m_redirects < GitLabApi::MAX_DOWNLOAD_REDIRECTS) {
+        ++m_redirects;
+        m_reply = m_gitLabApi->openDownload(target.toString(QUrl::FullyEncoded), m_size);
+        listen();
+        return;
+    }
+
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    const bool grew = m_size > m_fetchStartSize;
+    // 416: 请求的偏移已到日志末尾，没有新内容
+    if (reply->error() != QNetworkReply::NoError && status != 416) {
+        LOG_WARNING("拉取Job日志失败", {{"job", m_jobId}, {"status", status}, {"error", reply->errorString()}});
+        emit errorOccurred(reply->errorString());
+        scheduleNext(false);
+        return;
+    }
+
+    if (m_finalFetch) {
+        m_running = false;
+        for (const BuildArtifact& artifact : m_linkExtractor.finish()) {
+            emit artifactLinkFound(artifact);
+        }
+        LOG_INFO("Job日志跟踪结束", {{"job", m_jobId}, {"status", m_jobStatus}, {"bytes", m_size}, {"lines", lineCount()}});
+        emit finished();
+        return;
+    }
+    scheduleNext(grew);
+}
+
+void JobLogTailer::scheduleNext(bool grew) {
+    m_pollIntervalMs = grew ? POLL_MS : qMin(m_pollIntervalMs * 2, MAX_POLL_MS);
+    m_pollTimer->start(m_pollIntervalMs);
+}
+
+bool JobLogTailer::append(const char* data, qint64 size) {
+    m_file->seek(m_size);
+    if (m_file->write(data, size) != size) {
+        LOG_ERROR("写入Job日志临时文件失败", {{"error", m_file->errorString()}});
+        stop();
+        emit errorOccurred(m_file->errorString());
+        return false;
+    }
+
+    if (m_lineStarts.isEmpty()) {
+        m_lineStarts.append(0);
+    }
+    const char* end = data + size;
+    for (const char* p = data; (p = static_cast<const char*>(std::memchr(p, '\n', end - p))) != nullptr; ++p) {
+        m_lineStarts.append(m_size + (p - data) + 1);
+    }
+    m_size += size;
+
+    for (const BuildArtifact& artifact : m_linkExtractor.feed(data, size)) {
+        emit artifactLinkFound(artifact);
+    }
+    return true;
+}
+
+void JobLogTailer::notifyAppended() {
+    if (m_size == m_notifiedSize) {
+        return;
+    }
+    const int count = lineCount();
+    // 原末行可能没有换行，本次被补全
+    const int firstChanged = qMax(0, m_notifiedLines - 1);
+    m_lineCache.remove(firstChanged);
+    m_notifiedLines = count;
+    m_notifiedSize = m_size;
+    emit linesAppended(firstChanged, count);
+}
@@ -0,0 +1,94 @@
+#ifndef JOBLOGTAILER_H
+#define JOBLOGTAILER_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QCache>
+#include "ArtifactLinkExtractor.h"
+
+class GitLabApi;
+class QNetworkReply;
+class QTemporaryFile;
+class QTimer;
+
+/**
+ * @brief Job日志增量跟踪
+ *
+ * 按已接收的字节数发起 Range 请求（bytes=<偏移>-），只拉取新增的日志；响应体在 readyRead 中
+ * 逐段写入临时文件，内存中只保留每行的起始偏移。界面按行号随取随读（见 JobLogDialog），
+ * 上百MB的日志也不会整体读入内存。
+ * Job进行中时每 POLL_MS 拉取一次，没有新内容时间隔翻倍，最长 MAX_POLL_MS；Job结束后再取一次剩余内容即停止。
+ * 服务器忽略 Range 返回完整日志（200）时跳过已有的部分。
+ * 新到的内容同时交给 ArtifactLinkExtractor，发现产物链接时立即发出 artifactLinkFound。
+ */
+class JobLogTailer : public QObject {
+    Q_OBJECT
+
+public:
+    explicit JobLogTailer(GitLabApi* gitLabApi, QObject* parent = nullptr);
+    ~JobLogTailer();
+
+    // 开始跟踪，丢弃之前的日志；无法创建临时文件时返回 false
+    bool start(int jobId);
+    void stop();
+
+    int jobId() const { return m_jobId; }
+    QString jobStatus() const { return m_jobStatus; }
+    bool isRunning() const { return m_running; }
+    qint64 size() const { return m_size; }
+
+    // 行数，含末尾尚未换行的一行
+    int lineCount() const;
+    // 第 index 行的显示文本：去掉ANSI颜色与折叠段标记，回车覆盖的内容只保留最后一段
+    QString line(int index);
+
+    static constexpr int POLL_MS = 2000;
+    static constexpr int MAX_POLL_MS = 15000;
+    static constexpr int LINE_CACHE_SIZE = 4096;     // 缓存的已解码行数
+    static constexpr int MAX_LINE_BYTES = 64 * 1024; // 超长行只显示开头
+
+signals:
+    // firstChangedLine 之前的行不变；firstChangedLine 可能是被补全的原末行
+    void linesAppended(int firstChangedLine, int lineCount);
+    void jobStatusChanged(const QString& status);
+    void artifactLinkFound(const BuildArtifact& artifact);
+    void finished();
+    void errorOccurred(const QString& message);
+
+private:
+    void poll();
+    void fetch();
+    void listen();
+    void onReadyRead();
+    void onFetchFinished();
+    void scheduleNext(bool grew);
+    bool append(const char* data, qint64 size);
+    void notifyAppended();
+
+    GitLabApi* m_gitLabApi;
+    QTimer* m_pollTimer;
+    QNetworkReply* m_reply = nullptr;
+    QTemporaryFile* m_file = nullptr;
+
+    int m_jobId = 0;
+    QString m_jobStatus;
+    bool m_running = false;
+    bool m_finalFetch = false;      // Job已结束，本次拉取后停止
+    int m_generation = 0;           // stop()/start() 后丢弃旧的响应
+    int m_pollIntervalMs = POLL_MS;
+
+    qint64 m_size = 0;              // 已写入临时文件的字节数
+    qint64 m_fetchStartSize = 0;    // 本次请求的起始偏移
+    qint64 m_skip = 0;              // 服务器忽略 Range 时还需跳过的字节数
+    int m_redirects = 0;            // 本次拉取已跟随的重定向次数
+    bool m_statusChecked = false;   // 本次响应的状态码已检查
+    int m_notifiedLines = 0;        // 上次通知时的行数
+    qint64 m_notifiedSize = 0;      // 上次通知时的字节数
+
+    QVector<qint64> m_lineStarts;   // 每行在临时文件中的起始偏移
+    QCache<int, QString> m_lineCache;
+    ArtifactLinkExtractor m_linkExtractor;
+};
+
+#endif // JOBLOGTAILER_H
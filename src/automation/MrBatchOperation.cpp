@@ -0,0 +1,180 @@
+#include "MrBatchOperation.h"
+#include "api/GitLabApi.h"
+#include "utils/Logger.h"
+#include <QTimer>
+
+MrBatchOperation::MrBatchOperation(GitLabApi* gitLabApi, Action action, const QList<int>& mrIids, QObject* parent)
+    : QObject(parent)
+    , m_gitLabApi(gitLabApi)
+    , m_action(action)
+    , m_resumeTimer(new QTimer(this))
+{
+    m_resumeTimer->setSingleShot(true);
+    connect(m_resumeTimer, &QTimer::timeout, this, &MrBatchOperation::startNext);
+
+    for (int iid : mrIids) {
+        if (iid <= 0 || m_items.contains(iid)) {
+            continue;
+        }
+        Item item;
+        item.iid = iid;
+        m_items.insert(iid, item);
+        m_order.append(iid);
+    }
+}
+
+QString MrBatchOperation::actionName(Action action) {
+    switch (action) {
+    case Action::Approve:
+        return QString::fromUtf8("批准");
+    case Action::Merge:
+        return QString::fromUtf8("合并");
+    case Action::Close:
+        return QString::fromUtf8("关闭");
+    }
+    return QString();
+}
+
+void MrBatchOperation::start() {
+    LOG_INFO("批量MR操作开始", {{"action", actionName(m_action)}, {"count", m_order.size()}});
+    m_queue = m_order;
+    emit progressChanged(0, totalCount());
+    startNext();
+}
+
+void MrBatchOperation::cancel() {
+    if (m_finished) {
+        return;
+    }
+    m_canceled = true;
+    m_queue.clear();
+    m_resumeTimer->stop();
+
+    for (int iid : m_order) {
+        const State state = m_items[iid].state;
+        if (state == State::Succeeded || state == State::Failed || state == State::Canceled) {
+            continue;
+        }
+        if (state == State::Running) {
+            // 取消 future 会中止网络请求
+            m_inFlight.take(iid).cancel();
+        }
+        setState(iid, State::Canceled);
+    }
+    startNext();  // 触发结束
+}
+
+int MrBatchOperation::countInState(State state) const {
+    int count = 0;
+    for (const Item& item : m_items) {
+        if (item.state == state) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+int MrBatchOperation::finishedCount() const {
+    return countInState(State::Succeeded) + countInState(State::Failed) + countInState(State::Canceled);
+}
+
+QFuture<MrResponse> MrBatchOperation::send(int iid) {
+    switch (m_action) {
+    case Action::Approve:
+        return m_gitLabApi->approveMergeRequest(iid);
+    case Action::Merge:
+        return m_gitLabApi->mergeMergeRequest(iid, true);
+    case Action::Close:
+        return m_gitLabApi->closeMergeRequest(iid);
+    }
+    return QFuture<MrResponse>();
+}
+
+void MrBatchOperation::startNext() {
+    const int limit = m_action == Action::Merge ? MAX_CONCURRENT_MERGES : MAX_CONCURRENT;
+    while (!m_canceled && !m_resumeTimer->isActive() && m_inFlight.size() < limit && !m_queue.isEmpty()) {
+        begin(m_queue.takeFirst());
+    }
+
+    if (!m_finished && isFinished()) {
+        m_finished = true;
+        LOG_INFO("批量MR操作结束", {{"action", actionName(m_action)}, {"succeeded", countInState(State::Succeeded)},
+                                    {"failed", countInState(State::Failed)}, {"canceled", countInState(State::Canceled)}});
+        emit finished();
+    }
+}
+
+void MrBatchOperation::begin(int iid) {
+    Item& item = m_items[iid];
+    ++item.attempts;
+    setState(iid, State::Running);
+
+    QFuture<MrResponse> future = send(iid);
+    m_inFlight.insert(iid, future);
+    future.then(this, [this, iid](const MrResponse&) {
+        onSucceeded(iid);
+    }).onFailed(this, [this, iid](const ApiError& error) {
+        onFailed(iid, error);
+    });
+}
+
+void MrBatchOperation::onSucceeded(int iid) {
+    if (!m_inFlight.remove(iid)) {
+        return;  // 已取消
+    }
+    m_items[iid].errorMessage.clear();
+    setState(iid, State::Succeeded);
+    startNext();
+}
+
+void MrBatchOperation::onFailed(int iid, const ApiError& error) {
+    if (!m_inFlight.remove(iid)) {
+        return;  // 已取消
+    }
+    Item& item = m_items[iid];
+    item.errorMessage = error.message();
+
+    if (isRetryable(error) && item.attempts < MAX_ATTEMPTS && !m_canceled) {
+        const int delayMs = error.retryAfterSeconds() > 0
+            ? qMin(error.retryAfterSeconds() * 1000, MAX_RETRY_DELAY_MS)
+            : qMin(RETRY_BASE_DELAY_MS << (item.attempts - 1), MAX_RETRY_DELAY_MS);
+        LOG_WARNING("MR操作被限流或临时失败，稍后重试", {{"mr", iid}, {"status", error.httpStatus()},
+                                                       {"attempt", item.attempts}, {"delay_ms", delayMs}});
+        if (error.isRateLimited() && m_resumeTimer->remainingTime() < delayMs) {
+            m_resumeTimer->start(delayMs);  // 其他请求大概率同样被限流，一起暂停
+        }
+        setState(iid, State::Waiting);
+        QTimer::singleShot(delayMs, this, [this, iid]() {
+            if (m_items[iid].state != State::Waiting || m_canceled) {
+                return;
+            }
+            setState(iid, State::Queued);
+            m_queue.prepend(iid);
+            startNext();
+        });
+        startNext();
+        return;
+    }
+
+    LOG_ERROR("MR操作失败", {{"mr", iid}, {"action", actionName(m_action)}, {"status", error.httpStatus()},
+                             {"error", error.message()}});
+    setState(iid, State::Failed);
+    startNext();
+}
+
+bool MrBatchOperation::isRetryable(const ApiError& error) const {
+    if (error.isRateLimited()) {
+        return true;  // 请求未被处理
+    }
+    if (m_action == Action::Merge) {
+        return false;
+    }
+    const int status = error.httpStatus();
+    return error.isNetworkError() || status == 502 || status == 503 || status == 504;
+}
+
+void MrBatchOperation::setState(int iid, State state) {
+    m_items[iid].state = state;
+    emit itemChanged(iid);
+    emit progressChanged(finishedCount(), totalCount());
+}
@@ -0,0 +1,98 @@
+#ifndef MRBATCHOPERATION_H
+#define MRBATCHOPERATION_H
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QFuture>
+#include "api/ApiModels.h"
+
+class GitLabApi;
+class ApiError;
+class QTimer;
+
+/**
+ * @brief 批量批准/合并/关闭MR
+ *
+ * 请求经 GitLabApi 流水线发出，同时最多 MAX_CONCURRENT 个（合并为 MAX_CONCURRENT_MERGES 个：
+ * 合并到同一目标分支的请求在服务器上会相互等待），一个完成立即补发下一个。
+ * 被限流（429）的MR按 Retry-After 或指数退避重新排队，期间暂停发出新请求；
+ * 批准与关闭在网络错误、502/503/504 时同样重试，合并可能已在服务器生效，只在限流时重试。
+ * 进度与结果通过 itemChanged / progressChanged 汇总，全部结束后发出 finished。
+ * 一个实例只运行一次。
+ */
+class MrBatchOperation : public QObject {
+    Q_OBJECT
+
+public:
+    enum class Action {
+        Approve,
+        Merge,
+        Close
+    };
+
+    enum class State {
+        Queued,
+        Running,
+        Waiting,    // 被限流或临时错误，等待重试
+        Succeeded,
+        Failed,
+        Canceled
+    };
+
+    struct Item {
+        int iid = 0;
+        State state = State::Queued;
+        int attempts = 0;
+        QString errorMessage;
+    };
+
+    MrBatchOperation(GitLabApi* gitLabApi, Action action, const QList<int>& mrIids, QObject* parent = nullptr);
+
+    void start();
+    // 排队与等待重试的MR不再执行；已发出的请求被中止，但服务器可能已处理
+    void cancel();
+
+    Action action() const { return m_action; }
+    static QString actionName(Action action);  // "批准" / "合并" / "关闭"
+
+    QList<int> mrIids() const { return m_order; }
+    Item item(int iid) const { return m_items.value(iid); }
+    int totalCount() const { return m_order.size(); }
+    int countInState(State state) const;
+    int finishedCount() const;
+    bool isFinished() const { return finishedCount() == totalCount(); }
+
+    static constexpr int MAX_CONCURRENT = 4;
+    static constexpr int MAX_CONCURRENT_MERGES = 2;
+    static constexpr int MAX_ATTEMPTS = 5;
+    static constexpr int RETRY_BASE_DELAY_MS = 1000;
+    static constexpr int MAX_RETRY_DELAY_MS = 60000;
+
+signals:
+    void itemChanged(int iid);
+    void progressChanged(int finishedCount, int totalCount);
+    void finished();
+
+private:
+    QFuture<MrResponse> send(int iid);
+    void startNext();
+    void begin(int iid);
+    void onSucceeded(int iid);
+    void onFailed(int iid, const ApiError& error);
+    bool isRetryable(const ApiError& error) const;
+    void setState(int iid, State state);
+
+    GitLabApi* m_gitLabApi;
+    Action m_action;
+    QTimer* m_resumeTimer;      // 被限流后暂停发出新请求
+
+    QList<int> m_order;         // 按选择顺序
+    QHash<int, Item> m_items;
+    QList<int> m_queue;
+    QHash<int, QFuture<MrResponse>> m_inFlight;
+    bool m_canceled = false;
+    bool m_finished = false;
+};
+
+#endif // MRBATCHOPERATION_H
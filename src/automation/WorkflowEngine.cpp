@@ -1,4 +1,358 @@
 #include "WorkflowEngine.h"
+#include "api/GitLabApi.h"
+#include "utils/Logger.h"
+#include "utils/TraceRecorder.h"
+#include <QTimer>
 
-WorkflowEngine::WorkflowEngine(QObject* parent) : QObject(parent) {
-}
\ No newline at end of file
+WorkflowEngine::WorkflowEngine(const QString& name, QObject* parent)
+    : QObject(parent)
+    , m_name(name)
+{
+}
+
+void WorkflowEngine::addStep(const WorkflowStep& step) {
+    if (m_started) {
+        LOG_WARNING("工作流已开始，忽略新增步骤", {{"workflow", m_name}, {"step", step.id}});
+        return;
+    }
+    m_index.insert(step.id, m_steps.size());
+    m_steps.append(step);
+    m_runtime.append(Runtime());
+}
+
+QFuture<QVariant> WorkflowEngine::requireSuccess(QFuture<bool> future, const QString& failureMessage) {
+    return future.then([failureMessage](bool success) {
+        if (!success) {
+            throw WorkflowError(failureMessage);
+        }
+        return QVariant(true);
+    });
+}
+
+bool WorkflowEngine::validate(QString& error) const {
+    if (m_index.size() != m_steps.size()) {
+        error = QString::fromUtf8("步骤ID重复");
+        return false;
+    }
+    // Kahn 拓扑排序：排不完的步骤在环上
+    QVector<int> pendingDeps(m_steps.size(), 0);
+    QVector<QVector<int>> dependents(m_steps.size());
+    for (int i = 0; i < m_steps.size(); ++i) {
+        for (const QString& dep : m_steps[i].dependsOn) {
+            const int depIndex = m_index.value(dep, -1);
+            if (depIndex < 0) {
+                error = QString::fromUtf8("步骤 %1 依赖未知步骤 %2").arg(m_steps[i].id, dep);
+                return false;
+            }
+            ++pendingDeps[i];
+            dependents[depIndex].append(i);
+        }
+    }
+    QVector<int> ready;
+    for (int i = 0; i < m_steps.size(); ++i) {
+        if (pendingDeps[i] == 0) {
+            ready.append(i);
+        }
+    }
+    int sorted = 0;
+    while (!ready.isEmpty()) {
+        const int i = ready.takeLast();
+        ++sorted;
+        for (int dependent : dependents[i]) {
+            if (--pendingDeps[dependent] == 0) {
+                ready.append(dependent);
+            }
+        }
+    }
+    if (sorted != m_steps.size()) {
+        error = QString::fromUtf8("步骤依赖存在环");
+        return false;
+    }
+    return true;
+}
+
+bool WorkflowEngine::start() {
+    if (m_started) {
+        return false;
+    }
+    QString error;
+    if (!validate(error)) {
+        LOG_ERROR("工作流定义无效", {{"workflow", m_name}, {"error", error}});
+        return false;
+    }
+
+    m_started = true;
+    m_running = true;
+    m_elapsed.start();
+    LOG_INFO("工作流开始", {{"workflow", m_name}, {"steps", m_steps.size()}});
+    emit progressChanged(0, m_steps.size());
+    schedule();
+    return true;
+}
+
+void WorkflowEngine::cancel() {
+    if (!m_running) {
+        return;
+    }
+    m_canceled = true;
+    for (int i = 0; i < m_steps.size(); ++i) {
+        Runtime& rt = m_runtime[i];
+        if (isTerminal(rt.state)) {
+            continue;
+        }
+        ++rt.token;
+        if (rt.timer) {
+            rt.timer->stop();
+        }
+        if (rt.state == StepState::Running) {
+            rt.future.cancel();
+            endTrace(i, false);
+        }
+        setState(i, StepState::Canceled);
+    }
+    finishIfDone();
+}
+
+QStringList WorkflowEngine::stepIds() const {
+    QStringList ids;
+    for (const WorkflowStep& step : m_steps) {
+        ids << step.id;
+    }
+    return ids;
+}
+
+WorkflowEngine::StepState WorkflowEngine::state(const QString& id) const {
+    const int index = m_index.value(id, -1);
+    return index < 0 ? StepState::Pending : m_runtime[index].state;
+}
+
+QVariant WorkflowEngine::result(const QString& id) const {
+    const int index = m_index.value(id, -1);
+    return index < 0 ? QVariant() : m_runtime[index].result;
+}
+
+QString WorkflowEngine::errorMessage(const QString& id) const {
+    const int index = m_index.value(id, -1);
+    return index < 0 ? QString() : m_runtime[index].errorMessage;
+}
+
+int WorkflowEngine::attempts(const QString& id) const {
+    const int index = m_index.value(id, -1);
+    return index < 0 ? 0 : m_runtime[index].attempts;
+}
+
+int WorkflowEngine::finishedCount() const {
+    int count = 0;
+    for (const Runtime& rt : m_runtime) {
+        if (isTerminal(rt.state)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+QString WorkflowEngine::progressText() const {
+    QStringList active;
+    for (int i = 0; i < m_steps.size(); ++i) {
+        const Runtime& rt = m_runtime[i];
+        if (rt.state == StepState::Running || rt.state == StepState::Retrying) {
+            active << (rt.attempts > 1 || rt.state == StepState::Retrying
+                ? QString::fromUtf8("%1（重试 %2/%3）").arg(m_steps[i].label).arg(rt.attempts).arg(m_steps[i].maxAttempts)
+                : m_steps[i].label);
+        }
+    }
+    if (active.isEmpty()) {
+        return QString::fromUtf8("%1（%2/%3）").arg(m_name).arg(finishedCount()).arg(m_steps.size());
+    }
+    return QString::fromUtf8("正在%1...（%2/%3）")
+        .arg(active.join(QString::fromUtf8("、")))
+        .arg(finishedCount())
+        .arg(m_steps.size());
+}
+
+bool WorkflowEngine::isTerminal(StepState state) const {
+    return state == StepState::Succeeded || state == StepState::Failed || state == StepState::Skipped
+        || state == StepState::Blocked || state == StepState::Canceled;
+}
+
+void WorkflowEngine::schedule() {
+    // 一个步骤被跳过或阻塞后，依赖它的步骤可能在同一轮中也能确定，重复扫描直到没有变化
+    bool changed = true;
+    while (changed && !m_canceled) {
+        changed = false;
+        for (int i = 0; i < m_steps.size(); ++i) {
+            if (m_runtime[i].state != StepState::Pending) {
+                continue;
+            }
+
+            bool ready = true;
+            bool blocked = false;
+            for (const QString& dep : m_steps[i].dependsOn) {
+                const int depIndex = m_index.value(dep);
+                const StepState depState = m_runtime[depIndex].state;
+                if (depState == StepState::Succeeded || depState == StepState::Skipped
+                    || (depState == StepState::Failed && m_steps[depIndex].optional)) {
+                    continue;
+                }
+                if (isTerminal(depState)) {
+                    blocked = true;
+                } else {
+                    ready = false;
+                }
+            }
+
+            if (blocked) {
+                m_runtime[i].errorMessage = QString::fromUtf8("依赖的步骤未成功");
+                setState(i, StepState::Blocked);
+                changed = true;
+            } else if (ready) {
+                if (m_steps[i].condition && !m_steps[i].condition()) {
+                    setState(i, StepState::Skipped);
+                    changed = true;
+                } else {
+                    launch(i);
+                }
+            }
+        }
+    }
+    finishIfDone();
+}
+
+void WorkflowEngine::launch(int index) {
+    const WorkflowStep& step = m_steps[index];
+    Runtime& rt = m_runtime[index];
+    ++rt.attempts;
+    const int token = ++rt.token;
+    rt.errorMessage.clear();
+    rt.started.start();
+
+    TraceRecorder& tracer = TraceRecorder::instance();
+    if (tracer.isEnabled()) {
+        rt.traceId = tracer.nextId();
+        tracer.asyncBegin("workflow", step.label, rt.traceId, {{"workflow", m_name}, {"attempt", rt.attempts}});
+    }
+
+    setState(index, StepState::Running);
+    if (m_canceled) {
+        return;  // stepStateChanged 的处理中取消了工作流
+    }
+    rt.future = step.run();
+
+    if (step.timeoutMs > 0) {
+        if (!rt.timer) {
+            rt.timer = new QTimer(this);
+            rt.timer->setSingleShot(true);
+        }
+        rt.timer->disconnect(this);
+        connect(rt.timer, &QTimer::timeout, this, [this, index, token]() {
+            Runtime& current = m_runtime[index];
+            if (current.token != token || current.state != StepState::Running) {
+                return;
+            }
+            QFuture<QVariant> future = current.future;
+            onAttemptFailed(index, QString::fromUtf8("超时（%1 秒）").arg(m_steps[index].timeoutMs / 1000.0));
+            future.cancel();
+        });
+        rt.timer->start(step.timeoutMs);
+    }
+
+    rt.future.then(this, [this, index, token](QFuture<QVariant> future) {
+        onAttemptFinished(index, token, future);
+    }).onCanceled(this, [this, index, token]() {
+        // 步骤的 future 被取消（如 GitService 取消待执行的操作）
+        if (m_runtime[index].token == token && m_runtime[index].state == StepState::Running) {
+            onAttemptFailed(index, QString::fromUtf8("操作已取消"));
+        }
+    });
+}
+
+void WorkflowEngine::onAttemptFinished(int index, int token, QFuture<QVariant> future) {
+    Runtime& rt = m_runtime[index];
+    if (rt.token != token || rt.state != StepState::Running) {
+        return;
+    }
+    if (future.isCanceled()) {
+        onAttemptFailed(index, QString::fromUtf8("操作已取消"));
+        return;
+    }
+
+    try {
+        rt.result = future.result();
+    } catch (const ApiError& error) {
+        onAttemptFailed(index, error.message());
+        return;
+    } catch (const WorkflowError& error) {
+        onAttemptFailed(index, error.message());
+        return;
+    } catch (const std::exception& error) {
+        onAttemptFailed(index, QString::fromUtf8(error.what()));
+        return;
+    } catch (...) {
+        onAttemptFailed(index, QString::fromUtf8("未知错误"));
+        return;
+    }
+
+    if (rt.timer) {
+        rt.timer->stop();
+    }
+    endTrace(index, true);
+    setState(index, StepState::Succeeded);
+    schedule();
+}
+
+void WorkflowEngine::onAttemptFailed(int index, const QString& message) {
+    const WorkflowStep& step = m_steps[index];
+    Runtime& rt = m_runtime[index];
+    const int token = ++rt.token;  // 本次尝试之后到达的回调一律丢弃
+    rt.errorMessage = message;
+    if (rt.timer) {
+        rt.timer->stop();
+    }
+    endTrace(index, false);
+
+    if (rt.attempts < step.maxAttempts && !m_canceled) {
+        const int delayMs = step.retryDelayMs * (1 << qMin(rt.attempts - 1, 10));
+        LOG_WARNING("工作流步骤失败，稍后重试", {{"workflow", m_name}, {"step", step.id}, {"attempt", rt.attempts},
+                                                  {"delayMs", delayMs}, {"error", message}});
+        setState(index, StepState::Retrying);
+        QTimer::singleShot(delayMs, this, [this, index, token]() {
+            if (m_runtime[index].token == token && m_runtime[index].state == StepState::Retrying && !m_canceled) {
+                launch(index);
+            }
+        });
+        return;
+    }
+
+    LOG_WARNING("工作流步骤失败", {{"workflow", m_name}, {"step", step.id}, {"attempts", rt.attempts},
+                                    {"optional", step.optional}, {"error", message}});
+    if (!step.optional && m_failedStep.isEmpty()) {
+        m_failedStep = step.id;
+    }
+    setState(index, StepState::Failed);
+    schedule();
+}
+
+void WorkflowEngine::setState(int index, StepState state) {
+    m_runtime[index].state = state;
+    emit stepStateChanged(m_steps[index].id, state);
+    emit progressChanged(finishedCount(), m_steps.size());
+}
+
+void WorkflowEngine::endTrace(int index, bool success) {
+    Runtime& rt = m_runtime[index];
+    if (rt.traceId != 0) {
+        TraceRecorder::instance().asyncEnd("workflow", m_steps[index].label, rt.traceId, {{"success", success}});
+        rt.traceId = 0;
+    }
+}
+
+void WorkflowEngine::finishIfDone() {
+    if (!m_running || finishedCount() != m_steps.size()) {
+        return;
+    }
+    m_running = false;
+    const bool success = !m_canceled && m_failedStep.isEmpty();
+    LOG_INFO("工作流结束", {{"workflow", m_name}, {"success", success}, {"canceled", m_canceled},
+                            {"failedStep", m_failedStep}, {"ms", m_elapsed.elapsed()}});
+    emit finished(success);
+}
@@ -2,11 +2,146 @@
 #define WORKFLOWENGINE_H
 
 #include <QObject>
+#include <QException>
+#include <QFuture>
+#include <QVariant>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QElapsedTimer>
+#include <functional>
 
+class QTimer;
+
+/**
+ * @brief 工作流步骤失败（如Git操作返回 false）
+ */
+class WorkflowError : public QException {
+public:
+    explicit WorkflowError(const QString& message) : m_message(message) {}
+
+    void raise() const override { throw *this; }
+    WorkflowError* clone() const override { return new WorkflowError(*this); }
+
+    QString message() const { return m_message; }
+
+private:
+    QString m_message;
+};
+
+/**
+ * @brief 工作流中的一个步骤
+ *
+ * run 在UI线程调用，返回异步操作的 future（GitService / GitLabApi 的异步接口），结果保存为步骤结果。
+ * future 带异常（ApiError、WorkflowError 等）或被取消时步骤失败。
+ */
+struct WorkflowStep {
+    QString id;
+    QString label;                          // 进度显示，如 "推送到远程仓库"
+    QStringList dependsOn;                  // 全部完成后才开始
+    std::function<QFuture<QVariant>()> run;
+    std::function<bool()> condition;        // 依赖完成后求值，返回 false 时跳过；为空时总是执行
+    int timeoutMs = 0;                      // 单次尝试的超时，0 为不限
+    int maxAttempts = 1;
+    int retryDelayMs = 1000;                // 第 n 次重试前等待 retryDelayMs * 2^(n-1)
+    bool optional = false;                  // 失败不影响依赖它的步骤，也不算工作流失败
+};
+
+/**
+ * @brief 多步骤 Git/GitLab 工作流的依赖图执行器
+ *
+ * 步骤声明依赖后由引擎调度：依赖已完成的步骤立即开始，互不依赖的步骤（如 fetch、加载成员、冲突检测）并发执行。
+ * 单次尝试超时即视为失败并取消其 future（底层操作不支持取消时结果被丢弃）；失败后按指数退避重试，
+ * 用尽次数的必需步骤使依赖它的步骤不再执行（Blocked），工作流以失败结束。
+ * 每次状态变化发出 stepStateChanged 与 progressChanged，界面用 progressText() 显示进度。
+ * 一个实例只运行一次，finished 之后可 deleteLater。
+ */
 class WorkflowEngine : public QObject {
     Q_OBJECT
+
 public:
-    explicit WorkflowEngine(QObject* parent = nullptr);
+    enum class StepState {
+        Pending,
+        Running,
+        Retrying,   // 等待重试
+        Succeeded,
+        Failed,
+        Skipped,    // condition 返回 false
+        Blocked,    // 依赖的必需步骤失败，未执行
+        Canceled
+    };
+    Q_ENUM(StepState)
+
+    explicit WorkflowEngine(const QString& name, QObject* parent = nullptr);
+
+    // start() 之前调用
+    void addStep(const WorkflowStep& step);
+
+    // 检查步骤ID与依赖（重复、未知依赖、环）后开始执行；检查失败时返回 false，不发出 finished
+    bool start();
+    void cancel();
+
+    bool isRunning() const { return m_running; }
+    QString name() const { return m_name; }
+
+    QStringList stepIds() const;
+    StepState state(const QString& id) const;
+    QVariant result(const QString& id) const;
+    QString errorMessage(const QString& id) const;
+    int attempts(const QString& id) const;
+    QString failedStep() const { return m_failedStep; }  // 第一个失败的必需步骤
+
+    int stepCount() const { return m_steps.size(); }
+    int finishedCount() const;
+    // 如 "正在推送到远程仓库、检测同步冲突...（1/3）"
+    QString progressText() const;
+
+    // 把异步操作的结果转为步骤结果
+    template <typename T>
+    static QFuture<QVariant> toStepResult(QFuture<T> future) {
+        return future.then([](const T& value) { return QVariant::fromValue(value); });
+    }
+    // Git 操作返回 false 时步骤失败
+    static QFuture<QVariant> requireSuccess(QFuture<bool> future, const QString& failureMessage);
+
+signals:
+    void stepStateChanged(const QString& id, WorkflowEngine::StepState state);
+    void progressChanged(int finishedSteps, int totalSteps);
+    void finished(bool success);
+
+private:
+    struct Runtime {
+        StepState state = StepState::Pending;
+        QVariant result;
+        QString errorMessage;
+        int attempts = 0;
+        int token = 0;              // 每次尝试递增，丢弃过期的回调
+        QFuture<QVariant> future;
+        QTimer* timer = nullptr;
+        QElapsedTimer started;
+        quint64 traceId = 0;
+    };
+
+    bool validate(QString& error) const;
+    void schedule();
+    void launch(int index);
+    void onAttemptFinished(int index, int token, QFuture<QVariant> future);
+    void onAttemptFailed(int index, const QString& message);
+    void setState(int index, StepState state);
+    void endTrace(int index, bool success);
+    void finishIfDone();
+    bool isTerminal(StepState state) const;
+
+    QString m_name;
+    QVector<WorkflowStep> m_steps;
+    QVector<Runtime> m_runtime;
+    QHash<QString, int> m_index;
+
+    bool m_running = false;
+    bool m_started = false;
+    bool m_canceled = false;
+    QString m_failedStep;
+    QElapsedTimer m_elapsed;
 };
 
-#endif
\ No newline at end of file
+#endif // WORKFLOWENGINE_H
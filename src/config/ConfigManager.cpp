@@ -1,142 +1,324 @@
 #include "ConfigManager.h"
+#include "utils/Logger.h"
 #include <QCoreApplication>
 #include <QByteArray>
+#include <QTimer>
 
 ConfigManager& ConfigManager::instance() {
     static ConfigManager instance;
     return instance;
 }
 
-ConfigManager::ConfigManager() {
+ConfigManager::ConfigManager()
+    : m_persistTimer(new QTimer(this))
+{
     // QSettings会自动使用组织名和应用名创建配置文件
     // 需要在main.cpp中设置QCoreApplication::setOrganizationName/setApplicationName
     m_settings = new QSettings(QSettings::IniFormat, QSettings::UserScope,
                                "GitPilot", "GitPilot");
+    
+    std::atomic_store(&m_current, std::make_shared<const Snapshot>(loadSnapshot()));
+    
+    m_persistPool.setMaxThreadCount(1);
+    m_persistTimer->setSingleShot(true);
+    m_persistTimer->setInterval(PERSIST_DELAY_MS);
+    connect(m_persistTimer, &QTimer::timeout, this, &ConfigManager::persistAsync);
+    
+    if (QCoreApplication* app = QCoreApplication::instance()) {
+        // 通知与写盘定时器都在UI线程处理，即使第一次访问发生在工作线程
+        moveToThread(app->thread());
+        connect(app, &QCoreApplication::aboutToQuit, this, &ConfigManager::sync);
+    }
 }
 
 ConfigManager::~ConfigManager() {
+    sync();
     delete m_settings;
 }
 
+ConfigManager::Snapshot ConfigManager::loadSnapshot() {
+    Snapshot snapshot;
+    snapshot.setupCompleted = m_settings->contains("Setup/Completed");
+    snapshot.gitLabUrl = m_settings->value("GitLab/Url", DEFAULT_GITLAB_URL).toString();
+    
+    QString encrypted = m_settings->value("GitLab/Token").toString();
+    if (!encrypted.isEmpty()) {
+        snapshot.gitLabToken = decryptToken(encrypted);
+    }
+    
+    snapshot.currentProjectId = m_settings->value("Project/CurrentId").toString();
+    snapshot.currentProjectName = m_settings->value("Project/CurrentName").toString();
+    snapshot.repoPath = m_settings->value("Project/RepoPath").toString();
+    
+    QStringList defaultBranches = {"main", "master", "develop", "internal"};
+    snapshot.protectedBranches = m_settings->value("Branches/Protected", defaultBranches).toStringList();
+    snapshot.databaseBranch = m_settings->value("Branches/Database", DEFAULT_DATABASE_BRANCH).toString();
+    
+    snapshot.artifactPattern = m_settings->value("Build/ArtifactPattern", DEFAULT_ARTIFACT_PATTERN).toString();
+    snapshot.pollInterval = m_settings->value("Build/PollInterval", DEFAULT_POLL_INTERVAL).toInt();
+    
+    snapshot.loggingEnabled = m_settings->value("Logging/Enabled", true).toBool();
+    snapshot.logLevel = m_settings->value("Logging/Level", "info").toString();
+    snapshot.asyncLogging = m_settings->value("Logging/Async", true).toBool();
+    
+    snapshot.fsMonitor = m_settings->value("Git/FsMonitor", true).toBool();
+    return snapshot;
+}
+
+// ========== 修改与写盘 ==========
+
+template <typename T>
+void ConfigManager::update(Key key, T Snapshot::*field, const T& value) {
+    QMutexLocker locker(&m_writeMutex);
+    
+    // 写者已被 m_writeMutex 串行化，这里读到的就是最新快照
+    const std::shared_ptr<const Snapshot> current = snapshot();
+    if ((*current).*field == value) {
+        return;
+    }
+    
+    auto next = std::make_shared<Snapshot>(*current);
+    (*next).*field = value;
+    std::atomic_store(&m_current, std::shared_ptr<const Snapshot>(std::move(next)));
+    
+    m_unnotified |= key;
+    m_unsaved |= key;
+    if (!m_flushScheduled) {
+        m_flushScheduled = true;
+        QMetaObject::invokeMethod(this, &ConfigManager::flushChanges, Qt::QueuedConnection);
+    }
+}
+
+void ConfigManager::flushChanges() {
+    Keys changed;
+    {
+        QMutexLocker locker(&m_writeMutex);
+        changed = m_unnotified;
+        m_unnotified = Keys();
+        m_flushScheduled = false;
+    }
+    
+    // 每次修改都重新计时，连续修改只写一次盘
+    m_persistTimer->start();
+    if (changed) {
+        emit configChanged(changed);
+    }
+}
+
+void ConfigManager::persistAsync() {
+    Keys keys;
+    Snapshot current;
+    {
+        QMutexLocker locker(&m_writeMutex);
+        keys = m_unsaved;
+        m_unsaved = Keys();
+        current = *snapshot();
+    }
+    if (!keys) {
+        return;
+    }
+    
+    m_persistPool.start([this, current, keys]() {
+        writeSettings(current, keys);
+    });
+}
+
+void ConfigManager::sync() {
+    m_persistTimer->stop();
+    
+    Keys keys;
+    Snapshot current;
+    {
+        QMutexLocker locker(&m_writeMutex);
+        keys = m_unsaved;
+        m_unsaved = Keys();
+        current = *snapshot();
+    }
+    
+    // 等待已提交的写盘任务，保证顺序
+    m_persistPool.waitForDone();
+    if (keys) {
+        writeSettings(current, keys);
+    }
+}
+
+void ConfigManager::writeSettings(const Snapshot& snapshot, Keys keys) {
+    if (keys & SetupCompleted) {
+        m_settings->setValue("Setup/Completed", snapshot.setupCompleted);
+    }
+    if (keys & GitLabUrl) {
+        m_settings->setValue("GitLab/Url", snapshot.gitLabUrl);
+    }
+    if (keys & GitLabToken) {
+        if (snapshot.gitLabToken.isEmpty()) {
+            m_settings->remove("GitLab/Token");
+        } else {
+            m_settings->setValue("GitLab/Token", encryptToken(snapshot.gitLabToken));
+        }
+    }
+    if (keys & CurrentProjectId) {
+        m_settings->setValue("Project/CurrentId", snapshot.currentProjectId);
+    }
+    if (keys & CurrentProjectName) {
+        m_settings->setValue("Project/CurrentName", snapshot.currentProjectName);
+    }
+    if (keys & RepoPath) {
+        m_settings->setValue("Project/RepoPath", snapshot.repoPath);
+    }
+    if (keys & ProtectedBranches) {
+        m_settings->setValue("Branches/Protected", snapshot.protectedBranches);
+    }
+    if (keys & DatabaseBranch) {
+        m_settings->setValue("Branches/Database", snapshot.databaseBranch);
+    }
+    if (keys & ArtifactPattern) {
+        m_settings->setValue("Build/ArtifactPattern", snapshot.artifactPattern);
+    }
+    if (keys & PollInterval) {
+        m_settings->setValue("Build/PollInterval", snapshot.pollInterval);
+    }
+    if (keys & LoggingEnabled) {
+        m_settings->setValue("Logging/Enabled", snapshot.loggingEnabled);
+    }
+    if (keys & LogLevel) {
+        m_settings->setValue("Logging/Level", snapshot.logLevel);
+    }
+    if (keys & AsyncLogging) {
+        m_settings->setValue("Logging/Async", snapshot.asyncLogging);
+    }
+    if (keys & FsMonitor) {
+        m_settings->setValue("Git/FsMonitor", snapshot.fsMonitor);
+    }
+    m_settings->sync();
+}
+
 // ========== 首次运行检测 ==========
 
 bool ConfigManager::isFirstRun() {
-    return !m_settings->contains("Setup/Completed");
+    return !snapshot()->setupCompleted;
 }
 
 void ConfigManager::setFirstRunCompleted() {
-    m_settings->setValue("Setup/Completed", true);
-    m_settings->sync();
+    update(SetupCompleted, &Snapshot::setupCompleted, true);
 }
 
 // ========== GitLab连接配置 ==========
 
 QString ConfigManager::getGitLabUrl() {
-    return m_settings->value("GitLab/Url", DEFAULT_GITLAB_URL).toString();
+    return snapshot()->gitLabUrl;
 }
 
 void ConfigManager::setGitLabUrl(const QString& url) {
-    m_settings->setValue("GitLab/Url", url);
-    m_settings->sync();
+    update(GitLabUrl, &Snapshot::gitLabUrl, url);
 }
 
 QString ConfigManager::getGitLabToken() {
-    QString encrypted = m_settings->value("GitLab/Token").toString();
-    if (encrypted.isEmpty()) {
-        return QString();
-    }
-    return decryptToken(encrypted);
+    return snapshot()->gitLabToken;
 }
 
 void ConfigManager::setGitLabToken(const QString& token) {
-    if (token.isEmpty()) {
-        m_settings->remove("GitLab/Token");
-    } else {
-        QString encrypted = encryptToken(token);
-        m_settings->setValue("GitLab/Token", encrypted);
-    }
-    m_settings->sync();
+    update(GitLabToken, &Snapshot::gitLabToken, token);
 }
 
 // ========== 项目配置 ==========
 
 QString ConfigManager::getCurrentProjectId() {
-    return m_settings->value("Project/CurrentId").toString();
+    return snapshot()->currentProjectId;
 }
 
 void ConfigManager::setCurrentProjectId(const QString& id) {
-    m_settings->setValue("Project/CurrentId", id);
-    m_settings->sync();
+    update(CurrentProjectId, &Snapshot::currentProjectId, id);
 }
 
 QString ConfigManager::getCurrentProjectName() {
-    return m_settings->value("Project/CurrentName").toString();
+    return snapshot()->currentProjectName;
 }
 
 void ConfigManager::setCurrentProjectName(const QString& name) {
-    m_settings->setValue("Project/CurrentName", name);
-    m_settings->sync();
+    update(CurrentProjectName, &Snapshot::currentProjectName, name);
 }
 
 QString ConfigManager::getRepoPath() {
-    return m_settings->value("Project/RepoPath").toString();
+    return snapshot()->repoPath;
 }
 
 void ConfigManager::setRepoPath(const QString& path) {
-    m_settings->setValue("Project/RepoPath", path);
-    m_settings->sync();
+    update(RepoPath, &Snapshot::repoPath, path);
 }
 
 // ========== 分支保护规则 ==========
 
 QStringList ConfigManager::getProtectedBranches() {
-    QStringList defaultBranches = {"main", "master", "develop", "internal"};
-    return m_settings->value("Branches/Protected", defaultBranches).toStringList();
+    return snapshot()->protectedBranches;
 }
 
 void ConfigManager::setProtectedBranches(const QStringList& branches) {
-    m_settings->setValue("Branches/Protected", branches);
-    m_settings->sync();
+    update(ProtectedBranches, &Snapshot::protectedBranches, branches);
 }
 
 QString ConfigManager::getDatabaseBranchName() {
-    return m_settings->value("Branches/Database", DEFAULT_DATABASE_BRANCH).toString();
+    return snapshot()->databaseBranch;
 }
 
 void ConfigManager::setDatabaseBranchName(const QString& name) {
-    m_settings->setValue("Branches/Database", name);
-    m_settings->sync();
+    update(DatabaseBranch, &Snapshot::databaseBranch, name);
 }
 
 // ========== 构建配置 ==========
 
 QString ConfigManager::getArtifactPattern() {
-    return m_settings->value("Build/ArtifactPattern", DEFAULT_ARTIFACT_PATTERN).toString();
+    return snapshot()->artifactPattern;
 }
 
 void ConfigManager::setArtifactPattern(const QString& pattern) {
-    m_settings->setValue("Build/ArtifactPattern", pattern);
-    m_settings->sync();
+    update(ArtifactPattern, &Snapshot::artifactPattern, pattern);
 }
 
 int ConfigManager::getPipelinePollInterval() {
-    return m_settings->value("Build/PollInterval", DEFAULT_POLL_INTERVAL).toInt();
+    return snapshot()->pollInterval;
 }
 
 void ConfigManager::setPipelinePollInterval(int seconds) {
-    m_settings->setValue("Build/PollInterval", seconds);
-    m_settings->sync();
+    update(PollInterval, &Snapshot::pollInterval, seconds);
 }
 
 // ========== 日志配置 ==========
 
 bool ConfigManager::isLoggingEnabled() {
-    return m_settings->value("Logging/Enabled", true).toBool();
+    return snapshot()->loggingEnabled;
 }
 
 void ConfigManager::setLoggingEnabled(bool enabled) {
-    m_settings->setValue("Logging/Enabled", enabled);
-    m_settings->sync();
+    update(LoggingEnabled, &Snapshot::loggingEnabled, enabled);
+    Logger::instance().setEnabled(enabled);
+}
+
+QString ConfigManager::getLogLevel() {
+    return snapshot()->logLevel;
+}
+
+void ConfigManager::setLogLevel(const QString& level) {
+    update(LogLevel, &Snapshot::logLevel, level);
+    Logger::instance().setMinLevel(Logger::levelFromString(level));
+}
+
+bool ConfigManager::isAsyncLoggingEnabled() {
+    return snapshot()->asyncLogging;
+}
+
+void ConfigManager::setAsyncLoggingEnabled(bool enabled) {
+    update(AsyncLogging, &Snapshot::asyncLogging, enabled);
+    Logger::instance().setAsync(enabled);
+}
+
+// ========== Git配置 ==========
+
+bool ConfigManager::isFsMonitorEnabled() {
+    return snapshot()->fsMonitor;
+}
+
+void ConfigManager::setFsMonitorEnabled(bool enabled) {
+    update(FsMonitor, &Snapshot::fsMonitor, enabled);
 }
 
 // ========== Token加密/解密 ==========
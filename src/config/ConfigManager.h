@@ -1,19 +1,77 @@
 #ifndef CONFIGMANAGER_H
 #define CONFIGMANAGER_H
 
+#include <QObject>
 #include <QString>
 #include <QStringList>
 #include <QSettings>
+#include <QMutex>
+#include <QThreadPool>
+#include <atomic>
+#include <memory>
+
+class QTimer;
 
 /**
  * @brief 配置管理器 - 单例模式
  * 使用QSettings持久化配置到用户目录
  * Windows: C:\Users\<用户名>\AppData\Roaming\GitPilot\GitPilot.ini
+ *
+ * 启动时一次性读入内存快照（Token 已解密），getter 直接读取当前快照，不访问 QSettings、不加 QMutex。
+ * setter 复制快照修改后以 shared_ptr 原子替换，旧快照在最后一个持有者释放后销毁，
+ * 因此任何线程拿到的快照在持有期间都始终有效。
+ * 修改在下一次事件循环中合并为一次 configChanged 通知，并在 PERSIST_DELAY_MS 后
+ * 由后台线程统一写盘；退出时（aboutToQuit 或析构）同步写完未保存的修改。
  */
-class ConfigManager {
+class ConfigManager : public QObject {
+    Q_OBJECT
+    
 public:
+    enum Key : quint32 {
+        GitLabUrl          = 1u << 0,
+        GitLabToken        = 1u << 1,
+        CurrentProjectId   = 1u << 2,
+        CurrentProjectName = 1u << 3,
+        RepoPath           = 1u << 4,
+        ProtectedBranches  = 1u << 5,
+        DatabaseBranch     = 1u << 6,
+        ArtifactPattern    = 1u << 7,
+        PollInterval       = 1u << 8,
+        LoggingEnabled     = 1u << 9,
+        LogLevel           = 1u << 10,
+        AsyncLogging       = 1u << 11,
+        FsMonitor          = 1u << 12,
+        SetupCompleted     = 1u << 13
+    };
+    Q_DECLARE_FLAGS(Keys, Key)
+    Q_FLAG(Keys)
+    
+    // 配置快照：所有字段均为已解析的值
+    struct Snapshot {
+        bool setupCompleted = false;
+        QString gitLabUrl;
+        QString gitLabToken;          // 明文，仅写盘时加密
+        QString currentProjectId;
+        QString currentProjectName;
+        QString repoPath;
+        QStringList protectedBranches;
+        QString databaseBranch;
+        QString artifactPattern;
+        int pollInterval = 0;
+        bool loggingEnabled = true;
+        QString logLevel;
+        bool asyncLogging = true;
+        bool fsMonitor = true;
+    };
+    
     static ConfigManager& instance();
     
+    // 当前配置快照，可在任意线程读取；持有期间不会被释放
+    std::shared_ptr<const Snapshot> snapshot() const { return std::atomic_load(&m_current); }
+    
+    // 立即写入未保存的修改（阻塞）
+    void sync();
+    
     // 首次运行检测
     bool isFirstRun();
     void setFirstRunCompleted();
@@ -53,11 +111,29 @@ public:
     bool isLoggingEnabled();
     void setLoggingEnabled(bool enabled);
     
+    // 最低日志级别：debug / info / warning / error
+    QString getLogLevel();
+    void setLogLevel(const QString& level);
+    
+    // 异步写日志（后台线程批量写入），默认开启
+    bool isAsyncLoggingEnabled();
+    void setAsyncLoggingEnabled(bool enabled);
+    
+    // Git配置：工作区状态扫描时启用 core.fsmonitor 与 core.untrackedCache（需要git 2.37+），默认开启；
+    // fsmonitor 只在 Windows 与 macOS 上生效
+    bool isFsMonitorEnabled();
+    void setFsMonitorEnabled(bool enabled);
+    
     // 默认值
     static constexpr const char* DEFAULT_GITLAB_URL = "https://gitlab.example.com";
     static constexpr const char* DEFAULT_DATABASE_BRANCH = "develop-database";
     static constexpr const char* DEFAULT_ARTIFACT_PATTERN = R"(https?://[^\s]+\.(apk|exe|zip|tar\.gz))";
     static constexpr int DEFAULT_POLL_INTERVAL = 10; // 秒
+    static constexpr int PERSIST_DELAY_MS = 500;     // 连续修改合并写盘的等待时间
+    
+signals:
+    // 同一轮事件循环内的修改合并为一次通知
+    void configChanged(ConfigManager::Keys keys);
     
 private:
     ConfigManager();
@@ -67,11 +143,33 @@ private:
     ConfigManager(const ConfigManager&) = delete;
     ConfigManager& operator=(const ConfigManager&) = delete;
     
-    QSettings* m_settings;
+    Snapshot loadSnapshot();
+    void writeSettings(const Snapshot& snapshot, Keys keys);
+    void flushChanges();
+    void persistAsync();
+    
+    // 替换快照中的一个字段；值未变化时不做任何事
+    template <typename T>
+    void update(Key key, T Snapshot::*field, const T& value);
+    
+    QSettings* m_settings;  // 只在构造时与写盘线程中使用
+    
+    // 只通过 std::atomic_load/atomic_store 访问；旧快照在最后一个读者释放后销毁
+    std::shared_ptr<const Snapshot> m_current;
+    
+    QMutex m_writeMutex;     // 串行化 setter，保护以下成员
+    Keys m_unnotified;       // 尚未发出通知的修改
+    Keys m_unsaved;          // 尚未写盘的修改
+    bool m_flushScheduled = false;
+    
+    QTimer* m_persistTimer;
+    QThreadPool m_persistPool;  // 单线程，保证写盘顺序
     
     // Token加密/解密（简单的XOR + Base64）
     QString encryptToken(const QString& token);
     QString decryptToken(const QString& encrypted);
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(ConfigManager::Keys)
+
 #endif // CONFIGMANAGER_H
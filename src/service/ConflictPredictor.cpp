@@ -0,0 +1,160 @@
+#include "ConflictPredictor.h"
+#include "RepositoryState.h"
+#include "config/ConfigManager.h"
+#include "utils/Logger.h"
+#include <QTimer>
+
+ConflictPredictor::ConflictPredictor(GitService* gitService, RepositoryState* repoState, QObject* parent)
+    : QObject(parent)
+    , m_gitService(gitService)
+    , m_repoState(repoState)
+    , m_scheduleTimer(new QTimer(this))
+{
+    m_scheduleTimer->setSingleShot(true);
+    m_scheduleTimer->setInterval(SCHEDULE_DELAY_MS);
+    connect(m_scheduleTimer, &QTimer::timeout, this, &ConflictPredictor::run);
+
+    // 提交、fetch、切换分支后 RepositoryState 都会刷新一轮
+    connect(m_repoState, &RepositoryState::refreshFinished, this, &ConflictPredictor::schedule);
+    connect(&ConfigManager::instance(), &ConfigManager::configChanged, this, [this](ConfigManager::Keys keys) {
+        if (keys & (ConfigManager::ProtectedBranches | ConfigManager::RepoPath)) {
+            if (keys & ConfigManager::RepoPath) {
+                m_predictions.clear();
+                m_cache.clear();
+            }
+            schedule();
+        }
+    });
+}
+
+void ConflictPredictor::setExtraTargets(const QStringList& targets) {
+    if (targets == m_extraTargets) {
+        return;
+    }
+    m_extraTargets = targets;
+    schedule();
+}
+
+QStringList ConflictPredictor::targets() const {
+    QStringList result = ConfigManager::instance().getProtectedBranches();
+    result += m_extraTargets;
+    result.removeDuplicates();
+    return result;
+}
+
+void ConflictPredictor::schedule() {
+    m_scheduleTimer->start();
+}
+
+void ConflictPredictor::run() {
+    if (m_running) {
+        m_rerunRequested = true;  // 本轮结束后用最新的提交再算一次
+        return;
+    }
+    if (!m_gitService->isValidRepo()) {
+        return;
+    }
+
+    const QString currentBranch = m_repoState->currentBranch();
+    QStringList branches = targets();
+    branches.removeAll(currentBranch);  // 目标分支本身无需预测
+    if (branches.isEmpty()) {
+        return;
+    }
+
+    QStringList refs = {"HEAD"};
+    for (const QString& target : branches) {
+        refs.append("refs/remotes/origin/" + target);
+    }
+
+    m_running = true;
+    m_rerunRequested = false;
+    m_gitService->resolveRefsAsync(refs).then(this, [this, branches](const QStringList& oids) {
+        const QString sourceTip = oids.value(0);
+        // 先登记全部任务，避免先完成的任务提前结束本轮
+        ++m_outstanding;
+
+        for (int i = 0; i < branches.size(); ++i) {
+            const QString& target = branches[i];
+            const QString targetTip = oids.value(i + 1);
+
+            Prediction prediction;
+            prediction.sourceTip = sourceTip;
+            prediction.targetTip = targetTip;
+            if (sourceTip.isEmpty() || targetTip.isEmpty()) {
+                setPrediction(target, prediction);  // 未出生的分支或远程没有该目标
+                continue;
+            }
+
+            const TipPair key(sourceTip, targetTip);
+            auto cached = m_cache.constFind(key);
+            if (cached != m_cache.constEnd()) {
+                setPrediction(target, cached.value());
+                continue;
+            }
+
+            const Prediction current = m_predictions.value(target);
+            if (current.sourceTip != sourceTip || current.targetTip != targetTip) {
+                prediction.status = Status::Pending;
+                setPrediction(target, prediction);
+            }
+
+            ++m_outstanding;
+            m_gitService->mergeTreeAsync(sourceTip, targetTip).then(this,
+                [this, target, key](const MergeTreeResult& result) {
+                    const Prediction computed = fromResult(key.first, key.second, result);
+                    if (computed.status != Status::Error) {
+                        if (m_cache.size() >= MAX_CACHE_ENTRIES) {
+                            m_cache.clear();
+                        }
+                        m_cache.insert(key, computed);
+                    }
+                    setPrediction(target, computed);
+                    finishRound();
+                }).onCanceled(this, [this]() {
+                    finishRound();
+                });
+        }
+
+        finishRound();
+    }).onCanceled(this, [this]() {
+        m_running = false;
+    });
+}
+
+void ConflictPredictor::finishRound() {
+    if (--m_outstanding > 0) {
+        return;
+    }
+    m_running = false;
+    if (m_rerunRequested) {
+        schedule();
+    }
+}
+
+void ConflictPredictor::setPrediction(const QString& target, const Prediction& prediction) {
+    const Prediction previous = m_predictions.value(target);
+    m_predictions.insert(target, prediction);
+    if (previous.status != prediction.status || previous.sourceTip != prediction.sourceTip
+        || previous.targetTip != prediction.targetTip || previous.conflictFiles != prediction.conflictFiles) {
+        emit predictionChanged(target);
+    }
+}
+
+ConflictPredictor::Prediction ConflictPredictor::fromResult(const QString& sourceTip, const QString& targetTip,
+                                                            const MergeTreeResult& result) {
+    Prediction prediction;
+    prediction.sourceTip = sourceTip;
+    prediction.targetTip = targetTip;
+    if (!result.ok) {
+        prediction.status = Status::Error;
+        prediction.errorMessage = result.errorMessage;
+        LOG_WARNING("冲突预测失败", {{"source", sourceTip}, {"target", targetTip}, {"error", result.errorMessage}});
+    } else if (result.hasConflict) {
+        prediction.status = Status::Conflict;
+        prediction.conflictFiles = result.conflictFiles;
+    } else {
+        prediction.status = Status::Clean;
+    }
+    return prediction;
+}
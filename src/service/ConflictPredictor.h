@@ -0,0 +1,82 @@
+#ifndef CONFLICTPREDICTOR_H
+#define CONFLICTPREDICTOR_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QPair>
+#include "GitService.h"
+
+class QTimer;
+class RepositoryState;
+
+/**
+ * @brief 后台冲突预测
+ *
+ * 每次仓库状态刷新（提交、fetch、切换分支等）后，在后台对当前分支与每个目标分支
+ * （ConfigManager 中的受保护分支 + MrZone 的目标分支）做不改动工作区的合并预检，
+ * 打开MR专区时即可直接显示冲突标记，不必等待手动检查。
+ *
+ * 比较的是 HEAD 与 refs/remotes/origin/<目标>，不主动 fetch（fetch 由用户操作或其他流程触发）。
+ * 结果按 (源提交, 目标提交) 缓存：两端都没变时不会重复计算，切回之前的分支也能立即命中。
+ */
+class ConflictPredictor : public QObject {
+    Q_OBJECT
+
+public:
+    enum class Status {
+        Unknown,   // 尚未计算，或目标分支在远程不存在
+        Pending,   // 计算中（尚无当前提交的结果）
+        Clean,
+        Conflict,
+        Error
+    };
+
+    struct Prediction {
+        Status status = Status::Unknown;
+        QString sourceTip;
+        QString targetTip;
+        QStringList conflictFiles;
+        QString errorMessage;
+    };
+
+    explicit ConflictPredictor(GitService* gitService, RepositoryState* repoState, QObject* parent = nullptr);
+
+    // MrZone 中可选的目标分支，与受保护分支合并去重
+    void setExtraTargets(const QStringList& targets);
+    QStringList targets() const;
+
+    Prediction prediction(const QString& target) const { return m_predictions.value(target); }
+
+    // 合并短时间内的多次触发后重新预测
+    void schedule();
+
+signals:
+    void predictionChanged(const QString& target);
+
+private:
+    using TipPair = QPair<QString, QString>;
+
+    void run();
+    void finishRound();
+    void setPrediction(const QString& target, const Prediction& prediction);
+    static Prediction fromResult(const QString& sourceTip, const QString& targetTip, const MergeTreeResult& result);
+
+    GitService* m_gitService;
+    RepositoryState* m_repoState;
+    QTimer* m_scheduleTimer;
+
+    QStringList m_extraTargets;
+    QHash<QString, Prediction> m_predictions;  // 目标分支 -> 当前预测
+    QHash<TipPair, Prediction> m_cache;        // (源提交, 目标提交) -> 结果
+
+    bool m_running = false;
+    bool m_rerunRequested = false;
+    int m_outstanding = 0;
+
+    static constexpr int SCHEDULE_DELAY_MS = 500;
+    static constexpr int MAX_CACHE_ENTRIES = 256;
+};
+
+#endif // CONFLICTPREDICTOR_H
@@ -0,0 +1,201 @@
+#include "GitProcessPool.h"
+#include "GitService.h"
+#include "utils/Logger.h"
+#include <QDateTime>
+
+namespace {
+    constexpr int kRequestTimeoutMs = 10000;
+    std::atomic<int> g_sessionCount{0};
+}
+
+// ========== GitBatchSession ==========
+
+GitBatchSession::GitBatchSession(const QString& repoPath)
+    : m_repoPath(repoPath)
+{
+    ++g_sessionCount;
+}
+
+GitBatchSession::~GitBatchSession() {
+    if (m_process.state() != QProcess::NotRunning) {
+        // 关闭stdin后cat-file会自行退出
+        m_process.closeWriteChannel();
+        if (!m_process.waitForFinished(500)) {
+            m_process.kill();
+            m_process.waitForFinished(500);
+        }
+    }
+    --g_sessionCount;
+}
+
+bool GitBatchSession::start() {
+    m_process.setWorkingDirectory(m_repoPath);
+    m_process.setStandardErrorFile(QProcess::nullDevice());
+    m_process.start("git", {"cat-file", "--batch-command"});
+
+    if (!m_process.waitForStarted(3000)) {
+        return false;
+    }
+
+    // 探测: 旧版本git会直接打印用法并退出
+    QByteArray header;
+    return request("info HEAD", header);
+}
+
+bool GitBatchSession::isRunning() const {
+    return m_process.state() == QProcess::Running;
+}
+
+bool GitBatchSession::request(const QByteArray& command, QByteArray& header) {
+    if (!isRunning()) {
+        return false;
+    }
+
+    m_process.write(command + '\n');
+    return readLine(header);
+}
+
+bool GitBatchSession::readContents(qint64 size, QByteArray& data) {
+    data.clear();
+    data.reserve(size);
+
+    // 内容之后还有一个换行符
+    const qint64 total = size + 1;
+    QByteArray buffer;
+    buffer.reserve(total);
+
+    while (buffer.size() < total) {
+        if (m_process.bytesAvailable() == 0 && !m_process.waitForReadyRead(kRequestTimeoutMs)) {
+            return false;
+        }
+        buffer.append(m_process.read(total - buffer.size()));
+    }
+
+    buffer.chop(1);
+    data = buffer;
+    return true;
+}
+
+bool GitBatchSession::readLine(QByteArray& line) {
+    while (!m_process.canReadLine()) {
+        if (!m_process.waitForReadyRead(kRequestTimeoutMs)) {
+            return false;
+        }
+    }
+
+    line = m_process.readLine();
+    if (line.endsWith('\n')) {
+        line.chop(1);
+    }
+    return true;
+}
+
+// ========== GitProcessPool ==========
+
+GitProcessPool& GitProcessPool::instance() {
+    static GitProcessPool instance;
+    return instance;
+}
+
+int GitProcessPool::sessionCount() const {
+    return g_sessionCount.load();
+}
+
+GitBatchSession* GitProcessPool::sessionFor(const QString& repoPath) {
+    if (!m_enabled || !m_supported || repoPath.isEmpty()) {
+        return nullptr;
+    }
+
+    GitBatchSession* session = m_sessions.hasLocalData() ? m_sessions.localData() : nullptr;
+    if (session && session->repoPath() == repoPath && session->isRunning()) {
+        return session;
+    }
+
+    // 仓库切换或进程已退出，释放旧会话
+    if (session) {
+        m_sessions.setLocalData(nullptr);
+    }
+
+    if (g_sessionCount.load() >= MAX_SESSIONS) {
+        return nullptr;
+    }
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (now < m_retryAfterMs.load()) {
+        return nullptr;
+    }
+
+    session = new GitBatchSession(repoPath);
+    if (!session->start()) {
+        delete session;
+        // 版本已知且低于 2.36 时永久回退；取不到版本或其他启动失败视为临时失败
+        const QVersionNumber version = GitService::gitVersion();
+        if (!version.isNull() && version < QVersionNumber(2, 36)) {
+            LOG_WARNING("git cat-file --batch-command 不可用，回退到普通git命令（需要git 2.36+）");
+            m_supported = false;
+        } else {
+            // 临时失败：本次回退到普通命令，稍后再试
+            LOG_WARNING("git cat-file --batch-command 启动失败，暂时回退到普通git命令",
+                        {{"repo", repoPath}, {"retry_ms", RETRY_AFTER_FAILURE_MS}});
+            m_retryAfterMs = now + RETRY_AFTER_FAILURE_MS;
+        }
+        return nullptr;
+    }
+
+    m_sessions.setLocalData(session);
+    return session;
+}
+
+QString GitProcessPool::resolve(const QString& repoPath, const QString& revision) {
+    GitBatchSession* session = sessionFor(repoPath);
+    if (!session) {
+        return QString();
+    }
+
+    QByteArray header;
+    if (!session->request("info " + revision.toUtf8(), header)) {
+        m_sessions.setLocalData(nullptr);
+        return QString();
+    }
+
+    // 响应格式: "<oid> <type> <size>"，失败时为 "<obj> missing" 或 "<obj> ambiguous"
+    QList<QByteArray> parts = header.split(' ');
+    if (parts.size() != 3) {
+        return QString();
+    }
+    return QString::fromLatin1(parts[0]);
+}
+
+bool GitProcessPool::readObject(const QString& repoPath, const QString& revision, QByteArray& data,
+                                QString* oid, QByteArray* type) {
+    GitBatchSession* session = sessionFor(repoPath);
+    if (!session) {
+        return false;
+    }
+
+    QByteArray header;
+    if (!session->request("contents " + revision.toUtf8(), header)) {
+        m_sessions.setLocalData(nullptr);
+        return false;
+    }
+
+    QList<QByteArray> parts = header.split(' ');
+    if (parts.size() != 3) {
+        return false;  // missing / ambiguous，没有后续内容
+    }
+
+    bool ok = false;
+    qint64 size = parts[2].toLongLong(&ok);
+    if (!ok || !session->readContents(size, data)) {
+        m_sessions.setLocalData(nullptr);
+        return false;
+    }
+
+    if (oid) {
+        *oid = QString::fromLatin1(parts[0]);
+    }
+    if (type) {
+        *type = parts[1];
+    }
+    return true;
+}
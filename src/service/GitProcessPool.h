@@ -0,0 +1,81 @@
+#ifndef GITPROCESSPOOL_H
+#define GITPROCESSPOOL_H
+
+#include <QString>
+#include <QByteArray>
+#include <QProcess>
+#include <QThreadStorage>
+#include <atomic>
+
+/**
+ * @brief 常驻的 git cat-file --batch-command 会话
+ * QProcess 具有线程亲和性，因此每个会话只在创建它的线程中使用
+ */
+class GitBatchSession {
+public:
+    explicit GitBatchSession(const QString& repoPath);
+    ~GitBatchSession();
+
+    bool start();
+    bool isRunning() const;
+    QString repoPath() const { return m_repoPath; }
+
+    // 发送一条命令并读取响应头（如 "<oid> <type> <size>" 或 "<obj> missing"）
+    bool request(const QByteArray& command, QByteArray& header);
+    // 读取指定长度的对象内容（包含结尾换行的消费）
+    bool readContents(qint64 size, QByteArray& data);
+
+private:
+    bool readLine(QByteArray& line);
+
+    QProcess m_process;
+    QString m_repoPath;
+};
+
+/**
+ * @brief 长驻 git 辅助进程池
+ *
+ * 对象/引用查询（rev-parse、提交信息等）不再为每次调用创建新的 git 进程，
+ * 而是发送给常驻的 `git cat-file --batch-command`。
+ * 每个调用线程最多持有一个会话，总数受 MAX_SESSIONS 限制；
+ * 超出上限、git 版本过低（< 2.36）或被禁用时，调用方应回退到普通命令。
+ * 版本满足但会话启动失败（如文件描述符耗尽、仓库路径暂不可用）只影响本次调用，
+ * RETRY_AFTER_FAILURE_MS 后再尝试启动。
+ */
+class GitProcessPool {
+public:
+    static GitProcessPool& instance();
+
+    // 解析任意 revision（HEAD、分支名、@{u} 等）到对象ID，失败返回空
+    QString resolve(const QString& repoPath, const QString& revision);
+
+    // 读取对象原始内容，可选返回对象ID与类型
+    bool readObject(const QString& repoPath, const QString& revision, QByteArray& data,
+                    QString* oid = nullptr, QByteArray* type = nullptr);
+
+    // 启用/禁用（用于基准测试对比）
+    void setEnabled(bool enabled) { m_enabled = enabled; }
+    bool isEnabled() const { return m_enabled; }
+
+    // 当前存活的会话数量
+    int sessionCount() const;
+
+    static constexpr int MAX_SESSIONS = 8;
+    static constexpr qint64 RETRY_AFTER_FAILURE_MS = 10000;
+
+private:
+    GitProcessPool() = default;
+
+    GitProcessPool(const GitProcessPool&) = delete;
+    GitProcessPool& operator=(const GitProcessPool&) = delete;
+
+    // 获取当前线程的会话，必要时启动；不可用时返回nullptr
+    GitBatchSession* sessionFor(const QString& repoPath);
+
+    QThreadStorage<GitBatchSession*> m_sessions;
+    std::atomic<bool> m_enabled{true};
+    std::atomic<bool> m_supported{true};  // git不支持--batch-command时置为false
+    std::atomic<qint64> m_retryAfterMs{0};  // 启动失败后的下次尝试时间（毫秒时间戳）
+};
+
+#endif // GITPROCESSPOOL_H
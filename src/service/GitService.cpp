@@ -1,43 +1,281 @@
 #include "GitService.h"
+#include "GitProcessPool.h"
+#include "RepositoryReader.h"
+#include "StatusCache.h"
+#include "config/ConfigManager.h"
 #include "utils/Logger.h"
+#include "utils/MetricsRegistry.h"
 #include <QProcess>
 #include <QDir>
 #include <QFileInfo>
 #include <QRegularExpression>
 #include <QSet>
+#include <QHash>
+#include <QThread>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <queue>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief 提交对象中本服务关心的字段
+ */
+struct CommitObject {
+    QStringList parents;
+    qint64 commitTime = 0;  // committer 时间戳
+    QString subject;        // 与 --pretty=format:%s 一致
+};
+
+// 解析 cat-file 返回的原始提交对象
+bool parseCommitObject(const QByteArray& raw, CommitObject& commit) {
+    int headerEnd = raw.indexOf("\n\n");
+    QByteArray headers = headerEnd >= 0 ? raw.left(headerEnd) : raw;
+    
+    for (const QByteArray& line : headers.split('\n')) {
+        if (line.startsWith("parent ")) {
+            commit.parents.append(QString::fromLatin1(line.mid(7).trimmed()));
+        } else if (line.startsWith("committer ")) {
+            // committer Name <email> 1700000000 +0800
+            QList<QByteArray> parts = line.split(' ');
+            if (parts.size() >= 2) {
+                commit.commitTime = parts[parts.size() - 2].toLongLong();
+            }
+        }
+    }
+    
+    if (headerEnd < 0) {
+        return !headers.isEmpty();
+    }
+    
+    // %s: 第一段文字，换行替换为空格
+    QByteArray message = raw.mid(headerEnd + 2);
+    int paragraphEnd = message.indexOf("\n\n");
+    QByteArray subject = paragraphEnd >= 0 ? message.left(paragraphEnd) : message;
+    commit.subject = QString::fromUtf8(subject).trimmed().replace('\n', ' ');
+    return true;
+}
+
+// 当前线程正在执行的异步任务的取消检查
+thread_local std::function<bool()> t_isCanceled;
+thread_local const QString* t_repoPath = nullptr;
+
+// 提取git子命令，跳过 -c/-C 等全局选项
+QString gitSubcommand(const QStringList& args) {
+    for (int i = 0; i < args.size(); ++i) {
+        if (args[i] == "-c" || args[i] == "-C") {
+            ++i;  // 跳过全局选项的参数
+        } else if (!args[i].startsWith('-')) {
+            return args[i];
+        }
+    }
+    return QString();
+}
+
+// 性能指标中的命令名：子命令与选项，不含路径、分支名、提交信息等参数
+// 例如 {"log", "-5", "--pretty=format:%s"} -> "git log -N --pretty"
+QString gitCommandPattern(const QStringList& args) {
+    // 这些子命令的第一个参数是二级子命令
+    static const QSet<QString> nestedCommands = {"remote", "stash", "worktree", "submodule", "notes", "bisect"};
+    static const QRegularExpression numericOption("^-\\d+$");
+    
+    QStringList parts{"git"};
+    QString subcommand;
+    bool nestedTaken = false;
+    for (int i = 0; i < args.size(); ++i) {
+        const QString& arg = args[i];
+        if (arg == "--") {
+            break;  // 之后都是路径
+        }
+        if (subcommand.isEmpty()) {
+            if (arg == "-c" || arg == "-C") {
+                ++i;
+            } else if (!arg.startsWith('-')) {
+                subcommand = arg;
+                parts << arg;
+            }
+            continue;
+        }
+        if (arg.startsWith('-')) {
+            parts << (numericOption.match(arg).hasMatch() ? QString("-N") : arg.section('=', 0, 0));
+        } else if (!nestedTaken && nestedCommands.contains(subcommand)) {
+            parts << arg;
+            nestedTaken = true;
+        }
+    }
+    return parts.join(' ');
+}
+
+// 会修改工作区或暂存区的子命令，执行后状态缓存需要全量重建
+bool isWorktreeCommand(const QString& subcommand) {
+    static const QSet<QString> commands = {
+        "add", "commit", "checkout", "switch", "pull", "merge", "reset", "stash",
+        "cherry-pick", "rebase", "revert", "rm", "mv", "restore", "apply", "am", "clean"
+    };
+    return commands.contains(subcommand);
+}
+
+// 只修改引用的子命令（分支列表或上游提交数可能变化）
+bool isRefCommand(const QString& subcommand, const QStringList& args) {
+    if (subcommand == "push" || subcommand == "fetch") {
+        return true;
+    }
+    return subcommand == "branch" && (args.contains("-d") || args.contains("-D"));
+}
+
+bool isNetworkCommand(const QString& subcommand) {
+    return subcommand == "push" || subcommand == "pull" || subcommand == "fetch";
+}
+
+// 旧版 merge-tree 的条目行 "  our    100644 <oid> <path>"：跳过前三个字段，其余为路径（可含空格）
+QString mergeTreeEntryPath(const QByteArray& line) {
+    qsizetype pos = 0;
+    for (int field = 0; field < 3; ++field) {
+        while (pos < line.size() && line[pos] == ' ') {
+            ++pos;
+        }
+        while (pos < line.size() && line[pos] != ' ') {
+            ++pos;
+        }
+    }
+    while (pos < line.size() && line[pos] == ' ') {
+        ++pos;
+    }
+    return QString::fromUtf8(line.mid(pos));
+}
+
+}
+
+// ========== GitCancellationScope ==========
+
+GitCancellationScope::GitCancellationScope(std::function<bool()> isCanceled)
+    : m_previous(std::move(t_isCanceled))
+{
+    t_isCanceled = std::move(isCanceled);
+}
+
+GitCancellationScope::~GitCancellationScope() {
+    t_isCanceled = std::move(m_previous);
+}
+
+bool GitCancellationScope::isCanceled() {
+    return t_isCanceled && t_isCanceled();
+}
+
+// ========== GitRepoPathScope ==========
+
+GitRepoPathScope::GitRepoPathScope(const QString& repoPath)
+    : m_previous(t_repoPath)
+{
+    t_repoPath = &repoPath;
+}
+
+GitRepoPathScope::~GitRepoPathScope() {
+    t_repoPath = m_previous;
+}
+
+const QString* GitRepoPathScope::current() {
+    return t_repoPath;
+}
+
+// ========== GitService ==========
 
 GitService::GitService(QObject* parent)
     : QObject(parent)
+    , m_readExecutor(new QThreadPool(this))
+    , m_writeExecutor(new QThreadPool(this))
+    , m_readerIdleTimer(new QTimer(this))
+    , m_statusCache(new StatusCache(this))
 {
+    m_readExecutor->setMaxThreadCount(MAX_READ_THREADS);
+    m_writeExecutor->setMaxThreadCount(1);
+    
+    m_readerIdleTimer->setInterval(RepositoryReader::PACK_IDLE_MS);
+    connect(m_readerIdleTimer, &QTimer::timeout, this, [this]() {
+        QMutexLocker locker(&m_readerMutex);
+        if (m_reader) {
+            m_reader->releaseIdlePacks();
+        }
+    });
+    m_readerIdleTimer->start();
+}
+
+GitService::~GitService() {
+    // 任务会访问本对象的成员，必须在成员析构前结束
+    cancelPendingOperations();
+    m_readExecutor->waitForDone();
+    m_writeExecutor->waitForDone();
 }
 
 void GitService::setRepoPath(const QString& path) {
-    m_repoPath = path;
+    {
+        QMutexLocker locker(&m_repoPathMutex);
+        if (path == m_repoPath) {
+            return;
+        }
+        m_repoPath = path;
+    }
+    // 为旧仓库排队的任务与执行中的只读任务不再有意义；执行中的写操作在旧仓库中完成
+    cancelPendingOperations();
+    m_statusCache->setRepoPath(path);
     LOG_INFO(QString("设置仓库路径: %1").arg(path));
 }
 
+QString GitService::getRepoPath() const {
+    QMutexLocker locker(&m_repoPathMutex);
+    return m_repoPath;
+}
+
+QString GitService::repoPath() const {
+    if (const QString* taskPath = GitRepoPathScope::current()) {
+        return *taskPath;
+    }
+    return getRepoPath();
+}
+
 bool GitService::isValidRepo() {
-    if (m_repoPath.isEmpty()) {
+    const QString path = repoPath();
+    if (path.isEmpty()) {
         return false;
     }
     
     // 检查.git目录是否存在
-    QFileInfo gitDir(m_repoPath + "/.git");
+    QFileInfo gitDir(path + "/.git");
     return gitDir.exists() && gitDir.isDir();
 }
 
 // ========== 分支操作 ==========
 
 QString GitService::getCurrentBranch() {
-    QString output = executeGitCommandSimple({"branch", "--show-current"});
+    QString output;
+    QSharedPointer<RepositoryReader> reader = repositoryReader();
+    if (!reader || !reader->currentBranch(output)) {
+        output = executeGitCommandSimple({"branch", "--show-current"});
+    }
     LOG_INFO(QString("当前分支: %1").arg(output));
     return output;
 }
 
 QStringList GitService::getAllBranches() {
-    QString output = executeGitCommandSimple({"branch", "-a"});
     QStringList branches;
     
+    QStringList locals, remotes;
+    QSharedPointer<RepositoryReader> reader = repositoryReader();
+    if (reader && reader->branches(locals, remotes)) {
+        branches = locals;
+        for (const QString& remote : remotes) {
+            QString branch = "remotes/" + remote;
+            branch.remove("remotes/origin/");
+            branches.append(branch);
+        }
+        branches.removeDuplicates();
+        return branches;
+    }
+    
+    QString output = executeGitCommandSimple({"branch", "-a"});
+    
     for (const QString& line : output.split('\n')) {
         QString branch = line.trimmed();
         if (branch.isEmpty()) continue;
@@ -74,6 +312,7 @@ bool GitService::createBranch(const QString& newBranch, const QString& baseBranc
 }
 
 bool GitService::switchBranch(const QString& branchName) {
+    TRACE_SCOPE("git", "GitService::switchBranch");
     QString output, error;
     bool success = executeGitCommand({"checkout", branchName}, output, error);
     
@@ -103,21 +342,41 @@ bool GitService::deleteBranch(const QString& branchName, bool force) {
 // ========== 代码状态 ==========
 
 bool GitService::hasUncommittedChanges() {
-    QString output = executeGitCommandSimple({"status", "--porcelain"});
-    return !output.trimmed().isEmpty();
+    // 用于切换分支等破坏性操作前的检查：不依赖缓存的监控是否完整，总是全量扫描
+    return !statusLines(true).isEmpty();
 }
 
 bool GitService::hasUnpushedCommits() {
+    // 快速路径：HEAD 与上游指向同一提交时无需执行 git log
+    GitProcessPool& pool = GitProcessPool::instance();
+    const QString path = repoPath();
+    QString head = pool.resolve(path, "HEAD");
+    if (!head.isEmpty() && head == pool.resolve(path, "@{u}")) {
+        return false;
+    }
+    
     QString output = executeGitCommandSimple({"log", "@{u}..", "--oneline"});
     return !output.trimmed().isEmpty();
 }
 
+AheadBehind GitService::getAheadBehind() {
+    // 输出格式: "<领先数>\t<落后数>"；没有上游分支时命令失败
+    QString output, error;
+    if (!executeGitCommand({"rev-list", "--left-right", "--count", "HEAD...@{upstream}"}, output, error)) {
+        return AheadBehind(0, 0);
+    }
+    
+    QStringList counts = output.split('\t');
+    if (counts.size() != 2) {
+        return AheadBehind(0, 0);
+    }
+    return AheadBehind(counts[0].toInt(), counts[1].toInt());
+}
+
 QStringList GitService::getModifiedFiles() {
-    QString output = executeGitCommandSimple({"status", "--porcelain"});
     QStringList files;
     
-    for (const QString& line : output.split('\n')) {
-        if (line.trimmed().isEmpty()) continue;
+    for (const QString& line : statusLines()) {
         
         // 格式: "M  file.cpp" 或 "?? newfile.txt"
         QString file = line.mid(3); // 跳过状态标记
@@ -130,10 +389,8 @@ QStringList GitService::getModifiedFiles() {
 QList<FileStatus> GitService::getFileStatus() {
     QList<FileStatus> statusList;
     
-    // 使用 git status --porcelain 获取详细状态
-    QString output = executeGitCommandSimple({"status", "--porcelain"});
-    
-    QStringList lines = output.split('\n', Qt::SkipEmptyParts);
+    // git status --porcelain 的结果由状态缓存增量维护
+    const QStringList lines = statusLines();
     for (const QString& line : lines) {
         if (line.length() < 4) continue;
         
@@ -209,14 +466,88 @@ bool GitService::commit(const QString& message) {
 }
 
 QStringList GitService::getRecentCommits(int count) {
+    QStringList subjects;
+    if (walkRecentCommits(count, subjects)) {
+        return subjects;
+    }
+    
     QString output = executeGitCommandSimple({"log", QString("-%1").arg(count), "--pretty=format:%s"});
     return output.split('\n', Qt::SkipEmptyParts);
 }
 
 QString GitService::getLastCommitMessage() {
+    QByteArray raw;
+    CommitObject commit;
+    if (readCommit("HEAD", raw) && parseCommitObject(raw, commit)) {
+        return commit.subject;
+    }
+    
     return executeGitCommandSimple({"log", "-1", "--pretty=format:%s"});
 }
 
+bool GitService::readCommit(const QString& revision, QByteArray& raw, QString* oid) {
+    // 进程内读取 -> 常驻cat-file进程
+    QSharedPointer<RepositoryReader> reader = repositoryReader();
+    if (reader) {
+        QString resolved = revision;
+        QByteArray type;
+        if ((revision != "HEAD" || reader->resolveRef(revision, resolved)) &&
+            reader->readObject(resolved, raw, &type) && type == "commit") {
+            if (oid) {
+                *oid = resolved;
+            }
+            return true;
+        }
+    }
+    
+    return GitProcessPool::instance().readObject(repoPath(), revision, raw, oid);
+}
+
+bool GitService::walkRecentCommits(int count, QStringList& subjects) {
+    // 按提交时间倒序遍历，与 git log 默认顺序一致
+    QHash<QString, CommitObject> loaded;
+    
+    auto load = [&](const QString& rev, QString& oid) -> bool {
+        QByteArray raw;
+        CommitObject commit;
+        if (!readCommit(rev, raw, &oid) || !parseCommitObject(raw, commit)) {
+            return false;
+        }
+        loaded.insert(oid, commit);
+        return true;
+    };
+    
+    QString headOid;
+    if (!load("HEAD", headOid)) {
+        return false;
+    }
+    
+    typedef QPair<qint64, QString> Pending;
+    std::priority_queue<Pending, std::vector<Pending>> queue;
+    QSet<QString> queued = {headOid};
+    queue.push(qMakePair(loaded.value(headOid).commitTime, headOid));
+    
+    while (!queue.empty() && subjects.size() < count) {
+        QString oid = queue.top().second;
+        queue.pop();
+        
+        const CommitObject commit = loaded.value(oid);
+        subjects.append(commit.subject);
+        
+        for (const QString& parent : commit.parents) {
+            if (queued.contains(parent)) continue;
+            QString parentOid;
+            if (!load(parent, parentOid)) {
+                return false;  // 浅克隆等情况，交给git log处理
+            }
+            queued.insert(parent);
+            queue.push(qMakePair(loaded.value(parentOid).commitTime, parentOid));
+        }
+    }
+    
+    return true;
+}
+
 // ========== 远程操作 ==========
 
 bool GitService::pushBranch(const QString& branchName, bool setUpstream) {
@@ -240,9 +571,13 @@ bool GitService::pushBranch(const QString& branchName, bool setUpstream) {
     return success;
 }
 
-bool GitService::pullLatest() {
+bool GitService::pullLatest(bool fastForwardOnly) {
     QString output, error;
-    bool success = executeGitCommand({"pull"}, output, error);
+    QStringList args = {"pull"};
+    if (fastForwardOnly) {
+        args << "--ff-only";
+    }
+    bool success = executeGitCommand(args, output, error);
     
     if (success) {
         LOG_INFO("拉取最新代码成功");
@@ -268,38 +603,178 @@ bool GitService::checkMergeConflict(const QString& targetBranch, QString& confli
         return false;
     }
     
-    // 尝试合并但不提交
-    QString output, error;
-    QStringList args = {"merge", "--no-commit", "--no-ff", QString("origin/%1").arg(targetBranch)};
-    bool success = executeGitCommand(args, output, error);
+    // 在对象库中计算合并，不动工作区与索引（比较的是已提交的内容，未提交的修改不参与）
+    const MergeTreeResult result = mergeTree("HEAD", QString("origin/%1").arg(targetBranch));
     
-    if (!success) {
-        // 检查是否有冲突
-        if (error.contains("CONFLICT") || output.contains("CONFLICT")) {
-            conflictInfo = QString::fromUtf8("检测到合并冲突：\n\n") + output + "\n" + error;
-            
-            // 中止合并
-            QString abortOutput, abortError;
-            executeGitCommand({"merge", "--abort"}, abortOutput, abortError);
-            
-            emit operationFinished("check-conflict", false);
-            return false;
-        } else {
-            conflictInfo = QString::fromUtf8("合并失败：") + error;
-            emit operationFinished("check-conflict", false);
-            return false;
-        }
+    if (!result.ok) {
+        conflictInfo = QString::fromUtf8("合并检查失败：") + result.errorMessage;
+        emit operationFinished("check-conflict", false);
+        return false;
     }
     
-    // 合并成功，中止合并（不实际提交）
-    QString abortOutput, abortError;
-    executeGitCommand({"merge", "--abort"}, abortOutput, abortError);
+    if (result.hasConflict) {
+        conflictInfo = QString::fromUtf8("检测到合并冲突：\n\n") + result.conflictFiles.join('\n');
+        if (!result.messages.isEmpty()) {
+            conflictInfo += "\n\n" + result.messages.join('\n');
+        }
+        emit operationFinished("check-conflict", false);
+        return false;
+    }
     
     conflictInfo = QString::fromUtf8("✅ 没有冲突，可以安全合并");
     emit operationFinished("check-conflict", true);
     return true;
 }
 
+MergeTreeResult GitService::mergeTree(const QString& ours, const QString& theirs) {
+    if (!supportsWriteTreeMerge()) {
+        return trivialMergeTree(ours, theirs);
+    }
+    
+    MergeTreeResult result;
+    QString error;
+    // 与 checkCherryPickConflict 相同使用 -z，路径不经转义，两处报告的文件名一致
+    // 输出为 NUL 分隔的 <tree> <冲突文件>... <空记录>，其后每条说明为 <路径数> <路径>... <类型> <说明>
+    enum class Section { Tree, Files, PathCount, Paths, Type, Message };
+    Section section = Section::Tree;
+    int pathsLeft = 0;
+    bool isConflictMessage = false;
+    QSet<QString> uniqueFiles;  // 同一文件的多个阶段会重复出现
+    int exitCode = -1;
+    executeGitCommandStreamed({"merge-tree", "--write-tree", "-z", "--name-only", ours, theirs}, '\0',
+        [&](const QByteArray& record) {
+            switch (section) {
+            case Section::Tree:
+                result.treeOid = QString::fromLatin1(record);
+                section = Section::Files;
+                break;
+            case Section::Files:
+                if (record.isEmpty()) {
+                    section = Section::PathCount;
+                } else {
+                    const QString path = QString::fromUtf8(record);
+                    if (!uniqueFiles.contains(path)) {
+                        uniqueFiles.insert(path);
+                        result.conflictFiles.append(path);
+                    }
+                }
+                break;
+            case Section::PathCount:
+                pathsLeft = record.toInt();
+                section = pathsLeft > 0 ? Section::Paths : Section::Type;
+                break;
+            case Section::Paths:
+                if (--pathsLeft == 0) {
+                    section = Section::Type;
+                }
+                break;
+            case Section::Type:
+                isConflictMessage = record.startsWith("CONFLICT");
+                section = Section::Message;
+                break;
+            case Section::Message:
+                if (isConflictMessage) {
+                    result.messages.append(QString::fromUtf8(record).trimmed());
+                }
+                section = Section::PathCount;
+                break;
+            }
+            return true;
+        }, error, &exitCode);
+    
+    // 退出码 0 为无冲突，1 为有冲突，其余为执行失败（如没有共同祖先）
+    static const QRegularExpression oidPattern("^[0-9a-f]{40,64}$");
+    if ((exitCode != 0 && exitCode != 1) || !oidPattern.match(result.treeOid).hasMatch()) {
+        result = MergeTreeResult();
+        result.errorMessage = error;
+        LOG_ERROR(QString("merge-tree 失败: %1 %2: %3").arg(ours, theirs, error));
+        return result;
+    }
+    
+    result.ok = true;
+    result.hasConflict = exitCode == 1;
+    
+    LOG_INFO("合并预检", {{"ours", ours}, {"theirs", theirs}, {"conflicts", result.conflictFiles.size()}});
+    return result;
+}
+
+MergeTreeResult GitService::trivialMergeTree(const QString& ours, const QString& theirs, QHash<QString, int>* hunks) {
+    // 旧版 merge-tree <base> <ours> <theirs>：输出每个改动文件的三方合并diff，冲突处带 <<<<<<< 标记
+    MergeTreeResult result;
+    QString mergeBase, error;
+    if (!executeGitCommand({"merge-base", ours, theirs}, mergeBase, error)) {
+        result.errorMessage = QString::fromUtf8("无法找到共同祖先: ") + error;
+        return result;
+    }
+    
+    // 逐行解析，冲突再多也不把整份diff读进内存
+    // 段落以 "changed in both" 等不缩进的行开始，随后的 "  our    100644 <oid> <path>" 行给出路径
+    QString currentPath;
+    const bool finished = executeGitCommandStreamed({"merge-tree", mergeBase, ours, theirs}, '\n',
+        [&](const QByteArray& line) {
+            if (!line.isEmpty() && line.front() >= 'a' && line.front() <= 'z') {
+                currentPath.clear();
+            } else if (line.startsWith("  ") && currentPath.isEmpty()) {
+                currentPath = mergeTreeEntryPath(line);
+            } else if (line.startsWith("+<<<<<<<") && !currentPath.isEmpty()) {
+                if (!result.conflictFiles.contains(currentPath)) {
+                    result.conflictFiles.append(currentPath);
+                }
+                if (hunks) {
+                    ++(*hunks)[currentPath];
+                }
+            }
+            return true;
+        }, error);
+    
+    if (!finished) {
+        result.errorMessage = error;
+        result.conflictFiles.clear();
+        if (hunks) {
+            hunks->clear();
+        }
+        return result;
+    }
+    
+    result.ok = true;
+    result.hasConflict = !result.conflictFiles.isEmpty();
+    return result;
+}
+
+void GitService::countConflictHunks(const QString& treeOid, const QStringList& files, QHash<QString, int>& hunks) {
+    // 结果树中的冲突文件带有冲突标记，git grep -c 只回传每个文件的计数，不读出文件内容
+    const QStringList counted = files.mid(0, MAX_HUNK_COUNT_FILES);
+    if (counted.size() < files.size()) {
+        LOG_INFO("冲突文件过多，只统计部分文件的冲突块", {{"files", files.size()}, {"counted", counted.size()}});
+    }
+    
+    const QString prefix = treeOid + ':';
+    for (int i = 0; i < counted.size(); i += HUNK_COUNT_PATHS_PER_BATCH) {
+        QStringList args = {"grep", "-z", "-c", "-e", "^<<<<<<<", treeOid, "--"};
+        for (const QString& file : counted.mid(i, HUNK_COUNT_PATHS_PER_BATCH)) {
+            args.append(":(literal)" + file);
+        }
+        
+        QString error;
+        int exitCode = 0;
+        // 每行为 <tree>:<路径>\0<数量>
+        executeGitCommandStreamed(args, '\n', [&](const QByteArray& line) {
+            const qsizetype nul = line.indexOf('\0');
+            const QString name = QString::fromUtf8(line.left(nul));
+            if (nul > 0 && name.startsWith(prefix)) {
+                hunks.insert(name.mid(prefix.size()), line.mid(nul + 1).toInt());
+            }
+            return true;
+        }, error, &exitCode);
+        
+        // 没有匹配时退出码为 1
+        if (exitCode > 1) {
+            LOG_WARNING("统计冲突块失败", {{"tree", treeOid}, {"error", error}});
+            return;
+        }
+    }
+}
+
 CherryPickConflictResult GitService::checkCherryPickConflict(
     const QString& sourceBranch,
     const QString& targetBranch) {
@@ -320,47 +795,52 @@ CherryPickConflictResult GitService::checkCherryPickConflict(
     QString sourceRef = QString("origin/%1").arg(sourceBranch);
     QString targetRef = QString("origin/%1").arg(targetBranch);
     
-    // 3. 找到共同祖先
-    QString mergeBase;
-    if (!executeGitCommand({"merge-base", targetRef, sourceRef}, 
-                           mergeBase, error)) {
-        result.errorMessage = QString::fromUtf8("无法找到共同祖先: ") + error;
-        LOG_ERROR(result.errorMessage);
-        return result;
-    }
-    mergeBase = mergeBase.trimmed();
-    
-    // 4. 执行 merge-tree 三方合并分析
-    QString mergeTreeOutput;
-    // git merge-tree 总是返回成功，即使有冲突
-    executeGitCommand({"merge-tree", mergeBase, targetRef, sourceRef}, 
-                      mergeTreeOutput, error);
-    
-    // 5. 检测冲突标记
-    if (mergeTreeOutput.contains("<<<<<<<")) {
-        result.hasConflict = true;
-        
-        // 6. 解析冲突文件列表
-        // merge-tree 输出格式： @@@@@@@ filename @@@@@@@
-        QRegularExpression fileRegex(R"(@@@@@@@\s+(.+?)\s+@@@@@@@)");
-        QRegularExpressionMatchIterator it = fileRegex.globalMatch(mergeTreeOutput);
-        
-        QSet<QString> uniqueFiles;  // 去重
-        while (it.hasNext()) {
-            QRegularExpressionMatch match = it.next();
-            QString filename = match.captured(1).trimmed();
-            if (!filename.isEmpty()) {
-                uniqueFiles.insert(filename);
-            }
+    // 3. 三方合并分析，只读取冲突文件列表，不读取三方diff
+    if (!supportsWriteTreeMerge()) {
+        const MergeTreeResult merged = trivialMergeTree(targetRef, sourceRef, &result.conflictHunks);
+        if (!merged.ok) {
+            result.errorMessage = QString::fromUtf8("合并分析失败: ") + merged.errorMessage;
+            LOG_ERROR(result.errorMessage);
+            return result;
         }
+        result.hasConflict = merged.hasConflict;
+        result.conflictFiles = merged.conflictFiles;
+    } else {
+        // 输出为 NUL 分隔的 <tree> <冲突文件>...，同一文件的多个阶段会重复出现
+        QString treeOid;
+        QSet<QString> uniqueFiles;  // 去重
+        int exitCode = -1;
+        executeGitCommandStreamed({"merge-tree", "--write-tree", "-z", "--name-only", "--no-messages",
+                                   targetRef, sourceRef}, '\0',
+            [&](const QByteArray& record) {
+                if (treeOid.isEmpty()) {
+                    treeOid = QString::fromLatin1(record);
+                    return true;
+                }
+                const QString path = QString::fromUtf8(record);
+                if (!path.isEmpty() && !uniqueFiles.contains(path)) {
+                    uniqueFiles.insert(path);
+                    result.conflictFiles.append(path);
+                }
+                return true;
+            }, error, &exitCode);
         
-        result.conflictFiles = uniqueFiles.values();
-        
-        // 如果没有解析到文件名，至少标记有冲突
-        if (result.conflictFiles.isEmpty()) {
-            result.conflictFiles << QString::fromUtf8("(检测到冲突，但无法解析文件名)");
+        // 退出码 0 为无冲突，1 为有冲突，其余为执行失败（如没有共同祖先）
+        if (exitCode != 0 && exitCode != 1) {
+            result.conflictFiles.clear();
+            result.errorMessage = QString::fromUtf8("合并分析失败: ") + error;
+            LOG_ERROR(result.errorMessage);
+            return result;
         }
+        result.hasConflict = exitCode == 1;
         
+        // 4. 统计每个冲突文件的冲突块数
+        if (result.hasConflict) {
+            countConflictHunks(treeOid, result.conflictFiles, result.conflictHunks);
+        }
+    }
+    
+    if (result.hasConflict) {
         LOG_INFO(QString("Cherry-pick冲突检测: %1 -> %2, 发现%3个冲突文件")
              .arg(sourceBranch, targetBranch).arg(result.conflictFiles.size()));
     } else {
@@ -374,8 +854,12 @@ CherryPickConflictResult GitService::checkCherryPickConflict(
 
 QStringList GitService::getTags(int limit) {
     // 获取Tags，按版本号倒序排列
-    QString output = executeGitCommandSimple({"tag", "-l", "--sort=-v:refname"});
-    QStringList tags = output.split('\n', Qt::SkipEmptyParts);
+    QStringList tags;
+    QSharedPointer<RepositoryReader> reader = repositoryReader();
+    if (!reader || !reader->tags(tags)) {
+        QString output = executeGitCommandSimple({"tag", "-l", "--sort=-v:refname"});
+        tags = output.split('\n', Qt::SkipEmptyParts);
+    }
     
     // 限制返回数量
     if (limit > 0 && tags.size() > limit) {
@@ -398,9 +882,30 @@ QStringList GitService::getGraphLog(int limit) {
 
 
 QString GitService::getRemoteUrl() {
+    QString url;
+    QSharedPointer<RepositoryReader> reader = repositoryReader();
+    if (reader && reader->remoteUrl("origin", url)) {
+        return url;
+    }
     return executeGitCommandSimple({"remote", "get-url", "origin"});
 }
 
+QStringList GitService::resolveRefs(const QStringList& refs) {
+    QStringList oids;
+    QSharedPointer<RepositoryReader> reader = repositoryReader();
+    for (const QString& ref : refs) {
+        QString oid;
+        if (!reader || !reader->resolveRef(ref, oid)) {
+            QString error;
+            if (!executeGitCommand({"rev-parse", "--verify", "-q", ref + "^{commit}"}, oid, error)) {
+                oid.clear();
+            }
+        }
+        oids.append(oid);
+    }
+    return oids;
+}
+
 bool GitService::hasRemote() {
     QString output = executeGitCommandSimple({"remote"});
     return !output.trimmed().isEmpty();
@@ -461,27 +966,234 @@ void GitService::cloneRepositoryAsync(const QString& url, const QString& targetP
     process->start("git", args);
 }
 
+// ========== 异步API ==========
+
+QFuture<QString> GitService::getCurrentBranchAsync() {
+    return runAsync<QString>(m_readExecutor, [this]() { return getCurrentBranch(); });
+}
+
+QFuture<QStringList> GitService::getAllBranchesAsync() {
+    return runAsync<QStringList>(m_readExecutor, [this]() { return getAllBranches(); });
+}
+
+QFuture<QList<FileStatus>> GitService::getFileStatusAsync() {
+    return runAsync<QList<FileStatus>>(m_readExecutor, [this]() { return getFileStatus(); });
+}
+
+QFuture<bool> GitService::hasUncommittedChangesAsync() {
+    return runAsync<bool>(m_readExecutor, [this]() { return hasUncommittedChanges(); });
+}
+
+QFuture<AheadBehind> GitService::getAheadBehindAsync() {
+    return runAsync<AheadBehind>(m_readExecutor, [this]() { return getAheadBehind(); });
+}
+
+QFuture<QString> GitService::getRemoteUrlAsync() {
+    return runAsync<QString>(m_readExecutor, [this]() { return getRemoteUrl(); });
+}
+
+QFuture<bool> GitService::createBranchAsync(const QString& newBranch, const QString& baseBranch) {
+    return runAsync<bool>(m_writeExecutor, [this, newBranch, baseBranch]() {
+        return createBranch(newBranch, baseBranch);
+    });
+}
+
+QFuture<bool> GitService::switchBranchAsync(const QString& branchName) {
+    return runAsync<bool>(m_writeExecutor, [this, branchName]() { return switchBranch(branchName); });
+}
+
+QFuture<bool> GitService::stageAllAsync() {
+    return runAsync<bool>(m_writeExecutor, [this]() { return stageAll(); });
+}
+
+QFuture<bool> GitService::commitAsync(const QString& message) {
+    return runAsync<bool>(m_writeExecutor, [this, message]() { return commit(message); });
+}
+
+QFuture<bool> GitService::pushBranchAsync(const QString& branchName, bool setUpstream) {
+    return runAsync<bool>(m_writeExecutor, [this, branchName, setUpstream]() {
+        return pushBranch(branchName, setUpstream);
+    });
+}
+
+QFuture<bool> GitService::pullLatestAsync(bool fastForwardOnly) {
+    return runAsync<bool>(m_writeExecutor, [this, fastForwardOnly]() { return pullLatest(fastForwardOnly); });
+}
+
+QFuture<MergeCheckResult> GitService::checkMergeConflictAsync(const QString& targetBranch) {
+    return runAsync<MergeCheckResult>(m_writeExecutor, [this, targetBranch]() {
+        QString info;
+        bool ok = checkMergeConflict(targetBranch, info);
+        return MergeCheckResult(ok, info);
+    });
+}
+
+QFuture<CherryPickConflictResult> GitService::checkCherryPickConflictAsync(
+    const QString& sourceBranch, const QString& targetBranch) {
+    return runAsync<CherryPickConflictResult>(m_writeExecutor, [this, sourceBranch, targetBranch]() {
+        return checkCherryPickConflict(sourceBranch, targetBranch);
+    });
+}
+
+QFuture<QStringList> GitService::resolveRefsAsync(const QStringList& refs) {
+    return runAsync<QStringList>(m_readExecutor, [this, refs]() { return resolveRefs(refs); });
+}
+
+QFuture<MergeTreeResult> GitService::mergeTreeAsync(const QString& ours, const QString& theirs) {
+    return runAsync<MergeTreeResult>(m_readExecutor, [this, ours, theirs]() { return mergeTree(ours, theirs); });
+}
+
+void GitService::cancelPendingOperations() {
+    ++m_generation;
+}
+
+void GitService::invalidateStatusCache() {
+    m_statusCache->invalidate();
+}
+
 // ========== 私有方法 ==========
 
-bool GitService::executeGitCommand(const QStringList& args, QString& output, QString& error) {
+QStringList GitService::statusLines(bool forceFull) {
+    // 串行刷新：并发调用方等待同一次扫描结果，而不是拿到过期数据
+    QMutexLocker locker(&m_statusMutex);
+    
+    // 内置 fsmonitor 守护进程只支持 Windows 与 macOS，其他平台改用文件系统监控维护缓存
+#if defined(Q_OS_WIN) || defined(Q_OS_MACOS)
+    const bool fsMonitor = ConfigManager::instance().isFsMonitorEnabled();
+#else
+    const bool fsMonitor = false;
+#endif
+    m_statusCache->setFsMonitor(fsMonitor);
+    if (forceFull) {
+        m_statusCache->invalidate();
+    }
+    StatusCache::RefreshPlan plan = m_statusCache->takeRefreshPlan();
+    if (plan.repoPath != repoPath()) {
+        // 任务提交后已切换仓库，结果不会被使用；计划已被取走，交还给新仓库的下一次刷新
+        m_statusCache->invalidate();
+        return QStringList();
+    }
+    if (plan.type == StatusCache::RefreshType::None) {
+        return m_statusCache->lines();
+    }
+    
+    // --no-optional-locks: 避免status回写index，否则会触发index监控导致反复全量扫描
+    QStringList args = {"--no-optional-locks", "--literal-pathspecs"};
+    if (fsMonitor) {
+        args << "-c" << "core.fsmonitor=true";
+    }
+    if (ConfigManager::instance().isFsMonitorEnabled()) {
+        args << "-c" << "core.untrackedCache=true";
+    }
+    // -z: 路径不转义（非ASCII路径与监控到的目录一致），重命名的两个路径分为两条记录
+    args << "status" << "--porcelain" << "-z";
+    if (plan.type == StatusCache::RefreshType::Partial) {
+        args << "--" << plan.dirs;
+    }
+    
+    // 不能裁剪输出：首行状态码可能以空格开头（如 " M file"）
+    QString output, error;
+    if (!executeGitCommand(args, output, error, false)) {
+        LOG_WARNING(QString("获取工作区状态失败: %1").arg(error));
+        m_statusCache->invalidate();
+        return QStringList();
+    }
+    
+    const QList<StatusCache::Entry> entries = StatusCache::parsePorcelain(output);
+    if (plan.type == StatusCache::RefreshType::Full) {
+        m_statusCache->applyFull(plan, entries);
+    } else {
+        m_statusCache->applyPartial(plan, entries);
+    }
+    
+    if (plan.rewatch) {
+        QString files;
+        if (executeGitCommand({"ls-files", "-z"}, files, error, false)) {
+            m_statusCache->watchFiles(files.split(QChar('\0'), Qt::SkipEmptyParts));
+        }
+    }
+    
+    return m_statusCache->lines();
+}
+
+QSharedPointer<RepositoryReader> GitService::repositoryReader() {
+    if (!RepositoryReader::isEnabled()) {
+        return QSharedPointer<RepositoryReader>();
+    }
+    
+    const QString path = repoPath();
+    QMutexLocker locker(&m_readerMutex);
+    if (!m_reader || m_reader->repoPath() != path) {
+        m_reader.reset(new RepositoryReader(path));
+    }
+    return m_reader->isValid() ? m_reader : QSharedPointer<RepositoryReader>();
+}
+
+bool GitService::executeGitCommand(const QStringList& args, QString& output, QString& error, bool trimOutput) {
+    TraceSpan span("git", "GitService::executeGitCommand");
+    if (span.isActive()) {
+        span.addArg("args", args.join(' '));
+    }
+    
     if (!isGitInstalled()) {
         error = "Git未安装或不在PATH中";
         LOG_ERROR(error);
         return false;
     }
     
+    if (Q_UNLIKELY(QCoreApplication::instance() &&
+                   QThread::currentThread() == QCoreApplication::instance()->thread())) {
+        LOG_WARNING(QString("在UI线程中同步执行git命令: %1").arg(args.join(' ')));
+    }
+    
     QProcess process;
-    process.setWorkingDirectory(m_repoPath);
+    process.setWorkingDirectory(repoPath());
     
     emit operationStarted(args.join(' '));
     
     process.start("git", args);
-    process.waitForFinished(30000); // 30秒超时
     
-    output = QString::fromUtf8(process.readAllStandardOutput()).trimmed();
+    // 分段等待，以便异步任务被取消时及时终止进程
+    const int timeoutMs = isNetworkCommand(gitSubcommand(args)) ? NETWORK_COMMAND_TIMEOUT_MS : COMMAND_TIMEOUT_MS;
+    QElapsedTimer timer;
+    timer.start();
+    while (!process.waitForFinished(100)) {
+        if (process.state() == QProcess::NotRunning) {
+            break;  // 启动失败
+        }
+        if (GitCancellationScope::isCanceled()) {
+            process.kill();
+            process.waitForFinished(1000);
+            error = QString::fromUtf8("操作已取消");
+            emit operationFinished(args.join(' '), false);
+            return false;
+        }
+        if (timer.hasExpired(timeoutMs)) {
+            // 进程仍在运行时 exitCode() 为 0，不能当作成功；析构时同样会终止进程，这里显式处理
+            process.kill();
+            process.waitForFinished(1000);
+            error = QString::fromUtf8("执行超时（%1 秒）").arg(timeoutMs / 1000);
+            LOG_WARNING("git命令执行超时", {{"command", gitCommandPattern(args)}, {"timeout_ms", timeoutMs}});
+            MetricsRegistry::instance().record(gitCommandPattern(args), timer.nsecsElapsed() / 1000, false);
+            emit operationFinished(args.join(' '), false);
+            return false;
+        }
+    }
+    
+    output = QString::fromUtf8(process.readAllStandardOutput());
+    if (trimOutput) {
+        output = output.trimmed();
+    }
     error = QString::fromUtf8(process.readAllStandardError()).trimmed();
     
     bool success = (process.exitCode() == 0);
+    MetricsRegistry::instance().record(gitCommandPattern(args), timer.nsecsElapsed() / 1000, success);
+    
+    const QString subcommand = gitSubcommand(args);
+    const bool worktreeChanged = isWorktreeCommand(subcommand);
+    if (worktreeChanged) {
+        m_statusCache->invalidate();
+    }
     
     if (!output.isEmpty()) {
         emit outputReceived(output);
@@ -492,6 +1204,11 @@ bool GitService::executeGitCommand(const QStringList& args, QString& output, QSt
     
     emit operationFinished(args.join(' '), success);
     
+    // 失败的命令（如产生冲突的合并）同样可能已经改动仓库
+    if (worktreeChanged || isRefCommand(subcommand, args)) {
+        emit repositoryChanged();
+    }
+    
     return success;
 }
 
@@ -504,17 +1221,132 @@ QString GitService::executeGitCommandSimple(const QStringList& args) {
     return output;
 }
 
-bool GitService::isGitInstalled() {
-    static bool checked = false;
-    static bool installed = false;
+bool GitService::executeGitCommandStreamed(const QStringList& args, char separator,
+                                           const std::function<bool(const QByteArray&)>& onRecord,
+                                           QString& error, int* exitCode) {
+    // 仅用于只读命令：不发出 outputReceived，也不触发仓库变更通知
+    TraceSpan span("git", "GitService::executeGitCommandStreamed");
+    if (span.isActive()) {
+        span.addArg("args", args.join(' '));
+    }
+    if (exitCode) {
+        *exitCode = -1;
+    }
+    
+    if (!isGitInstalled()) {
+        error = "Git未安装或不在PATH中";
+        LOG_ERROR(error);
+        return false;
+    }
     
-    if (!checked) {
+    QProcess process;
+    process.setWorkingDirectory(repoPath());
+    
+    emit operationStarted(args.join(' '));
+    
+    process.start("git", args);
+    
+    // 只保留尚未遇到分隔符的残余部分；超长记录截断到上限
+    QByteArray pending;
+    bool stopped = false;
+    auto consume = [&](const QByteArray& chunk) {
+        qsizetype start = 0;
+        while (!stopped && start < chunk.size()) {
+            const qsizetype end = chunk.indexOf(separator, start);
+            const qsizetype length = (end < 0 ? chunk.size() : end) - start;
+            const qsizetype room = MAX_STREAM_RECORD_BYTES - pending.size();
+            if (room > 0) {
+                pending.append(chunk.constData() + start, qMin(length, room));
+            }
+            if (end < 0) {
+                break;
+            }
+            stopped = !onRecord(pending);
+            pending.clear();
+            start = end + 1;
+        }
+    };
+    
+    QElapsedTimer timer;
+    timer.start();
+    bool canceled = false;
+    bool timedOut = false;
+    while (!stopped && process.state() != QProcess::NotRunning) {
+        process.waitForReadyRead(100);
+        consume(process.readAllStandardOutput());
+        if (GitCancellationScope::isCanceled()) {
+            canceled = true;
+            break;
+        }
+        if (timer.hasExpired(30000)) {  // 30秒超时
+            timedOut = true;
+            break;
+        }
+    }
+    
+    if (process.state() != QProcess::NotRunning) {
+        process.kill();
+        process.waitForFinished(1000);
+    } else if (!stopped) {
+        consume(process.readAllStandardOutput());
+        if (!stopped && !pending.isEmpty()) {
+            onRecord(pending);  // 末尾没有分隔符的最后一条
+        }
+    }
+    
+    error = QString::fromUtf8(process.readAllStandardError()).trimmed();
+    if (canceled) {
+        error = QString::fromUtf8("操作已取消");
+    } else if (timedOut) {
+        error = QString::fromUtf8("执行超时");
+    }
+    
+    const bool exited = !canceled && !timedOut && process.error() != QProcess::FailedToStart
+                        && process.exitStatus() == QProcess::NormalExit;
+    // 回调主动结束时进程被终止，视为成功
+    const bool success = stopped || (exited && process.exitCode() == 0);
+    if (exitCode && exited) {
+        *exitCode = process.exitCode();
+    }
+    MetricsRegistry::instance().record(gitCommandPattern(args), timer.nsecsElapsed() / 1000, success);
+    
+    if (!error.isEmpty()) {
+        emit errorReceived(error);
+    }
+    emit operationFinished(args.join(' '), success);
+    
+    return success;
+}
+
+bool GitService::supportsWriteTreeMerge() {
+    // 旧版 merge-tree 在任何版本上都可用
+    const bool supported = gitVersion() >= QVersionNumber(2, 38);
+    static std::atomic<bool> logged{false};
+    if (!supported && !logged.exchange(true)) {
+        LOG_INFO("git 版本低于 2.38 或无法确定，合并预检使用旧版 merge-tree");
+    }
+    return supported;
+}
+
+QVersionNumber GitService::gitVersion() {
+    // 多个工作线程并发调用时只检测一次；首次检测超时（如杀毒软件扫描）不会让结果永久失效
+    static QMutex mutex;
+    static QVersionNumber cached;
+    QMutexLocker locker(&mutex);
+    if (cached.isNull()) {
         QProcess process;
         process.start("git", {"--version"});
         process.waitForFinished(3000);
-        installed = (process.exitCode() == 0);
-        checked = true;
+        // "git version 2.39.2.windows.1"
+        static const QRegularExpression versionPattern(R"(git version (\d+(?:\.\d+)*))");
+        const QRegularExpressionMatch match = versionPattern.match(QString::fromUtf8(process.readAllStandardOutput()));
+        if (match.hasMatch()) {
+            cached = QVersionNumber::fromString(match.captured(1));
+        }
     }
-    
-    return installed;
+    return cached;
+}
+
+bool GitService::isGitInstalled() {
+    return !gitVersion().isNull();
 }
@@ -5,6 +5,17 @@
 #include <QStringList>
 #include <QObject>
 #include <QPair>
+#include <QHash>
+#include <QFuture>
+#include <QPromise>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QMutex>
+#include <QVersionNumber>
+#include <QSharedPointer>
+#include <atomic>
+#include <functional>
+#include "utils/TraceRecorder.h"
 
 /**
  * @brief 文件状态结构
@@ -15,6 +26,10 @@ struct FileStatus {
     QString displayText;
 };
 
+inline bool operator==(const FileStatus& a, const FileStatus& b) {
+    return a.filename == b.filename && a.status == b.status && a.displayText == b.displayText;
+}
+
 Q_DECLARE_METATYPE(FileStatus)
 Q_DECLARE_METATYPE(QList<FileStatus>)
 
@@ -24,22 +39,84 @@ Q_DECLARE_METATYPE(QList<FileStatus>)
 struct CherryPickConflictResult {
     bool hasConflict;           // 是否存在冲突
     QStringList conflictFiles;  // 冲突文件列表
+    QHash<QString, int> conflictHunks;  // 冲突文件 -> 冲突块数（二进制、删除/改名冲突或未统计的文件不在其中）
+    QString errorMessage;       // 错误信息（如果检测失败）
+};
+
+/**
+ * @brief 合并预检结果
+ * 合并只在对象库中计算，不改动工作区、索引与引用
+ */
+struct MergeTreeResult {
+    bool ok = false;            // git 执行成功（无论是否有冲突）
+    bool hasConflict = false;
+    QString treeOid;            // 合并结果树（git 2.38 以下为空）
+    QStringList conflictFiles;  // 冲突文件列表
+    QStringList messages;       // 冲突说明，如 "CONFLICT (content): Merge conflict in a.txt"
     QString errorMessage;       // 错误信息（如果检测失败）
 };
 
+/**
+ * @brief 合并冲突检查结果 (无冲突, 说明信息)
+ */
+typedef QPair<bool, QString> MergeCheckResult;
+
+/**
+ * @brief 当前分支相对上游的提交数 (领先, 落后)
+ */
+typedef QPair<int, int> AheadBehind;
+
+/**
+ * @brief 标记当前线程正在执行的只读异步任务
+ * 执行中的git进程会周期性检查取消状态，被取消时立即终止进程；写操作不设置，以免进程被中途杀死
+ */
+class GitCancellationScope {
+public:
+    explicit GitCancellationScope(std::function<bool()> isCanceled);
+    ~GitCancellationScope();
+    
+    static bool isCanceled();
+    
+private:
+    std::function<bool()> m_previous;
+};
+
+/**
+ * @brief 标记当前线程正在执行的异步任务所属的仓库
+ * 任务在提交时取得仓库路径的副本，执行期间不受 setRepoPath() 影响
+ */
+class GitRepoPathScope {
+public:
+    explicit GitRepoPathScope(const QString& repoPath);
+    ~GitRepoPathScope();
+    
+    // 不在异步任务中时返回 nullptr
+    static const QString* current();
+    
+private:
+    const QString* m_previous;
+};
+
 /**
  * @brief Git操作服务层
  * 封装所有Git命令，使用QProcess执行
+ * 只读查询（分支、标签、远程URL、提交信息）优先由 RepositoryReader 在进程内直接读取，
+ * 其次走 GitProcessPool 中的常驻进程，最后才回退到git命令
  */
+class RepositoryReader;
+class QTimer;
+class StatusCache;
+
 class GitService : public QObject {
     Q_OBJECT
     
 public:
     explicit GitService(QObject* parent = nullptr);
+    ~GitService();
     
     // 仓库管理
     void setRepoPath(const QString& path);
-    QString getRepoPath() const { return m_repoPath; }
+    QString getRepoPath() const;
     bool isValidRepo();
     
     // 分支操作
@@ -54,6 +131,7 @@ public:
     bool hasUnpushedCommits();
     QStringList getModifiedFiles();
     QList<FileStatus> getFileStatus();  // 新增：获取详细文件状态
+    AheadBehind getAheadBehind();       // 没有上游分支时为 (0, 0)
     
     // 提交操作
     bool stageAll();
@@ -64,9 +142,10 @@ public:
     
     // 远程操作
     bool pushBranch(const QString& branchName, bool setUpstream = false);
-    bool pullLatest();
+    bool pullLatest(bool fastForwardOnly = false);  // fastForwardOnly: 本地与远程分叉时失败，不产生合并
     bool fetch();
-    bool checkMergeConflict(const QString& targetBranch, QString& conflictInfo);  // 检查合并冲突
+    bool checkMergeConflict(const QString& targetBranch, QString& conflictInfo);  // 检查合并冲突（先fetch）
+    MergeTreeResult mergeTree(const QString& ours, const QString& theirs);        // 不改动工作区的合并预检
     CherryPickConflictResult checkCherryPickConflict(const QString& sourceBranch, const QString& targetBranch);  // Cherry-pick冲突检测
     
     // Tags操作
@@ -77,30 +156,146 @@ public:
     QString getRemoteUrl();
     bool hasRemote();
     
+    // 解析 HEAD 或完整引用名（refs/...）到提交ID，无法解析的位置为空字符串
+    QStringList resolveRefs(const QStringList& refs);
+    
     // 仓库管理（静态方法）
     static bool cloneRepository(const QString& url, const QString& targetPath, QString& error);
     
     // 异步仓库管理
     void cloneRepositoryAsync(const QString& url, const QString& targetPath);
     
+    // ========== 异步API ==========
+    // 所有任务在服务自有的有界线程池中执行，UI线程不会被git进程阻塞。
+    // 调用方使用 future.then(context, ...) 在UI线程处理结果，context销毁后回调不会执行。
+    // 只读查询并行执行；会修改仓库的操作在单线程队列中串行执行，避免index.lock竞争。
+    QFuture<QString> getCurrentBranchAsync();
+    QFuture<QStringList> getAllBranchesAsync();
+    QFuture<QList<FileStatus>> getFileStatusAsync();
+    QFuture<bool> hasUncommittedChangesAsync();
+    QFuture<QString> getRemoteUrlAsync();
+    QFuture<AheadBehind> getAheadBehindAsync();
+    
+    QFuture<bool> createBranchAsync(const QString& newBranch, const QString& baseBranch = QString());
+    QFuture<bool> switchBranchAsync(const QString& branchName);
+    QFuture<bool> stageAllAsync();
+    QFuture<bool> commitAsync(const QString& message);
+    QFuture<bool> pushBranchAsync(const QString& branchName, bool setUpstream = false);
+    QFuture<bool> pullLatestAsync(bool fastForwardOnly = false);
+    QFuture<MergeCheckResult> checkMergeConflictAsync(const QString& targetBranch);
+    QFuture<CherryPickConflictResult> checkCherryPickConflictAsync(const QString& sourceBranch, const QString& targetBranch);
+    QFuture<QStringList> resolveRefsAsync(const QStringList& refs);
+    QFuture<MergeTreeResult> mergeTreeAsync(const QString& ours, const QString& theirs);  // 只读，可并行
+    
+    // 取消排队中的异步任务与执行中的只读任务（对应的future进入canceled状态）；切换仓库时自动调用
+    // 已开始的写操作继续执行完毕
+    void cancelPendingOperations();
+    
+    // 丢弃工作区状态缓存，下一次查询全量扫描（如用户手动刷新）
+    void invalidateStatusCache();
+    
+    static constexpr int MAX_READ_THREADS = 4;
+    
+    // 已安装的git版本（如 2.39.2），取不到时为空；只缓存成功取得的结果，失败时下次调用重试
+    static QVersionNumber gitVersion();
+    // 单条git命令的执行上限，超时后终止进程并报告失败；访问远程仓库的命令（push/pull/fetch）更长
+    static constexpr int COMMAND_TIMEOUT_MS = 30000;
+    static constexpr int NETWORK_COMMAND_TIMEOUT_MS = 120000;
+    
 signals:
     void operationStarted(const QString& operation);
     void operationFinished(const QString& operation, bool success);
     void outputReceived(const QString& output);
     void errorReceived(const QString& error);
     
+    // 工作区、分支或引用可能已被修改（来自工作线程，连接时需指定context）
+    void repositoryChanged();
+    
     // 异步操作完成信号
     void cloneFinished(bool success, const QString& errorMsg);
     
 private:
     QString m_repoPath;
+    mutable QMutex m_repoPathMutex;  // setRepoPath() 在UI线程写，工作线程读
+    // 异步任务中为提交时的仓库路径，否则为当前仓库路径
+    QString repoPath() const;
+    
+    // 异步执行器
+    QThreadPool* m_readExecutor;
+    QThreadPool* m_writeExecutor;
+    std::atomic<int> m_generation{0};  // cancelPendingOperations() 时递增
+    
+    // 进程内只读读取器，仓库路径变化时重建
+    QMutex m_readerMutex;
+    QSharedPointer<RepositoryReader> m_reader;
+    QSharedPointer<RepositoryReader> repositoryReader();
+    QTimer* m_readerIdleTimer;  // 定时关闭空闲的pack文件
+    
+    // 增量工作区状态
+    StatusCache* m_statusCache;
+    QMutex m_statusMutex;
+    // forceFull: 忽略缓存重新全量扫描（结果同时写回缓存）
+    QStringList statusLines(bool forceFull = false);
+    
+    template <typename T, typename Fn>
+    QFuture<T> runAsync(QThreadPool* executor, Fn fn);
     
     // 执行Git命令
-    bool executeGitCommand(const QStringList& args, QString& output, QString& error);
+    bool executeGitCommand(const QStringList& args, QString& output, QString& error, bool trimOutput = true);
     QString executeGitCommandSimple(const QStringList& args);
+    // 按分隔符逐条回调输出，不缓存完整输出；onRecord 返回 false 时提前终止进程
+    bool executeGitCommandStreamed(const QStringList& args, char separator,
+                                   const std::function<bool(const QByteArray&)>& onRecord,
+                                   QString& error, int* exitCode = nullptr);
     
     // 辅助方法
     bool isGitInstalled();
+    bool supportsWriteTreeMerge();  // git 2.38+ 的 merge-tree --write-tree；取不到版本时按不支持处理
+    MergeTreeResult trivialMergeTree(const QString& ours, const QString& theirs, QHash<QString, int>* hunks = nullptr);
+    void countConflictHunks(const QString& treeOid, const QStringList& files, QHash<QString, int>& hunks);
+    
+    static constexpr int MAX_HUNK_COUNT_FILES = 200;          // 冲突文件过多时只统计前若干个的冲突块
+    static constexpr int HUNK_COUNT_PATHS_PER_BATCH = 100;    // 单条 git grep 的路径数，避免命令行过长
+    static constexpr int MAX_STREAM_RECORD_BYTES = 1 << 20;   // 流式读取时单条记录的上限，超出部分丢弃
+    bool walkRecentCommits(int count, QStringList& subjects);  // 不启动git log遍历提交
+    bool readCommit(const QString& revision, QByteArray& raw, QString* oid = nullptr);
 };
 
+template <typename T, typename Fn>
+QFuture<T> GitService::runAsync(QThreadPool* executor, Fn fn) {
+    const int generation = m_generation.load();
+    const QString repoPath = getRepoPath();
+    // 时间线中从提交任务处连到工作线程中的执行区间
+    const quint64 flowId = TraceRecorder::instance().flowBegin("git");
+    
+    // 写操作（commit/checkout/pull 等）被 SIGKILL 后会留下 index.lock 或改到一半的工作区，
+    // 只在排队时丢弃，开始执行后一定执行完并交付结果
+    const bool killable = executor == m_readExecutor;
+    
+    return QtConcurrent::run(executor, [this, fn, generation, repoPath, flowId, killable](QPromise<T>& promise) {
+        TRACE_SCOPE("git", "GitService::runAsync");
+        TraceRecorder::instance().flowEnd("git", flowId);
+        GitRepoPathScope repoScope(repoPath);
+        
+        auto isCanceled = [this, &promise, generation]() {
+            return promise.isCanceled() || m_generation.load() != generation;
+        };
+        
+        if (!isCanceled()) {
+            if (!killable) {
+                promise.addResult(fn());
+                return;
+            }
+            GitCancellationScope scope(isCanceled);
+            T result = fn();
+            if (!isCanceled()) {
+                promise.addResult(std::move(result));
+                return;
+            }
+        }
+        
+        promise.future().cancel();
+    });
+}
+
 #endif // GITSERVICE_H
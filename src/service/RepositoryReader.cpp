@@ -0,0 +1,819 @@
+#include "RepositoryReader.h"
+#include "utils/Logger.h"
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr int kOidRawSize = 20;       // 仅支持 SHA-1 仓库
+constexpr int kMaxDeltaDepth = 64;    // git 默认 pack.depth 为 50
+constexpr int kMaxSymrefDepth = 5;
+
+std::atomic<bool> g_enabled{true};
+
+// 系统级 git 配置文件的可能位置
+QStringList systemConfigPaths() {
+    QStringList paths;
+    const QString overridden = qEnvironmentVariable("GIT_CONFIG_SYSTEM");
+    if (!overridden.isEmpty()) {
+        paths.append(overridden);
+    }
+#ifdef Q_OS_WIN
+    // Git for Windows: <安装目录>/etc/gitconfig（git.exe 位于 cmd/、bin/ 或 mingw64/bin/），
+    // 以及所有用户共用的 %PROGRAMDATA%/Git/config
+    const QString gitExe = QStandardPaths::findExecutable("git");
+    if (!gitExe.isEmpty()) {
+        QDir dir = QFileInfo(gitExe).absoluteDir();
+        for (int level = 0; level < 2 && dir.cdUp(); ++level) {
+            paths.append(dir.filePath("etc/gitconfig"));
+        }
+    }
+    const QString programData = qEnvironmentVariable("PROGRAMDATA");
+    if (!programData.isEmpty()) {
+        paths.append(programData + "/Git/config");
+    }
+#else
+    paths.append("/etc/gitconfig");
+#endif
+    return paths;
+}
+
+bool isHexOid(const QString& oid) {
+    if (oid.size() != kOidRawSize * 2) {
+        return false;
+    }
+    for (QChar c : oid) {
+        if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+QByteArray readSmallFile(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    return file.readAll();
+}
+
+// 解压zlib数据流；qUncompress 需要4字节大端长度前缀，长度不准时会自行扩容
+bool inflate(const uchar* src, qint64 length, quint64 expectedSize, QByteArray& out) {
+    if (length <= 0) {
+        return false;
+    }
+    QByteArray buffer;
+    buffer.reserve(length + 4);
+    const quint32 hint = quint32(qMin<quint64>(expectedSize, 0x7fffffff));
+    uchar prefix[4];
+    qToBigEndian(hint, prefix);
+    buffer.append(reinterpret_cast<const char*>(prefix), 4);
+    buffer.append(reinterpret_cast<const char*>(src), length);
+    out = qUncompress(buffer);
+    return !out.isNull() || expectedSize == 0;
+}
+
+bool readVarint(const uchar*& p, const uchar* end, quint64& value) {
+    value = 0;
+    int shift = 0;
+    uchar c;
+    do {
+        if (p >= end || shift > 63) {
+            return false;
+        }
+        c = *p++;
+        value |= quint64(c & 0x7f) << shift;
+        shift += 7;
+    } while (c & 0x80);
+    return true;
+}
+
+// 将 git delta 应用到基础对象上
+bool applyDelta(const QByteArray& base, const QByteArray& delta, QByteArray& out) {
+    const uchar* p = reinterpret_cast<const uchar*>(delta.constData());
+    const uchar* end = p + delta.size();
+
+    quint64 baseSize = 0, resultSize = 0;
+    if (!readVarint(p, end, baseSize) || !readVarint(p, end, resultSize) ||
+        baseSize != quint64(base.size()) || resultSize > 0x7fffffff) {
+        return false;
+    }
+
+    out.resize(qsizetype(resultSize));
+    char* dst = out.data();
+    quint64 written = 0;
+
+    while (p < end) {
+        const uchar op = *p++;
+        if (op & 0x80) {
+            // 从基础对象复制
+            quint64 offset = 0, size = 0;
+            for (int i = 0; i < 4; ++i) {
+                if (op & (1 << i)) {
+                    if (p >= end) return false;
+                    offset |= quint64(*p++) << (8 * i);
+                }
+            }
+            for (int i = 0; i < 3; ++i) {
+                if (op & (0x10 << i)) {
+                    if (p >= end) return false;
+                    size |= quint64(*p++) << (8 * i);
+                }
+            }
+            if (size == 0) {
+                size = 0x10000;
+            }
+            if (offset + size > baseSize || written + size > resultSize) {
+                return false;
+            }
+            memcpy(dst + written, base.constData() + offset, size_t(size));
+            written += size;
+        } else if (op) {
+            // 插入delta中的字面数据
+            if (p + op > end || written + op > resultSize) {
+                return false;
+            }
+            memcpy(dst + written, p, op);
+            p += op;
+            written += op;
+        } else {
+            return false;  // 保留指令
+        }
+    }
+
+    return written == resultSize;
+}
+
+const char* typeName(int type) {
+    switch (type) {
+        case 1: return "commit";
+        case 2: return "tree";
+        case 3: return "blob";
+        case 4: return "tag";
+        default: return nullptr;
+    }
+}
+
+}
+
+// ========== Pack ==========
+
+/**
+ * @brief 一个 pack 文件及其内存映射的 v2 索引
+ */
+struct RepositoryReader::Pack {
+    QFile idxFile;
+    QFile packFile;
+    const uchar* idx = nullptr;
+    qint64 idxSize = 0;
+    const uchar* data = nullptr;
+    qint64 dataSize = 0;
+    quint32 count = 0;
+    std::vector<quint64> sortedOffsets;  // 用于确定对象在pack中的结束位置
+
+    ~Pack() {
+        // 显式解除映射，文件句柄随 QFile 析构关闭
+        if (idx) {
+            idxFile.unmap(const_cast<uchar*>(idx));
+        }
+        if (data) {
+            packFile.unmap(const_cast<uchar*>(data));
+        }
+    }
+
+    bool open(const QString& idxPath) {
+        QString packPath = idxPath.left(idxPath.size() - 4) + ".pack";
+        idxFile.setFileName(idxPath);
+        packFile.setFileName(packPath);
+        if (!idxFile.open(QIODevice::ReadOnly) || !packFile.open(QIODevice::ReadOnly)) {
+            return false;
+        }
+
+        idxSize = idxFile.size();
+        dataSize = packFile.size();
+        idx = idxFile.map(0, idxSize);
+        data = packFile.map(0, dataSize);
+        if (!idx || !data || idxSize < 8 + 1024 || dataSize < 12 + kOidRawSize) {
+            return false;
+        }
+
+        // v2 索引: "\377tOc" + 版本号2
+        if (memcmp(idx, "\377tOc", 4) != 0 || qFromBigEndian<quint32>(idx + 4) != 2) {
+            return false;
+        }
+        if (memcmp(data, "PACK", 4) != 0) {
+            return false;
+        }
+
+        count = qFromBigEndian<quint32>(idx + 8 + 255 * 4);
+        const qint64 minSize = 8 + 1024 + qint64(count) * (kOidRawSize + 4 + 4) + 2 * kOidRawSize;
+        if (idxSize < minSize) {
+            return false;
+        }
+
+        sortedOffsets.reserve(count);
+        for (quint32 i = 0; i < count; ++i) {
+            sortedOffsets.push_back(offsetAt(i));
+        }
+        std::sort(sortedOffsets.begin(), sortedOffsets.end());
+        return true;
+    }
+
+    const uchar* oidTable() const { return idx + 8 + 1024; }
+
+    quint64 offsetAt(quint32 i) const {
+        const uchar* offsets = oidTable() + qint64(count) * (kOidRawSize + 4);
+        quint32 offset = qFromBigEndian<quint32>(offsets + qint64(i) * 4);
+        if (!(offset & 0x80000000)) {
+            return offset;
+        }
+        // 大于2GB的pack使用8字节偏移表
+        const uchar* large = offsets + qint64(count) * 4 + qint64(offset & 0x7fffffff) * 8;
+        if (large + 8 > idx + idxSize) {
+            return 0;
+        }
+        return qFromBigEndian<quint64>(large);
+    }
+
+    bool find(const QByteArray& rawOid, quint64& offset) const {
+        const uchar first = uchar(rawOid[0]);
+        const uchar* fanout = idx + 8;
+        quint32 lo = first ? qFromBigEndian<quint32>(fanout + (first - 1) * 4) : 0;
+        quint32 hi = qFromBigEndian<quint32>(fanout + first * 4);
+
+        while (lo < hi) {
+            const quint32 mid = lo + (hi - lo) / 2;
+            int cmp = memcmp(oidTable() + qint64(mid) * kOidRawSize, rawOid.constData(), kOidRawSize);
+            if (cmp == 0) {
+                offset = offsetAt(mid);
+                return offset >= 12;
+            }
+            if (cmp < 0) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return false;
+    }
+
+    // 对象压缩数据的结束位置：下一个对象的起始处，或pack末尾的校验和之前
+    quint64 objectEnd(quint64 offset) const {
+        auto it = std::upper_bound(sortedOffsets.begin(), sortedOffsets.end(), offset);
+        return it != sortedOffsets.end() ? *it : quint64(dataSize - kOidRawSize);
+    }
+};
+
+// ========== RepositoryReader ==========
+
+RepositoryReader::RepositoryReader(const QString& repoPath)
+    : m_repoPath(repoPath)
+{
+    if (repoPath.isEmpty()) {
+        return;
+    }
+
+    QString dotGit = QDir(repoPath).filePath(".git");
+    QFileInfo info(dotGit);
+    if (info.isDir()) {
+        m_gitDir = dotGit;
+    } else if (info.isFile()) {
+        // worktree / submodule: ".git" 文件内容为 "gitdir: <path>"
+        QByteArray content = readSmallFile(dotGit).trimmed();
+        if (!content.startsWith("gitdir: ")) {
+            return;
+        }
+        m_gitDir = QDir(repoPath).absoluteFilePath(QString::fromUtf8(content.mid(8)));
+    } else {
+        return;
+    }
+
+    m_commonDir = m_gitDir;
+    QByteArray commonDir = readSmallFile(m_gitDir + "/commondir").trimmed();
+    if (!commonDir.isEmpty()) {
+        m_commonDir = QDir(m_gitDir).absoluteFilePath(QString::fromUtf8(commonDir));
+    }
+    m_commonDir = QDir::cleanPath(m_commonDir);
+
+    // 不支持 reftable 与 SHA-256 仓库
+    QHash<QString, QStringList> config;
+    readConfig(config);
+    QString objectFormat = config.value("extensions.objectformat").value(0).toLower();
+    QString refStorage = config.value("extensions.refstorage").value(0).toLower();
+    if ((!objectFormat.isEmpty() && objectFormat != "sha1") ||
+        (!refStorage.isEmpty() && refStorage != "files") ||
+        QFileInfo(m_commonDir + "/reftable").exists()) {
+        LOG_INFO(QString("仓库格式不受进程内读取器支持，回退到git命令: %1").arg(repoPath));
+        return;
+    }
+
+    m_valid = QFileInfo(m_gitDir + "/HEAD").isFile();
+}
+
+RepositoryReader::~RepositoryReader() = default;
+
+void RepositoryReader::setEnabled(bool enabled) {
+    g_enabled = enabled;
+}
+
+bool RepositoryReader::isEnabled() {
+    return g_enabled.load();
+}
+
+// ========== 引用 ==========
+
+QByteArray RepositoryReader::readRefFile(const QString& path) const {
+    QByteArray content = readSmallFile(path);
+    int newline = content.indexOf('\n');
+    if (newline >= 0) {
+        content.truncate(newline);
+    }
+    return content.trimmed();
+}
+
+QHash<QByteArray, QByteArray> RepositoryReader::readPackedRefs() const {
+    // 格式: "<oid> <refname>"，"^<oid>" 为上一行标签的剥离值，"#" 开头为注释
+    QHash<QByteArray, QByteArray> refs;
+    QByteArray content = readSmallFile(m_commonDir + "/packed-refs");
+    for (const QByteArray& line : content.split('\n')) {
+        if (line.isEmpty() || line.startsWith('#') || line.startsWith('^')) {
+            continue;
+        }
+        int space = line.indexOf(' ');
+        if (space != kOidRawSize * 2) {
+            continue;
+        }
+        refs.insert(line.mid(space + 1).trimmed(), line.left(space));
+    }
+    return refs;
+}
+
+void RepositoryReader::collectLooseRefs(const QString& prefix, QHash<QByteArray, QByteArray>& refs) const {
+    const QString root = m_commonDir + "/" + prefix;
+    QDirIterator it(root, QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        QString path = it.next();
+        if (path.endsWith(".lock")) {
+            continue;
+        }
+        QByteArray content = readRefFile(path);
+        if (content.isEmpty()) {
+            continue;
+        }
+        QString name = prefix + "/" + QDir(root).relativeFilePath(path);
+        refs.insert(name.toUtf8(), content);  // 松散引用优先于 packed-refs
+    }
+}
+
+QHash<QByteArray, QByteArray> RepositoryReader::listRefs(const QString& prefix) const {
+    QHash<QByteArray, QByteArray> refs;
+    const QByteArray bytePrefix = prefix.toUtf8() + '/';
+    const QHash<QByteArray, QByteArray> packed = readPackedRefs();
+    for (auto it = packed.constBegin(); it != packed.constEnd(); ++it) {
+        if (it.key().startsWith(bytePrefix)) {
+            refs.insert(it.key(), it.value());
+        }
+    }
+    collectLooseRefs(prefix, refs);
+    return refs;
+}
+
+bool RepositoryReader::resolveRef(const QString& ref, QString& oid) const {
+    if (!m_valid || ref.contains("..")) {
+        return false;
+    }
+
+    QString name = ref;
+    for (int depth = 0; depth < kMaxSymrefDepth; ++depth) {
+        // HEAD 属于当前工作树，其余引用位于公共目录
+        const QString base = (name == "HEAD") ? m_gitDir : m_commonDir;
+        QByteArray content = readRefFile(base + "/" + name);
+        if (content.isEmpty() && name.startsWith("refs/")) {
+            content = readPackedRefs().value(name.toUtf8());
+        }
+        if (content.startsWith("ref: ")) {
+            name = QString::fromUtf8(content.mid(5).trimmed());
+            continue;
+        }
+        QString value = QString::fromLatin1(content);
+        if (!isHexOid(value)) {
+            return false;  // 未出生的分支或无法识别的内容
+        }
+        oid = value;
+        return true;
+    }
+    return false;
+}
+
+bool RepositoryReader::currentBranch(QString& branch) const {
+    if (!m_valid) {
+        return false;
+    }
+
+    QByteArray head = readRefFile(m_gitDir + "/HEAD");
+    if (head.startsWith("ref: ")) {
+        QByteArray ref = head.mid(5).trimmed();
+        if (!ref.startsWith("refs/heads/")) {
+            return false;
+        }
+        branch = QString::fromUtf8(ref.mid(11));
+        return true;
+    }
+
+    if (isHexOid(QString::fromLatin1(head))) {
+        branch.clear();  // 分离HEAD
+        return true;
+    }
+    return false;
+}
+
+bool RepositoryReader::branches(QStringList& locals, QStringList& remotes) const {
+    if (!m_valid) {
+        return false;
+    }
+
+    // git branch -a 按引用名字节序输出：先本地分支，再远程跟踪分支
+    auto collect = [this](const QString& prefix, QStringList& out) {
+        const QHash<QByteArray, QByteArray> refs = listRefs(prefix);
+        std::vector<QByteArray> names;
+        names.reserve(refs.size());
+        for (auto it = refs.constBegin(); it != refs.constEnd(); ++it) {
+            if (!it.value().startsWith("ref: ")) {  // 跳过 origin/HEAD 等符号引用
+                names.push_back(it.key());
+            }
+        }
+        std::sort(names.begin(), names.end());
+
+        const int strip = prefix.size() + 1;
+        for (const QByteArray& name : names) {
+            out.append(QString::fromUtf8(name.mid(strip)));
+        }
+    };
+
+    locals.clear();
+    remotes.clear();
+    collect("refs/heads", locals);
+    collect("refs/remotes", remotes);
+    return true;
+}
+
+bool RepositoryReader::tags(QStringList& tags) const {
+    if (!m_valid) {
+        return false;
+    }
+
+    const QHash<QByteArray, QByteArray> refs = listRefs("refs/tags");
+    std::vector<QByteArray> names;
+    names.reserve(refs.size());
+    for (auto it = refs.constBegin(); it != refs.constEnd(); ++it) {
+        names.push_back(it.key().mid(10));
+    }
+
+    // --sort=-v:refname: 版本号倒序
+    std::sort(names.begin(), names.end(), [](const QByteArray& a, const QByteArray& b) {
+        return compareVersions(a, b) > 0;
+    });
+
+    tags.clear();
+    for (const QByteArray& name : names) {
+        tags.append(QString::fromUtf8(name));
+    }
+    return true;
+}
+
+// ========== 配置 ==========
+
+bool RepositoryReader::readConfig(QHash<QString, QStringList>& values) const {
+    // 只解析本仓库的 config；键为 "section.subsection.key"，section 与 key 小写
+    QByteArray content = readSmallFile(m_commonDir + "/config");
+    bool complete = true;
+    QString section;
+
+    for (QByteArray line : content.split('\n')) {
+        line = line.trimmed();
+        if (line.isEmpty() || line.startsWith('#') || line.startsWith(';')) {
+            continue;
+        }
+
+        if (line.startsWith('[')) {
+            int close = line.lastIndexOf(']');
+            if (close < 0) {
+                return false;
+            }
+            QByteArray header = line.mid(1, close - 1).trimmed();
+            int quote = header.indexOf('"');
+            if (quote >= 0) {
+                QByteArray name = header.left(quote).trimmed().toLower();
+                QByteArray sub = header.mid(quote + 1);
+                sub.chop(sub.endsWith('"') ? 1 : 0);
+                section = QString::fromUtf8(name) + "." + QString::fromUtf8(sub);
+            } else {
+                section = QString::fromUtf8(header.toLower());
+            }
+            if (section == "include" || section.startsWith("includeif.")) {
+                complete = false;
+            }
+            continue;
+        }
+
+        int eq = line.indexOf('=');
+        QByteArray key = (eq >= 0 ? line.left(eq) : line).trimmed().toLower();
+        QByteArray value = eq >= 0 ? line.mid(eq + 1).trimmed() : QByteArray("true");
+
+        // 去除引号和行尾注释
+        QByteArray parsed;
+        bool inQuote = false;
+        for (char c : value) {
+            if (c == '"') {
+                inQuote = !inQuote;
+            } else if (!inQuote && (c == '#' || c == ';')) {
+                break;
+            } else {
+                parsed.append(c);
+            }
+        }
+
+        values[section + "." + QString::fromUtf8(key)].append(QString::fromUtf8(parsed.trimmed()));
+    }
+    return complete;
+}
+
+bool RepositoryReader::remoteUrl(const QString& remote, QString& url) const {
+    if (!m_valid) {
+        return false;
+    }
+
+    QHash<QString, QStringList> config;
+    if (!readConfig(config)) {
+        return false;  // 存在 include，可能在其他文件中定义
+    }
+
+    // url.<base>.insteadOf 可能在任意层级配置中改写URL，此时交给git处理
+    for (auto it = config.constBegin(); it != config.constEnd(); ++it) {
+        if (it.key().startsWith("url.")) {
+            return false;
+        }
+    }
+    static const QStringList globalConfigs = systemConfigPaths() + QStringList{
+        QDir::homePath() + "/.gitconfig",
+        QStandardPaths::writableLocation(QStandardPaths::GenericConfigLocation) + "/git/config"
+    };
+    for (const QString& path : globalConfigs) {
+        if (readSmallFile(path).toLower().contains("insteadof")) {
+            return false;
+        }
+    }
+
+    const QStringList urls = config.value("remote." + remote + ".url");
+    if (urls.isEmpty()) {
+        return false;
+    }
+    url = urls.first();
+    return true;
+}
+
+// ========== 对象库 ==========
+
+bool RepositoryReader::readObject(const QString& oid, QByteArray& data, QByteArray* type) {
+    if (!m_valid || !isHexOid(oid)) {
+        return false;
+    }
+
+    QByteArray objectType;
+    if (!readObjectRaw(QByteArray::fromHex(oid.toLatin1()), objectType, data, 0)) {
+        return false;
+    }
+    if (type) {
+        *type = objectType;
+    }
+    return true;
+}
+
+bool RepositoryReader::readObjectRaw(const QByteArray& rawOid, QByteArray& type, QByteArray& data, int depth) {
+    if (readLooseObject(rawOid, type, data)) {
+        return true;
+    }
+
+    QMutexLocker locker(&m_packMutex);
+    std::shared_ptr<Pack> pack;
+    quint64 offset = 0;
+    if (!findInPacks(rawOid, pack, offset)) {
+        // 可能是 gc/fetch 后新增的pack；pack 列表未变化时（如部分克隆中缺失的对象）不再重复查找
+        if (!loadPacks() || !findInPacks(rawOid, pack, offset)) {
+            return false;
+        }
+    }
+    m_lastPackUse.start();
+    locker.unlock();
+
+    return readPackedObject(*pack, offset, type, data, depth);
+}
+
+bool RepositoryReader::readLooseObject(const QByteArray& rawOid, QByteArray& type, QByteArray& data) const {
+    const QByteArray hex = rawOid.toHex();
+    QFile file(m_commonDir + "/objects/" + QString::fromLatin1(hex.left(2)) + "/" +
+               QString::fromLatin1(hex.mid(2)));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    const QByteArray compressed = file.readAll();
+    QByteArray raw;
+    if (!inflate(reinterpret_cast<const uchar*>(compressed.constData()), compressed.size(),
+                 quint64(compressed.size()) * 4, raw)) {
+        return false;
+    }
+
+    // 头部: "<type> <size>\0"
+    int nul = raw.indexOf('\0');
+    int space = raw.indexOf(' ');
+    if (nul < 0 || space < 0 || space > nul) {
+        return false;
+    }
+    type = raw.left(space);
+    data = raw.mid(nul + 1);
+    return data.size() == raw.mid(space + 1, nul - space - 1).toLongLong();
+}
+
+bool RepositoryReader::loadPacks() {
+    m_packsLoaded = true;
+
+    QDir packDir(m_commonDir + "/objects/pack");
+    const QStringList names = packDir.entryList({"*.idx"}, QDir::Files, QDir::Name);
+    if (names == m_packListing) {
+        return false;
+    }
+    m_packListing = names;
+
+    // 列表变化通常是 gc/repack/fetch 正在替换pack：全部重新打开，不继续占用可能被删除的旧文件
+    m_packs.clear();
+    for (const QString& name : names) {
+        auto pack = std::make_shared<Pack>();
+        if (!pack->open(packDir.filePath(name))) {
+            LOG_WARNING(QString("无法读取pack索引，已跳过: %1").arg(name));
+            continue;
+        }
+        m_packs.push_back(std::move(pack));
+    }
+    return true;
+}
+
+void RepositoryReader::closePacks() {
+    m_packs.clear();
+    m_packListing.clear();
+    m_packsLoaded = false;
+}
+
+void RepositoryReader::releaseIdlePacks() {
+    QMutexLocker locker(&m_packMutex);
+    if (m_packsLoaded && (!m_lastPackUse.isValid() || m_lastPackUse.hasExpired(PACK_IDLE_MS))) {
+        closePacks();
+    }
+}
+
+bool RepositoryReader::findInPacks(const QByteArray& rawOid, std::shared_ptr<Pack>& pack, quint64& offset) {
+    if (!m_packsLoaded) {
+        loadPacks();
+    }
+    for (const auto& candidate : m_packs) {
+        if (candidate->find(rawOid, offset)) {
+            pack = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool RepositoryReader::readPackedObject(Pack& pack, quint64 offset, QByteArray& type, QByteArray& data, int depth) {
+    if (depth > kMaxDeltaDepth || offset >= quint64(pack.dataSize)) {
+        return false;
+    }
+
+    const uchar* p = pack.data + offset;
+    const uchar* end = pack.data + pack.dataSize - kOidRawSize;
+
+    // 对象头: 3位类型 + 变长大小
+    uchar c = *p++;
+    const int objectType = (c >> 4) & 7;
+    quint64 size = c & 15;
+    int shift = 4;
+    while (c & 0x80) {
+        if (p >= end || shift > 60) return false;
+        c = *p++;
+        size |= quint64(c & 0x7f) << shift;
+        shift += 7;
+    }
+
+    QByteArray baseType, baseData;
+    if (objectType == 6) {
+        // OFS_DELTA: 基础对象位于同一pack中的相对偏移
+        if (p >= end) return false;
+        c = *p++;
+        quint64 relative = c & 0x7f;
+        while (c & 0x80) {
+            if (p >= end) return false;
+            c = *p++;
+            relative = ((relative + 1) << 7) | (c & 0x7f);
+        }
+        if (relative == 0 || relative > offset ||
+            !readPackedObject(pack, offset - relative, baseType, baseData, depth + 1)) {
+            return false;
+        }
+    } else if (objectType == 7) {
+        // REF_DELTA: 基础对象以对象ID引用
+        if (p + kOidRawSize > end) return false;
+        QByteArray baseOid(reinterpret_cast<const char*>(p), kOidRawSize);
+        p += kOidRawSize;
+        if (!readObjectRaw(baseOid, baseType, baseData, depth + 1)) {
+            return false;
+        }
+    } else if (!typeName(objectType)) {
+        return false;
+    }
+
+    const quint64 objectEnd = pack.objectEnd(offset);
+    const uchar* compressedEnd = pack.data + qMin<quint64>(objectEnd, quint64(end - pack.data));
+    QByteArray inflated;
+    if (!inflate(p, compressedEnd - p, size, inflated) || quint64(inflated.size()) != size) {
+        return false;
+    }
+
+    if (objectType == 6 || objectType == 7) {
+        type = baseType;
+        return applyDelta(baseData, inflated, data);
+    }
+
+    type = typeName(objectType);
+    data = inflated;
+    return true;
+}
+
+// ========== 版本号比较 ==========
+
+int RepositoryReader::compareVersions(const QByteArray& a, const QByteArray& b) {
+    // glibc strverscmp 状态机（git versioncmp 的基础实现）
+    enum { S_N = 0x0, S_I = 0x3, S_F = 0x6, S_Z = 0x9 };
+    enum { CMP = 2, LEN = 3 };
+    static const quint8 nextState[] = {
+        /*         x    d    0  */
+        /* S_N */ S_N, S_I, S_Z,
+        /* S_I */ S_N, S_I, S_I,
+        /* S_F */ S_N, S_F, S_F,
+        /* S_Z */ S_N, S_F, S_Z
+    };
+    static const qint8 resultType[] = {
+        /*         x/x  x/d  x/0  d/x  d/d  d/0  0/x  0/d  0/0 */
+        /* S_N */ CMP, CMP, CMP, CMP, LEN, CMP, CMP, CMP, CMP,
+        /* S_I */ CMP, -1,  -1,  +1,  LEN, LEN, +1,  LEN, LEN,
+        /* S_F */ CMP, CMP, CMP, CMP, CMP, CMP, CMP, CMP, CMP,
+        /* S_Z */ CMP, +1,  +1,  -1,  CMP, CMP, -1,  CMP, CMP
+    };
+
+    auto charClass = [](uchar ch) { return (ch == '0') + (ch >= '0' && ch <= '9'); };
+
+    // QByteArray::constData() 保证以 '\0' 结尾
+    const uchar* p1 = reinterpret_cast<const uchar*>(a.constData());
+    const uchar* p2 = reinterpret_cast<const uchar*>(b.constData());
+    if (p1 == p2) {
+        return 0;
+    }
+
+    uchar c1 = *p1++;
+    uchar c2 = *p2++;
+    int state = S_N + charClass(c1);
+    int diff;
+
+    while ((diff = int(c1) - int(c2)) == 0) {
+        if (c1 == '\0') {
+            return diff;
+        }
+        state = nextState[state];
+        c1 = *p1++;
+        c2 = *p2++;
+        state += charClass(c1);
+    }
+
+    state = resultType[state * 3 + charClass(c2)];
+    switch (state) {
+        case CMP:
+            return diff;
+        case LEN:
+            while (*p1 >= '0' && *p1 <= '9') {
+                ++p1;
+                if (!(*p2 >= '0' && *p2 <= '9')) {
+                    return 1;
+                }
+                ++p2;
+            }
+            return (*p2 >= '0' && *p2 <= '9') ? -1 : diff;
+        default:
+            return state;
+    }
+}
@@ -0,0 +1,90 @@
+#ifndef REPOSITORYREADER_H
+#define REPOSITORYREADER_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief 进程内只读仓库读取器
+ *
+ * 直接解析 .git 目录（HEAD、松散引用、packed-refs、config 与对象库）回答只读查询，
+ * 不启动任何 git 进程。pack 索引通过 QFile::map 内存映射后二分查找；
+ * 打开的pack在 Windows 上会阻止 git gc/repack/fetch 删除或替换pack文件，
+ * 因此 pack 列表变化时全部重新打开，空闲超过 PACK_IDLE_MS 后由 releaseIdlePacks() 关闭。
+ * 遇到不支持的仓库特性（reftable、SHA-256、url.insteadOf 等）时返回 false，
+ * 调用方应回退到 GitProcessPool 或 git 命令。所有方法均可跨线程并发调用。
+ */
+class RepositoryReader {
+public:
+    explicit RepositoryReader(const QString& repoPath);
+    ~RepositoryReader();
+
+    QString repoPath() const { return m_repoPath; }
+    bool isValid() const { return m_valid; }
+
+    // 当前分支短名；分离HEAD时为空（与 git branch --show-current 一致）
+    bool currentBranch(QString& branch) const;
+
+    // 本地分支与远程跟踪分支短名（如 "origin/develop"），按引用名字节序排列，不含符号引用
+    bool branches(QStringList& locals, QStringList& remotes) const;
+
+    // 标签名，按版本号倒序（与 git tag -l --sort=-v:refname 一致）
+    bool tags(QStringList& tags) const;
+
+    // 远程仓库URL（与 git remote get-url 一致）
+    bool remoteUrl(const QString& remote, QString& url) const;
+
+    // 解析 HEAD 或完整引用名（refs/...）到对象ID
+    bool resolveRef(const QString& ref, QString& oid) const;
+
+    // 读取对象内容，type 为 "commit"/"tree"/"blob"/"tag"
+    bool readObject(const QString& oid, QByteArray& data, QByteArray* type = nullptr);
+
+    // 超过 PACK_IDLE_MS 未读取pack时关闭全部pack，下一次读取时重新打开；由持有者定时调用
+    void releaseIdlePacks();
+    static constexpr qint64 PACK_IDLE_MS = 5000;
+
+    // 全局开关（用于基准测试对比）
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    // 版本号比较，语义与 git versioncmp (strverscmp) 相同
+    static int compareVersions(const QByteArray& a, const QByteArray& b);
+
+private:
+    struct Pack;
+
+    QByteArray readRefFile(const QString& path) const;
+    QHash<QByteArray, QByteArray> readPackedRefs() const;
+    void collectLooseRefs(const QString& prefix, QHash<QByteArray, QByteArray>& refs) const;
+    QHash<QByteArray, QByteArray> listRefs(const QString& prefix) const;
+    bool readConfig(QHash<QString, QStringList>& values) const;
+
+    bool readObjectRaw(const QByteArray& rawOid, QByteArray& type, QByteArray& data, int depth);
+    bool readLooseObject(const QByteArray& rawOid, QByteArray& type, QByteArray& data) const;
+    bool readPackedObject(Pack& pack, quint64 offset, QByteArray& type, QByteArray& data, int depth);
+    bool findInPacks(const QByteArray& rawOid, std::shared_ptr<Pack>& pack, quint64& offset);
+    // 重新列出pack索引，列表有变化时重新打开全部pack并返回 true
+    bool loadPacks();
+    void closePacks();
+
+    QString m_repoPath;
+    QString m_gitDir;     // HEAD 所在目录（worktree 时为 .git/worktrees/<name>）
+    QString m_commonDir;  // refs、objects、config 所在目录
+    bool m_valid = false;
+
+    QMutex m_packMutex;
+    std::vector<std::shared_ptr<Pack>> m_packs;  // 读取中的pack在关闭或重新扫描后仍保持有效，读完才释放
+    QStringList m_packListing;                   // 上次列出的全部索引（含读取失败的）
+    bool m_packsLoaded = false;
+    QElapsedTimer m_lastPackUse;
+};
+
+#endif // REPOSITORYREADER_H
@@ -0,0 +1,170 @@
+#include "RepositoryState.h"
+#include "utils/Logger.h"
+#include "utils/MetricsRegistry.h"
+#include "utils/TraceRecorder.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QTimer>
+
+RepositoryState::RepositoryState(GitService* gitService, QObject* parent)
+    : QObject(parent)
+    , m_gitService(gitService)
+    , m_headWatcher(new QFileSystemWatcher(this))
+    , m_changeTimer(new QTimer(this))
+{
+    m_changeTimer->setSingleShot(true);
+    m_changeTimer->setInterval(CHANGE_DEBOUNCE_MS);
+    connect(m_changeTimer, &QTimer::timeout, this, [this]() { refresh(AllParts); });
+
+    // 信号来自工作线程，指定context使其以队列方式回到UI线程
+    connect(m_gitService, &GitService::repositoryChanged, this, &RepositoryState::scheduleRefresh);
+
+    connect(m_headWatcher, &QFileSystemWatcher::fileChanged, this, [this](const QString& path) {
+        LOG_INFO(QString("监测到分支文件变化: %1").arg(path));
+        // Git在某些操作（如 checkout）时会通过重命名替换 HEAD 文件，导致监控失效，需要重新加入
+        if (!m_headWatcher->files().contains(path) && QFileInfo::exists(path)) {
+            m_headWatcher->addPath(path);
+        }
+        scheduleRefresh();
+    });
+    // 新建、删除分支会改动 refs/heads（嵌套目录与 packed-refs 的变化只能靠手动刷新或git操作通知）
+    connect(m_headWatcher, &QFileSystemWatcher::directoryChanged, this, &RepositoryState::scheduleRefresh);
+}
+
+void RepositoryState::reload() {
+    m_loaded = Parts();
+    setupHeadWatcher();
+    refresh(AllParts);
+}
+
+void RepositoryState::refresh(RepositoryState::Parts parts) {
+    m_pending |= parts;
+    if (m_outstanding > 0) {
+        return;  // 本轮结束后统一处理
+    }
+    startRefresh();
+}
+
+void RepositoryState::scheduleRefresh() {
+    m_changeTimer->start();
+}
+
+template <typename T, typename Fn>
+void RepositoryState::track(QFuture<T> future, Fn onResult) {
+    ++m_outstanding;
+    // 任务被 cancelPendingOperations() 取消时同样要结束本轮，否则后续刷新会一直挂起
+    future.then(this, [this, onResult](const T& value) {
+        onResult(value);
+        finishOne();
+    }).onCanceled(this, [this]() {
+        finishOne();
+    });
+}
+
+void RepositoryState::startRefresh() {
+    if (!m_gitService->isValidRepo()) {
+        m_pending = Parts();
+        return;
+    }
+
+    m_running = m_pending;
+    m_pending = Parts();
+    if (!m_running) {
+        return;
+    }
+
+    // 先登记全部任务再启动，避免先完成的任务提前结束本轮
+    ++m_outstanding;
+    m_roundTimer.start();
+    if (TraceRecorder::instance().isEnabled()) {
+        m_traceId = TraceRecorder::instance().nextId();
+        TraceRecorder::instance().asyncBegin("ui", "RepositoryState::refresh", m_traceId,
+                                             {{"parts", int(m_running.toInt())}});
+    }
+
+    if (m_running & CurrentBranch) {
+        track(m_gitService->getCurrentBranchAsync(), [this](const QString& branch) {
+            if (!isLoaded(CurrentBranch) || branch != m_currentBranch) {
+                m_currentBranch = branch;
+                m_loaded |= CurrentBranch;
+                emit currentBranchChanged(branch);
+            }
+        });
+    }
+
+    if (m_running & BranchList) {
+        track(m_gitService->getAllBranchesAsync(), [this](const QStringList& branches) {
+            if (!isLoaded(BranchList) || branches != m_branches) {
+                m_branches = branches;
+                m_loaded |= BranchList;
+                emit branchesChanged(branches);
+            }
+        });
+    }
+
+    if (m_running & WorkingTree) {
+        track(m_gitService->getFileStatusAsync(), [this](const QList<FileStatus>& files) {
+            if (!isLoaded(WorkingTree) || files != m_fileStatus) {
+                m_fileStatus = files;
+                m_loaded |= WorkingTree;
+                emit fileStatusChanged(files);
+            }
+        });
+    }
+
+    if (m_running & Upstream) {
+        track(m_gitService->getAheadBehindAsync(), [this](const AheadBehind& aheadBehind) {
+            if (!isLoaded(Upstream) || aheadBehind != m_aheadBehind) {
+                m_aheadBehind = aheadBehind;
+                m_loaded |= Upstream;
+                emit aheadBehindChanged(aheadBehind.first, aheadBehind.second);
+            }
+        });
+    }
+
+    finishOne();
+}
+
+void RepositoryState::finishOne() {
+    if (--m_outstanding > 0) {
+        return;
+    }
+
+    const Parts finished = m_running;
+    m_running = Parts();
+    MetricsRegistry::instance().record("ui RepositoryState.refresh", m_roundTimer.nsecsElapsed() / 1000);
+    TraceRecorder::instance().asyncEnd("ui", "RepositoryState::refresh", m_traceId);
+    m_traceId = 0;
+    emit refreshFinished(finished);
+
+    if (m_pending) {
+        startRefresh();
+    }
+}
+
+void RepositoryState::setupHeadWatcher() {
+    QStringList oldPaths = m_headWatcher->files() + m_headWatcher->directories();
+    if (!oldPaths.isEmpty()) {
+        m_headWatcher->removePaths(oldPaths);
+    }
+
+    QString repoPath = m_gitService->getRepoPath();
+    if (repoPath.isEmpty()) {
+        return;
+    }
+
+    QDir repoDir(repoPath);
+    QString headFilePath = repoDir.filePath(".git/HEAD");
+    if (QFileInfo::exists(headFilePath)) {
+        m_headWatcher->addPath(headFilePath);
+        LOG_INFO(QString("已启动分支监控: %1").arg(headFilePath));
+    } else {
+        LOG_WARNING(QString("找不到 HEAD 文件，无法建立监控: %1").arg(headFilePath));
+    }
+
+    QString headsDirPath = repoDir.filePath(".git/refs/heads");
+    if (QFileInfo(headsDirPath).isDir()) {
+        m_headWatcher->addPath(headsDirPath);
+    }
+}
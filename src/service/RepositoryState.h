@@ -0,0 +1,94 @@
+#ifndef REPOSITORYSTATE_H
+#define REPOSITORYSTATE_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QFuture>
+#include <QElapsedTimer>
+#include "GitService.h"
+
+class QFileSystemWatcher;
+class QTimer;
+
+/**
+ * @brief 共享的仓库状态模型
+ *
+ * 集中持有当前分支、分支列表、工作区文件状态与上游领先/落后提交数，
+ * 由主窗口创建并注入各视图。视图读取缓存值并订阅细粒度的变化信号，
+ * 不再各自查询 GitService。
+ *
+ * 刷新时机：.git/HEAD 或 .git/refs/heads 变化、GitService::repositoryChanged、显式调用 refresh()。
+ * 短时间内的多次变化合并为一次刷新；刷新进行中收到的请求在本轮结束后合并执行。
+ * 只有值真正变化（或首次加载）时才发出对应的信号。
+ */
+class RepositoryState : public QObject {
+    Q_OBJECT
+
+public:
+    enum Part {
+        CurrentBranch = 0x1,
+        BranchList    = 0x2,
+        WorkingTree   = 0x4,
+        Upstream      = 0x8,
+        AllParts      = CurrentBranch | BranchList | WorkingTree | Upstream
+    };
+    Q_DECLARE_FLAGS(Parts, Part)
+
+    explicit RepositoryState(GitService* gitService, QObject* parent = nullptr);
+
+    // 以下接口返回最近一次刷新的结果，不会执行git命令
+    QString currentBranch() const { return m_currentBranch; }
+    QStringList branches() const { return m_branches; }
+    QList<FileStatus> fileStatus() const { return m_fileStatus; }
+    bool hasUncommittedChanges() const { return !m_fileStatus.isEmpty(); }
+    AheadBehind aheadBehind() const { return m_aheadBehind; }
+
+    bool isLoaded(Parts parts) const { return (m_loaded & parts) == parts; }
+    bool isRefreshing() const { return m_outstanding > 0; }
+
+    // 仓库路径变化后调用：清空缓存、重建HEAD监控并全量刷新
+    void reload();
+
+public slots:
+    void refresh(RepositoryState::Parts parts = AllParts);
+
+signals:
+    void currentBranchChanged(const QString& branch);
+    void branchesChanged(const QStringList& branches);
+    void fileStatusChanged(const QList<FileStatus>& files);
+    void aheadBehindChanged(int ahead, int behind);
+    void refreshFinished(RepositoryState::Parts parts);
+
+private:
+    void startRefresh();
+    void finishOne();
+    void setupHeadWatcher();
+    void scheduleRefresh();
+
+    template <typename T, typename Fn>
+    void track(QFuture<T> future, Fn onResult);
+
+    GitService* m_gitService;
+    QFileSystemWatcher* m_headWatcher;
+    QTimer* m_changeTimer;  // 合并短时间内的多次变化通知
+
+    QString m_currentBranch;
+    QStringList m_branches;
+    QList<FileStatus> m_fileStatus;
+    AheadBehind m_aheadBehind = AheadBehind(0, 0);
+
+    Parts m_loaded;
+    Parts m_pending;   // 等待下一轮刷新的部分
+    Parts m_running;   // 本轮刷新的部分
+    int m_outstanding = 0;
+    QElapsedTimer m_roundTimer;  // 一轮刷新的耗时，记入性能指标
+    quint64 m_traceId = 0;       // 本轮刷新在时间线中的异步区间（未记录时为0）
+
+    static constexpr int CHANGE_DEBOUNCE_MS = 200;
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(RepositoryState::Parts)
+
+#endif // REPOSITORYSTATE_H
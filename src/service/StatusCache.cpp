@@ -0,0 +1,278 @@
+#include "StatusCache.h"
+#include "utils/Logger.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QMetaObject>
+#include <algorithm>
+
+StatusCache::StatusCache(QObject* parent)
+    : QObject(parent)
+    , m_watcher(new QFileSystemWatcher(this))
+{
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &StatusCache::onDirectoryChanged);
+    connect(m_watcher, &QFileSystemWatcher::fileChanged, this, &StatusCache::onFileChanged);
+}
+
+void StatusCache::setRepoPath(const QString& repoPath) {
+    {
+        QMutexLocker locker(&m_mutex);
+        if (repoPath == m_repoPath) {
+            return;
+        }
+        m_repoPath = repoPath;
+        m_entries.clear();
+        m_dirtyDirs.clear();
+        m_needsFull = true;
+        m_needsRewatch = true;
+        m_watching = false;
+    }
+
+    // 新仓库的监控在下一次全量扫描提供文件列表时建立；此处先清空旧监控
+    clearWatches();
+}
+
+void StatusCache::setFsMonitor(bool enabled) {
+    {
+        QMutexLocker locker(&m_mutex);
+        if (enabled == m_fsMonitor) {
+            return;
+        }
+        m_fsMonitor = enabled;
+        m_dirtyDirs.clear();
+        m_needsFull = true;
+        m_needsRewatch = true;  // 关闭 fsmonitor 后重新建立监控
+        m_watching = false;
+    }
+    clearWatches();
+}
+
+void StatusCache::clearWatches() {
+    QMetaObject::invokeMethod(this, [this]() {
+        QStringList oldPaths = m_watcher->files() + m_watcher->directories();
+        if (!oldPaths.isEmpty()) {
+            m_watcher->removePaths(oldPaths);
+        }
+    }, Qt::QueuedConnection);
+}
+
+StatusCache::RefreshPlan StatusCache::takeRefreshPlan() {
+    QMutexLocker locker(&m_mutex);
+    RefreshPlan plan;
+    plan.repoPath = m_repoPath;
+
+    if (m_fsMonitor) {
+        // 未变化的文件由 fsmonitor 跳过，全量扫描的代价与改动量相当
+        plan.type = RefreshType::Full;
+        m_needsFull = false;
+        m_dirtyDirs.clear();
+        return plan;
+    }
+
+    const bool expired = !m_seededAt.isValid() || m_seededAt.hasExpired(MAX_CACHE_AGE_MS);
+    if (m_needsFull || !m_watching || expired || m_dirtyDirs.contains(QString())) {
+        plan.type = RefreshType::Full;
+        plan.rewatch = m_needsRewatch;
+        m_needsFull = false;
+        m_needsRewatch = false;
+        m_dirtyDirs.clear();
+        return plan;
+    }
+
+    if (m_dirtyDirs.isEmpty()) {
+        return plan;
+    }
+
+    // 父目录会递归扫描，去掉已被覆盖的子目录
+    QStringList dirs = m_dirtyDirs.values();
+    std::sort(dirs.begin(), dirs.end());
+    for (const QString& dir : dirs) {
+        if (plan.dirs.isEmpty() || !dir.startsWith(plan.dirs.last())) {
+            plan.dirs.append(dir);
+        }
+    }
+    m_dirtyDirs.clear();
+    plan.type = RefreshType::Partial;
+    return plan;
+}
+
+QList<StatusCache::Entry> StatusCache::parsePorcelain(const QString& output) {
+    QList<Entry> entries;
+    const QStringList records = output.split(QChar('\0'), Qt::SkipEmptyParts);
+    for (int i = 0; i < records.size(); ++i) {
+        const QString& record = records[i];
+        if (record.size() < 4) {
+            continue;
+        }
+        Entry entry;
+        entry.path = record.mid(3);
+        entry.line = record;
+        const QString code = record.left(2);
+        if ((code.contains('R') || code.contains('C')) && i + 1 < records.size()) {
+            entry.line = code + ' ' + records[++i] + " -> " + entry.path;
+        }
+        entries.append(entry);
+    }
+    return entries;
+}
+
+void StatusCache::applyFull(const RefreshPlan& plan, const QList<Entry>& entries) {
+    QMutexLocker locker(&m_mutex);
+    if (plan.repoPath != m_repoPath) {
+        return;
+    }
+    m_entries.clear();
+    for (const Entry& entry : entries) {
+        m_entries.insert(entry.path, entry.line);
+    }
+    m_seededAt.start();
+}
+
+void StatusCache::applyPartial(const RefreshPlan& plan, const QList<Entry>& entries) {
+    QMutexLocker locker(&m_mutex);
+    if (plan.repoPath != m_repoPath) {
+        return;
+    }
+    for (const QString& dir : plan.dirs) {
+        auto it = m_entries.lowerBound(dir);
+        while (it != m_entries.end() && it.key().startsWith(dir)) {
+            it = m_entries.erase(it);
+        }
+    }
+    for (const Entry& entry : entries) {
+        m_entries.insert(entry.path, entry.line);
+    }
+}
+
+void StatusCache::watchFiles(const QStringList& files) {
+    QMetaObject::invokeMethod(this, [this, files]() { applyWatches(files); }, Qt::QueuedConnection);
+}
+
+void StatusCache::invalidate() {
+    QMutexLocker locker(&m_mutex);
+    m_needsFull = true;
+}
+
+QStringList StatusCache::lines() const {
+    QMutexLocker locker(&m_mutex);
+    QStringList tracked, untracked;
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        if (it.value().startsWith("??")) {
+            untracked.append(it.value());
+        } else {
+            tracked.append(it.value());
+        }
+    }
+    return tracked + untracked;
+}
+
+bool StatusCache::isWatching() const {
+    QMutexLocker locker(&m_mutex);
+    return m_watching;
+}
+
+void StatusCache::applyWatches(const QStringList& files) {
+    QStringList oldPaths = m_watcher->files() + m_watcher->directories();
+    if (!oldPaths.isEmpty()) {
+        m_watcher->removePaths(oldPaths);
+    }
+
+    QString repoPath;
+    {
+        QMutexLocker locker(&m_mutex);
+        repoPath = m_repoPath;
+        m_watching = false;
+        if (m_fsMonitor) {
+            return;
+        }
+    }
+    if (repoPath.isEmpty()) {
+        return;
+    }
+
+    // index 与 HEAD 变化意味着暂存区或分支变化，需要全量重建
+    QDir repoDir(repoPath);
+    QStringList gitFiles;
+    for (const QString& name : {QString(".git/index"), QString(".git/HEAD")}) {
+        QString path = repoDir.filePath(name);
+        if (QFileInfo::exists(path)) {
+            gitFiles.append(path);
+        }
+    }
+    if (!gitFiles.isEmpty()) {
+        m_watcher->addPaths(gitFiles);
+    }
+
+    // 目录监控只报告增删改名，文件原地写入需要监控文件本身
+    QSet<QString> dirs;
+    for (const QString& file : files) {
+        for (qsizetype slash = file.lastIndexOf('/'); slash > 0; slash = file.lastIndexOf('/', slash - 1)) {
+            const QString dir = file.left(slash);
+            if (dirs.contains(dir)) {
+                break;  // 更上层的目录已经加入
+            }
+            dirs.insert(dir);
+        }
+    }
+    if (files.size() + dirs.size() + 1 > MAX_WATCHED_PATHS) {
+        LOG_INFO(QString("被跟踪文件过多(%1)，状态缓存改为每次全量扫描，建议启用 core.fsmonitor").arg(files.size()));
+        return;
+    }
+
+    QStringList absPaths = {repoDir.absolutePath()};
+    for (const QString& dir : dirs) {
+        absPaths.append(repoDir.filePath(dir));
+    }
+    for (const QString& file : files) {
+        // 工作区中已删除的文件无法监控，重新出现时由目录监控感知
+        const QString absPath = repoDir.filePath(file);
+        if (QFileInfo::exists(absPath)) {
+            absPaths.append(absPath);
+        }
+    }
+    QStringList failed = m_watcher->addPaths(absPaths);
+    if (!failed.isEmpty()) {
+        // 监控不完整时无法保证增量结果正确，退回全量扫描
+        LOG_WARNING(QString("无法监控%1个路径，状态缓存改为每次全量扫描").arg(failed.size()));
+        m_watcher->removePaths(m_watcher->files() + m_watcher->directories());
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    if (repoPath == m_repoPath) {
+        m_watching = true;
+        // 种子扫描早于监控建立，期间的变化可能遗漏，下一次刷新重新全量扫描
+        m_needsFull = true;
+    }
+    LOG_INFO(QString("工作区状态监控已启动: %1个目录，%2个文件").arg(dirs.size() + 1).arg(files.size()));
+}
+
+void StatusCache::onDirectoryChanged(const QString& path) {
+    QMutexLocker locker(&m_mutex);
+    QString relative = QDir(m_repoPath).relativeFilePath(path);
+    if (relative == "." || relative.isEmpty()) {
+        m_dirtyDirs.insert(QString());  // 根目录变化，全量扫描
+    } else if (!relative.startsWith("..")) {
+        m_dirtyDirs.insert(relative + "/");
+    }
+}
+
+void StatusCache::onFileChanged(const QString& path) {
+    {
+        QMutexLocker locker(&m_mutex);
+        const QString relative = QDir(m_repoPath).relativeFilePath(path);
+        if (relative.startsWith(".git/")) {
+            m_needsFull = true;
+            m_needsRewatch = true;  // 暂存、提交、切换分支后被跟踪文件可能变化
+        } else if (!relative.startsWith("..")) {
+            // 被跟踪文件原地写入：重新扫描其所在目录，根目录下的文件全量扫描
+            const qsizetype slash = relative.lastIndexOf('/');
+            m_dirtyDirs.insert(slash < 0 ? QString() : relative.left(slash + 1));
+        }
+    }
+
+    // git 通过重命名 *.lock 更新 index/HEAD，编辑器也可能以改名方式保存，原监控会失效，需要重新添加
+    if (!m_watcher->files().contains(path) && QFileInfo::exists(path)) {
+        m_watcher->addPath(path);
+    }
+}
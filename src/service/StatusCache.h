@@ -0,0 +1,102 @@
+#ifndef STATUSCACHE_H
+#define STATUSCACHE_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QMap>
+#include <QSet>
+#include <QMutex>
+#include <QElapsedTimer>
+
+class QFileSystemWatcher;
+
+/**
+ * @brief 增量工作区状态缓存
+ *
+ * 变化来源有两种：
+ * - git 的 core.fsmonitor 可用时（setFsMonitor），每次刷新都全量执行 `git status --porcelain -z`，
+ *   由 fsmonitor 守护进程跳过未变化的文件，本对象只保存最近一次结果，不使用文件系统监控。
+ * - 否则首次全量扫描作为种子，之后监控被跟踪文件及其所在目录：文件原地写入（目录监控感知不到，
+ *   如 Linux inotify）与目录中的增删改名都把该目录标记为脏，只对脏目录重新执行带 pathspec 的 status。
+ *   被跟踪文件与目录合计超过 MAX_WATCHED_PATHS 时不再监控，每次都全量扫描。
+ * .git/index 或 .git/HEAD 变化（暂存、提交、切换分支等）以及缓存过期时重新全量扫描。
+ * 切换分支等破坏性操作前的检查仍应先 invalidate() 再全量扫描（见 GitService::hasUncommittedChanges）。
+ *
+ * 监控器属于创建本对象的线程（UI线程）；数据接口可在任意线程调用。
+ */
+class StatusCache : public QObject {
+    Q_OBJECT
+
+public:
+    enum class RefreshType {
+        None,     // 缓存有效，直接使用
+        Partial,  // 只需重新扫描 dirs 中的目录
+        Full      // 需要全量扫描
+    };
+
+    struct RefreshPlan {
+        RefreshType type = RefreshType::None;
+        QStringList dirs;            // 相对仓库根目录，以 '/' 结尾
+        bool rewatch = false;        // 全量扫描后需要重新提供被跟踪目录列表
+        QString repoPath;            // 取出计划时的仓库，写回结果时据此丢弃已切换仓库的扫描
+    };
+
+    struct Entry {
+        QString path;   // 当前路径（重命名/复制为新路径），未转义
+        QString line;   // "XY 路径"，重命名/复制为 "XY 旧路径 -> 新路径"
+    };
+
+    explicit StatusCache(QObject* parent = nullptr);
+
+    // 解析 `git status --porcelain -z` 的输出：路径不转义，重命名/复制的原路径是下一条记录
+    static QList<Entry> parsePorcelain(const QString& output);
+
+    void setRepoPath(const QString& repoPath);
+    // core.fsmonitor 可用时每次都全量扫描，并停止文件系统监控
+    void setFsMonitor(bool enabled);
+
+    // 取出下一次刷新需要做的工作（取出后脏目录即被清空）
+    RefreshPlan takeRefreshPlan();
+
+    // 写回扫描结果；plan 的仓库已不是当前仓库时忽略
+    void applyFull(const RefreshPlan& plan, const QList<Entry>& entries);
+    void applyPartial(const RefreshPlan& plan, const QList<Entry>& entries);
+
+    // 设置需要监控的被跟踪文件（相对路径，所在目录一并监控），可在任意线程调用
+    void watchFiles(const QStringList& files);
+
+    // 强制下一次全量扫描，如手动刷新或执行了修改仓库的命令
+    void invalidate();
+
+    // 当前缓存的状态行：已跟踪文件的变化在前，未跟踪文件在后，各自按路径排序
+    QStringList lines() const;
+
+    bool isWatching() const;
+
+    static constexpr int MAX_WATCHED_PATHS = 4096;  // 被跟踪文件与目录合计
+    static constexpr qint64 MAX_CACHE_AGE_MS = 5 * 60 * 1000;
+
+private slots:
+    void onDirectoryChanged(const QString& path);
+    void onFileChanged(const QString& path);
+
+private:
+    void applyWatches(const QStringList& files);
+    void clearWatches();
+
+    QFileSystemWatcher* m_watcher;
+    QString m_repoPath;
+
+    mutable QMutex m_mutex;
+    QMap<QString, QString> m_entries;  // 路径 -> porcelain 行
+    QSet<QString> m_dirtyDirs;
+    bool m_needsFull = true;
+    bool m_needsRewatch = true;
+    bool m_watching = false;
+    bool m_fsMonitor = false;
+    QElapsedTimer m_seededAt;
+};
+
+#endif // STATUSCACHE_H
@@ -0,0 +1,153 @@
+#include "DiagnosticsDialog.h"
+#include "api/GitLabApi.h"
+#include "utils/MetricsRegistry.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <QFile>
+#include <QDir>
+#include <QTimer>
+
+DiagnosticsDialog::DiagnosticsDialog(GitLabApi* gitLabApi, QWidget* parent)
+    : QDialog(parent)
+    , m_gitLabApi(gitLabApi)
+    , m_refreshTimer(new QTimer(this))
+{
+    setupUi();
+    refreshMetrics();
+    
+    // 对话框打开期间定时刷新
+    m_refreshTimer->setInterval(REFRESH_INTERVAL_MS);
+    connect(m_refreshTimer, &QTimer::timeout, this, &DiagnosticsDialog::refreshMetrics);
+    m_refreshTimer->start();
+}
+
+void DiagnosticsDialog::setupUi() {
+    setWindowTitle(QString::fromUtf8("诊断信息"));
+    resize(760, 480);
+    
+    QVBoxLayout* mainLayout = new QVBoxLayout(this);
+    
+    m_summaryLabel = new QLabel(this);
+    m_summaryLabel->setStyleSheet("color: #666; font-size: 11px;");
+    mainLayout->addWidget(m_summaryLabel);
+    
+    m_table = new QTableWidget(this);
+    m_table->setColumnCount(8);
+    m_table->setHorizontalHeaderLabels({
+        QString::fromUtf8("操作"), QString::fromUtf8("次数"), QString::fromUtf8("失败率"),
+        QString::fromUtf8("平均(ms)"), "p50(ms)", "p95(ms)", "p99(ms)", QString::fromUtf8("最大(ms)")
+    });
+    m_table->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    m_table->verticalHeader()->setVisible(false);
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_table->setSortingEnabled(true);
+    mainLayout->addWidget(m_table);
+    
+    QHBoxLayout* buttonLayout = new QHBoxLayout();
+    
+    QPushButton* resetButton = new QPushButton(QString::fromUtf8("清零"), this);
+    connect(resetButton, &QPushButton::clicked, this, &DiagnosticsDialog::onResetClicked);
+    buttonLayout->addWidget(resetButton);
+    
+    buttonLayout->addStretch();
+    
+    QPushButton* jsonButton = new QPushButton(QString::fromUtf8("导出JSON"), this);
+    connect(jsonButton, &QPushButton::clicked, this, &DiagnosticsDialog::onExportJson);
+    buttonLayout->addWidget(jsonButton);
+    
+    QPushButton* prometheusButton = new QPushButton(QString::fromUtf8("导出Prometheus"), this);
+    connect(prometheusButton, &QPushButton::clicked, this, &DiagnosticsDialog::onExportPrometheus);
+    buttonLayout->addWidget(prometheusButton);
+    
+    QPushButton* closeButton = new QPushButton(QString::fromUtf8("关闭"), this);
+    connect(closeButton, &QPushButton::clicked, this, &QDialog::accept);
+    buttonLayout->addWidget(closeButton);
+    
+    mainLayout->addLayout(buttonLayout);
+}
+
+void DiagnosticsDialog::refreshMetrics() {
+    const QMap<QString, MetricsRegistry::Series> series = MetricsRegistry::instance().snapshot();
+    
+    // 填充期间关闭排序，避免行在写入过程中移动
+    m_table->setSortingEnabled(false);
+    m_table->setRowCount(series.size());
+    
+    auto numberItem = [](double value, int precision) {
+        QTableWidgetItem* item = new QTableWidgetItem();
+        item->setData(Qt::DisplayRole, QString::number(value, 'f', precision).toDouble());
+        item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+        return item;
+    };
+    
+    int row = 0;
+    quint64 totalCalls = 0;
+    for (auto it = series.constBegin(); it != series.constEnd(); ++it, ++row) {
+        const MetricsRegistry::Series& s = it.value();
+        totalCalls += s.count;
+        
+        m_table->setItem(row, 0, new QTableWidgetItem(it.key()));
+        m_table->setItem(row, 1, numberItem(double(s.count), 0));
+        
+        QTableWidgetItem* errorItem = new QTableWidgetItem(QString("%1%").arg(s.errorRate() * 100, 0, 'f', 1));
+        errorItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+        if (s.errors > 0) {
+            errorItem->setForeground(QBrush(Qt::red));
+        }
+        m_table->setItem(row, 2, errorItem);
+        
+        m_table->setItem(row, 3, numberItem(s.meanMs(), 1));
+        m_table->setItem(row, 4, numberItem(s.percentileMs(0.50), 1));
+        m_table->setItem(row, 5, numberItem(s.percentileMs(0.95), 1));
+        m_table->setItem(row, 6, numberItem(s.percentileMs(0.99), 1));
+        m_table->setItem(row, 7, numberItem(s.maxUs / 1000.0, 1));
+    }
+    
+    m_table->setSortingEnabled(true);
+    
+    QString summary = QString::fromUtf8("共 %1 项操作，%2 次调用").arg(series.size()).arg(totalCalls);
+    if (m_gitLabApi) {
+        const ApiResponseCache::Stats cache = m_gitLabApi->cacheStats();
+        summary += QString::fromUtf8("；API缓存：命中 %1，重新验证 %2，未命中 %3（命中率 %4%）")
+                   .arg(cache.hits).arg(cache.revalidated).arg(cache.misses)
+                   .arg(cache.hitRate() * 100, 0, 'f', 1);
+    }
+    m_summaryLabel->setText(summary);
+}
+
+void DiagnosticsDialog::onResetClicked() {
+    MetricsRegistry::instance().reset();
+    refreshMetrics();
+}
+
+void DiagnosticsDialog::onExportJson() {
+    exportTo(QString::fromUtf8("JSON 文件 (*.json)"), "gitpilot-metrics.json",
+             MetricsRegistry::instance().toJson());
+}
+
+void DiagnosticsDialog::onExportPrometheus() {
+    exportTo(QString::fromUtf8("Prometheus 文本 (*.prom *.txt)"), "gitpilot-metrics.prom",
+             MetricsRegistry::instance().toPrometheus());
+}
+
+void DiagnosticsDialog::exportTo(const QString& filter, const QString& defaultName, const QByteArray& content) {
+    QString path = QFileDialog::getSaveFileName(this, QString::fromUtf8("导出性能指标"),
+                                                QDir::home().filePath(defaultName), filter);
+    if (path.isEmpty()) {
+        return;
+    }
+    
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(content) != content.size()) {
+        QMessageBox::warning(this, QString::fromUtf8("导出失败"),
+                             QString::fromUtf8("无法写入文件：%1\n%2").arg(path, file.errorString()));
+        return;
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef DIAGNOSTICSDIALOG_H
+#define DIAGNOSTICSDIALOG_H
+
+#include <QDialog>
+
+class QTableWidget;
+class QLabel;
+class QTimer;
+class GitLabApi;  // 前向声明
+
+/**
+ * @brief 诊断信息对话框
+ * 展示 MetricsRegistry 中各项操作的调用次数、失败率与耗时分布，以及API缓存命中率，
+ * 可导出为 JSON 或 Prometheus 文本格式。
+ */
+class DiagnosticsDialog : public QDialog {
+    Q_OBJECT
+    
+public:
+    explicit DiagnosticsDialog(GitLabApi* gitLabApi, QWidget* parent = nullptr);
+    
+private slots:
+    void refreshMetrics();
+    void onResetClicked();
+    void onExportJson();
+    void onExportPrometheus();
+    
+private:
+    void setupUi();
+    void exportTo(const QString& filter, const QString& defaultName, const QByteArray& content);
+    
+    GitLabApi* m_gitLabApi;
+    
+    QTableWidget* m_table;
+    QLabel* m_summaryLabel;
+    QTimer* m_refreshTimer;
+    
+    static constexpr int REFRESH_INTERVAL_MS = 2000;
+};
+
+#endif // DIAGNOSTICSDIALOG_H
@@ -1,8 +1,10 @@
 #include "MainWindow.h"
 #include "config/ConfigManager.h"
 #include "utils/Logger.h"
-#include "utils/Logger.h"
+#include "utils/MetricsRegistry.h"
+#include "utils/TraceRecorder.h"
 #include "SettingsDialog.h"
+#include "DiagnosticsDialog.h"
 #include "widgets/BranchSwitchDialog.h"
 #include "views/MainBranchView.h"
 #include "views/ProtectedBranchView.h"
@@ -19,12 +21,14 @@
 #include <QDir>
 #include <QFileInfo>
 #include <QTimer>
+#include <QFileDialog>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , m_gitService(new GitService(this))
     , m_gitLabApi(new GitLabApi(this))
-    , m_branchWatcher(new QFileSystemWatcher(this))
+    , m_repoState(new RepositoryState(m_gitService, this))
+    , m_conflictPredictor(new ConflictPredictor(m_gitService, m_repoState, this))
 {
     setWindowTitle("Easy Git");
     resize(600, 700);
@@ -42,8 +46,8 @@ MainWindow::MainWindow(QWidget *parent)
     
     // 延迟启动分支监控，避免阻塞窗口显示
     QTimer::singleShot(100, this, [this]() {
+        m_repoState->reload();
         loadCurrentBranch();
-        setupBranchWatcher();
     });
     
     LOG_INFO("主窗口初始化完成");
@@ -58,10 +62,10 @@ void MainWindow::setupUi() {
     setCentralWidget(m_stackedWidget);
     
     // 创建各视图（目前是占位实现）
-    m_mainBranchView = new MainBranchView(m_gitService, m_gitLabApi, this);
-    m_protectedBranchView = new ProtectedBranchView(m_gitService, m_gitLabApi, this);
-    m_featureBranchView = new FeatureBranchView(m_gitService, m_gitLabApi, this);
-    m_databaseBranchView = new DatabaseBranchView(m_gitService, m_gitLabApi, this);
+    m_mainBranchView = new MainBranchView(m_gitService, m_gitLabApi, m_repoState, this);
+    m_protectedBranchView = new ProtectedBranchView(m_gitService, m_gitLabApi, m_repoState, this);
+    m_featureBranchView = new FeatureBranchView(m_gitService, m_gitLabApi, m_repoState, m_conflictPredictor, this);
+    m_databaseBranchView = new DatabaseBranchView(m_gitService, m_gitLabApi, m_repoState, m_conflictPredictor, this);
     
     m_stackedWidget->addWidget(m_mainBranchView);
     m_stackedWidget->addWidget(m_protectedBranchView);
@@ -120,6 +124,18 @@ void MainWindow::createMenuBar() {
     connect(exitAction, &QAction::triggered, this, &QWidget::close);
     
     QMenu* helpMenu = menuBar()->addMenu("帮助(&H)");
+    QAction* diagnosticsAction = helpMenu->addAction("诊断信息(&D)");
+    connect(diagnosticsAction, &QAction::triggered, this, [this]() {
+        DiagnosticsDialog dialog(m_gitLabApi, this);
+        dialog.exec();
+    });
+    
+    QAction* traceAction = helpMenu->addAction("记录性能追踪(&T)");
+    traceAction->setCheckable(true);
+    connect(traceAction, &QAction::toggled, this, &MainWindow::setTraceRecording);
+    
+    helpMenu->addSeparator();
+    
     QAction* aboutAction = helpMenu->addAction("关于(&A)");
     connect(aboutAction, &QAction::triggered, [this]() {
         QMessageBox::about(this, "关于", 
@@ -129,59 +145,28 @@ void MainWindow::createMenuBar() {
 }
 
 void MainWindow::connectServices() {
+    // 配置修改（设置对话框等）合并后统一通知
+    connect(&ConfigManager::instance(), &ConfigManager::configChanged, this, &MainWindow::applyConfigChanges);
+    
     // Git服务信号 - 操作开始时显示进度
-    connect(m_gitService, &GitService::operationStarted, 
+    // 信号来自工作线程，必须指定context对象，使槽函数以队列方式回到UI线程执行
+    connect(m_gitService, &GitService::operationStarted, this,
             [this](const QString& op) {
         m_operationLabel->setText(QString::fromUtf8("正在执行: %1").arg(op));
     });
     
-    connect(m_gitService, &GitService::operationFinished,
+    connect(m_gitService, &GitService::operationFinished, this,
             [this](const QString& op, bool success) {
         // 操作完成后，恢复显示就绪
         m_operationLabel->setText(QString::fromUtf8("就绪"));
     });
     
-    // 文件监控器事件
-    connect(m_branchWatcher, &QFileSystemWatcher::fileChanged, this, [this](const QString& path) {
-        LOG_INFO(QString("监测到分支文件变化: %1").arg(path));
-        // Git在某些操作（如 checkout）时可能会删除并重新创建 HEAD 文件，导致 watcher 失效
-        // 因此需要重新将其加入监控
-        if (!m_branchWatcher->files().contains(path)) {
-            QFileInfo fileInfo(path);
-            if (fileInfo.exists()) {
-                m_branchWatcher->addPath(path);
-            }
-        }
-        onBranchChanged();
-    });
-}
-
-// 提取的新方法，用于随时重新配置 watcher
-void MainWindow::setupBranchWatcher() {
-    // 先清空旧的监控
-    QStringList oldFiles = m_branchWatcher->files();
-    if (!oldFiles.isEmpty()) {
-        m_branchWatcher->removePaths(oldFiles);
-    }
-    
-    ConfigManager& config = ConfigManager::instance();
-    QString repoPath = config.getRepoPath();
-    if (repoPath.isEmpty()) return;
-    
-    // 监控 .git/HEAD 文件
-    QDir repoDir(repoPath);
-    QString headFilePath = repoDir.filePath(".git/HEAD");
-    
-    QFileInfo headInfo(headFilePath);
-    if (headInfo.exists()) {
-        m_branchWatcher->addPath(headFilePath);
-        LOG_INFO(QString("已启动分支监控: %1").arg(headFilePath));
-    } else {
-        LOG_WARNING(QString("找不到 HEAD 文件，无法建立监控: %1").arg(headFilePath));
-    }
+    // 当前分支由共享状态维护（监控 .git/HEAD 并在git操作后自动刷新），变化时切换视图
+    connect(m_repoState, &RepositoryState::currentBranchChanged, this, &MainWindow::switchToAppropriateView);
 }
 
 void MainWindow::loadCurrentBranch() {
+    TRACE_SCOPE("ui", "MainWindow::loadCurrentBranch");
     if (!m_gitService->isValidRepo()) {
         // 仓库未配置或无效时，显示友好提示而不是警告弹窗
         m_operationLabel->setText(QString::fromUtf8("请在菜单 [文件 > 设置] 中配置仓库路径"));
@@ -193,14 +178,13 @@ void MainWindow::loadCurrentBranch() {
     // 启用分支按钮
     m_branchButton->setEnabled(true);
     
-    QString branch = m_gitService->getCurrentBranch();
-    if (branch != m_currentBranch) {
-        m_currentBranch = branch;
-        switchToAppropriateView(branch);
-    }
+    // 分支变化时经由 currentBranchChanged 切换视图
+    m_repoState->refresh();
 }
 
 void MainWindow::switchToAppropriateView(const QString& branchName) {
+    ScopedMetric metric("ui MainWindow.switchView");
+    TRACE_SCOPE("ui", "MainWindow::switchToAppropriateView");
     LOG_INFO(QString("切换视图: 分支=%1").arg(branchName));
     
     ConfigManager& config = ConfigManager::instance();
@@ -239,37 +223,52 @@ void MainWindow::onBranchChanged() {
 
 void MainWindow::onRefreshRequested() {
     LOG_INFO("手动刷新请求");
+    m_gitService->invalidateStatusCache();
     loadCurrentBranch();
     QMessageBox::information(this, "刷新", "已刷新当前分支状态");
 }
 
 void MainWindow::onSettingsRequested() {
+    // 保存后修改过的配置经由 configChanged 在 applyConfigChanges 中应用
     SettingsDialog dialog(this);
-    if (dialog.exec() == QDialog::Accepted) {
-        // 重新加载配置
-        ConfigManager& config = ConfigManager::instance();
-        m_gitService->setRepoPath(config.getRepoPath());
-        m_gitLabApi->setBaseUrl(config.getGitLabUrl());
-        m_gitLabApi->setApiToken(config.getGitLabToken());
-        m_gitLabApi->setProjectId(config.getCurrentProjectId());
-        
+    dialog.exec();
+}
+
+void MainWindow::applyConfigChanges(ConfigManager::Keys keys) {
+    const std::shared_ptr<const ConfigManager::Snapshot> config = ConfigManager::instance().snapshot();
+    
+    if (keys & ConfigManager::GitLabUrl) {
+        m_gitLabApi->setBaseUrl(config->gitLabUrl);
+    }
+    if (keys & ConfigManager::GitLabToken) {
+        m_gitLabApi->setApiToken(config->gitLabToken);
+    }
+    if (keys & ConfigManager::CurrentProjectId) {
+        m_gitLabApi->setProjectId(config->currentProjectId);
+    }
+    
+    if (keys & ConfigManager::RepoPath) {
+        m_gitService->setRepoPath(config->repoPath);
+        m_repoState->reload(); // 更新repoPath后需要清空缓存状态并重新设置文件监控
+    }
+    
+    // 分支规则变化会影响当前分支对应的视图
+    if (keys & (ConfigManager::RepoPath | ConfigManager::ProtectedBranches | ConfigManager::DatabaseBranch)) {
         loadCurrentBranch();
-        setupBranchWatcher(); // 更新repoPath后需要重新设置文件监控
     }
 }
 
 #include <QProgressDialog>
-#include <QtConcurrent>
-#include <QFutureWatcher>
 
 void MainWindow::onBranchSwitchClicked() {
-    QStringList branches = m_gitService->getAllBranches();
+    TRACE_SCOPE("ui", "MainWindow::onBranchSwitchClicked");
+    const QStringList branches = m_repoState->branches();
     if (branches.isEmpty()) {
         QMessageBox::information(this, "提示", "没有可用的本地分支");
         return;
     }
     
-    QString currentBranch = m_gitService->getCurrentBranch();
+    QString currentBranch = m_repoState->currentBranch();
     
     // 获取配置中的数据库分支名
     QString databaseBranch = ConfigManager::instance().getDatabaseBranchName();
@@ -285,7 +284,11 @@ void MainWindow::onBranchSwitchClicked() {
     if (targetBranch.isEmpty() || targetBranch == currentBranch) {
         return;
     }
+    
+    switchToBranch(targetBranch);
+}
 
+void MainWindow::switchToBranch(const QString& targetBranch) {
     // 创建进度条对话框
     QProgressDialog* progress = new QProgressDialog(QString::fromUtf8("正在切换分支到 %1...").arg(targetBranch), QString(), 0, 0, this);
     progress->setWindowModality(Qt::WindowModal);
@@ -293,17 +296,17 @@ void MainWindow::onBranchSwitchClicked() {
     progress->setCancelButton(nullptr); // 禁止取消
     progress->show();
     
-    // 使用 QtConcurrent 在后台线程执行切换操作
-    QFutureWatcher<bool>* watcher = new QFutureWatcher<bool>(this);
-    QFuture<bool> future = QtConcurrent::run([this, targetBranch]() {
-        return m_gitService->switchBranch(targetBranch);
-    });
+    // 整个切换过程（含后台git命令）在时间线中作为一个异步区间
+    TraceRecorder& tracer = TraceRecorder::instance();
+    const quint64 traceId = tracer.isEnabled() ? tracer.nextId() : 0;
+    if (traceId != 0) {
+        tracer.asyncBegin("ui", QString::fromUtf8("切换分支"), traceId, {{"branch", targetBranch}});
+    }
     
-    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher, progress, targetBranch]() {
-        bool success = watcher->result();
+    m_gitService->switchBranchAsync(targetBranch).then(this, [this, progress, targetBranch, traceId](bool success) {
+        TRACE_SCOPE("ui", "MainWindow::switchToBranch.finished");
         progress->close();
         progress->deleteLater();
-        watcher->deleteLater();
         
         if (success) {
             // 切换成功，不显示弹窗，直接刷新界面
@@ -313,7 +316,37 @@ void MainWindow::onBranchSwitchClicked() {
         } else {
             QMessageBox::critical(this, "错误", QString::fromUtf8("切换分支失败\n请检查是否有未提交的更改或冲突"));
         }
+        
+        TraceRecorder::instance().asyncEnd("ui", QString::fromUtf8("切换分支"), traceId, {{"success", success}});
     });
+}
+
+void MainWindow::setTraceRecording(bool enabled) {
+    TraceRecorder& tracer = TraceRecorder::instance();
+    if (enabled) {
+        tracer.start();
+        statusBar()->showMessage(QString::fromUtf8("正在记录性能追踪，再次点击菜单项结束并保存"), 5000);
+        LOG_INFO("开始记录性能追踪");
+        return;
+    }
+    
+    tracer.stop();
+    LOG_INFO("结束记录性能追踪", {{"events", tracer.eventCount()}});
     
-    watcher->setFuture(future);
+    const QString path = QFileDialog::getSaveFileName(
+        this, QString::fromUtf8("保存性能追踪"),
+        QDir::home().filePath("gitpilot-trace.json"),
+        QString::fromUtf8("Trace 文件 (*.json)"));
+    if (path.isEmpty()) {
+        return;
+    }
+    
+    QString error;
+    if (!tracer.writeTo(path, &error)) {
+        QMessageBox::warning(this, "错误", QString::fromUtf8("保存失败: %1").arg(error));
+        return;
+    }
+    QMessageBox::information(this, "提示",
+        QString::fromUtf8("已保存 %1 个事件到\n%2\n\n可在 https://ui.perfetto.dev 或 chrome://tracing 中打开查看")
+            .arg(tracer.eventCount()).arg(QDir::toNativeSeparators(path)));
 }
@@ -5,9 +5,11 @@
 #include <QStackedWidget>
 #include <QLabel>
 #include <QPushButton>
-#include <QFileSystemWatcher>
 #include "service/GitService.h"
 #include "api/GitLabApi.h"
+#include "service/RepositoryState.h"
+#include "service/ConflictPredictor.h"
+#include "config/ConfigManager.h"
 
 // 前向声明
 class MainBranchView;
@@ -38,11 +40,15 @@ private:
     void connectServices();
     void loadCurrentBranch();
     void switchToAppropriateView(const QString& branchName);
-    void setupBranchWatcher();
+    void switchToBranch(const QString& targetBranch);
+    void applyConfigChanges(ConfigManager::Keys keys);
+    void setTraceRecording(bool enabled);  // 结束时导出 Chrome trace JSON
     
     // 核心服务
     GitService* m_gitService;
     GitLabApi* m_gitLabApi;
+    RepositoryState* m_repoState;  // 各视图共享的仓库状态
+    ConflictPredictor* m_conflictPredictor;  // 后台预测当前分支与各目标分支的冲突
     
     // UI组件
     QStackedWidget* m_stackedWidget;
@@ -54,11 +60,6 @@ private:
     ProtectedBranchView* m_protectedBranchView;
     FeatureBranchView* m_featureBranchView;
     DatabaseBranchView* m_databaseBranchView;
-    
-    // 监控分支变化
-    QFileSystemWatcher* m_branchWatcher;
-    
-    QString m_currentBranch;
 };
 
 #endif // MAINWINDOW_H
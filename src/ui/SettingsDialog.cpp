@@ -336,60 +336,64 @@ void SettingsDialog::onExtractFromGit() {
     }
 
     // 使用临时GitService获取信息
-    GitService tempService(this);
-    tempService.setRepoPath(repoPath);
+    GitService* tempService = new GitService(this);
+    tempService->setRepoPath(repoPath);
     
-    if (!tempService.isValidRepo()) {
+    if (!tempService->isValidRepo()) {
+        tempService->deleteLater();
         QMessageBox::warning(this, QString::fromUtf8("错误"), 
             QString::fromUtf8("该目录不是有效的Git仓库"));
         return;
     }
     
-    // 获取远程URL
-    QString remoteUrl = tempService.getRemoteUrl();
-    if (remoteUrl.isEmpty()) {
-        QMessageBox::warning(this, QString::fromUtf8("提示"), 
-            QString::fromUtf8("未找到远程仓库(origin)配置"));
-        return;
-    }
-    
-    // 自动填充远程URL
-    m_remoteUrlEdit->setText(remoteUrl);
-    
-    // 解析项目路径及Host
-    // 支持解析Host以自动填充服务器地址
-    // 捕获组1: Base URL (https://host 或 git@host)
-    // 捕获组2: Project Path (支持多级group/subgroup/project)
-    QRegularExpression regex(R"((https?://[^/]+|git@[^:]+)(?:/|:)(.+?)(?:\.git)?$)");
-    QRegularExpressionMatch match = regex.match(remoteUrl);
-
-    if (match.hasMatch()) {
-        QString baseUrl = match.captured(1);
-        QString projectPath = match.captured(2);
+    // 获取远程URL（后台执行，避免阻塞对话框）
+    tempService->getRemoteUrlAsync().then(this, [this, tempService](const QString& remoteUrl) {
+        tempService->deleteLater();
         
-        // 如果是SSH格式 (git@domain.com), 尝试转换为HTTPS格式 (https://domain.com)
-        if (baseUrl.startsWith("git@")) {
-            baseUrl.replace("git@", "https://");
+        if (remoteUrl.isEmpty()) {
+            QMessageBox::warning(this, QString::fromUtf8("提示"), 
+                QString::fromUtf8("未找到远程仓库(origin)配置"));
+            return;
         }
+        
+        // 自动填充远程URL
+        m_remoteUrlEdit->setText(remoteUrl);
+        
+        // 解析项目路径及Host
+        // 支持解析Host以自动填充服务器地址
+        // 捕获组1: Base URL (https://host 或 git@host)
+        // 捕获组2: Project Path (支持多级group/subgroup/project)
+        QRegularExpression regex(R"((https?://[^/]+|git@[^:]+)(?:/|:)(.+?)(?:\.git)?$)");
+        QRegularExpressionMatch match = regex.match(remoteUrl);
 
-        m_gitlabUrlEdit->setText(baseUrl);
-        m_projectPathEdit->setText(projectPath);
+        if (match.hasMatch()) {
+            QString baseUrl = match.captured(1);
+            QString projectPath = match.captured(2);
+        
+            // 如果是SSH格式 (git@domain.com), 尝试转换为HTTPS格式 (https://domain.com)
+            if (baseUrl.startsWith("git@")) {
+                baseUrl.replace("git@", "https://");
+            }
 
-        // 猜测项目名称 (取最后一段)
-        QString projectName = projectPath.split('/').last();
-        m_projectNameEdit->setText(projectName);
+            m_gitlabUrlEdit->setText(baseUrl);
+            m_projectPathEdit->setText(projectPath);
 
-        QMessageBox::information(this, QString::fromUtf8("提取成功"), 
-            QString::fromUtf8("成功提取项目信息：\n\n"
-                              "服务器地址: %1\n"
-                              "项目路径: %2\n"
-                              "项目名称: %3\n\n"
-                              "请检查是否准确，特别是Token需要手动填写。").arg(baseUrl, projectPath, projectName));
-    } else {
-        QMessageBox::warning(this, QString::fromUtf8("解析失败"), 
-            QString::fromUtf8("无法从URL中解析项目路径：\n%1\n\n"
-                              "请手动填写，或确保URL格式标准。").arg(remoteUrl));
-    }
+            // 猜测项目名称 (取最后一段)
+            QString projectName = projectPath.split('/').last();
+            m_projectNameEdit->setText(projectName);
+
+            QMessageBox::information(this, QString::fromUtf8("提取成功"), 
+                QString::fromUtf8("成功提取项目信息：\n\n"
+                                  "服务器地址: %1\n"
+                                  "项目路径: %2\n"
+                                  "项目名称: %3\n\n"
+                                  "请检查是否准确，特别是Token需要手动填写。").arg(baseUrl, projectPath, projectName));
+        } else {
+            QMessageBox::warning(this, QString::fromUtf8("解析失败"), 
+                QString::fromUtf8("无法从URL中解析项目路径：\n%1\n\n"
+                                  "请手动填写，或确保URL格式标准。").arg(remoteUrl));
+        }
+    });
 }
 
 #include <QSslSocket>
@@ -430,7 +434,8 @@ void SettingsDialog::onTestConnection() {
         return;
     }
     
-    connect(m_testApi, &GitLabApi::userInfoReceived, this, [this](const UserInfo& user) {
+    // 发起测试请求（HTTP错误如401同样要恢复按钮并提示）
+    m_testApi->getCurrentUser().then(this, [this](const UserInfo& user) {
         m_testConnectionBtn->setText(QString::fromUtf8("测试连接"));
         m_testConnectionBtn->setEnabled(true);
         QMessageBox::information(this, QString::fromUtf8("连接成功"),
@@ -438,19 +443,16 @@ void SettingsDialog::onTestConnection() {
             .arg(user.username, user.name));
         m_testApi->deleteLater();
         m_testApi = nullptr;
-    });
-    
-    connect(m_testApi, &GitLabApi::networkError, this, [this](const QString& error) {
+    }).onFailed(this, [this](const ApiError& error) {
         m_testConnectionBtn->setText(QString::fromUtf8("测试连接"));
         m_testConnectionBtn->setEnabled(true);
         QMessageBox::critical(this, QString::fromUtf8("连接失败"),
-            QString::fromUtf8("网络连接错误: %1").arg(error));
+            error.isNetworkError()
+                ? QString::fromUtf8("网络连接错误: %1").arg(error.message())
+                : QString::fromUtf8("服务器返回错误: %1").arg(error.message()));
         m_testApi->deleteLater();
         m_testApi = nullptr;
     });
-    
-    // 发起测试请求
-    m_testApi->getCurrentUser();
 }
 
 void SettingsDialog::onSave() {
@@ -1,8 +1,87 @@
 #include "Logger.h"
 #include "config/ConfigManager.h"
 #include <QDir>
+#include <QFileInfo>
 #include <QStandardPaths>
 #include <QMutexLocker>
+#include <array>
+
+namespace {
+
+quint32 crc32(const QByteArray& data) {
+    static const auto table = []() {
+        std::array<quint32, 256> t{};
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+    
+    quint32 crc = 0xFFFFFFFFu;
+    for (char byte : data) {
+        crc = table[(crc ^ quint8(byte)) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+void appendLittleEndian(QByteArray& out, quint32 value) {
+    for (int i = 0; i < 4; ++i) {
+        out.append(char((value >> (8 * i)) & 0xFF));
+    }
+}
+
+// 生成标准 gzip 文件内容（任何解压工具都能打开）：
+// qCompress 输出为 4字节长度 + zlib头(2字节) + deflate数据 + adler32(4字节)，取出中间的 deflate 数据重新封装
+QByteArray gzipCompress(const QByteArray& data, qint64 mtimeSecs) {
+    const QByteArray zlib = qCompress(data, 6);
+    if (zlib.size() < 10) {
+        return QByteArray();
+    }
+    
+    QByteArray gzip;
+    gzip.reserve(zlib.size() + 12);
+    gzip.append("\x1f\x8b\x08\x00", 4);           // 魔数、deflate、无附加字段
+    appendLittleEndian(gzip, quint32(mtimeSecs));
+    gzip.append("\x00\xff", 2);                     // XFL、OS未知
+    gzip.append(zlib.constData() + 6, zlib.size() - 10);
+    appendLittleEndian(gzip, crc32(data));
+    appendLittleEndian(gzip, quint32(data.size()));
+    return gzip;
+}
+
+// logfmt：含空格、引号、等号或换行的值加引号并转义
+void appendFieldValue(QString& out, const QString& value) {
+    bool needsQuotes = value.isEmpty();
+    for (QChar ch : value) {
+        if (ch == u' ' || ch == u'"' || ch == u'=' || ch == u'\n' || ch == u'\\') {
+            needsQuotes = true;
+            break;
+        }
+    }
+    if (!needsQuotes) {
+        out += value;
+        return;
+    }
+    
+    out += '"';
+    for (QChar ch : value) {
+        if (ch == u'"' || ch == u'\\') {
+            out += '\\';
+            out += ch;
+        } else if (ch == u'\n') {
+            out += QLatin1String("\\n");
+        } else {
+            out += ch;
+        }
+    }
+    out += '"';
+}
+
+}
 
 Logger& Logger::instance() {
     static Logger instance;
@@ -14,22 +93,38 @@ Logger::Logger() {
     QString logDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/logs";
     QDir().mkpath(logDir);
     
-    QString logPath = logDir + "/gitpilot.log";
-    m_logFile.setFileName(logPath);
+    m_logPath = logDir + "/gitpilot.log";
+    m_logFile.setFileName(m_logPath);
+    
+    // 上次退出时已改名但还没压缩完的旧日志
+    const QStringList unfinished = QDir(logDir).entryList({"gitpilot.log.*.rotating"}, QDir::Files, QDir::Name);
+    for (const QString& name : unfinished) {
+        archiveSegment(logDir + "/" + name);
+    }
     
     // 以追加模式打开
-    if (m_logFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
-        m_stream.setDevice(&m_logFile);
-        
+    openLogFile();
+    if (m_logFile.isOpen()) {
         // 记录启动信息
         QString startMsg = QString("\n========== %1 ==========\n")
                           .arg(QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss"));
         m_stream << startMsg;
         m_stream.flush();
     }
+    
+    // 只在启动时读取一次配置，之后由 ConfigManager 的 setter 同步
+    ConfigManager& config = ConfigManager::instance();
+    m_enabled.store(config.isLoggingEnabled(), std::memory_order_relaxed);
+    m_minLevel.store(levelFromString(config.getLogLevel()), std::memory_order_relaxed);
+    updateThreshold();
+    if (config.isAsyncLoggingEnabled()) {
+        startWriter();
+    }
 }
 
 Logger::~Logger() {
+    stopWriter();
+    
     if (m_logFile.isOpen()) {
         m_logFile.close();
     }
@@ -51,28 +146,249 @@ void Logger::error(const QString& message) {
     log(Level::Error, message);
 }
 
-void Logger::log(Level level, const QString& message) {
-    // 检查是否启用日志
-    if (!ConfigManager::instance().isLoggingEnabled()) {
+void Logger::log(Level level, const QString& message, std::initializer_list<Field> fields) {
+    // 检查是否启用日志（宏已检查过，这里兼容直接调用）
+    if (!isEnabled(level)) {
+        return;
+    }
+    
+    Entry entry{QDateTime::currentMSecsSinceEpoch(), level, message, QList<Field>(fields)};
+    if (isAsync()) {
+        enqueue(std::move(entry));
+        return;
+    }
+    
+    QString segment;
+    {
+        QMutexLocker locker(&m_mutex); // 线程安全
+        
+        QString formattedMessage;
+        appendLine(formattedMessage, entry);
+        writeToFile(formattedMessage);
+        m_stream.flush(); // 立即写入文件
+        segment = detachSegmentIfNeeded();
+    }
+    
+    if (!segment.isEmpty()) {
+        archiveSegment(segment);
+    }
+}
+
+void Logger::setEnabled(bool enabled) {
+    m_enabled.store(enabled, std::memory_order_relaxed);
+    updateThreshold();
+}
+
+void Logger::setMinLevel(Level level) {
+    m_minLevel.store(level, std::memory_order_relaxed);
+    updateThreshold();
+}
+
+void Logger::updateThreshold() {
+    const int threshold = isEnabled() ? int(minLevel()) : int(Level::Error) + 1;
+    m_threshold.store(threshold, std::memory_order_relaxed);
+}
+
+Logger::Level Logger::levelFromString(const QString& name, Level fallback) {
+    const QString lower = name.trimmed().toLower();
+    if (lower == "debug") {
+        return Level::Debug;
+    }
+    if (lower == "info") {
+        return Level::Info;
+    }
+    if (lower == "warning" || lower == "warn") {
+        return Level::Warning;
+    }
+    if (lower == "error") {
+        return Level::Error;
+    }
+    return fallback;
+}
+
+QString Logger::levelToString(Level level) {
+    switch (level) {
+        case Level::Debug:   return "debug";
+        case Level::Info:    return "info";
+        case Level::Warning: return "warning";
+        case Level::Error:   return "error";
+    }
+    return "info";
+}
+
+void Logger::setAsync(bool async) {
+    if (async == m_writer.joinable()) {
+        return;
+    }
+    
+    if (async) {
+        startWriter();
+    } else {
+        stopWriter();
+    }
+}
+
+bool Logger::enqueue(Entry&& entry) {
+    const bool isError = entry.level == Level::Error;
+    int retries = isError ? ERROR_PUSH_RETRIES : 0;
+    
+    // tryPush 只在成功时才移走 entry，失败后可以原样重试
+    while (!m_queue.tryPush(std::move(entry))) {
+        if (retries-- <= 0) {
+            m_droppedTotal.fetch_add(1, std::memory_order_relaxed);
+            if (m_dropped.fetch_add(1, std::memory_order_relaxed) == 0) {
+                wakeWriter();
+            }
+            return false;
+        }
+        if (retries == ERROR_PUSH_RETRIES - 1) {
+            wakeWriter();
+        }
+        std::this_thread::yield();
+    }
+    
+    const quint64 count = m_enqueued.fetch_add(1, std::memory_order_release) + 1;
+    // ERROR 立即落盘；积压到缓冲区的1/4时提前唤醒写线程，避免突发日志被丢弃
+    if (isError || count % (RING_CAPACITY / 4) == 0) {
+        wakeWriter();
+    }
+    return true;
+}
+
+void Logger::wakeWriter() {
+    QMutexLocker locker(&m_wakeMutex);
+    m_wakeRequested = true;
+    m_wakeCondition.wakeOne();
+}
+
+void Logger::startWriter() {
+    {
+        QMutexLocker locker(&m_wakeMutex);
+        m_stopping = false;
+    }
+    m_writer = std::thread([this]() { writerLoop(); });
+    m_async.store(true, std::memory_order_release);
+}
+
+void Logger::stopWriter() {
+    if (!m_writer.joinable()) {
         return;
     }
     
-    QMutexLocker locker(&m_mutex); // 线程安全
+    m_async.store(false, std::memory_order_release);
+    {
+        QMutexLocker locker(&m_wakeMutex);
+        m_stopping = true;
+        m_wakeCondition.wakeOne();
+        m_drainedCondition.wakeAll();
+    }
+    m_writer.join();
     
-    QString timestamp = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss");
-    QString levelStr = getLevelString(level);
-    QString formattedMessage = QString("[%1] [%2] %3\n")
-                              .arg(timestamp)
-                              .arg(levelStr)
-                              .arg(message);
+    // 写线程退出后，切换模式前刚放入的日志由当前线程补写
+    drainQueue();
+}
+
+void Logger::flush() {
+    if (!isAsync()) {
+        return; // 同步模式每行都已刷新
+    }
     
-    writeToFile(formattedMessage);
+    const quint64 target = m_enqueued.load(std::memory_order_acquire);
+    QMutexLocker locker(&m_wakeMutex);
+    m_wakeRequested = true;
+    m_wakeCondition.wakeOne();
+    while (m_written.load(std::memory_order_acquire) < target && !m_stopping) {
+        m_drainedCondition.wait(&m_wakeMutex, FLUSH_INTERVAL_MS);
+    }
+}
+
+void Logger::writerLoop() {
+    for (;;) {
+        bool stopping = false;
+        {
+            QMutexLocker locker(&m_wakeMutex);
+            if (!m_wakeRequested && !m_stopping) {
+                m_wakeCondition.wait(&m_wakeMutex, FLUSH_INTERVAL_MS);
+            }
+            m_wakeRequested = false;
+            stopping = m_stopping;
+        }
+        
+        // 一批写满说明还有积压，继续写而不等待
+        while (drainQueue() == int(RING_CAPACITY)) {
+        }
+        
+        if (stopping) {
+            return;
+        }
+    }
+}
+
+int Logger::drainQueue() {
+    int count = 0;
+    QString segment;
+    {
+        QMutexLocker locker(&m_mutex);
+        
+        QString batch;
+        Entry entry;
+        while (count < int(RING_CAPACITY) && m_queue.tryPop(entry)) {
+            appendLine(batch, entry);
+            ++count;
+        }
+        
+        const quint64 dropped = m_dropped.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0) {
+            appendLine(batch, Entry{QDateTime::currentMSecsSinceEpoch(), Level::Warning,
+                                    QString("日志缓冲区已满，丢弃了 %1 条日志").arg(dropped), {}});
+        }
+        
+        if (!batch.isEmpty()) {
+            writeToFile(batch);
+            m_stream.flush();
+            segment = detachSegmentIfNeeded();
+        }
+    }
+    
+    // 压缩在锁外进行，不阻塞同步模式下的调用方
+    if (!segment.isEmpty()) {
+        archiveSegment(segment);
+    }
+    
+    if (count > 0) {
+        m_written.fetch_add(count, std::memory_order_release);
+    }
+    
+    QMutexLocker locker(&m_wakeMutex);
+    m_drainedCondition.wakeAll();
+    return count;
+}
+
+void Logger::appendLine(QString& out, const Entry& entry) {
+    const qint64 second = entry.timestamp / 1000;
+    if (second != m_cachedSecond) {
+        m_cachedSecond = second;
+        m_cachedTimestamp = QDateTime::fromMSecsSinceEpoch(entry.timestamp).toString("yyyy-MM-dd hh:mm:ss");
+    }
+    
+    out += '[';
+    out += m_cachedTimestamp;
+    out += QLatin1String("] [");
+    out += getLevelString(entry.level);
+    out += QLatin1String("] ");
+    out += entry.message;
+    for (const Field& field : entry.fields) {
+        out += ' ';
+        out += QLatin1String(field.key);
+        out += '=';
+        appendFieldValue(out, field.value.toString());
+    }
+    out += '\n';
 }
 
 void Logger::writeToFile(const QString& formattedMessage) {
     if (m_logFile.isOpen()) {
         m_stream << formattedMessage;
-        m_stream.flush(); // 立即写入文件
     }
 }
 
@@ -86,6 +402,73 @@ QString Logger::getLevelString(Level level) {
     }
 }
 
+// ========== 日志轮转 ==========
+
+void Logger::openLogFile() {
+    if (!m_logFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        return;
+    }
+    m_stream.setDevice(&m_logFile);
+    
+    // 沿用上次会话的日志时按文件创建时间计算分段时长
+    const QDateTime created = QFileInfo(m_logPath).birthTime();
+    const bool resumed = m_logFile.size() > 0 && created.isValid();
+    m_segmentStartMs = resumed ? created.toMSecsSinceEpoch() : QDateTime::currentMSecsSinceEpoch();
+}
+
+QString Logger::detachSegmentIfNeeded() {
+    if (!m_logFile.isOpen()) {
+        return QString();
+    }
+    
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (m_logFile.size() < MAX_FILE_BYTES && now - m_segmentStartMs < MAX_SEGMENT_AGE_SECS * 1000) {
+        return QString();
+    }
+    
+    // 只在锁内改名并重新打开，耗时的压缩交给 archiveSegment
+    const QString segment = QString("%1.%2.rotating").arg(m_logPath).arg(now);
+    m_logFile.close();
+    const bool renamed = QFile::rename(m_logPath, segment);
+    openLogFile();
+    if (!renamed) {
+        m_segmentStartMs = now; // 改名失败（如文件被占用）时推迟到下一个分段再试
+        return QString();
+    }
+    return segment;
+}
+
+void Logger::archiveSegment(const QString& segmentPath) {
+    QMutexLocker locker(&m_archiveMutex);
+    
+    QFile segment(segmentPath);
+    if (!segment.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    const QByteArray data = segment.readAll();
+    const qint64 modified = QFileInfo(segment).lastModified().toSecsSinceEpoch();
+    segment.close();
+    
+    // 依次后移：.1.gz -> .2.gz ...，超出保留数量的删除
+    QFile::remove(archivePath(MAX_ARCHIVES));
+    for (int i = MAX_ARCHIVES - 1; i >= 1; --i) {
+        if (QFile::exists(archivePath(i))) {
+            QFile::rename(archivePath(i), archivePath(i + 1));
+        }
+    }
+    
+    QFile archive(archivePath(1));
+    if (archive.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        archive.write(gzipCompress(data, modified));
+        archive.close();
+        QFile::remove(segmentPath);
+    }
+}
+
+QString Logger::archivePath(int index) const {
+    return QString("%1.%2.gz").arg(m_logPath).arg(index);
+}
+
 QString Logger::getLogFilePath() const {
     return m_logFile.fileName();
 }
@@ -102,6 +485,11 @@ void Logger::clearLogs() {
     m_logFile.close();
     
     // 重新打开
-    m_logFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text);
-    m_stream.setDevice(&m_logFile);
+    openLogFile();
+    
+    // 同时删除已压缩的旧日志
+    QMutexLocker archiveLocker(&m_archiveMutex);
+    for (int i = 1; i <= MAX_ARCHIVES; ++i) {
+        QFile::remove(archivePath(i));
+    }
 }
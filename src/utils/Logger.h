@@ -1,15 +1,34 @@
 #ifndef LOGGER_H
 #define LOGGER_H
 
+#include "MpscRingBuffer.h"
 #include <QString>
 #include <QFile>
 #include <QTextStream>
 #include <QDateTime>
 #include <QMutex>
+#include <QWaitCondition>
+#include <QVariant>
+#include <QList>
+#include <atomic>
+#include <initializer_list>
+#include <thread>
 
 /**
  * @brief 日志记录器 - 单例模式
  * 记录所有Git操作、API调用和重要事件
+ *
+ * 异步模式（默认）下调用方只把时间戳、级别和消息放入无锁环形缓冲区，
+ * 由后台写线程批量格式化并写入文件：每 FLUSH_INTERVAL_MS 刷新一次，ERROR 级别立即刷新。
+ * 缓冲区满时丢弃新日志并计数（ERROR 会先等待写线程腾出空间），丢弃数量随后写入日志。
+ * 同步模式与原来一致，每行写完即刷新到磁盘。
+ *
+ * LOG_* 宏先检查最低级别再对参数求值，被过滤的日志不会执行 QString::arg 等格式化。
+ * 可附带键值字段，按 logfmt 格式追加在消息后：
+ *     LOG_INFO("API响应", {{"endpoint", name}, {"status", 200}});
+ *     => [2024-05-10 08:30:00] [INFO ] API响应 endpoint=getProject status=200
+ * 日志文件超过 MAX_FILE_BYTES 或 MAX_SEGMENT_AGE_SECS 后轮转，
+ * 旧文件压缩为 gitpilot.log.1.gz ... gitpilot.log.N.gz，最多保留 MAX_ARCHIVES 个。
  */
 class Logger {
 public:
@@ -20,6 +39,12 @@ public:
         Error
     };
     
+    // 结构化字段；key 必须是字符串字面量（写线程格式化时才读取）
+    struct Field {
+        const char* key;
+        QVariant value;
+    };
+    
     static Logger& instance();
     
     // 日志记录方法
@@ -29,12 +54,42 @@ public:
     void error(const QString& message);
     
     // 通用日志方法
-    void log(Level level, const QString& message);
+    void log(Level level, const QString& message, std::initializer_list<Field> fields = {});
+    
+    // 日志开关（缓存ConfigManager中的配置，避免每次记录都读取QSettings）
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+    
+    // 最低记录级别，低于该级别的日志在宏中直接跳过
+    void setMinLevel(Level level);
+    Level minLevel() const { return m_minLevel.load(std::memory_order_relaxed); }
+    bool isEnabled(Level level) const { return int(level) >= m_threshold.load(std::memory_order_relaxed); }
+    
+    // "debug" / "info" / "warning" / "error"，无法识别时返回 fallback
+    static Level levelFromString(const QString& name, Level fallback = Level::Info);
+    static QString levelToString(Level level);
+    
+    // 切换异步/同步模式；切换到同步模式前会写完缓冲区中的日志
+    void setAsync(bool async);
+    bool isAsync() const { return m_async.load(std::memory_order_acquire); }
+    
+    // 阻塞直到此前记录的日志都已写入文件
+    void flush();
+    
+    // 缓冲区满而丢弃的日志条数（累计）
+    quint64 droppedCount() const { return m_droppedTotal.load(std::memory_order_relaxed); }
     
     // 日志管理
     QString getLogFilePath() const;
     void clearLogs();
     
+    static constexpr std::size_t RING_CAPACITY = 8192;      // 必须是2的幂
+    static constexpr int FLUSH_INTERVAL_MS = 200;
+    static constexpr int ERROR_PUSH_RETRIES = 1000;         // 缓冲区满时ERROR日志的最大重试次数
+    static constexpr qint64 MAX_FILE_BYTES = 10 * 1024 * 1024;
+    static constexpr qint64 MAX_SEGMENT_AGE_SECS = 24 * 3600;
+    static constexpr int MAX_ARCHIVES = 5;
+    
 private:
     Logger();
     ~Logger();
@@ -42,18 +97,74 @@ private:
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
     
+    struct Entry {
+        qint64 timestamp = 0;  // 毫秒时间戳，格式化推迟到写线程
+        Level level = Level::Info;
+        QString message;
+        QList<Field> fields;
+    };
+    
+    bool enqueue(Entry&& entry);
+    void wakeWriter();
+    void startWriter();
+    void stopWriter();
+    void writerLoop();
+    int drainQueue();
+    
+    void appendLine(QString& out, const Entry& entry);
     void writeToFile(const QString& formattedMessage);
     QString getLevelString(Level level);
     
+    // 轮转：openLogFile / detachSegment 需持有 m_mutex；archiveSegment 在锁外压缩
+    void openLogFile();
+    QString detachSegmentIfNeeded();
+    void archiveSegment(const QString& segmentPath);
+    QString archivePath(int index) const;
+    void updateThreshold();
+    
     QFile m_logFile;
     QTextStream m_stream;
-    QMutex m_mutex; // 线程安全
+    QMutex m_mutex; // 保护文件与格式化缓存
+    QMutex m_archiveMutex; // 串行化旧日志压缩
+    QString m_logPath;
+    qint64 m_segmentStartMs = 0;
+    
+    // 格式化时间戳缓存：同一秒内的日志复用字符串（受 m_mutex 保护）
+    qint64 m_cachedSecond = -1;
+    QString m_cachedTimestamp;
+    
+    std::atomic<bool> m_enabled{true};
+    std::atomic<Level> m_minLevel{Level::Info};
+    std::atomic<int> m_threshold{int(Level::Info)};  // 关闭日志时高于所有级别
+    std::atomic<bool> m_async{false};
+    
+    MpscRingBuffer<Entry> m_queue{RING_CAPACITY};
+    std::atomic<quint64> m_enqueued{0};
+    std::atomic<quint64> m_written{0};
+    std::atomic<quint64> m_dropped{0};       // 尚未报告的丢弃数
+    std::atomic<quint64> m_droppedTotal{0};
+    
+    // 写线程只在等待时使用互斥量，调用方记录日志不加锁
+    std::thread m_writer;
+    QMutex m_wakeMutex;
+    QWaitCondition m_wakeCondition;
+    QWaitCondition m_drainedCondition;
+    bool m_wakeRequested = false;
+    bool m_stopping = false;
 };
 
-// 便捷宏定义
-#define LOG_DEBUG(msg) Logger::instance().debug(msg)
-#define LOG_INFO(msg) Logger::instance().info(msg)
-#define LOG_WARNING(msg) Logger::instance().warning(msg)
-#define LOG_ERROR(msg) Logger::instance().error(msg)
+// 便捷宏定义：LOG_INFO(消息) 或 LOG_INFO(消息, {{"键", 值}, ...})
+#define LOG_AT(level, ...) \
+    do { \
+        Logger& gitpilotLogger_ = Logger::instance(); \
+        if (gitpilotLogger_.isEnabled(level)) { \
+            gitpilotLogger_.log(level, __VA_ARGS__); \
+        } \
+    } while (false)
+
+#define LOG_DEBUG(...) LOG_AT(Logger::Level::Debug, __VA_ARGS__)
+#define LOG_INFO(...) LOG_AT(Logger::Level::Info, __VA_ARGS__)
+#define LOG_WARNING(...) LOG_AT(Logger::Level::Warning, __VA_ARGS__)
+#define LOG_ERROR(...) LOG_AT(Logger::Level::Error, __VA_ARGS__)
 
 #endif // LOGGER_H
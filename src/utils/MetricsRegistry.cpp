@@ -0,0 +1,168 @@
+#include "MetricsRegistry.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <algorithm>
+
+namespace {
+
+const char* const OVERFLOW_SERIES = "other";
+
+QString prometheusLabel(const QString& value) {
+    QString escaped = value;
+    escaped.replace('\\', "\\\\").replace('"', "\\\"").replace('\n', "\\n");
+    return escaped;
+}
+
+QString seconds(qint64 us) {
+    return QString::number(us / 1e6, 'g', 9);
+}
+
+}
+
+double MetricsRegistry::Series::percentileMs(double p) const {
+    if (count == 0) {
+        return 0.0;
+    }
+
+    const double target = p * double(count);
+    quint64 cumulative = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        if (buckets[i] == 0) {
+            continue;
+        }
+        if (double(cumulative + buckets[i]) >= target) {
+            const qint64 lower = i == 0 ? 0 : BUCKET_BOUNDS_US[i - 1];
+            const qint64 upper = i < BUCKET_COUNT - 1 ? BUCKET_BOUNDS_US[i] : maxUs;
+            const double fraction = (target - double(cumulative)) / double(buckets[i]);
+            const double estimate = lower + fraction * double(upper - lower);
+            // 插值结果不会超出实际观测到的范围
+            return std::clamp(estimate, double(minUs), double(maxUs)) / 1000.0;
+        }
+        cumulative += buckets[i];
+    }
+    return maxUs / 1000.0;
+}
+
+MetricsRegistry& MetricsRegistry::instance() {
+    static MetricsRegistry instance;
+    return instance;
+}
+
+void MetricsRegistry::record(const QString& name, qint64 elapsedUs, bool success) {
+    const auto bound = std::lower_bound(BUCKET_BOUNDS_US.begin(), BUCKET_BOUNDS_US.end(), elapsedUs);
+    const int bucket = int(bound - BUCKET_BOUNDS_US.begin());
+
+    QMutexLocker locker(&m_mutex);
+    auto it = m_series.find(name);
+    if (it == m_series.end()) {
+        const QString key = m_series.size() < MAX_SERIES ? name : QString(OVERFLOW_SERIES);
+        it = m_series.find(key);
+        if (it == m_series.end()) {
+            it = m_series.insert(key, Series());
+        }
+    }
+
+    Series& series = it.value();
+    series.minUs = series.count == 0 ? elapsedUs : qMin(series.minUs, elapsedUs);
+    series.maxUs = qMax(series.maxUs, elapsedUs);
+    ++series.count;
+    if (!success) {
+        ++series.errors;
+    }
+    series.totalUs += elapsedUs;
+    ++series.buckets[bucket];
+}
+
+QMap<QString, MetricsRegistry::Series> MetricsRegistry::snapshot() const {
+    QMutexLocker locker(&m_mutex);
+    QMap<QString, Series> result;
+    for (auto it = m_series.constBegin(); it != m_series.constEnd(); ++it) {
+        result.insert(it.key(), it.value());
+    }
+    return result;
+}
+
+void MetricsRegistry::reset() {
+    QMutexLocker locker(&m_mutex);
+    m_series.clear();
+}
+
+QByteArray MetricsRegistry::toJson() const {
+    const QMap<QString, Series> series = snapshot();
+
+    QJsonArray bounds;
+    for (qint64 bound : BUCKET_BOUNDS_US) {
+        bounds.append(bound / 1000.0);
+    }
+
+    QJsonArray operations;
+    for (auto it = series.constBegin(); it != series.constEnd(); ++it) {
+        const Series& s = it.value();
+        QJsonArray buckets;
+        for (quint64 value : s.buckets) {
+            buckets.append(qint64(value));
+        }
+
+        QJsonObject op;
+        op["name"] = it.key();
+        op["count"] = qint64(s.count);
+        op["errors"] = qint64(s.errors);
+        op["error_rate"] = s.errorRate();
+        op["mean_ms"] = s.meanMs();
+        op["min_ms"] = s.minUs / 1000.0;
+        op["max_ms"] = s.maxUs / 1000.0;
+        op["p50_ms"] = s.percentileMs(0.50);
+        op["p95_ms"] = s.percentileMs(0.95);
+        op["p99_ms"] = s.percentileMs(0.99);
+        op["buckets"] = buckets;
+        operations.append(op);
+    }
+
+    QJsonObject root;
+    root["bucket_bounds_ms"] = bounds;
+    root["operations"] = operations;
+    return QJsonDocument(root).toJson(QJsonDocument::Indented);
+}
+
+QByteArray MetricsRegistry::toPrometheus() const {
+    const QMap<QString, Series> series = snapshot();
+
+    QString text;
+    text += "# HELP gitpilot_operation_duration_seconds Duration of git commands, GitLab API calls and UI refreshes.\n";
+    text += "# TYPE gitpilot_operation_duration_seconds histogram\n";
+    for (auto it = series.constBegin(); it != series.constEnd(); ++it) {
+        const QString op = prometheusLabel(it.key());
+        const Series& s = it.value();
+
+        // Prometheus 的桶是累计计数
+        quint64 cumulative = 0;
+        for (int i = 0; i < BUCKET_COUNT; ++i) {
+            cumulative += s.buckets[i];
+            const QString le = i < BUCKET_COUNT - 1 ? seconds(BUCKET_BOUNDS_US[i]) : QString("+Inf");
+            text += QString("gitpilot_operation_duration_seconds_bucket{op=\"%1\",le=\"%2\"} %3\n")
+                        .arg(op, le).arg(cumulative);
+        }
+        text += QString("gitpilot_operation_duration_seconds_sum{op=\"%1\"} %2\n").arg(op, seconds(s.totalUs));
+        text += QString("gitpilot_operation_duration_seconds_count{op=\"%1\"} %2\n").arg(op).arg(s.count);
+    }
+
+    text += "# HELP gitpilot_operation_errors_total Failed git commands and GitLab API calls.\n";
+    text += "# TYPE gitpilot_operation_errors_total counter\n";
+    for (auto it = series.constBegin(); it != series.constEnd(); ++it) {
+        text += QString("gitpilot_operation_errors_total{op=\"%1\"} %2\n")
+                    .arg(prometheusLabel(it.key())).arg(it.value().errors);
+    }
+    return text.toUtf8();
+}
+
+ScopedMetric::ScopedMetric(const QString& name)
+    : m_name(name)
+{
+    m_timer.start();
+}
+
+ScopedMetric::~ScopedMetric() {
+    MetricsRegistry::instance().record(m_name, m_timer.nsecsElapsed() / 1000, !m_failed);
+}
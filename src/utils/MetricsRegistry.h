@@ -0,0 +1,86 @@
+#ifndef METRICSREGISTRY_H
+#define METRICSREGISTRY_H
+
+#include <QString>
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QByteArray>
+#include <array>
+
+/**
+ * @brief 性能指标注册表 - 单例模式
+ *
+ * 按操作名记录耗时直方图、调用次数与失败次数，可在任意线程调用。
+ * 操作名约定：
+ *   git 命令   "git status --porcelain"（子命令与选项，不含路径、分支名等参数）
+ *   API 调用   "api listMergeRequests"（GitLabApi 的 endpointName）
+ *   界面刷新   "ui FeatureBranchView.refreshView"
+ * 可导出为 JSON 或 Prometheus 文本格式，在“帮助 > 诊断信息”中查看。
+ */
+class MetricsRegistry {
+public:
+    static constexpr int BUCKET_COUNT = 15;   // 最后一个桶为 +Inf
+    static constexpr int MAX_SERIES = 512;    // 超出后新操作名计入 "other"，防止命名失控
+
+    // 各桶上界（微秒）
+    static constexpr std::array<qint64, BUCKET_COUNT - 1> BUCKET_BOUNDS_US = {
+        1000, 2000, 5000, 10000, 25000, 50000, 100000, 250000,
+        500000, 1000000, 2500000, 5000000, 10000000, 30000000
+    };
+
+    struct Series {
+        quint64 count = 0;
+        quint64 errors = 0;
+        qint64 totalUs = 0;
+        qint64 minUs = 0;
+        qint64 maxUs = 0;
+        std::array<quint64, BUCKET_COUNT> buckets{};
+
+        double meanMs() const { return count == 0 ? 0.0 : totalUs / 1000.0 / count; }
+        double errorRate() const { return count == 0 ? 0.0 : double(errors) / double(count); }
+        // 由直方图在桶内线性插值估算，p 取 0~1
+        double percentileMs(double p) const;
+    };
+
+    static MetricsRegistry& instance();
+
+    void record(const QString& name, qint64 elapsedUs, bool success = true);
+
+    QMap<QString, Series> snapshot() const;
+    void reset();
+
+    QByteArray toJson() const;
+    QByteArray toPrometheus() const;
+
+private:
+    MetricsRegistry() = default;
+
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    mutable QMutex m_mutex;
+    QHash<QString, Series> m_series;
+};
+
+/**
+ * @brief 作用域计时：析构时把耗时记入 MetricsRegistry
+ */
+class ScopedMetric {
+public:
+    explicit ScopedMetric(const QString& name);
+    ~ScopedMetric();
+
+    void setFailed(bool failed = true) { m_failed = failed; }
+
+    ScopedMetric(const ScopedMetric&) = delete;
+    ScopedMetric& operator=(const ScopedMetric&) = delete;
+
+private:
+    QString m_name;
+    QElapsedTimer m_timer;
+    bool m_failed = false;
+};
+
+#endif // METRICSREGISTRY_H
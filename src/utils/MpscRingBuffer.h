@@ -0,0 +1,85 @@
+#ifndef MPSCRINGBUFFER_H
+#define MPSCRINGBUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+/**
+ * @brief 有界无锁多生产者单消费者环形缓冲区
+ *
+ * 每个槽位带序号：生产者通过 CAS 抢占写入位置，写完后发布序号；
+ * 唯一的消费者按顺序读取已发布的槽位。缓冲区满时 tryPush 直接返回 false，不阻塞调用方。
+ * 容量必须是2的幂。
+ */
+template <typename T>
+class MpscRingBuffer {
+public:
+    explicit MpscRingBuffer(std::size_t capacity)
+        : m_slots(new Slot[capacity])
+        , m_mask(capacity - 1)
+    {
+        for (std::size_t i = 0; i < capacity; ++i) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    
+    MpscRingBuffer(const MpscRingBuffer&) = delete;
+    MpscRingBuffer& operator=(const MpscRingBuffer&) = delete;
+    
+    // 任意线程调用；缓冲区已满时返回 false
+    bool tryPush(T&& value) {
+        std::size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        Slot* slot = nullptr;
+        for (;;) {
+            slot = &m_slots[pos & m_mask];
+            const std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            const std::ptrdiff_t diff = std::ptrdiff_t(sequence) - std::ptrdiff_t(pos);
+            if (diff == 0) {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // 消费者还没取走上一轮的数据
+            } else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        slot->value = std::move(value);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+    
+    // 只能由消费者线程调用；没有已发布的数据时返回 false
+    bool tryPop(T& value) {
+        Slot& slot = m_slots[m_dequeuePos & m_mask];
+        const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (std::ptrdiff_t(sequence) - std::ptrdiff_t(m_dequeuePos + 1) < 0) {
+            return false;
+        }
+        value = std::move(slot.value);
+        slot.value = T();
+        slot.sequence.store(m_dequeuePos + m_mask + 1, std::memory_order_release);
+        ++m_dequeuePos;
+        return true;
+    }
+    
+    std::size_t capacity() const { return m_mask + 1; }
+
+private:
+    struct Slot {
+        std::atomic<std::size_t> sequence{0};
+        T value;
+    };
+    
+    static constexpr std::size_t CACHE_LINE = 64;
+    
+    std::unique_ptr<Slot[]> m_slots;
+    const std::size_t m_mask;
+    // 生产者与消费者的位置分处不同缓存行，避免互相争用
+    alignas(CACHE_LINE) std::atomic<std::size_t> m_enqueuePos{0};
+    alignas(CACHE_LINE) std::size_t m_dequeuePos = 0;
+};
+
+#endif // MPSCRINGBUFFER_H
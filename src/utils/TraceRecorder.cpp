@@ -0,0 +1,216 @@
+#include "TraceRecorder.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QThread>
+
+namespace {
+
+std::atomic<quint64> g_nextThreadId{1};
+thread_local quint64 t_threadTraceId = 0;
+
+}
+
+TraceRecorder& TraceRecorder::instance() {
+    static TraceRecorder instance;
+    return instance;
+}
+
+TraceRecorder::TraceRecorder() {
+    m_clock.start();
+}
+
+void TraceRecorder::start() {
+    QMutexLocker locker(&m_mutex);
+    m_events.clear();
+    m_dropped = 0;
+    m_enabled.store(true, std::memory_order_relaxed);
+}
+
+void TraceRecorder::stop() {
+    m_enabled.store(false, std::memory_order_relaxed);
+}
+
+int TraceRecorder::eventCount() const {
+    QMutexLocker locker(&m_mutex);
+    return m_events.size();
+}
+
+quint64 TraceRecorder::currentThreadTraceId() {
+    if (t_threadTraceId != 0) {
+        return t_threadTraceId;
+    }
+
+    t_threadTraceId = g_nextThreadId.fetch_add(1, std::memory_order_relaxed);
+
+    // 线程名只在第一次记录时确定
+    QThread* thread = QThread::currentThread();
+    QString name;
+    if (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread()) {
+        name = QString::fromUtf8("UI线程");
+    } else if (!thread->objectName().isEmpty()) {
+        name = QString("%1 #%2").arg(thread->objectName()).arg(t_threadTraceId);
+    } else {
+        name = QString("worker #%1").arg(t_threadTraceId);
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_threadNames.insert(t_threadTraceId, name);
+    return t_threadTraceId;
+}
+
+void TraceRecorder::append(Event&& event) {
+    event.tid = currentThreadTraceId();
+
+    QMutexLocker locker(&m_mutex);
+    if (m_events.size() >= MAX_EVENTS) {
+        ++m_dropped;
+        return;
+    }
+    m_events.append(std::move(event));
+}
+
+void TraceRecorder::complete(const char* category, const QString& name, qint64 startUs, qint64 durationUs,
+                             const QVariantMap& args) {
+    if (!isEnabled()) {
+        return;
+    }
+    Event event;
+    event.phase = 'X';
+    event.category = category;
+    event.name = name;
+    event.ts = startUs;
+    event.dur = durationUs;
+    event.args = args;
+    append(std::move(event));
+}
+
+void TraceRecorder::asyncBegin(const char* category, const QString& name, quint64 id, const QVariantMap& args) {
+    if (!isEnabled()) {
+        return;
+    }
+    Event event;
+    event.phase = 'b';
+    event.category = category;
+    event.name = name;
+    event.ts = nowUs();
+    event.id = id;
+    event.args = args;
+    append(std::move(event));
+}
+
+void TraceRecorder::asyncEnd(const char* category, const QString& name, quint64 id, const QVariantMap& args) {
+    // 开始事件已记录时，即使随后关闭了记录也要写入结束事件，避免区间悬空
+    if (id == 0) {
+        return;
+    }
+    Event event;
+    event.phase = 'e';
+    event.category = category;
+    event.name = name;
+    event.ts = nowUs();
+    event.id = id;
+    event.args = args;
+    append(std::move(event));
+}
+
+quint64 TraceRecorder::flowBegin(const char* category) {
+    if (!isEnabled()) {
+        return 0;
+    }
+    Event event;
+    event.phase = 's';
+    event.category = category;
+    event.name = "flow";
+    event.ts = nowUs();
+    event.id = nextId();
+    const quint64 id = event.id;
+    append(std::move(event));
+    return id;
+}
+
+void TraceRecorder::flowEnd(const char* category, quint64 id) {
+    if (id == 0 || !isEnabled()) {
+        return;
+    }
+    Event event;
+    event.phase = 'f';
+    event.category = category;
+    event.name = "flow";
+    event.ts = nowUs();
+    event.id = id;
+    append(std::move(event));
+}
+
+bool TraceRecorder::writeTo(const QString& path, QString* error) const {
+    QVector<Event> events;
+    QHash<quint64, QString> threadNames;
+    int dropped = 0;
+    {
+        QMutexLocker locker(&m_mutex);
+        events = m_events;
+        threadNames = m_threadNames;
+        dropped = m_dropped;
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+
+    const qint64 pid = QCoreApplication::applicationPid();
+    bool first = true;
+    auto writeEvent = [&file, &first](const QJsonObject& object) {
+        file.write(first ? "\n" : ",\n");
+        file.write(QJsonDocument(object).toJson(QJsonDocument::Compact));
+        first = false;
+    };
+
+    file.write("{\"displayTimeUnit\":\"ms\",");
+    file.write(QString("\"otherData\":{\"dropped_events\":%1},").arg(dropped).toUtf8());
+    file.write("\"traceEvents\":[");
+
+    writeEvent(QJsonObject{{"ph", "M"}, {"name", "process_name"}, {"pid", pid},
+                           {"args", QJsonObject{{"name", "GitPilot"}}}});
+    for (auto it = threadNames.constBegin(); it != threadNames.constEnd(); ++it) {
+        writeEvent(QJsonObject{{"ph", "M"}, {"name", "thread_name"}, {"pid", pid}, {"tid", qint64(it.key())},
+                               {"args", QJsonObject{{"name", it.value()}}}});
+    }
+
+    for (const Event& event : events) {
+        QJsonObject object;
+        object["ph"] = QString(QChar(event.phase));
+        object["cat"] = QString::fromUtf8(event.category);
+        object["name"] = event.name;
+        object["ts"] = event.ts;
+        object["pid"] = pid;
+        object["tid"] = qint64(event.tid);
+        if (event.phase == 'X') {
+            object["dur"] = event.dur;
+        }
+        if (event.id != 0) {
+            object["id"] = QString("0x%1").arg(event.id, 0, 16);
+        }
+        if (event.phase == 'f') {
+            object["bp"] = "e";  // 绑定到包含该时间点的区间
+        }
+        if (!event.args.isEmpty()) {
+            object["args"] = QJsonObject::fromVariantMap(event.args);
+        }
+        writeEvent(object);
+    }
+
+    file.write("\n]}\n");
+    if (file.error() != QFileDevice::NoError) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+    return true;
+}
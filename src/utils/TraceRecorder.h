@@ -0,0 +1,126 @@
+#ifndef TRACERECORDER_H
+#define TRACERECORDER_H
+
+#include <QString>
+#include <QVariantMap>
+#include <QVector>
+#include <QHash>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <atomic>
+
+/**
+ * @brief 会话时间线记录器 - 单例模式
+ *
+ * 记录嵌套的耗时区间，导出为 Chrome trace-event JSON，可直接拖入 https://ui.perfetto.dev 查看。
+ *   同步区间   TRACE_SCOPE("git", "GitService::switchBranch")，按线程嵌套显示
+ *   异步区间   asyncBegin/asyncEnd（如一次API请求、一轮仓库状态刷新），单独成轨
+ *   跨线程关联 flowBegin/flowEnd，在提交任务的区间与工作线程中的区间之间画箭头
+ * 默认关闭；关闭时每个记录点只有一次原子读取，不分配内存、不取时间。
+ * 最多保留 MAX_EVENTS 个事件，超出后丢弃新事件。
+ */
+class TraceRecorder {
+public:
+    static constexpr int MAX_EVENTS = 500000;
+
+    static TraceRecorder& instance();
+
+    bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    // 清空已有事件并开始记录 / 停止记录（保留事件以便导出）
+    void start();
+    void stop();
+
+    int eventCount() const;
+    bool writeTo(const QString& path, QString* error = nullptr) const;
+
+    qint64 nowUs() const { return m_clock.nsecsElapsed() / 1000; }
+    quint64 nextId() { return m_nextId.fetch_add(1, std::memory_order_relaxed); }
+
+    void complete(const char* category, const QString& name, qint64 startUs, qint64 durationUs,
+                  const QVariantMap& args = QVariantMap());
+    void asyncBegin(const char* category, const QString& name, quint64 id, const QVariantMap& args = QVariantMap());
+    void asyncEnd(const char* category, const QString& name, quint64 id, const QVariantMap& args = QVariantMap());
+
+    // 未在记录时返回 0；flowEnd 需在目标区间内调用
+    quint64 flowBegin(const char* category);
+    void flowEnd(const char* category, quint64 id);
+
+private:
+    TraceRecorder();
+
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    struct Event {
+        char phase = 'X';
+        const char* category = "";
+        QString name;
+        qint64 ts = 0;
+        qint64 dur = 0;
+        quint64 id = 0;
+        quint64 tid = 0;
+        QVariantMap args;
+    };
+
+    void append(Event&& event);
+    quint64 currentThreadTraceId();
+
+    mutable QMutex m_mutex;
+    QVector<Event> m_events;
+    QHash<quint64, QString> m_threadNames;
+    int m_dropped = 0;
+
+    QElapsedTimer m_clock;
+    std::atomic<bool> m_enabled{false};
+    std::atomic<quint64> m_nextId{1};
+};
+
+/**
+ * @brief 作用域区间：构造时开始、析构时结束
+ * name 必须是字符串字面量，关闭记录时不做任何格式化。
+ */
+class TraceSpan {
+public:
+    TraceSpan(const char* category, const char* name)
+        : m_active(TraceRecorder::instance().isEnabled())
+        , m_category(category)
+        , m_name(name)
+    {
+        if (m_active) {
+            m_startUs = TraceRecorder::instance().nowUs();
+        }
+    }
+
+    ~TraceSpan() {
+        if (m_active) {
+            TraceRecorder& recorder = TraceRecorder::instance();
+            recorder.complete(m_category, QString::fromUtf8(m_name), m_startUs, recorder.nowUs() - m_startUs, m_args);
+        }
+    }
+
+    bool isActive() const { return m_active; }
+
+    // 附加参数（在 Perfetto 的详情面板中显示）；调用方应先检查 isActive() 以免无谓地构造参数
+    void addArg(const QString& key, const QVariant& value) {
+        if (m_active) {
+            m_args.insert(key, value);
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    bool m_active;
+    const char* m_category;
+    const char* m_name;
+    qint64 m_startUs = 0;
+    QVariantMap m_args;
+};
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+#define TRACE_SCOPE(category, name) TraceSpan TRACE_CONCAT(traceSpan_, __LINE__)(category, name)
+
+#endif // TRACERECORDER_H
@@ -1,5 +1,6 @@
 #include "DatabaseBranchView.h"
 #include "service/GitService.h"
+#include "service/RepositoryState.h"
 #include "api/GitLabApi.h"
 #include "widgets/MrZone.h"
 #include <QVBoxLayout>
@@ -12,13 +13,15 @@
 #include <QInputDialog>
 #include <QProgressDialog>
 #include <QApplication>
-#include <QtConcurrent>
-#include <QFutureWatcher>
+#include <QFuture>
 
-DatabaseBranchView::DatabaseBranchView(GitService* gitService, GitLabApi* gitLabApi, QWidget* parent)
+DatabaseBranchView::DatabaseBranchView(GitService* gitService, GitLabApi* gitLabApi, RepositoryState* repoState,
+                                       ConflictPredictor* conflictPredictor, QWidget* parent)
     : QWidget(parent)
     , m_gitService(gitService)
     , m_gitLabApi(gitLabApi)
+    , m_repoState(repoState)
+    , m_conflictPredictor(conflictPredictor)
 {
     setupUi();
     connectSignals();
@@ -183,7 +186,7 @@ void DatabaseBranchView::setupUi() {
     mainLayout->addWidget(remoteGroup);
     
     // MR提交专区（目标锁定为develop）
-    m_mrZone = new MrZone(m_gitService, m_gitLabApi, this);
+    m_mrZone = new MrZone(m_gitService, m_gitLabApi, m_conflictPredictor, this);
     mainLayout->addWidget(m_mrZone);
     
     mainLayout->addStretch();
@@ -198,6 +201,14 @@ void DatabaseBranchView::connectSignals() {
     // MR Zone信号
     connect(m_mrZone, &MrZone::conflictCheckRequested, this, &DatabaseBranchView::onConflictCheckRequested);
     connect(m_mrZone, &MrZone::mrSubmitted, this, &DatabaseBranchView::onMrSubmitted);
+    
+    // 共享仓库状态变化
+    connect(m_repoState, &RepositoryState::fileStatusChanged, this, &DatabaseBranchView::onFileStatusChanged);
+    connect(m_repoState, &RepositoryState::currentBranchChanged, this, [this]() {
+        if (isVisible()) {
+            updateMrZone();
+        }
+    });
 }
 
 void DatabaseBranchView::showEvent(QShowEvent* event) {
@@ -207,10 +218,16 @@ void DatabaseBranchView::showEvent(QShowEvent* event) {
 }
 
 void DatabaseBranchView::updateFileList() {
+    // 先显示缓存结果；状态有变化时通过 fileStatusChanged 更新列表
+    if (m_repoState->isLoaded(RepositoryState::WorkingTree)) {
+        onFileStatusChanged(m_repoState->fileStatus());
+    }
+    m_repoState->refresh(RepositoryState::WorkingTree);
+}
+
+void DatabaseBranchView::onFileStatusChanged(const QList<FileStatus>& fileStatuses) {
     m_filesListWidget->clear();
     
-    QList<FileStatus> fileStatuses = m_gitService->getFileStatus();
-    
     if (fileStatuses.isEmpty()) {
         m_filesListWidget->addItem(QString::fromUtf8("💚 工作区干净"));
     } else {
@@ -221,11 +238,16 @@ void DatabaseBranchView::updateFileList() {
 }
 
 void DatabaseBranchView::updateMrZone() {
-    QString currentBranch = m_gitService->getCurrentBranch();
-    m_mrZone->updateForBranch(currentBranch);
+    if (!m_repoState->isLoaded(RepositoryState::CurrentBranch)) {
+        // 加载完成后经 currentBranchChanged 回到这里
+        m_repoState->refresh(RepositoryState::CurrentBranch);
+        return;
+    }
+    m_mrZone->updateForBranch(m_repoState->currentBranch());
 }
 
 void DatabaseBranchView::onRefreshClicked() {
+    m_gitService->invalidateStatusCache();
     updateFileList();
 }
 
@@ -239,25 +261,28 @@ void DatabaseBranchView::onCommitClicked() {
     }
     
     // 先暂存所有修改
-    bool stageSuccess = m_gitService->stageAll();
-    if (!stageSuccess) {
-        QMessageBox::warning(this, QString::fromUtf8("暂存失败"),
-            QString::fromUtf8("暂存文件失败，请检查Git状态"));
-        return;
-    }
-    
-    if (m_gitService->commit(message)) {
-        QMessageBox::information(this, QString::fromUtf8("提交成功"),
-            QString::fromUtf8("✅ 代码已提交到本地仓库"));
-        updateFileList();
-    } else {
-        QMessageBox::warning(this, QString::fromUtf8("提交失败"),
-            QString::fromUtf8("提交失败，请检查是否有文件已暂存"));
-    }
+    m_gitService->stageAllAsync().then(this, [this, message](bool stageSuccess) {
+        if (!stageSuccess) {
+            QMessageBox::warning(this, QString::fromUtf8("暂存失败"),
+                QString::fromUtf8("暂存文件失败，请检查Git状态"));
+            return;
+        }
+        
+        m_gitService->commitAsync(message).then(this, [this](bool success) {
+            if (success) {
+                QMessageBox::information(this, QString::fromUtf8("提交成功"),
+                    QString::fromUtf8("✅ 代码已提交到本地仓库"));
+                updateFileList();
+            } else {
+                QMessageBox::warning(this, QString::fromUtf8("提交失败"),
+                    QString::fromUtf8("提交失败，请检查是否有文件已暂存"));
+            }
+        });
+    });
 }
 
 void DatabaseBranchView::onPullClicked() {
-    QString currentBranch = m_gitService->getCurrentBranch();
+    const QString currentBranch = m_repoState->currentBranch();
     
     int ret = QMessageBox::question(
         this,
@@ -281,14 +306,9 @@ void DatabaseBranchView::onPullClicked() {
     progress->setValue(0);
     progress->show();
     
-    QFutureWatcher<bool>* watcher = new QFutureWatcher<bool>(this);
-    
-    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher, progress]() {
-        bool success = watcher->result();
-        
+    m_gitService->pullLatestAsync().then(this, [this, progress](bool success) {
         progress->close();
         progress->deleteLater();
-        watcher->deleteLater();
         
         if (success) {
             QMessageBox::information(this, QString::fromUtf8("拉取成功"),
@@ -299,16 +319,10 @@ void DatabaseBranchView::onPullClicked() {
                 QString::fromUtf8("拉取失败，请检查网络连接或是否存在冲突"));
         }
     });
-    
-    QFuture<bool> future = QtConcurrent::run([this]() {
-        return m_gitService->pullLatest();
-    });
-    
-    watcher->setFuture(future);
 }
 
 void DatabaseBranchView::onPushClicked() {
-    QString currentBranch = m_gitService->getCurrentBranch();
+    const QString currentBranch = m_repoState->currentBranch();
     
     int ret = QMessageBox::question(
         this,
@@ -332,14 +346,9 @@ void DatabaseBranchView::onPushClicked() {
     progress->setValue(0);
     progress->show();
     
-    QFutureWatcher<bool>* watcher = new QFutureWatcher<bool>(this);
-    
-    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher, progress]() {
-        bool success = watcher->result();
-        
+    m_gitService->pushBranchAsync(currentBranch, true).then(this, [this, progress](bool success) {
         progress->close();
         progress->deleteLater();
-        watcher->deleteLater();
         
         if (success) {
             QMessageBox::information(this, QString::fromUtf8("推送成功"),
@@ -349,12 +358,6 @@ void DatabaseBranchView::onPushClicked() {
                 QString::fromUtf8("推送失败，请检查网络连接和权限"));
         }
     });
-    
-    QFuture<bool> future = QtConcurrent::run([this, currentBranch]() {
-        return m_gitService->pushBranch(currentBranch, true);
-    });
-    
-    watcher->setFuture(future);
 }
 
 void DatabaseBranchView::onConflictCheckRequested(const QString& targetBranch) {
@@ -369,17 +372,13 @@ void DatabaseBranchView::onConflictCheckRequested(const QString& targetBranch) {
     progress->setValue(0);
     progress->show();
     
-    typedef QPair<bool, QString> CheckResult;
-    QFutureWatcher<CheckResult>* watcher = new QFutureWatcher<CheckResult>(this);
-    
-    connect(watcher, &QFutureWatcher<CheckResult>::finished, this, [this, watcher, progress, targetBranch]() {
-        CheckResult result = watcher->result();
+    m_gitService->checkMergeConflictAsync(targetBranch).then(this,
+        [this, progress, targetBranch](const MergeCheckResult& result) {
         bool hasNoConflict = result.first;
         QString conflictInfo = result.second;
         
         progress->close();
         progress->deleteLater();
-        watcher->deleteLater();
         
         if (hasNoConflict) {
             QMessageBox msgBox(this);
@@ -415,18 +414,10 @@ void DatabaseBranchView::onConflictCheckRequested(const QString& targetBranch) {
             msgBox.exec();
         }
     });
-    
-    QFuture<CheckResult> future = QtConcurrent::run([this, targetBranch]() {
-        QString info;
-        bool result = m_gitService->checkMergeConflict(targetBranch, info);
-        return qMakePair(result, info);
-    });
-    
-    watcher->setFuture(future);
 }
 
 void DatabaseBranchView::onMrSubmitted(const QString& targetBranch, const QString& title, const QString& description) {
-    QString sourceBranch = m_gitService->getCurrentBranch();
+    const QString sourceBranch = m_repoState->currentBranch();
     
     MrParams params;
     params.sourceBranch = sourceBranch;
@@ -448,59 +439,45 @@ void DatabaseBranchView::onMrSubmitted(const QString& targetBranch, const QStrin
     progress->show();
     QApplication::processEvents();
     
-    connect(m_gitLabApi, &GitLabApi::mergeRequestCreated, this, 
-        [this, progress](const MrResponse& mr) {
-            progress->close();
-            progress->deleteLater();
-            
-            QString message = QString(
-                "<h3 style='color: green;'>✅ 合并请求创建成功！</h3>"
-                "<p><b>编号:</b> %1</p>"
-                "<p><b>标题:</b> %2</p>"
-                "<p><b>状态:</b> %3</p>"
-                "<p><b>链接:</b> ⬇️⬇️⬇️ <br>"
-                "<a href='%4'>%4</a></p>"
-                "<p style='color: #666; font-size: 11px;'>💡 点击链接在浏览器中查看合并请求详情</p>"
-            ).arg(mr.iid).arg(mr.title, mr.state, mr.webUrl);
-            
-            QMessageBox msgBox(this);
-            msgBox.setWindowTitle(QString::fromUtf8("合并请求创建成功"));
-            msgBox.setTextFormat(Qt::RichText);
-            msgBox.setText(message);
-            msgBox.setIcon(QMessageBox::NoIcon);
-            msgBox.setStandardButtons(QMessageBox::Ok);
-            msgBox.setDefaultButton(QMessageBox::Ok);
-            msgBox.setMinimumWidth(255);
-            msgBox.setTextInteractionFlags(Qt::TextBrowserInteraction);
-            msgBox.exec();
-            
-            disconnect(m_gitLabApi, &GitLabApi::mergeRequestCreated, this, nullptr);
-            disconnect(m_gitLabApi, &GitLabApi::apiError, this, nullptr);
-        });
-    
-    connect(m_gitLabApi, &GitLabApi::apiError, this,
-        [this, progress](const QString& endpoint, const QString& errorMessage) {
-            if (endpoint.contains("merge_request")) {
-                progress->close();
-                progress->deleteLater();
-                
-                QString userMessage;
-                if (errorMessage.contains("409")) {
-                    userMessage = QString::fromUtf8(
-                        "⚠️ MR已存在\n\n"
-                        "该分支的MR可能已经创建过了。\n\n"
-                        "详细错误：\n%1"
-                    ).arg(errorMessage);
-                } else {
-                    userMessage = QString::fromUtf8("创建MR失败：\n\n%1").arg(errorMessage);
-                }
-                
-                QMessageBox::warning(this, QString::fromUtf8("创建失败"), userMessage);
-                
-                disconnect(m_gitLabApi, &GitLabApi::mergeRequestCreated, this, nullptr);
-                disconnect(m_gitLabApi, &GitLabApi::apiError, this, nullptr);
-            }
-        });
-    
-    m_gitLabApi->createMergeRequest(params);
+    m_gitLabApi->createMergeRequest(params).then(this, [this, progress](const MrResponse& mr) {
+        progress->close();
+        progress->deleteLater();
+        
+        QString message = QString(
+            "<h3 style='color: green;'>✅ 合并请求创建成功！</h3>"
+            "<p><b>编号:</b> %1</p>"
+            "<p><b>标题:</b> %2</p>"
+            "<p><b>状态:</b> %3</p>"
+            "<p><b>链接:</b> ⬇️⬇️⬇️ <br>"
+            "<a href='%4'>%4</a></p>"
+            "<p style='color: #666; font-size: 11px;'>💡 点击链接在浏览器中查看合并请求详情</p>"
+        ).arg(mr.iid).arg(mr.title, mr.state, mr.webUrl);
+        
+        QMessageBox msgBox(this);
+        msgBox.setWindowTitle(QString::fromUtf8("合并请求创建成功"));
+        msgBox.setTextFormat(Qt::RichText);
+        msgBox.setText(message);
+        msgBox.setIcon(QMessageBox::NoIcon);
+        msgBox.setStandardButtons(QMessageBox::Ok);
+        msgBox.setDefaultButton(QMessageBox::Ok);
+        msgBox.setMinimumWidth(255);
+        msgBox.setTextInteractionFlags(Qt::TextBrowserInteraction);
+        msgBox.exec();
+    }).onFailed(this, [this, progress](const ApiError& error) {
+        progress->close();
+        progress->deleteLater();
+        
+        QString userMessage;
+        if (error.httpStatus() == 409) {
+            userMessage = QString::fromUtf8(
+                "⚠️ MR已存在\n\n"
+                "该分支的MR可能已经创建过了。\n\n"
+                "详细错误：\n%1"
+            ).arg(error.message());
+        } else {
+            userMessage = QString::fromUtf8("创建MR失败：\n\n%1").arg(error.message());
+        }
+        
+        QMessageBox::warning(this, QString::fromUtf8("创建失败"), userMessage);
+    });
 }
\ No newline at end of file
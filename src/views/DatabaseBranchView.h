@@ -3,9 +3,13 @@
 
 #include <QWidget>
 #include <QShowEvent>
+#include <QList>
 
 class GitService;
 class GitLabApi;
+class RepositoryState;
+class ConflictPredictor;
+struct FileStatus;
 class MrZone;
 class QListWidget;
 class QPushButton;
@@ -19,7 +23,8 @@ class DatabaseBranchView : public QWidget {
     Q_OBJECT
     
 public:
-    explicit DatabaseBranchView(GitService* gitService, GitLabApi* gitLabApi, QWidget* parent = nullptr);
+    explicit DatabaseBranchView(GitService* gitService, GitLabApi* gitLabApi, RepositoryState* repoState,
+                                ConflictPredictor* conflictPredictor, QWidget* parent = nullptr);
     
 protected:
     void showEvent(QShowEvent* event) override;
@@ -37,9 +42,12 @@ private:
     void connectSignals();
     void updateFileList();
     void updateMrZone();
+    void onFileStatusChanged(const QList<FileStatus>& fileStatuses);
     
     GitService* m_gitService;
     GitLabApi* m_gitLabApi;
+    RepositoryState* m_repoState;
+    ConflictPredictor* m_conflictPredictor;
     
     QListWidget* m_filesListWidget;
     QPushButton* m_refreshButton;
@@ -1,9 +1,13 @@
 #include "FeatureBranchView.h"
 #include "service/GitService.h"
+#include "service/RepositoryState.h"
 #include "api/GitLabApi.h"
 #include "api/ApiModels.h"
 #include "widgets/MrZone.h"
 #include "widgets/ProgressDialog.h"
+#include "automation/WorkflowEngine.h"
+#include "utils/MetricsRegistry.h"
+#include "utils/TraceRecorder.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QGroupBox>
@@ -16,15 +20,15 @@
 #include <QApplication>
 #include <QTimer>
 #include <QFrame>
-#include <QtConcurrent>
 #include <QFuture>
-#include <QFutureWatcher>
 
-FeatureBranchView::FeatureBranchView(GitService* gitService, GitLabApi* gitLabApi, QWidget* parent)
+FeatureBranchView::FeatureBranchView(GitService* gitService, GitLabApi* gitLabApi, RepositoryState* repoState,
+                                     ConflictPredictor* conflictPredictor, QWidget* parent)
     : QWidget(parent)
     , m_gitService(gitService)
     , m_gitLabApi(gitLabApi)
-    , m_fileStatusWatcher(new QFutureWatcher<QList<FileStatus>>(this))
+    , m_repoState(repoState)
+    , m_conflictPredictor(conflictPredictor)
 {
     setupUi();
     connectSignals();
@@ -179,7 +183,7 @@ void FeatureBranchView::setupUi() {
     mainLayout->addWidget(remoteGroup);
     
     // MR提交专区
-    m_mrZone = new MrZone(m_gitService, m_gitLabApi, this);
+    m_mrZone = new MrZone(m_gitService, m_gitLabApi, m_conflictPredictor, this);
     mainLayout->addWidget(m_mrZone);
     
     mainLayout->addStretch();
@@ -196,9 +200,14 @@ void FeatureBranchView::connectSignals() {
     connect(m_mrZone, &MrZone::conflictCheckRequested, this, &FeatureBranchView::onConflictCheckRequested);
     connect(m_mrZone, &MrZone::mrSubmitted,
             this, &FeatureBranchView::onMrSubmitted);
-            
-    connect(m_fileStatusWatcher, &QFutureWatcher<QList<FileStatus>>::finished,
-            this, &FeatureBranchView::onFileStatusReady);
+    
+    // 共享仓库状态变化
+    connect(m_repoState, &RepositoryState::fileStatusChanged, this, &FeatureBranchView::onFileStatusChanged);
+    connect(m_repoState, &RepositoryState::currentBranchChanged, this, [this]() {
+        if (isVisible()) {
+            updateMrZone();
+        }
+    });
 }
 
 void FeatureBranchView::showEvent(QShowEvent* event) {
@@ -208,33 +217,32 @@ void FeatureBranchView::showEvent(QShowEvent* event) {
 }
 
 void FeatureBranchView::refreshView() {
+    ScopedMetric metric("ui FeatureBranchView.refreshView");
+    TRACE_SCOPE("ui", "FeatureBranchView::refreshView");
+    
     // 刷新文件列表和MR区域（包括Welcome Zone样式）
     updateFileList();
     updateMrZone();
 }
 
 void FeatureBranchView::updateFileList() {
-    // 避免重复扫描
-    if (m_fileStatusWatcher->isRunning()) {
-        return;
+    // 先显示缓存结果；状态有变化时通过 fileStatusChanged 更新列表
+    if (m_repoState->isLoaded(RepositoryState::WorkingTree)) {
+        onFileStatusChanged(m_repoState->fileStatus());
+    } else {
+        m_filesListWidget->clear();
+        QListWidgetItem* loadingItem = new QListWidgetItem(QString::fromUtf8("⏳ 正在扫描文件变动..."));
+        loadingItem->setForeground(QBrush(Qt::gray));
+        m_filesListWidget->addItem(loadingItem);
     }
     
-    m_filesListWidget->clear();
-    QListWidgetItem* loadingItem = new QListWidgetItem(QString::fromUtf8("⏳ 正在扫描文件变动..."));
-    loadingItem->setForeground(QBrush(Qt::gray));
-    m_filesListWidget->addItem(loadingItem);
-    
-    QFuture<QList<FileStatus>> future = QtConcurrent::run([this]() {
-        return m_gitService->getFileStatus();
-    });
-    m_fileStatusWatcher->setFuture(future);
+    // 并发的刷新请求由共享状态合并
+    m_repoState->refresh(RepositoryState::WorkingTree);
 }
 
-void FeatureBranchView::onFileStatusReady() {
+void FeatureBranchView::onFileStatusChanged(const QList<FileStatus>& fileStatuses) {
     m_filesListWidget->clear();
     
-    QList<FileStatus> fileStatuses = m_fileStatusWatcher->result();
-    
     if (fileStatuses.isEmpty()) {
         m_filesListWidget->addItem(QString::fromUtf8("✓ 没有待提交的修改"));
     } else {
@@ -247,9 +255,18 @@ void FeatureBranchView::onFileStatusReady() {
 }
 
 void FeatureBranchView::updateMrZone() {
-    QString currentBranch = m_gitService->getCurrentBranch();
-    m_mrZone->updateForBranch(currentBranch);
+    if (!m_repoState->isLoaded(RepositoryState::CurrentBranch)) {
+        // 加载完成后经 currentBranchChanged 回到这里
+        m_repoState->refresh(RepositoryState::CurrentBranch);
+        return;
+    }
     
+    const QString currentBranch = m_repoState->currentBranch();
+    m_mrZone->updateForBranch(currentBranch);
+    updateWelcomeZone(currentBranch);
+}
+
+void FeatureBranchView::updateWelcomeZone(const QString& currentBranch) {    
     // Update Welcome Zone Style
     if (isBugfixBranch(currentBranch)) {
          m_welcomeGroup->setTitle(QString::fromUtf8("🐞 修复分支 - 紧急修复模式"));
@@ -304,6 +321,7 @@ void FeatureBranchView::updateMrZone() {
 }
 
 void FeatureBranchView::onRefreshClicked() {
+    m_gitService->invalidateStatusCache();
     updateFileList();
     QMessageBox::information(this, QString::fromUtf8("刷新状态"), 
         QString::fromUtf8("已刷新文件列表"));
@@ -325,28 +343,29 @@ void FeatureBranchView::onCommitClicked() {
     }
     
     // 先暂存所有修改
-    bool stageSuccess = m_gitService->stageAll();
-    if (!stageSuccess) {
-        QMessageBox::warning(this, QString::fromUtf8("暂存失败"),
-            QString::fromUtf8("暂存文件失败，请检查Git状态"));
-        return;
-    }
-    
-    // 静默执行commit，不显示进度对话框
-    bool success = m_gitService->commit(commitMsg);
-    
-    if (success) {
-        // 成功后刷新列表，不弹窗
-        updateFileList();
-    } else {
-        // 只在失败时弹窗
-        QMessageBox::warning(this, QString::fromUtf8("提交失败"),
-            QString::fromUtf8("提交失败，请检查Git状态"));
-    }
+    m_gitService->stageAllAsync().then(this, [this, commitMsg](bool stageSuccess) {
+        if (!stageSuccess) {
+            QMessageBox::warning(this, QString::fromUtf8("暂存失败"),
+                QString::fromUtf8("暂存文件失败，请检查Git状态"));
+            return;
+        }
+        
+        // 静默执行commit，不显示进度对话框
+        m_gitService->commitAsync(commitMsg).then(this, [this](bool success) {
+            if (success) {
+                // 成功后刷新列表，不弹窗
+                updateFileList();
+            } else {
+                // 只在失败时弹窗
+                QMessageBox::warning(this, QString::fromUtf8("提交失败"),
+                    QString::fromUtf8("提交失败，请检查Git状态"));
+            }
+        });
+    });
 }
 
 void FeatureBranchView::onPullClicked() {
-    QString currentBranch = m_gitService->getCurrentBranch();
+    const QString currentBranch = m_repoState->currentBranch();
     
     int ret = QMessageBox::question(
         this,
@@ -371,15 +390,10 @@ void FeatureBranchView::onPullClicked() {
     progress->setValue(0);
     progress->show();
     
-    // 使用FutureWatcher监听异步任务
-    QFutureWatcher<bool>* watcher = new QFutureWatcher<bool>(this);
-    
-    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher, progress]() {
-        bool success = watcher->result();
-        
+    // 在GitService的后台线程执行Git操作
+    m_gitService->pullLatestAsync().then(this, [this, progress](bool success) {
         progress->close();
         progress->deleteLater();
-        watcher->deleteLater();
         
         if (success) {
             QMessageBox::information(this, QString::fromUtf8("拉取成功"),
@@ -390,17 +404,10 @@ void FeatureBranchView::onPullClicked() {
                 QString::fromUtf8("拉取失败，请检查网络连接或是否存在冲突"));
         }
     });
-    
-    // 在后台线程执行Git操作
-    QFuture<bool> future = QtConcurrent::run([this]() {
-        return m_gitService->pullLatest();
-    });
-    
-    watcher->setFuture(future);
 }
 
 void FeatureBranchView::onPushClicked() {
-    QString currentBranch = m_gitService->getCurrentBranch();
+    const QString currentBranch = m_repoState->currentBranch();
     
     int ret = QMessageBox::question(
         this,
@@ -425,15 +432,10 @@ void FeatureBranchView::onPushClicked() {
     progress->setValue(0);
     progress->show();
     
-    // 使用FutureWatcher监听异步任务
-    QFutureWatcher<bool>* watcher = new QFutureWatcher<bool>(this);
-    
-    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher, progress]() {
-        bool success = watcher->result();
-        
+    // 在GitService的后台线程执行Git操作
+    m_gitService->pushBranchAsync(currentBranch, true).then(this, [this, progress](bool success) {
         progress->close();
         progress->deleteLater();
-        watcher->deleteLater();
         
         if (success) {
             QMessageBox msgBox(this);
@@ -457,13 +459,6 @@ void FeatureBranchView::onPushClicked() {
             msgBox.exec();
         }
     });
-    
-    // 在后台线程执行Git操作
-    QFuture<bool> future = QtConcurrent::run([this, currentBranch]() {
-        return m_gitService->pushBranch(currentBranch, true);
-    });
-    
-    watcher->setFuture(future);
 }
 
 void FeatureBranchView::onConflictCheckRequested(const QString& targetBranch) {
@@ -479,18 +474,14 @@ void FeatureBranchView::onConflictCheckRequested(const QString& targetBranch) {
     progress->setValue(0);
     progress->show();
     
-    // 定义结果类型
-    typedef QPair<bool, QString> CheckResult;
-    QFutureWatcher<CheckResult>* watcher = new QFutureWatcher<CheckResult>(this);
-    
-    connect(watcher, &QFutureWatcher<CheckResult>::finished, this, [this, watcher, progress, targetBranch]() {
-        CheckResult result = watcher->result();
+    // 在GitService的后台线程执行Git操作
+    m_gitService->checkMergeConflictAsync(targetBranch).then(this,
+        [this, progress, targetBranch](const MergeCheckResult& result) {
         bool hasNoConflict = result.first;
         QString conflictInfo = result.second;
         
         progress->close();
         progress->deleteLater();
-        watcher->deleteLater();
         
         if (hasNoConflict) {
             QMessageBox msgBox(this);
@@ -528,20 +519,10 @@ void FeatureBranchView::onConflictCheckRequested(const QString& targetBranch) {
             msgBox.exec();
         }
     });
-    
-    // 在后台线程执行Git操作
-    QFuture<CheckResult> future = QtConcurrent::run([this, targetBranch]() {
-        QString info;
-        // 注意：GitService必须是线程安全的，或者checkMergeConflict不应该访问任何GUI元素
-        bool result = m_gitService->checkMergeConflict(targetBranch, info);
-        return qMakePair(result, info);
-    });
-    
-    watcher->setFuture(future);
 }
 
 void FeatureBranchView::onMrSubmitted(const QString& targetBranch, const QString& title, const QString& description) {
-    QString sourceBranch = m_gitService->getCurrentBranch();
+    const QString sourceBranch = m_repoState->currentBranch();
     
     // 创建MR参数
     MrParams params;
@@ -552,10 +533,67 @@ void FeatureBranchView::onMrSubmitted(const QString& targetBranch, const QString
     params.removeSourceBranch = false;
     params.squash = false;
     
+    // bugfix 分支需要同步到另一条主线，推送后与创建MR并行检测同步冲突
+    const bool needsSync = isBugfixBranch(sourceBranch);
+    const QString syncTarget = (targetBranch == "develop") ? "internal" : "develop";
+    
+    WorkflowEngine* workflow = new WorkflowEngine(QString::fromUtf8("提交合并请求"), this);
+    
+    WorkflowStep push;
+    push.id = "push";
+    push.label = QString::fromUtf8("推送到远程仓库");
+    // 步骤超时略长于 GitService 的命令上限：命令超时由 GitService 报告，余量覆盖在写队列中的等待
+    push.timeoutMs = GitService::NETWORK_COMMAND_TIMEOUT_MS + 10000;
+    push.maxAttempts = 2;  // 推送可安全重试
+    push.run = [this, sourceBranch]() {
+        return WorkflowEngine::requireSuccess(m_gitService->pushBranchAsync(sourceBranch, true),
+            QString::fromUtf8("无法推送到远程仓库，请检查网络连接或权限。"));
+    };
+    workflow->addStep(push);
+    
+    WorkflowStep createMr;
+    createMr.id = "createMr";
+    createMr.label = QString::fromUtf8("创建合并请求");
+    createMr.dependsOn = QStringList{"push"};
+    createMr.timeoutMs = 30000;  // 不重试：请求可能已生效，重试会得到 409
+    createMr.run = [this, params]() {
+        return WorkflowEngine::toStepResult(m_gitLabApi->createMergeRequest(params))
+            .onFailed([](const ApiError& error) -> QVariant {
+                if (error.httpStatus() == 409) {
+                    throw WorkflowError(QString::fromUtf8("⚠️ MR已存在\n该分支的MR可能已经创建过了。"));
+                } else if (error.httpStatus() == 401 || error.httpStatus() == 403) {
+                    throw WorkflowError(QString::fromUtf8("🔒 权限错误\nToken无效或权限不足。"));
+                } else if (error.httpStatus() == 404) {
+                    throw WorkflowError(QString::fromUtf8("❓ 未找到资源\n项目ID不正确或远程分支不存在。"));
+                }
+                throw WorkflowError(QString::fromUtf8("❌ 创建MR失败\n%1").arg(error.message()));
+            });
+    };
+    workflow->addStep(createMr);
+    
+    WorkflowStep syncCheck;
+    syncCheck.id = "syncCheck";
+    syncCheck.label = QString::fromUtf8("检测同步冲突");
+    syncCheck.dependsOn = QStringList{"push"};
+    syncCheck.condition = [needsSync]() { return needsSync; };
+    syncCheck.timeoutMs = GitService::NETWORK_COMMAND_TIMEOUT_MS + GitService::COMMAND_TIMEOUT_MS;  // fetch 加合并分析
+    syncCheck.maxAttempts = 2;
+    syncCheck.optional = true;  // 检测失败不影响MR
+    syncCheck.run = [this, sourceBranch, syncTarget]() {
+        return m_gitService->checkCherryPickConflictAsync(sourceBranch, syncTarget)
+            .then([](const CherryPickConflictResult& result) {
+                if (!result.errorMessage.isEmpty()) {
+                    throw WorkflowError(result.errorMessage);
+                }
+                return QVariant::fromValue(result);
+            });
+    };
+    workflow->addStep(syncCheck);
+    
     // 显示等待动画
     QProgressDialog* progress = new QProgressDialog(
         QString::fromUtf8("正在推送到远程仓库..."), 
-        QString(), 0, 0, this);
+        QString(), 0, workflow->stepCount(), this);
     progress->setWindowTitle(QString::fromUtf8("提交中"));
     progress->setMinimumWidth(255);
     progress->setWindowModality(Qt::WindowModal);
@@ -563,82 +601,44 @@ void FeatureBranchView::onMrSubmitted(const QString& targetBranch, const QString
     progress->setCancelButton(nullptr);  // 不可取消
     progress->setValue(0);
     progress->show();
-    QApplication::processEvents();
-    
-    // 异步执行Push操作
-    QFutureWatcher<bool>* watcher = new QFutureWatcher<bool>(this);
     
-    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher, progress, params, sourceBranch]() {
-        bool pushSuccess = watcher->result();
-        watcher->deleteLater();
+    connect(workflow, &WorkflowEngine::progressChanged, progress, [workflow, progress](int finishedSteps, int) {
+        progress->setValue(finishedSteps);
+        progress->setLabelText(workflow->progressText());
+    });
+    connect(workflow, &WorkflowEngine::finished, this,
+        [this, workflow, progress, sourceBranch, syncTarget, title](bool success) {
+        progress->close();
+        progress->deleteLater();
+        workflow->deleteLater();
         
-        if (!pushSuccess) {
-            progress->close();
-            progress->deleteLater();
-            QMessageBox::warning(this, QString::fromUtf8("推送失败"), 
-                QString::fromUtf8("无法推送到远程仓库，请检查网络连接或权限。"));
+        if (!success) {
+            const QString failedStep = workflow->failedStep();
+            QMessageBox::warning(this,
+                failedStep == "push" ? QString::fromUtf8("推送失败") : QString::fromUtf8("失败"),
+                workflow->errorMessage(failedStep));
             return;
         }
         
-        // Push成功，开始创建MR
-        progress->setLabelText(QString::fromUtf8("正在创建合并请求..."));
-        
-        // 连接API信号（一次性连接）
-        connect(m_gitLabApi, &GitLabApi::mergeRequestCreated, this, 
-            [this, progress, params, sourceBranch](const MrResponse& mr) {
-                progress->close();
-                progress->deleteLater();
-                
-                // 显示MR创建成功
-                showMrSuccessDialog(mr);
-                
-                // 检测是否需要同步（仅针对bugfix分支）
-                if (isBugfixBranch(sourceBranch)) {
-                    QString syncTarget = (params.targetBranch == "develop") 
-                                         ? "internal" : "develop";
-                    
-                    // 启动异步冲突检测并提示同步
-                    checkAndPromptSync(sourceBranch, syncTarget, params.title);
-                }
-                
-                disconnect(m_gitLabApi, &GitLabApi::mergeRequestCreated, this, nullptr);
-                disconnect(m_gitLabApi, &GitLabApi::apiError, this, nullptr);
-            });
-        
-        connect(m_gitLabApi, &GitLabApi::apiError, this,
-            [this, progress](const QString& endpoint, const QString& errorMessage) {
-                progress->close();
-                progress->deleteLater();
-                
-                QString userMessage;
-                
-                if (errorMessage.contains("409")) {
-                    userMessage = QString::fromUtf8("⚠️ MR已存在\n该分支的MR可能已经创建过了。");
-                } else if (errorMessage.contains("401") || errorMessage.contains("403")) {
-                    userMessage = QString::fromUtf8("🔒 权限错误\nToken无效或权限不足。");
-                } else if (errorMessage.contains("404")) {
-                    userMessage = QString::fromUtf8("❓ 未找到资源\n项目ID不正确或远程分支不存在。");
-                } else {
-                    userMessage = QString::fromUtf8("❌ 创建MR失败\n%1").arg(errorMessage);
-                }
-                
-                QMessageBox::warning(this, QString::fromUtf8("失败"), userMessage);
-                disconnect(m_gitLabApi, &GitLabApi::mergeRequestCreated, this, nullptr);
-                disconnect(m_gitLabApi, &GitLabApi::apiError, this, nullptr);
-            });
+        // 显示MR创建成功
+        showMrSuccessDialog(workflow->result("createMr").value<MrResponse>());
         
-        // 发起API调用
-        m_gitLabApi->createMergeRequest(params);
-    });
-    
-    // 开始后台Push
-    QFuture<bool> future = QtConcurrent::run([this, sourceBranch]() {
-        // pushBranch(branch, setUpstream=true)
-        return m_gitService->pushBranch(sourceBranch, true);
+        // 根据同步冲突检测结果提示同步（仅针对bugfix分支）
+        if (workflow->state("syncCheck") == WorkflowEngine::StepState::Succeeded) {
+            promptSync(sourceBranch, syncTarget, title,
+                       workflow->result("syncCheck").value<CherryPickConflictResult>());
+        } else if (workflow->state("syncCheck") == WorkflowEngine::StepState::Failed) {
+            QMessageBox::warning(this, QString::fromUtf8("检测失败"),
+                QString::fromUtf8("无法检测同步到 %1 的冲突：\n%2\n\n"
+                                  "如需同步，请稍后手动创建同步MR。")
+                    .arg(syncTarget, workflow->errorMessage("syncCheck")));
+        }
     });
     
-    watcher->setFuture(future);
-}// Bugfix 分支同步工作流的辅助函数实现
+    workflow->start();
+}
+
+// Bugfix 分支同步工作流的辅助函数实现
 // 这些函数将被追加到 FeatureBranchView.cpp 的末尾
 
 // 检测是否为 bugfix 分支（支持 bugfix/xxx 命名）
@@ -673,61 +673,24 @@ void FeatureBranchView::showMrSuccessDialog(const MrResponse& mr) {
     msgBox.exec();
 }
 
-// 异步检测冲突并提示用户同步
-void FeatureBranchView::checkAndPromptSync(
+// 根据同步冲突检测结果提示用户同步
+void FeatureBranchView::promptSync(
     const QString& sourceBranch,
     const QString& targetBranch,
-    const QString& originalTitle) {
-    
-    // 创建进度对话框
-    QProgressDialog* checkProgress = new QProgressDialog(
-        QString::fromUtf8("正在为同步修改检测冲突 ..."), 
-        QString(), 0, 0, this);
-    checkProgress->setWindowTitle(QString::fromUtf8("冲突检测"));
-    checkProgress->setMinimumWidth(255);
-    checkProgress->setWindowModality(Qt::WindowModal);
-    checkProgress->setCancelButton(nullptr);
-    checkProgress->show();
-    QApplication::processEvents();
-    
-    // 异步执行冲突检测
-    QFutureWatcher<CherryPickConflictResult>* watcher = 
-        new QFutureWatcher<CherryPickConflictResult>(this);
+    const QString& originalTitle,
+    const CherryPickConflictResult& result) {
     
-    connect(watcher, &QFutureWatcher<CherryPickConflictResult>::finished, 
-        this, [this, watcher, checkProgress, sourceBranch, targetBranch, originalTitle]() {
-        
-        CherryPickConflictResult result = watcher->result();
-        watcher->deleteLater();
-        checkProgress->close();
-        checkProgress->deleteLater();
-        
-        // 检测失败
-        if (!result.errorMessage.isEmpty()) {
-            QMessageBox::warning(this, QString::fromUtf8("检测失败"),
-                QString::fromUtf8("无法检测冲突：\n%1\n\n"
-                                  "是否仍要创建同步MR？")
-                    .arg(result.errorMessage));
-            // 用户可选择继续或放弃
-            return;
-        }
-        
-        // 根据检测结果提示用户
-        if (result.hasConflict) {
-            promptSyncWithConflict(sourceBranch, targetBranch, 
-                                  originalTitle, result.conflictFiles);
-        } else {
-            promptSyncNoConflict(sourceBranch, targetBranch, originalTitle);
+    if (result.hasConflict) {
+        QStringList conflictFiles;
+        for (const QString& file : result.conflictFiles) {
+            const int hunks = result.conflictHunks.value(file);
+            conflictFiles << (hunks > 0 ? QString::fromUtf8("%1（%2 处冲突）").arg(file).arg(hunks) : file);
         }
-    });
-    
-    // 启动后台检测
-    QFuture<CherryPickConflictResult> future = QtConcurrent::run(
-        [this, sourceBranch, targetBranch]() {
-            return m_gitService->checkCherryPickConflict(sourceBranch, targetBranch);
-        });
-    
-    watcher->setFuture(future);
+        promptSyncWithConflict(sourceBranch, targetBranch,
+                              originalTitle, conflictFiles);
+    } else {
+        promptSyncNoConflict(sourceBranch, targetBranch, originalTitle);
+    }
 }
 
 // 提示无冲突同步
@@ -836,34 +799,20 @@ void FeatureBranchView::createSyncMergeRequest(
     syncProgress->show();
     QApplication::processEvents();
     
-    // 连接API信号
-    connect(m_gitLabApi, &GitLabApi::mergeRequestCreated, this, 
-        [this, syncProgress](const MrResponse& mr) {
-            syncProgress->close();
-            syncProgress->deleteLater();
-            
-            QMessageBox::information(this, QString::fromUtf8("同步MR创建成功"),
-                QString::fromUtf8("同步合并请求已创建！\n\n"
-                                  "编号: #%1\n"
-                                  "链接: %2")
-                    .arg(mr.iid).arg(mr.webUrl));
-            
-            disconnect(m_gitLabApi, &GitLabApi::mergeRequestCreated, this, nullptr);
-            disconnect(m_gitLabApi, &GitLabApi::apiError, this, nullptr);
-        });
-    
-    connect(m_gitLabApi, &GitLabApi::apiError, this,
-        [this, syncProgress](const QString& endpoint, const QString& errorMessage) {
-            syncProgress->close();
-            syncProgress->deleteLater();
-            
-            QMessageBox::warning(this, QString::fromUtf8("创建失败"),
-                QString::fromUtf8("同步MR创建失败：\n%1").arg(errorMessage));
-            
-            disconnect(m_gitLabApi, &GitLabApi::mergeRequestCreated, this, nullptr);
-            disconnect(m_gitLabApi, &GitLabApi::apiError, this, nullptr);
-        });
-    
-    // 发起API调用
-    m_gitLabApi->createMergeRequest(syncParams);
+    m_gitLabApi->createMergeRequest(syncParams).then(this, [this, syncProgress](const MrResponse& mr) {
+        syncProgress->close();
+        syncProgress->deleteLater();
+        
+        QMessageBox::information(this, QString::fromUtf8("同步MR创建成功"),
+            QString::fromUtf8("同步合并请求已创建！\n\n"
+                              "编号: #%1\n"
+                              "链接: %2")
+                .arg(mr.iid).arg(mr.webUrl));
+    }).onFailed(this, [this, syncProgress](const ApiError& error) {
+        syncProgress->close();
+        syncProgress->deleteLater();
+        
+        QMessageBox::warning(this, QString::fromUtf8("创建失败"),
+            QString::fromUtf8("同步MR创建失败：\n%1").arg(error.message()));
+    });
 }
@@ -3,13 +3,12 @@
 
 #include <QWidget>
 #include <QShowEvent>
-#include <QFutureWatcher>
-#include <QList>
-
 #include <QList>
 #include "service/GitService.h"
 
 class GitLabApi;
+class RepositoryState;
+class ConflictPredictor;
 class MrZone;
 class QListWidget;
 class QPushButton;
@@ -22,7 +21,8 @@ class FeatureBranchView : public QWidget {
     Q_OBJECT
     
 public:
-    explicit FeatureBranchView(GitService* gitService, GitLabApi* gitLabApi, QWidget* parent = nullptr);
+    explicit FeatureBranchView(GitService* gitService, GitLabApi* gitLabApi, RepositoryState* repoState,
+                               ConflictPredictor* conflictPredictor, QWidget* parent = nullptr);
     
     // 公共刷新方法 - 用于分支切换时刷新UI
     void refreshView();
@@ -37,17 +37,19 @@ private slots:
     void onPushClicked();
     void onConflictCheckRequested(const QString& targetBranch);
     void onMrSubmitted(const QString& targetBranch, const QString& title, const QString& description);
-    void onFileStatusReady();
+    void onFileStatusChanged(const QList<FileStatus>& fileStatuses);
     
 private:
     void setupUi();
     void connectSignals();
     void updateFileList();
     void updateMrZone();
+    void updateWelcomeZone(const QString& currentBranch);
     
     // Bugfix cherry-pick 同步工作流
     bool isBugfixBranch(const QString& branchName);
-    void checkAndPromptSync(const QString& sourceBranch, const QString& targetBranch, const QString& originalTitle);
+    void promptSync(const QString& sourceBranch, const QString& targetBranch, const QString& originalTitle,
+                    const CherryPickConflictResult& result);
     void promptSyncNoConflict(const QString& sourceBranch, const QString& targetBranch, const QString& originalTitle);
     void promptSyncWithConflict(const QString& sourceBranch, const QString& targetBranch, const QString& originalTitle, const QStringList& conflictFiles);
     void createSyncMergeRequest(const QString& sourceBranch, const QString& targetBranch, const QString& originalTitle, bool hasConflict);
@@ -55,6 +57,8 @@ private:
     
     GitService* m_gitService;
     GitLabApi* m_gitLabApi;
+    RepositoryState* m_repoState;
+    ConflictPredictor* m_conflictPredictor;
     
     QListWidget* m_filesListWidget;
     QPushButton* m_refreshButton;
@@ -63,7 +67,6 @@ private:
     QPushButton* m_pushButton;
     MrZone* m_mrZone;
     
-    QFutureWatcher<QList<FileStatus>>* m_fileStatusWatcher;
 
     QGroupBox* m_welcomeGroup;
     QLabel* m_welcomeLabel;
@@ -1,7 +1,13 @@
 #include "MainBranchView.h"
 #include "service/GitService.h"
+#include "service/RepositoryState.h"
 #include "api/GitLabApi.h"
+#include "automation/BuildMonitor.h"
+#include "automation/ArtifactDownloader.h"
 #include "widgets/PipelineTriggerDialog.h"
+#include "widgets/JobLogDialog.h"
+#include "widgets/DownloadLinkWidget.h"
+#include "utils/Logger.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QLabel>
@@ -12,9 +18,7 @@
 #include <QInputDialog>
 #include <QProgressDialog>
 #include <QApplication>
-#include <QtConcurrent>
-#include <QFutureWatcher>
-#include <QFutureWatcher>
+#include <QFuture>
 #include <QTimer>
 #include <QTreeWidget>
 #include <QHeaderView>
@@ -22,20 +26,27 @@
 #include <QDesktopServices>
 #include <QUrl>
 #include <QTimeZone>
+#include <QFileDialog>
+#include <QStandardPaths>
+#include <QDir>
+#include <QRegularExpression>
+#include <memory>
 
-MainBranchView::MainBranchView(GitService* gitService, GitLabApi* gitLabApi, QWidget* parent)
+MainBranchView::MainBranchView(GitService* gitService, GitLabApi* gitLabApi, RepositoryState* repoState,
+                               QWidget* parent)
     : QWidget(parent)
     , m_gitService(gitService)
     , m_gitLabApi(gitLabApi)
+    , m_repoState(repoState)
+    , m_buildMonitor(new BuildMonitor(gitLabApi, this))
+    , m_artifactDownloader(new ArtifactDownloader(gitLabApi, this))
 {
     setupUi();
     connectSignals();
     
-    // Auto refresh timer
-    m_refreshTimer = new QTimer(this);
-    m_refreshTimer->setInterval(30000); // 30s auto refresh
-    connect(m_refreshTimer, &QTimer::timeout, this, &MainBranchView::refreshPipelines);
-    m_refreshTimer->start();
+    // 不传递分支参数，显示所有分支的最新 Pipeline
+    // 这样无论触发哪个分支的构建，都能在列表中看到
+    m_buildMonitor->start();
 }
 
 void MainBranchView::setupUi() {
@@ -185,6 +196,11 @@ void MainBranchView::setupUi() {
     header->setSectionResizeMode(3, QHeaderView::ResizeToContents);
     
     pipelineLayout->addWidget(m_pipelineTreeWidget);
+    
+    // 产物下载列表，有下载任务后显示
+    m_downloadWidget = new DownloadLinkWidget(m_artifactDownloader, this);
+    m_downloadWidget->hide();
+    pipelineLayout->addWidget(m_downloadWidget);
     mainLayout->addWidget(m_pipelineGroup);
 
     mainLayout->addStretch();
@@ -196,10 +212,10 @@ void MainBranchView::connectSignals() {
     connect(m_switchBranchButton, &QPushButton::clicked, this, &MainBranchView::onSwitchBranchClicked);
     
     connect(m_refreshPipelinesButton, &QPushButton::clicked, this, &MainBranchView::refreshPipelines);
-    connect(m_gitLabApi, &GitLabApi::pipelinesReceived, this, &MainBranchView::onPipelinesReceived);
-    connect(m_gitLabApi, &GitLabApi::pipelineTriggered, this, &MainBranchView::refreshPipelines); // Refresh after trigger
-    connect(m_gitLabApi, &GitLabApi::pipelineRetried, this, &MainBranchView::onPipelineOperationCompleted);
-    connect(m_gitLabApi, &GitLabApi::pipelineCanceled, this, &MainBranchView::onPipelineOperationCompleted);
+    connect(m_artifactDownloader, &ArtifactDownloader::taskAdded, m_downloadWidget, &QWidget::show);
+    connect(m_buildMonitor, &BuildMonitor::pipelinesUpdated, this, [this](const QList<PipelineStatus>& pipelines) {
+        onPipelinesReceived(pipelines);
+    });
     
     connect(m_pipelineTreeWidget, &QTreeWidget::customContextMenuRequested, this, &MainBranchView::onPipelineContextMenuRequested);
     connect(m_pipelineTreeWidget, &QTreeWidget::itemDoubleClicked, [](QTreeWidgetItem* item, int column) {
@@ -232,14 +248,9 @@ void MainBranchView::onPullClicked() {
     progress->setValue(0);
     progress->show();
     
-    QFutureWatcher<bool>* watcher = new QFutureWatcher<bool>(this);
-    
-    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher, progress]() {
-        bool success = watcher->result();
-        
+    m_gitService->pullLatestAsync().then(this, [this, progress](bool success) {
         progress->close();
         progress->deleteLater();
-        watcher->deleteLater();
         
         if (success) {
             QMessageBox::information(this, QString::fromUtf8("拉取成功"),
@@ -249,12 +260,6 @@ void MainBranchView::onPullClicked() {
                 QString::fromUtf8("拉取失败，请检查网络连接"));
         }
     });
-    
-    QFuture<bool> future = QtConcurrent::run([this]() {
-        return m_gitService->pullLatest();
-    });
-    
-    watcher->setFuture(future);
 }
 
 void MainBranchView::onTriggerBuildClicked() {
@@ -295,33 +300,25 @@ void MainBranchView::onTriggerBuildClicked() {
     progress->show();
     QApplication::processEvents();
     
-    // 4. 连接错误信号 - 只在失败时提示
-    connect(m_gitLabApi, &GitLabApi::apiError, this,
-        [this](const QString& endpoint, const QString& errorMessage) {
-            if (endpoint.contains("pipeline")) {
-                QMessageBox::warning(this, QString::fromUtf8("触发失败"),
-                    QString::fromUtf8("Pipeline触发失败：\n\n%1").arg(errorMessage));
-                
-                disconnect(m_gitLabApi, &GitLabApi::apiError, this, nullptr);
-            }
-        });
-    
-    // 5. 触发API调用
-    m_gitLabApi->triggerPipeline(selectedBranch);
+    // 4. 触发API调用，成功后交给监控快速轮询，只在失败时提示
+    m_gitLabApi->triggerPipeline(selectedBranch).then(this, [this](const PipelineStatus& pipeline) {
+        m_buildMonitor->trackPipeline(pipeline);
+    }).onFailed(this, [this](const ApiError& error) {
+        QMessageBox::warning(this, QString::fromUtf8("触发失败"),
+            QString::fromUtf8("Pipeline触发失败：\n\n%1").arg(error.message()));
+    });
     
-    // 6. 立即关闭进度条，因为下方列表会自动刷新显示状态
+    // 5. 立即关闭进度条，因为下方列表会自动刷新显示状态
     progress->close();
     progress->deleteLater();
-    
-    // 7. 立即刷新Pipeline列表以显示新触发的Pipeline
-    QTimer::singleShot(1000, this, &MainBranchView::refreshPipelines);
 }
 
 void MainBranchView::onSwitchBranchClicked() {
-    // 获取所有分支列表
-    QStringList branches = m_gitService->getAllBranches();
-    QString currentBranch = m_gitService->getCurrentBranch();
-    
+    // 分支列表与当前分支取自共享仓库状态
+    promptSwitchBranch(m_repoState->branches(), m_repoState->currentBranch());
+}
+
+void MainBranchView::promptSwitchBranch(QStringList branches, const QString& currentBranch) {
     if (branches.isEmpty()) {
         QMessageBox::warning(this, QString::fromUtf8("无可用分支"),
             QString::fromUtf8("未找到可切换的分支"));
@@ -360,22 +357,28 @@ void MainBranchView::onSwitchBranchClicked() {
     }
     
     // 检查是否有未提交的修改
-    if (m_gitService->hasUncommittedChanges()) {
-        int ret = QMessageBox::warning(
-            this,
-            QString::fromUtf8("发现未提交的修改"),
-            QString::fromUtf8("当前工作区有未提交的修改，切换分支可能会丢失修改。\n\n"
-                             "是否继续切换？\n\n"
-                             "建议：先暂存或提交修改后再切换。"),
-            QMessageBox::Yes | QMessageBox::No,
-            QMessageBox::No
-        );
-        
-        if (ret != QMessageBox::Yes) {
-            return;
+    m_gitService->hasUncommittedChangesAsync().then(this, [this, selectedBranch](bool hasChanges) {
+        if (hasChanges) {
+            int ret = QMessageBox::warning(
+                this,
+                QString::fromUtf8("发现未提交的修改"),
+                QString::fromUtf8("当前工作区有未提交的修改，切换分支可能会丢失修改。\n\n"
+                                 "是否继续切换？\n\n"
+                                 "建议：先暂存或提交修改后再切换。"),
+                QMessageBox::Yes | QMessageBox::No,
+                QMessageBox::No
+            );
+            
+            if (ret != QMessageBox::Yes) {
+                return;
+            }
         }
-    }
-    
+        
+        switchToBranch(selectedBranch);
+    });
+}
+
+void MainBranchView::switchToBranch(const QString& selectedBranch) {
     // 显示进度对话框
     QProgressDialog* progress = new QProgressDialog(
         QString::fromUtf8("正在切换分支..."), 
@@ -388,14 +391,9 @@ void MainBranchView::onSwitchBranchClicked() {
     progress->setValue(0);
     progress->show();
     
-    QFutureWatcher<bool>* watcher = new QFutureWatcher<bool>(this);
-    
-    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher, progress, selectedBranch]() {
-        bool success = watcher->result();
-        
+    m_gitService->switchBranchAsync(selectedBranch).then(this, [this, progress](bool success) {
         progress->close();
         progress->deleteLater();
-        watcher->deleteLater();
         
         if (success) {
             // 切换成功，直接通知主窗口刷新，不弹窗干扰用户
@@ -405,18 +403,10 @@ void MainBranchView::onSwitchBranchClicked() {
                 QString::fromUtf8("切换分支失败，请检查工作区状态"));
         }
     });
-    
-    QFuture<bool> future = QtConcurrent::run([this, selectedBranch]() {
-        return m_gitService->switchBranch(selectedBranch);
-    });
-    
-    watcher->setFuture(future);
 }
 
 void MainBranchView::refreshPipelines() {
-    // 不传递分支参数，显示所有分支的最新 Pipeline
-    // 这样无论触发哪个分支的构建，都能在列表中看到
-    m_gitLabApi->listPipelines();
+    m_buildMonitor->refreshNow();
 }
 
 void MainBranchView::onPipelinesReceived(const QList<PipelineStatus>& pipelines) {
@@ -463,6 +453,8 @@ void MainBranchView::onPipelineContextMenuRequested(const QPoint& pos) {
     QMenu contextMenu(this);
     
     QAction* browserAction = contextMenu.addAction(QString::fromUtf8("🌐 在浏览器中打开"));
+    QAction* jobLogAction = contextMenu.addAction(QString::fromUtf8("📜 查看Job日志"));
+    QAction* artifactAction = contextMenu.addAction(QString::fromUtf8("📦 下载构建产物"));
     contextMenu.addSeparator();
     
     // Actions based on status
@@ -481,6 +473,12 @@ void MainBranchView::onPipelineContextMenuRequested(const QPoint& pos) {
     connect(browserAction, &QAction::triggered, [url]() {
         QDesktopServices::openUrl(QUrl(url));
     });
+    connect(jobLogAction, &QAction::triggered, this, [this, pipelineId = m_selectedPipelineId]() {
+        showJobLogs(pipelineId);
+    });
+    connect(artifactAction, &QAction::triggered, this, [this, pipelineId = m_selectedPipelineId]() {
+        downloadArtifacts(pipelineId);
+    });
     
     contextMenu.exec(m_pipelineTreeWidget->mapToGlobal(pos));
 }
@@ -497,7 +495,12 @@ void MainBranchView::onPipelineActionClicked() {
             QMessageBox::Yes | QMessageBox::No);
             
         if (ret == QMessageBox::Yes) {
-            m_gitLabApi->retryPipeline(m_selectedPipelineId);
+            m_gitLabApi->retryPipeline(m_selectedPipelineId).then(this, [this](const PipelineStatus& pipeline) {
+                onPipelineOperationCompleted(pipeline);
+            }).onFailed(this, [this](const ApiError& error) {
+                QMessageBox::warning(this, QString::fromUtf8("操作失败"),
+                    QString::fromUtf8("Pipeline操作失败：\n\n%1").arg(error.message()));
+            });
         }
     } else if (type == "cancel") {
         int ret = QMessageBox::question(this, QString::fromUtf8("确认取消"),
@@ -505,11 +508,114 @@ void MainBranchView::onPipelineActionClicked() {
             QMessageBox::Yes | QMessageBox::No);
             
         if (ret == QMessageBox::Yes) {
-            m_gitLabApi->cancelPipeline(m_selectedPipelineId);
+            m_gitLabApi->cancelPipeline(m_selectedPipelineId).then(this, [this](const PipelineStatus& pipeline) {
+                onPipelineOperationCompleted(pipeline);
+            }).onFailed(this, [this](const ApiError& error) {
+                QMessageBox::warning(this, QString::fromUtf8("操作失败"),
+                    QString::fromUtf8("Pipeline操作失败：\n\n%1").arg(error.message()));
+            });
         }
     }
 }
 
+void MainBranchView::showJobLogs(int pipelineId) {
+    m_gitLabApi->listPipelineJobs(pipelineId).items.then(this, [this, pipelineId](QFuture<PipelineJob> future) {
+        QList<PipelineJob> jobs;
+        try {
+            jobs = future.results();  // 失败时抛出 ApiError
+        } catch (const ApiError& error) {
+            QMessageBox::warning(this, QString::fromUtf8("获取Job失败"),
+                QString::fromUtf8("无法获取 Pipeline #%1 的Job列表：\n\n%2").arg(pipelineId).arg(error.message()));
+            return;
+        }
+        if (jobs.isEmpty()) {
+            QMessageBox::information(this, QString::fromUtf8("查看Job日志"),
+                QString::fromUtf8("Pipeline #%1 没有Job").arg(pipelineId));
+            return;
+        }
+        
+        // 默认选中第一个进行中或失败的Job
+        QStringList items;
+        int defaultIndex = -1;
+        for (int i = 0; i < jobs.size(); ++i) {
+            const PipelineJob& job = jobs[i];
+            items << QString("%1 / %2  [%3]  #%4").arg(job.stage, job.name, job.status).arg(job.id);
+            if (defaultIndex < 0 && (job.isActive() || job.status == "failed")) {
+                defaultIndex = i;
+            }
+        }
+        
+        int selected = 0;
+        if (jobs.size() > 1) {
+            bool ok = false;
+            const QString item = QInputDialog::getItem(this, QString::fromUtf8("查看Job日志"),
+                QString::fromUtf8("Pipeline #%1 的Job：").arg(pipelineId), items, qMax(0, defaultIndex), false, &ok);
+            if (!ok) {
+                return;
+            }
+            selected = items.indexOf(item);
+        }
+        
+        JobLogDialog* dialog = new JobLogDialog(m_gitLabApi, m_artifactDownloader, jobs[selected], this);
+        dialog->setAttribute(Qt::WA_DeleteOnClose);
+        dialog->show();
+    });
+}
+
+void MainBranchView::downloadArtifacts(int pipelineId) {
+    const QString directory = QFileDialog::getExistingDirectory(this, QString::fromUtf8("选择保存目录"),
+        QStandardPaths::writableLocation(QStandardPaths::DownloadLocation));
+    if (directory.isEmpty()) {
+        return;
+    }
+    
+    m_gitLabApi->listPipelineJobs(pipelineId).items.then(this, [this, pipelineId, directory](QFuture<PipelineJob> future) {
+        QList<PipelineJob> jobs;
+        try {
+            jobs = future.results();  // 失败时抛出 ApiError
+        } catch (const ApiError& error) {
+            QMessageBox::warning(this, QString::fromUtf8("获取Job失败"),
+                QString::fromUtf8("无法获取 Pipeline #%1 的Job列表：\n\n%2").arg(pipelineId).arg(error.message()));
+            return;
+        }
+        
+        // 各Job的产物清单并发查询，全部返回后仍没有可下载的产物时提示
+        auto pending = std::make_shared<int>(jobs.size());
+        auto found = std::make_shared<int>(0);
+        auto finishOne = [this, pipelineId, pending, found]() {
+            if (--*pending == 0 && *found == 0) {
+                QMessageBox::information(this, QString::fromUtf8("下载构建产物"),
+                    QString::fromUtf8("Pipeline #%1 没有可下载的产物").arg(pipelineId));
+            }
+        };
+        if (jobs.isEmpty()) {
+            ++*pending;
+            finishOne();
+            return;
+        }
+        
+        for (const PipelineJob& job : jobs) {
+            m_gitLabApi->getJobArtifacts(job.id).then(this, [this, job, directory, found, finishOne](QFuture<BuildArtifact> artifacts) {
+                try {
+                    for (const BuildArtifact& artifact : artifacts.results()) {
+                        if (artifact.downloadUrl.isEmpty()) {
+                            continue;
+                        }
+                        // Job名可能含 ":" "/" 与空格
+                        QString name = QString("%1-%2-%3").arg(job.name).arg(job.id).arg(artifact.filename);
+                        name.replace(QRegularExpression("[\\\\/:*?\"<>|\\s]+"), "_");
+                        m_artifactDownloader->enqueue(artifact, QDir(directory).filePath(name));
+                        ++*found;
+                    }
+                } catch (const ApiError& error) {
+                    LOG_WARNING("获取Job产物清单失败", {{"job", job.id}, {"error", error.message()}});
+                }
+                finishOne();
+            });
+        }
+    });
+}
+
 void MainBranchView::onPipelineOperationCompleted(const PipelineStatus& pipeline) {
     QString msg;
     // Detect operation type by status or just generic success
@@ -520,5 +626,5 @@ void MainBranchView::onPipelineOperationCompleted(const PipelineStatus& pipeline
     QMessageBox::information(this, QString::fromUtf8("成功"),
         QString("%1 #%2\n状态: %3").arg(msg).arg(pipeline.id).arg(pipeline.status));
         
-    refreshPipelines();
+    m_buildMonitor->trackPipeline(pipeline);
 }
\ No newline at end of file
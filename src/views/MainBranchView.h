@@ -5,6 +5,10 @@
 
 class GitService;
 class GitLabApi;
+class BuildMonitor;
+class ArtifactDownloader;
+class DownloadLinkWidget;
+class RepositoryState;
 class QListWidget;
 class QTreeWidget;
 class QTreeWidgetItem;
@@ -22,7 +26,8 @@ class MainBranchView : public QWidget {
     Q_OBJECT
     
 public:
-    explicit MainBranchView(GitService* gitService, GitLabApi* gitLabApi, QWidget* parent = nullptr);
+    explicit MainBranchView(GitService* gitService, GitLabApi* gitLabApi, RepositoryState* repoState,
+                            QWidget* parent = nullptr);
     
 signals:
     void branchSwitched();  // 通知主窗口刷新
@@ -32,7 +37,6 @@ private slots:
     void onTriggerBuildClicked();
     void onSwitchBranchClicked();
     void refreshPipelines();
-    void onPipelinesReceived(const QList<PipelineStatus>& pipelines);
     void onPipelineContextMenuRequested(const QPoint& pos);
     void onPipelineActionClicked();
     void onPipelineOperationCompleted(const PipelineStatus& pipeline);
@@ -40,9 +44,15 @@ private slots:
 private:
     void setupUi();
     void connectSignals();
+    void promptSwitchBranch(QStringList branches, const QString& currentBranch);
+    void switchToBranch(const QString& selectedBranch);
+    void onPipelinesReceived(const QList<PipelineStatus>& pipelines);
+    void showJobLogs(int pipelineId);
+    void downloadArtifacts(int pipelineId);
     
     GitService* m_gitService;
     GitLabApi* m_gitLabApi;
+    RepositoryState* m_repoState;
     
     QPushButton* m_pullButton;
     QPushButton* m_triggerBuildButton;
@@ -53,7 +63,9 @@ private:
     QGroupBox* m_pipelineGroup;
     QTreeWidget* m_pipelineTreeWidget;
     QPushButton* m_refreshPipelinesButton;
-    QTimer* m_refreshTimer;
+    BuildMonitor* m_buildMonitor;  // 自适应轮询，替代固定30秒刷新整个列表
+    ArtifactDownloader* m_artifactDownloader;
+    DownloadLinkWidget* m_downloadWidget;
     
     int m_selectedPipelineId;
 };
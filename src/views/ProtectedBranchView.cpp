@@ -1,8 +1,10 @@
 #include "ProtectedBranchView.h"
 #include "service/GitService.h"
+#include "service/RepositoryState.h"
 #include "api/GitLabApi.h"
 #include "utils/Logger.h"
 #include "widgets/BranchCreatorDialog.h"
+#include "automation/WorkflowEngine.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -16,9 +18,7 @@
 #include <QListWidget>
 #include <QTimer>
 #include <QProgressDialog>
-#include <QtConcurrent>
-#include <QFutureWatcher>
-#include <QFutureWatcher>
+#include <QFuture>
 #include <QTreeWidget>
 #include <QHeaderView>
 #include <QTimer>
@@ -27,10 +27,30 @@
 #include <QMenu>
 #include <QTimeZone>
 
-ProtectedBranchView::ProtectedBranchView(GitService* gitService, GitLabApi* gitLabApi, QWidget* parent) 
+namespace {
+
+// "!12、!15、!23"，超过 limit 个时省略其余
+QString formatMrList(const QList<int>& iids, int limit = 10) {
+    QStringList refs;
+    for (int i = 0; i < iids.size() && i < limit; ++i) {
+        refs << QString("!%1").arg(iids[i]);
+    }
+    QString text = refs.join(QString::fromUtf8("、"));
+    if (iids.size() > limit) {
+        text += QString::fromUtf8(" 等 %1 个").arg(iids.size());
+    }
+    return text;
+}
+
+}
+
+ProtectedBranchView::ProtectedBranchView(GitService* gitService, GitLabApi* gitLabApi, RepositoryState* repoState,
+                                         QWidget* parent) 
     : QWidget(parent)
     , m_gitService(gitService)
     , m_gitLabApi(gitLabApi)
+    , m_repoState(repoState)
+    , m_mrWatcher(new QFutureWatcher<MrResponse>(this))
 {
     setupUi();
     connectSignals();
@@ -171,7 +191,7 @@ void ProtectedBranchView::setupUi() {
     m_mrTreeWidget = new QTreeWidget(this);
     m_mrTreeWidget->setAlternatingRowColors(true);
     m_mrTreeWidget->setContextMenuPolicy(Qt::CustomContextMenu);
-    m_mrTreeWidget->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_mrTreeWidget->setSelectionMode(QAbstractItemView::ExtendedSelection);  // Ctrl/Shift 多选后批量操作
     m_mrTreeWidget->setRootIsDecorated(false);
     
     // 设置列头
@@ -214,21 +234,24 @@ void ProtectedBranchView::connectSignals() {
     connect(m_switchBranchButton, &QPushButton::clicked, this, &ProtectedBranchView::onSwitchBranchClicked);
     
     // MR Signal
-    connect(m_gitLabApi, &GitLabApi::mergeRequestsReceived, this, &ProtectedBranchView::onMergeRequestsReceived);
-    connect(m_gitLabApi, &GitLabApi::mergeRequestApproved, this, &ProtectedBranchView::onMrOperationCompleted);
-    connect(m_gitLabApi, &GitLabApi::mergeRequestMerged, this, &ProtectedBranchView::onMrOperationCompleted);
-    connect(m_gitLabApi, &GitLabApi::mergeRequestClosed, this, &ProtectedBranchView::onMrOperationCompleted);
-    connect(m_gitLabApi, &GitLabApi::apiError, this, &ProtectedBranchView::onMrOperationFailed);
+    connect(m_mrWatcher, &QFutureWatcher<MrResponse>::resultsReadyAt, this, &ProtectedBranchView::onMrResultsReady);
+    connect(m_mrWatcher, &QFutureWatcher<MrResponse>::finished, this, &ProtectedBranchView::onMrListFinished);
     connect(m_mrRefreshButton, &QPushButton::clicked, this, &ProtectedBranchView::refreshMrs);
     connect(m_mrTreeWidget, &QTreeWidget::itemDoubleClicked, this, &ProtectedBranchView::onMrItemDoubleClicked);
     connect(m_mrTreeWidget, &QTreeWidget::customContextMenuRequested, this, &ProtectedBranchView::onMrContextMenuRequested);
     
     connect(m_gitService, &GitService::operationStarted, this, &ProtectedBranchView::onOperationStarted);
     connect(m_gitService, &GitService::operationFinished, this, &ProtectedBranchView::onOperationFinished);
+    
+    connect(m_repoState, &RepositoryState::currentBranchChanged, this, [this]() {
+        if (isVisible()) {
+            refreshMrs();
+        }
+    });
 }
 
 void ProtectedBranchView::onPullClicked() {
-    QString currentBranch = m_gitService->getCurrentBranch();
+    const QString currentBranch = m_repoState->currentBranch();
     
     int ret = QMessageBox::question(
         this,
@@ -253,15 +276,10 @@ void ProtectedBranchView::onPullClicked() {
     progress->setValue(0);
     progress->show();
     
-    // 使用FutureWatcher监听异步任务
-    QFutureWatcher<bool>* watcher = new QFutureWatcher<bool>(this);
-    
-    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher, progress]() {
-        bool success = watcher->result();
-        
+    // 在GitService的后台线程执行Git操作
+    m_gitService->pullLatestAsync().then(this, [this, progress](bool success) {
         progress->close();
         progress->deleteLater();
-        watcher->deleteLater();
         
         if (success) {
             m_statusLabel->setText(QString::fromUtf8("拉取成功"));
@@ -273,17 +291,10 @@ void ProtectedBranchView::onPullClicked() {
                 QString::fromUtf8("拉取失败，请检查网络连接或是否存在冲突"));
         }
     });
-    
-    // 在后台线程执行Git操作
-    QFuture<bool> future = QtConcurrent::run([this]() {
-        return m_gitService->pullLatest();
-    });
-    
-    watcher->setFuture(future);
 }
 
 void ProtectedBranchView::onNewBranchClicked() {
-    QString baseBranch = m_gitService->getCurrentBranch();
+    const QString baseBranch = m_repoState->currentBranch();
     
     BranchCreatorDialog dialog(baseBranch, this);
     if (dialog.exec() != QDialog::Accepted) {
@@ -291,65 +302,114 @@ void ProtectedBranchView::onNewBranchClicked() {
     }
     
     QString branchName = dialog.getBranchName();
+    const bool isDatabase = dialog.getSelectedType() == BranchCreatorDialog::Database;
     m_newBranchButton->setEnabled(false);
     
-    bool success = false;
+    WorkflowEngine* workflow = new WorkflowEngine(QString::fromUtf8("新建分支"), this);
+    
+    // 只快进：本地与远程分叉时直接失败，不会留下合并到一半的工作区；
+    // 失败可能是分叉而非网络问题，重试无意义，只尝试一次。
+    // 步骤超时略长于 GitService 的命令上限：命令超时由 GitService 报告，余量覆盖在写队列中的等待
+    WorkflowStep pull;
+    pull.id = "pull";
+    pull.timeoutMs = GitService::NETWORK_COMMAND_TIMEOUT_MS + 10000;
+    pull.run = [this]() {
+        return WorkflowEngine::requireSuccess(m_gitService->pullLatestAsync(true),
+            QString::fromUtf8("拉取最新代码失败"));
+    };
+    
+    if (isDatabase) {
+        // 数据库分支：直接checkout，再拉取最新代码
+        WorkflowStep checkout;
+        checkout.id = "switch";
+        checkout.label = QString::fromUtf8("切换到 develop-database");
+        checkout.timeoutMs = GitService::COMMAND_TIMEOUT_MS + 10000;
+        checkout.run = [this]() {
+            return WorkflowEngine::requireSuccess(m_gitService->switchBranchAsync("develop-database"),
+                QString::fromUtf8("切换到 develop-database 失败"));
+        };
+        workflow->addStep(checkout);
+        
+        pull.label = QString::fromUtf8("拉取最新代码");
+        pull.dependsOn = QStringList{"switch"};
+        workflow->addStep(pull);
+    } else {
+        // 其他类型：先拉取基础分支的最新代码再创建新分支；
+        // 拉取失败（离线、没有上游、与远程分叉）时工作区未被改动，仍基于本地代码创建
+        pull.label = QString::fromUtf8("拉取 %1 的最新代码").arg(baseBranch);
+        pull.optional = true;
+        workflow->addStep(pull);
+        
+        WorkflowStep create;
+        create.id = "create";
+        create.label = QString::fromUtf8("创建分支 %1").arg(branchName);
+        create.dependsOn = QStringList{"pull"};
+        create.timeoutMs = GitService::COMMAND_TIMEOUT_MS + 10000;
+        create.run = [this, branchName, baseBranch]() {
+            return WorkflowEngine::requireSuccess(m_gitService->createBranchAsync(branchName, baseBranch),
+                QString::fromUtf8("创建分支失败"));
+        };
+        workflow->addStep(create);
+    }
     
-    if (dialog.getSelectedType() == BranchCreatorDialog::Database) {
-        // 数据库分支：直接checkout
-        m_statusLabel->setText(QString::fromUtf8("正在切换到数据库版本升级分支..."));
-        success = m_gitService->switchBranch("develop-database");
+    QProgressDialog* progress = new QProgressDialog(
+        QString::fromUtf8("正在执行分支操作..."),
+        QString(), 0, workflow->stepCount(), this);
+    progress->setWindowModality(Qt::WindowModal);
+    progress->setMinimumDuration(0);
+    progress->setCancelButton(nullptr);
+    progress->show();
+    
+    connect(workflow, &WorkflowEngine::progressChanged, progress, [this, workflow, progress](int finishedSteps, int) {
+        progress->setValue(finishedSteps);
+        progress->setLabelText(workflow->progressText());
+        m_statusLabel->setText(workflow->progressText());
+    });
+    connect(workflow, &WorkflowEngine::finished, this,
+        [this, workflow, progress, isDatabase, branchName, baseBranch](bool success) {
+        progress->close();
+        progress->deleteLater();
+        workflow->deleteLater();
         
-        if (success) {
-            // 切换成功后，自动执行pull
-            m_statusLabel->setText(QString::fromUtf8("正在拉取最新代码..."));
-            
-            QProgressDialog* progress = new QProgressDialog(
-                QString::fromUtf8("✅ 已切换到 develop-database\n正在拉取最新代码..."),
-                QString(), 0, 0, this);
-            progress->setWindowModality(Qt::WindowModal);
-            progress->setMinimumDuration(0);
-            progress->setCancelButton(nullptr);
-            progress->show();
-            
-            // 异步执行pull
-            QFutureWatcher<bool>* watcher = new QFutureWatcher<bool>(this);
-            QFuture<bool> future = QtConcurrent::run([this]() {
-                return m_gitService->pullLatest();
-            });
-            watcher->setFuture(future);
+        if (isDatabase) {
+            const bool switched = workflow->state("switch") == WorkflowEngine::StepState::Succeeded;
+            onBranchOperationFinished(switched);
+            if (!switched) {
+                return;
+            }
             
-            connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher, progress]() {
-                bool pullSuccess = watcher->result();
-                progress->close();
-                progress->deleteLater();
-                watcher->deleteLater();
-                
-                if (pullSuccess) {
-                    QMessageBox::information(this, QString::fromUtf8("成功"),
-                        QString::fromUtf8("已切换到 develop-database 分支并拉取最新代码\n\n"
-                                         "此分支用于数据库版本升级，只能向develop合并。"));
-                } else {
-                    QMessageBox::warning(this, QString::fromUtf8("拉取失败"),
-                        QString::fromUtf8("已切换到 develop-database，但拉取最新代码失败。\n"
-                                         "请手动执行拉取操作。"));
-                }
-                
-                m_statusLabel->setText(QString::fromUtf8("分支操作完成"));
-                emit branchChanged();
-            });
+            if (success) {
+                QMessageBox::information(this, QString::fromUtf8("成功"),
+                    QString::fromUtf8("已切换到 develop-database 分支并拉取最新代码\n\n"
+                                     "此分支用于数据库版本升级，只能向develop合并。"));
+            } else {
+                QMessageBox::warning(this, QString::fromUtf8("拉取失败"),
+                    QString::fromUtf8("已切换到 develop-database，但拉取最新代码失败。\n"
+                                     "请手动执行拉取操作。"));
+            }
+            m_statusLabel->setText(QString::fromUtf8("分支操作完成"));
+            return;
         }
-    } else {
-        // 其他类型：创建新分支
-        m_statusLabel->setText(QString::fromUtf8("正在创建分支..."));
-        success = m_gitService->createBranch(branchName, baseBranch);
         
         if (success) {
-            QMessageBox::information(this, QString::fromUtf8("成功"),
-                QString::fromUtf8("已创建并切换到新分支：%1\n\n现在可以开始开发了！").arg(branchName));
+            if (workflow->state("pull") == WorkflowEngine::StepState::Failed) {
+                QMessageBox::warning(this, QString::fromUtf8("已创建分支"),
+                    QString::fromUtf8("已创建并切换到新分支：%1\n\n"
+                                     "⚠️ 拉取 %2 的最新代码失败（%3），新分支基于本地的 %2 创建，可能不是最新代码。\n"
+                                     "请检查网络连接，或本地 %2 是否有未推送的提交（与远程分叉时无法快进）。")
+                        .arg(branchName, baseBranch, workflow->errorMessage("pull")));
+            } else {
+                QMessageBox::information(this, QString::fromUtf8("成功"),
+                    QString::fromUtf8("已创建并切换到新分支：%1\n\n现在可以开始开发了！").arg(branchName));
+            }
         }
-    }
+        onBranchOperationFinished(success);
+    });
     
+    workflow->start();
+}
+
+void ProtectedBranchView::onBranchOperationFinished(bool success) {
     m_newBranchButton->setEnabled(true);
     
     if (success) {
@@ -370,11 +430,9 @@ void ProtectedBranchView::onOperationFinished(const QString& operation, bool suc
     if (success) {
         m_statusLabel->setText(QString::fromUtf8("完成: %1").arg(operation));
         
-        // 切换分支成功后自动刷新MR列表
+        // 切换分支成功后通知主窗口；MR列表由 currentBranchChanged 驱动刷新
         if (operation.contains("checkout") || operation.contains("switch")) {
             emit branchChanged();
-            // 使用0.5秒延迟确保git操作完全释放锁
-            QTimer::singleShot(500, this, &ProtectedBranchView::refreshMrs);
         }
     } else {
         m_statusLabel->setText(QString::fromUtf8("失败: %1").arg(operation));
@@ -382,9 +440,9 @@ void ProtectedBranchView::onOperationFinished(const QString& operation, bool suc
 }
 
 void ProtectedBranchView::onSwitchBranchClicked() {
-    // 获取所有分支列表
-    QStringList branches = m_gitService->getAllBranches();
-    QString currentBranch = m_gitService->getCurrentBranch();
+    // 分支列表取自共享仓库状态
+    QStringList branches = m_repoState->branches();
+    const QString currentBranch = m_repoState->currentBranch();
     
     if (branches.isEmpty()) {
         QMessageBox::warning(this, QString::fromUtf8("无可用分支"),
@@ -424,19 +482,25 @@ void ProtectedBranchView::onSwitchBranchClicked() {
     }
     
     // 检查是否有未提交的改动
-    if (m_gitService->hasUncommittedChanges()) {
-        int ret = QMessageBox::warning(this, 
-            QString::fromUtf8("未提交的改动"),
-            QString::fromUtf8("当前存在未提交的改动，切换分支可能会丢失这些改动。\n\n"
-                                 "是否继续切换？"),
-            QMessageBox::Yes | QMessageBox::No,
-            QMessageBox::No);
-        
-        if (ret != QMessageBox::Yes) {
-            return;
+    m_gitService->hasUncommittedChangesAsync().then(this, [this, selectedBranch](bool hasChanges) {
+        if (hasChanges) {
+            int ret = QMessageBox::warning(this, 
+                QString::fromUtf8("未提交的改动"),
+                QString::fromUtf8("当前存在未提交的改动，切换分支可能会丢失这些改动。\n\n"
+                                     "是否继续切换？"),
+                QMessageBox::Yes | QMessageBox::No,
+                QMessageBox::No);
+            
+            if (ret != QMessageBox::Yes) {
+                return;
+            }
         }
-    }
-    
+        
+        switchToBranch(selectedBranch);
+    });
+}
+
+void ProtectedBranchView::switchToBranch(const QString& selectedBranch) {
     // 执行切换
     QProgressDialog* progress = new QProgressDialog(
         QString::fromUtf8("正在切换分支..."),
@@ -448,19 +512,9 @@ void ProtectedBranchView::onSwitchBranchClicked() {
     progress->setCancelButton(nullptr);
     progress->show();
     
-    QFuture<bool> future = QtConcurrent::run([this, selectedBranch]() {
-        return m_gitService->switchBranch(selectedBranch);
-    });
-    
-    QFutureWatcher<bool>* watcher = new QFutureWatcher<bool>(this);
-    watcher->setFuture(future);
-    
-    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher, progress, selectedBranch]() {
-        bool success = watcher->result();
-        
+    m_gitService->switchBranchAsync(selectedBranch).then(this, [this, progress, selectedBranch](bool success) {
         progress->close();
         progress->deleteLater();
-        watcher->deleteLater();
         
         if (success) {
             emit branchChanged();
@@ -468,12 +522,6 @@ void ProtectedBranchView::onSwitchBranchClicked() {
             QMessageBox::warning(this, QString::fromUtf8("切换失败"),
                 QString::fromUtf8("切换到分支 %1 失败，请检查Git状态。").arg(selectedBranch));
         }
-        if (success) {
-            emit branchChanged();
-        } else {
-            QMessageBox::warning(this, QString::fromUtf8("切换失败"),
-                QString::fromUtf8("切换到分支 %1 失败，请检查Git状态。").arg(selectedBranch));
-        }
     });
 }
 
@@ -483,64 +531,99 @@ void ProtectedBranchView::showEvent(QShowEvent* event) {
 }
 
 void ProtectedBranchView::refreshMrs() {
-    QString currentBranch = m_gitService->getCurrentBranch();
+    if (!m_repoState->isLoaded(RepositoryState::CurrentBranch)) {
+        // 加载完成后经 currentBranchChanged 回到这里
+        m_repoState->refresh(RepositoryState::CurrentBranch);
+        return;
+    }
+    
+    // 取消尚未完成的上一次加载（中止其网络请求）
+    m_mrWatcher->cancel();
     setCursor(Qt::WaitCursor);
-    m_gitLabApi->listMergeRequests(1, 20, "opened", currentBranch);
-    setCursor(Qt::ArrowCursor);
+    const PagedList<MrResponse> mrList = m_gitLabApi->listMergeRequests("opened", m_repoState->currentBranch());
+    m_mrListTruncated = mrList.truncated;
+    m_mrWatcher->setFuture(mrList.items);
 }
 
-void ProtectedBranchView::onMergeRequestsReceived(const QList<MrResponse>& mrs) {
-    m_mrTreeWidget->clear();
-    setCursor(Qt::ArrowCursor);
+void ProtectedBranchView::onMrResultsReady(int begin, int end) {
+    // 首页到达即开始显示，后续页追加
+    if (begin == 0) {
+        m_mrTreeWidget->clear();
+        setCursor(Qt::ArrowCursor);
+    }
     
-    if (mrs.isEmpty()) {
+    for (int index = begin; index < end; ++index) {
+        const MrResponse mr = m_mrWatcher->resultAt(index);
         QTreeWidgetItem* item = new QTreeWidgetItem(m_mrTreeWidget);
-        item->setText(1, QString::fromUtf8("✓ 没有待处理的MR"));
-    } else {
-        for (const MrResponse& mr : mrs) {
-            QTreeWidgetItem* item = new QTreeWidgetItem(m_mrTreeWidget);
-            item->setText(0, QString::number(mr.iid));
-            item->setText(1, mr.title);
-            item->setText(2, mr.description.left(100) + (mr.description.length() > 100 ? "..." : "")); // 截断显示
-            item->setText(3, mr.authorName);
-            
-            // 格式化时间
-            QDateTime dt = QDateTime::fromString(mr.createdAt, Qt::ISODate);
-            
-            // Debug Log
-            LOG_INFO(QString("MR created_at raw: %1, Parsed: %2, Spec: %3")
-                     .arg(mr.createdAt)
-                     .arg(dt.toString(Qt::ISODate))
-                     .arg(dt.timeSpec()));
+        item->setText(0, QString::number(mr.iid));
+        item->setText(1, mr.title);
+        item->setText(2, mr.description.left(100) + (mr.description.length() > 100 ? "..." : "")); // 截断显示
+        item->setText(3, mr.authorName);
+        
+        // 格式化时间
+        QDateTime dt = QDateTime::fromString(mr.createdAt, Qt::ISODate);
+        
+        // Debug Log
+        LOG_INFO(QString("MR created_at raw: %1, Parsed: %2, Spec: %3")
+                 .arg(mr.createdAt)
+                 .arg(dt.toString(Qt::ISODate))
+                 .arg(dt.timeSpec()));
 
-            // 强制转换为UTC+8 (28800秒)
-            QTimeZone zone = QTimeZone::fromSecondsAheadOfUtc(28800);
-            QDateTime dt8 = dt.toTimeZone(zone); // Use new variable
-            
-             LOG_INFO(QString("Converted to +8: %1").arg(dt8.toString(Qt::ISODate)));
-             
-            item->setText(4, dt8.toString("MM-dd HH:mm"));
-            
-            // 设置数据
-            item->setData(0, Qt::UserRole, mr.webUrl);
-            item->setData(0, Qt::UserRole + 1, mr.iid);
+        // 强制转换为UTC+8 (28800秒)
+        QTimeZone zone = QTimeZone::fromSecondsAheadOfUtc(28800);
+        QDateTime dt8 = dt.toTimeZone(zone); // Use new variable
+        
+         LOG_INFO(QString("Converted to +8: %1").arg(dt8.toString(Qt::ISODate)));
+         
+        item->setText(4, dt8.toString("MM-dd HH:mm"));
+        
+        // 设置数据
+        item->setData(0, Qt::UserRole, mr.webUrl);
+        item->setData(0, Qt::UserRole + 1, mr.iid);
 
-            // 设置ToolTip
-            QString tooltip = QString::fromUtf8(
-                "MR !%1\n"
-                "标题: %2\n"
-                "提交人: %3\n"
-                "时间: %4\n\n"
-                "%5"
-            ).arg(mr.iid).arg(mr.title, mr.authorName, dt.toString("MM-dd HH:mm"), mr.description);
-            
-            for(int i=0; i<5; ++i) {
-                item->setToolTip(i, tooltip);
-            }
+        // 设置ToolTip
+        QString tooltip = QString::fromUtf8(
+            "MR !%1\n"
+            "标题: %2\n"
+            "提交人: %3\n"
+            "时间: %4\n\n"
+            "%5"
+        ).arg(mr.iid).arg(mr.title, mr.authorName, dt.toString("MM-dd HH:mm"), mr.description);
+        
+        for(int i=0; i<5; ++i) {
+            item->setToolTip(i, tooltip);
         }
     }
 }
 
+void ProtectedBranchView::onMrListFinished() {
+    setCursor(Qt::ArrowCursor);
+    
+    try {
+        m_mrWatcher->waitForFinished();  // 加载失败时重新抛出 ApiError
+    } catch (const ApiError& error) {
+        LOG_WARNING(QString("加载MR列表失败: %1").arg(error.message()));
+        onMrOperationFailed(error);
+        return;
+    }
+    
+    if (m_mrWatcher->isCanceled()) {
+        return;  // 已被新的加载取代
+    }
+    
+    if (m_mrWatcher->future().resultCount() == 0) {
+        m_mrTreeWidget->clear();
+        QTreeWidgetItem* item = new QTreeWidgetItem(m_mrTreeWidget);
+        item->setText(1, QString::fromUtf8("✓ 没有待处理的MR"));
+    } else if (m_mrListTruncated.result()) {  // 列表成功完成时已有结果
+        // 不带MR数据，双击与右键菜单会忽略此行
+        QTreeWidgetItem* item = new QTreeWidgetItem(m_mrTreeWidget);
+        item->setText(1, QString::fromUtf8("⚠️ 仅显示前 %1 个MR，列表未完整加载，请在GitLab中查看其余MR")
+                         .arg(m_mrWatcher->future().resultCount()));
+        item->setFlags(Qt::ItemIsEnabled);
+    }
+}
+
 void ProtectedBranchView::onMrItemDoubleClicked(QTreeWidgetItem* item, int column) {
     if (!item) return;
     
@@ -563,15 +646,27 @@ void ProtectedBranchView::onMrContextMenuRequested(const QPoint& pos) {
     QString url = item->data(0, Qt::UserRole).toString();
     if (url.isEmpty()) return; // 空条目
     
-    // 从UserRole+1获取MR IID
-    m_selectedMrIid = item->data(0, Qt::UserRole + 1).toInt();
-    if (m_selectedMrIid == 0) return;
+    // 从UserRole+1获取MR IID；右键点在选中项上时操作全部选中的MR
+    m_selectedMrIids.clear();
+    const QList<QTreeWidgetItem*> selected = item->isSelected() ? m_mrTreeWidget->selectedItems()
+                                                                : QList<QTreeWidgetItem*>{item};
+    for (QTreeWidgetItem* selectedItem : selected) {
+        const int iid = selectedItem->data(0, Qt::UserRole + 1).toInt();
+        if (iid != 0) {
+            m_selectedMrIids.append(iid);
+        }
+    }
+    if (m_selectedMrIids.isEmpty()) return;
     
+    const int count = m_selectedMrIids.size();
     QMenu contextMenu(this);
     
-    QAction* approveAction = contextMenu.addAction(QString::fromUtf8("✅ 批准 (Approve)"));
-    QAction* mergeAction = contextMenu.addAction(QString::fromUtf8("🔀 合并 (Merge)"));
-    QAction* closeAction = contextMenu.addAction(QString::fromUtf8("❌ 关闭 (Close)"));
+    QAction* approveAction = contextMenu.addAction(count > 1
+        ? QString::fromUtf8("✅ 批准选中的 %1 个MR").arg(count) : QString::fromUtf8("✅ 批准 (Approve)"));
+    QAction* mergeAction = contextMenu.addAction(count > 1
+        ? QString::fromUtf8("🔀 合并选中的 %1 个MR").arg(count) : QString::fromUtf8("🔀 合并 (Merge)"));
+    QAction* closeAction = contextMenu.addAction(count > 1
+        ? QString::fromUtf8("❌ 关闭选中的 %1 个MR").arg(count) : QString::fromUtf8("❌ 关闭 (Close)"));
     contextMenu.addSeparator();
     QAction* openAction = contextMenu.addAction(QString::fromUtf8("🌐 在浏览器中打开"));
     
@@ -586,62 +681,129 @@ void ProtectedBranchView::onMrContextMenuRequested(const QPoint& pos) {
 }
 
 void ProtectedBranchView::onMrApproveClicked() {
-    if (m_selectedMrIid == 0) return;
+    if (m_selectedMrIids.isEmpty()) return;
     
-    m_gitLabApi->approveMergeRequest(m_selectedMrIid);
-    QMessageBox::information(this, QString::fromUtf8("批准MR"),
-        QString::fromUtf8("正在批准 MR !%1，请稍候...").arg(m_selectedMrIid));
+    runMrBatch(MrBatchOperation::Action::Approve, m_selectedMrIids);
 }
 
 void ProtectedBranchView::onMrMergeClicked() {
-    if (m_selectedMrIid == 0) return;
+    if (m_selectedMrIids.isEmpty()) return;
     
+    const QString target = m_selectedMrIids.size() > 1
+        ? QString::fromUtf8("选中的 %1 个MR（%2）").arg(m_selectedMrIids.size()).arg(formatMrList(m_selectedMrIids))
+        : QString::fromUtf8("MR !%1").arg(m_selectedMrIids.first());
     int ret = QMessageBox::question(this, QString::fromUtf8("确认合并"),
-        QString::fromUtf8("确定要合并 MR !%1 吗？\n\n此操作将：\n"
+        QString::fromUtf8("确定要合并 %1 吗？\n\n此操作将：\n"
                          "• 将代码合并到目标分支\n"
                          "• 自动删除源分支\n\n"
-                         "此操作不可撤销！").arg(m_selectedMrIid),
+                         "此操作不可撤销！").arg(target),
         QMessageBox::Yes | QMessageBox::No,
         QMessageBox::No);
     
     if (ret == QMessageBox::Yes) {
-        m_gitLabApi->mergeMergeRequest(m_selectedMrIid, true);
-        QMessageBox::information(this, QString::fromUtf8("合并MR"),
-            QString::fromUtf8("正在合并 MR !%1，请稍候...").arg(m_selectedMrIid));
+        runMrBatch(MrBatchOperation::Action::Merge, m_selectedMrIids);
     }
 }
 
 void ProtectedBranchView::onMrCloseClicked() {
-    if (m_selectedMrIid == 0) return;
+    if (m_selectedMrIids.isEmpty()) return;
     
+    const QString target = m_selectedMrIids.size() > 1
+        ? QString::fromUtf8("选中的 %1 个MR（%2）").arg(m_selectedMrIids.size()).arg(formatMrList(m_selectedMrIids))
+        : QString::fromUtf8("MR !%1").arg(m_selectedMrIids.first());
     int ret = QMessageBox::question(this, QString::fromUtf8("确认关闭"),
-        QString::fromUtf8("确定要关闭 MR !%1 而不合并吗？\n\n"
+        QString::fromUtf8("确定要关闭 %1 而不合并吗？\n\n"
                          "此操作将关闭MR，不会合并代码。\n\n"
-                         "是否继续？").arg(m_selectedMrIid),
+                         "是否继续？").arg(target),
         QMessageBox::Yes | QMessageBox::No,
         QMessageBox::No);
     
     if (ret == QMessageBox::Yes) {
-        m_gitLabApi->closeMergeRequest(m_selectedMrIid);
-        QMessageBox::information(this, QString::fromUtf8("关闭MR"),
-            QString::fromUtf8("正在关闭 MR !%1，请稍候...").arg(m_selectedMrIid));
+        runMrBatch(MrBatchOperation::Action::Close, m_selectedMrIids);
     }
 }
 
-void ProtectedBranchView::onMrOperationCompleted(const MrResponse& mr) {
-    QMessageBox::information(this, QString::fromUtf8("操作成功"),
-        QString::fromUtf8("MR !%1 操作完成！\n\n刷新列表以查看最新状态。").arg(mr.iid));
+void ProtectedBranchView::runMrBatch(MrBatchOperation::Action action, const QList<int>& mrIids) {
+    MrBatchOperation* batch = new MrBatchOperation(m_gitLabApi, action, mrIids, this);
+    const QString actionName = MrBatchOperation::actionName(action);
     
-    // 自动刷新MR列表
-    refreshMrs();
+    // 整批只有一个进度框，结束后一个汇总框
+    QProgressDialog* progress = new QProgressDialog(
+        QString::fromUtf8("正在%1 MR...").arg(actionName),
+        QString::fromUtf8("取消"), 0, batch->totalCount(), this);
+    progress->setWindowTitle(QString::fromUtf8("%1MR").arg(actionName));
+    progress->setMinimumWidth(300);
+    progress->setWindowModality(Qt::WindowModal);
+    progress->setMinimumDuration(0);
+    progress->setAutoClose(false);
+    progress->setAutoReset(false);
+    progress->setValue(0);
+    
+    connect(progress, &QProgressDialog::canceled, batch, &MrBatchOperation::cancel);
+    connect(batch, &MrBatchOperation::progressChanged, progress, [batch, progress, actionName](int finishedCount, int totalCount) {
+        progress->setValue(finishedCount);
+        QString text = QString::fromUtf8("正在%1 MR：已完成 %2/%3").arg(actionName).arg(finishedCount).arg(totalCount);
+        const int failed = batch->countInState(MrBatchOperation::State::Failed);
+        const int waiting = batch->countInState(MrBatchOperation::State::Waiting);
+        if (failed > 0) {
+            text += QString::fromUtf8("，失败 %1").arg(failed);
+        }
+        if (waiting > 0) {
+            text += QString::fromUtf8("，%1 个被限流等待重试").arg(waiting);
+        }
+        progress->setLabelText(text);
+    });
+    connect(batch, &MrBatchOperation::finished, this, [this, batch, progress, actionName]() {
+        progress->close();
+        progress->deleteLater();
+        batch->deleteLater();
+        onMrBatchFinished(batch, actionName);
+    });
+    
+    progress->show();
+    batch->start();
 }
 
-void ProtectedBranchView::onMrOperationFailed(const QString& endpoint, const QString& error) {
-    // 只处理MR相关的错误
-    if (!endpoint.contains("MergeRequest") && !endpoint.contains("merge_request")) {
-        return;
+void ProtectedBranchView::onMrBatchFinished(MrBatchOperation* batch, const QString& actionName) {
+    const int succeeded = batch->countInState(MrBatchOperation::State::Succeeded);
+    const int failed = batch->countInState(MrBatchOperation::State::Failed);
+    const int canceled = batch->countInState(MrBatchOperation::State::Canceled);
+    
+    QStringList details;
+    for (int iid : batch->mrIids()) {
+        const MrBatchOperation::Item item = batch->item(iid);
+        if (item.state == MrBatchOperation::State::Failed) {
+            details << QString::fromUtf8("!%1 失败：%2").arg(iid).arg(item.errorMessage);
+        } else if (item.state == MrBatchOperation::State::Canceled) {
+            details << QString::fromUtf8("!%1 已取消（请求已发出的可能已生效）").arg(iid);
+        }
+    }
+    
+    QMessageBox msgBox(this);
+    msgBox.setWindowTitle(QString::fromUtf8("%1MR").arg(actionName));
+    msgBox.setMinimumWidth(255);
+    if (details.isEmpty()) {
+        msgBox.setIcon(QMessageBox::Information);
+        msgBox.setText(QString::fromUtf8("已%1 %2 个MR。").arg(actionName).arg(succeeded));
+    } else {
+        msgBox.setIcon(QMessageBox::Warning);
+        QString text = QString::fromUtf8("成功 %1 个，失败 %2 个").arg(succeeded).arg(failed);
+        if (canceled > 0) {
+            text += QString::fromUtf8("，取消 %1 个").arg(canceled);
+        }
+        msgBox.setText(text + QString::fromUtf8("。\n\n") + details.mid(0, 5).join("\n")
+                       + (details.size() > 5 ? QString::fromUtf8("\n...（完整列表见详细信息）") : QString()));
+        msgBox.setDetailedText(details.join("\n"));
     }
+    msgBox.exec();
     
+    // 自动刷新MR列表
+    if (succeeded > 0 || canceled > 0) {
+        refreshMrs();
+    }
+}
+
+void ProtectedBranchView::onMrOperationFailed(const ApiError& error) {
     QMessageBox::warning(this, QString::fromUtf8("操作失败"),
-        QString::fromUtf8("MR操作失败：\n\n%1").arg(error));
+        QString::fromUtf8("MR操作失败：\n\n%1").arg(error.message()));
 }
\ No newline at end of file
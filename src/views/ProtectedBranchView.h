@@ -3,20 +3,25 @@
 
 #include <QWidget>
 #include <QShowEvent>
+#include <QFutureWatcher>
+#include "automation/MrBatchOperation.h"
 
 class GitService;
 class GitLabApi;
+class RepositoryState;
 class QPushButton;
 class QLabel;
 class QTreeWidget;
 class QTreeWidgetItem;
 class QGroupBox;
 struct MrResponse;
+class ApiError;
 
 class ProtectedBranchView : public QWidget {
     Q_OBJECT
 public:
-    explicit ProtectedBranchView(GitService* gitService, GitLabApi* gitLabApi, QWidget* parent = nullptr);
+    explicit ProtectedBranchView(GitService* gitService, GitLabApi* gitLabApi, RepositoryState* repoState,
+                                 QWidget* parent = nullptr);
 
 protected:
     void showEvent(QShowEvent* event) override;
@@ -35,9 +40,12 @@ private slots:
 private:
     void setupUi();
     void connectSignals();
+    void onBranchOperationFinished(bool success);
+    void switchToBranch(const QString& selectedBranch);
     
     GitService* m_gitService;
     GitLabApi* m_gitLabApi;
+    RepositoryState* m_repoState;
     
     QPushButton* m_pullButton;
     QPushButton* m_newBranchButton;
@@ -49,17 +57,22 @@ private:
     QPushButton* m_mrRefreshButton;
     
 private slots:
-    void onMergeRequestsReceived(const QList<MrResponse>& mrs);
     void refreshMrs();
     void onMrContextMenuRequested(const QPoint& pos);
     void onMrApproveClicked();
     void onMrMergeClicked();
     void onMrCloseClicked();
-    void onMrOperationCompleted(const MrResponse& mr);
-    void onMrOperationFailed(const QString& endpoint, const QString& error);
     
 private:
-    int m_selectedMrIid;
+    void onMrResultsReady(int begin, int end);
+    void onMrListFinished();
+    void runMrBatch(MrBatchOperation::Action action, const QList<int>& mrIids);
+    void onMrBatchFinished(MrBatchOperation* batch, const QString& actionName);
+    void onMrOperationFailed(const ApiError& error);
+    
+    QList<int> m_selectedMrIids;  // 右键菜单打开时选中的MR
+    QFutureWatcher<MrResponse>* m_mrWatcher;  // 当前MR列表加载，随分页逐步显示
+    QFuture<bool> m_mrListTruncated;          // 当前MR列表是否因页数上限未取全
 };
 
 #endif // PROTECTEDBRANCHVIEW_H
\ No newline at end of file
@@ -1,4 +1,189 @@
 #include "DownloadLinkWidget.h"
+#include "automation/ArtifactDownloader.h"
+#include <QVBoxLayout>
+#include <QLabel>
+#include <QTreeWidget>
+#include <QHeaderView>
+#include <QMenu>
+#include <QFileInfo>
+#include <QDesktopServices>
+#include <QUrl>
+#include <QLocale>
+#include <QFileDialog>
+#include <QStandardPaths>
+#include <QDir>
 
-DownloadLinkWidget::DownloadLinkWidget(QWidget* parent) : QWidget(parent) {
-}
\ No newline at end of file
+namespace {
+
+enum Column { FileColumn, ProgressColumn, SpeedColumn, StateColumn };
+
+QString stateText(ArtifactDownloader::State state) {
+    switch (state) {
+    case ArtifactDownloader::State::Queued:   return QString::fromUtf8("排队中");
+    case ArtifactDownloader::State::Running:  return QString::fromUtf8("下载中");
+    case ArtifactDownloader::State::Retrying: return QString::fromUtf8("等待续传");
+    case ArtifactDownloader::State::Finished: return QString::fromUtf8("✅ 完成");
+    case ArtifactDownloader::State::Failed:   return QString::fromUtf8("❌ 失败");
+    case ArtifactDownloader::State::Canceled: return QString::fromUtf8("已取消");
+    }
+    return QString();
+}
+
+}
+
+DownloadLinkWidget::DownloadLinkWidget(ArtifactDownloader* downloader, QWidget* parent)
+    : QWidget(parent)
+    , m_downloader(downloader)
+{
+    setupUi();
+    
+    connect(m_downloader, &ArtifactDownloader::taskAdded, this, &DownloadLinkWidget::addTask);
+    connect(m_downloader, &ArtifactDownloader::taskChanged, this, &DownloadLinkWidget::updateTask);
+    for (int id : m_downloader->taskIds()) {
+        addTask(id);
+    }
+}
+
+void DownloadLinkWidget::setupUi() {
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    
+    m_summaryLabel = new QLabel(this);
+    layout->addWidget(m_summaryLabel);
+    
+    m_taskTree = new QTreeWidget(this);
+    m_taskTree->setRootIsDecorated(false);
+    m_taskTree->setAlternatingRowColors(true);
+    m_taskTree->setContextMenuPolicy(Qt::CustomContextMenu);
+    m_taskTree->setHeaderLabels({QString::fromUtf8("文件"), QString::fromUtf8("进度"),
+                                 QString::fromUtf8("速度"), QString::fromUtf8("状态")});
+    m_taskTree->header()->setSectionResizeMode(FileColumn, QHeaderView::Stretch);
+    m_taskTree->setMinimumHeight(100);
+    layout->addWidget(m_taskTree);
+    
+    connect(m_taskTree, &QTreeWidget::customContextMenuRequested, this, &DownloadLinkWidget::showContextMenu);
+    connect(m_taskTree, &QTreeWidget::itemDoubleClicked, this, [this](QTreeWidgetItem* item) {
+        if (m_links.contains(item)) {
+            downloadLink(item);
+        }
+    });
+    updateSummary();
+}
+
+void DownloadLinkWidget::addTask(int id) {
+    QTreeWidgetItem* item = new QTreeWidgetItem(m_taskTree);
+    item->setData(FileColumn, Qt::UserRole, id);
+    m_items.insert(id, item);
+    updateTask(id);
+    m_taskTree->scrollToItem(item);
+}
+
+void DownloadLinkWidget::addLink(const BuildArtifact& artifact) {
+    for (const BuildArtifact& existing : std::as_const(m_links)) {
+        if (existing.downloadUrl == artifact.downloadUrl) {
+            return;
+        }
+    }
+    
+    QTreeWidgetItem* item = new QTreeWidgetItem(m_taskTree);
+    item->setText(FileColumn, artifact.filename);
+    item->setToolTip(FileColumn, artifact.downloadUrl);
+    item->setText(StateColumn, QString::fromUtf8("🔗 可下载"));
+    item->setToolTip(StateColumn, QString::fromUtf8("双击下载"));
+    m_links.insert(item, artifact);
+    updateSummary();
+}
+
+void DownloadLinkWidget::downloadLink(QTreeWidgetItem* item) {
+    const BuildArtifact artifact = m_links.value(item);
+    const QString defaultPath = QDir(QStandardPaths::writableLocation(QStandardPaths::DownloadLocation))
+                                    .filePath(artifact.filename);
+    const QString destination = QFileDialog::getSaveFileName(this, QString::fromUtf8("保存产物"), defaultPath);
+    if (destination.isEmpty()) {
+        return;
+    }
+    
+    // 链接行由下载任务的行取代
+    m_links.remove(item);
+    delete item;
+    m_downloader->enqueue(artifact, destination);
+}
+
+void DownloadLinkWidget::updateTask(int id) {
+    QTreeWidgetItem* item = m_items.value(id);
+    if (!item) {
+        return;
+    }
+    
+    const ArtifactDownloader::Task task = m_downloader->task(id);
+    const QLocale locale;
+    item->setText(FileColumn, QFileInfo(task.destination).fileName());
+    item->setToolTip(FileColumn, task.destination);
+    
+    if (task.total > 0) {
+        item->setText(ProgressColumn, QString("%1%  %2 / %3")
+            .arg(task.received * 100 / task.total)
+            .arg(locale.formattedDataSize(task.received), locale.formattedDataSize(task.total)));
+    } else {
+        item->setText(ProgressColumn, locale.formattedDataSize(task.received));
+    }
+    item->setText(SpeedColumn, task.state == ArtifactDownloader::State::Running
+                                   ? locale.formattedDataSize(task.bytesPerSecond) + "/s" : QString());
+    item->setText(StateColumn, stateText(task.state));
+    item->setToolTip(StateColumn, task.errorMessage);
+    
+    updateSummary();
+}
+
+void DownloadLinkWidget::updateSummary() {
+    int running = 0;
+    int finished = 0;
+    for (int id : m_downloader->taskIds()) {
+        const ArtifactDownloader::State state = m_downloader->task(id).state;
+        if (state == ArtifactDownloader::State::Running) {
+            ++running;
+        } else if (state == ArtifactDownloader::State::Finished) {
+            ++finished;
+        }
+    }
+    QString summary = QString::fromUtf8("📦 产物下载：%1 个进行中，%2/%3 个完成，合计 %4/s")
+        .arg(running).arg(finished).arg(m_items.size())
+        .arg(QLocale().formattedDataSize(m_downloader->bytesPerSecond()));
+    if (!m_links.isEmpty()) {
+        summary += QString::fromUtf8("；%1 个链接待下载").arg(m_links.size());
+    }
+    m_summaryLabel->setText(summary);
+}
+
+void DownloadLinkWidget::showContextMenu(const QPoint& pos) {
+    QTreeWidgetItem* item = m_taskTree->itemAt(pos);
+    if (!item) {
+        return;
+    }
+    
+    QMenu menu(this);
+    if (m_links.contains(item)) {
+        QAction* downloadAction = menu.addAction(QString::fromUtf8("⬇️ 下载"));
+        connect(downloadAction, &QAction::triggered, this, [this, item]() { downloadLink(item); });
+        menu.exec(m_taskTree->viewport()->mapToGlobal(pos));
+        return;
+    }
+    
+    const int id = item->data(FileColumn, Qt::UserRole).toInt();
+    const ArtifactDownloader::Task task = m_downloader->task(id);
+    
+    QAction* openAction = menu.addAction(QString::fromUtf8("📂 打开所在文件夹"));
+    connect(openAction, &QAction::triggered, this, [task]() {
+        QDesktopServices::openUrl(QUrl::fromLocalFile(QFileInfo(task.destination).absolutePath()));
+    });
+    
+    if (task.state == ArtifactDownloader::State::Failed || task.state == ArtifactDownloader::State::Canceled) {
+        QAction* retryAction = menu.addAction(QString::fromUtf8("🔄 重试"));
+        connect(retryAction, &QAction::triggered, this, [this, id]() { m_downloader->retry(id); });
+    } else if (task.state != ArtifactDownloader::State::Finished) {
+        QAction* cancelAction = menu.addAction(QString::fromUtf8("⏹️ 取消"));
+        connect(cancelAction, &QAction::triggered, this, [this, id]() { m_downloader->cancel(id); });
+    }
+    
+    menu.exec(m_taskTree->viewport()->mapToGlobal(pos));
+}
@@ -2,11 +2,41 @@
 #define DOWNLOADLINKWIDGET_H
 
 #include <QWidget>
+#include <QHash>
+#include "api/ApiModels.h"
 
+class ArtifactDownloader;
+class QTreeWidget;
+class QTreeWidgetItem;
+class QLabel;
+
+/**
+ * @brief 产物下载列表
+ * 显示 ArtifactDownloader 中每个任务的进度、速度与状态，以及合计下载速度；
+ * 右键可打开所在文件夹、取消或重试。
+ * 也可以列出尚未下载的产物链接（如从Job日志中提取的），双击或右键选择保存位置后开始下载。
+ */
 class DownloadLinkWidget : public QWidget {
     Q_OBJECT
 public:
-    explicit DownloadLinkWidget(QWidget* parent = nullptr);
+    explicit DownloadLinkWidget(ArtifactDownloader* downloader, QWidget* parent = nullptr);
+    
+    // 添加一条待下载的链接（同一链接只列出一次）
+    void addLink(const BuildArtifact& artifact);
+    
+private:
+    void setupUi();
+    void addTask(int id);
+    void updateTask(int id);
+    void updateSummary();
+    void showContextMenu(const QPoint& pos);
+    void downloadLink(QTreeWidgetItem* item);
+    
+    ArtifactDownloader* m_downloader;
+    QLabel* m_summaryLabel;
+    QTreeWidget* m_taskTree;
+    QHash<int, QTreeWidgetItem*> m_items;  // 任务ID -> 行
+    QHash<QTreeWidgetItem*, BuildArtifact> m_links;  // 尚未下载的链接行
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,137 @@
+#include "JobLogDialog.h"
+#include "DownloadLinkWidget.h"
+#include "automation/JobLogTailer.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QListView>
+#include <QLabel>
+#include <QCheckBox>
+#include <QPushButton>
+#include <QScrollBar>
+#include <QAbstractListModel>
+#include <QFontDatabase>
+#include <QDesktopServices>
+#include <QUrl>
+#include <QLocale>
+
+/**
+ * @brief 按行号向 JobLogTailer 取行的列表模型
+ * 行数只在收到 linesAppended 时更新，与视图收到的插入通知保持一致
+ */
+class JobLogModel : public QAbstractListModel {
+public:
+    explicit JobLogModel(JobLogTailer* tailer, QObject* parent = nullptr)
+        : QAbstractListModel(parent), m_tailer(tailer) {}
+    
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override {
+        return parent.isValid() ? 0 : m_rows;
+    }
+    
+    QVariant data(const QModelIndex& index, int role) const override {
+        if (role != Qt::DisplayRole || !index.isValid() || index.row() >= m_rows) {
+            return QVariant();
+        }
+        return m_tailer->line(index.row());
+    }
+    
+    void linesAppended(int firstChangedLine, int lineCount) {
+        if (firstChangedLine < m_rows) {
+            emit dataChanged(index(firstChangedLine), index(m_rows - 1));
+        }
+        if (lineCount > m_rows) {
+            beginInsertRows(QModelIndex(), m_rows, lineCount - 1);
+            m_rows = lineCount;
+            endInsertRows();
+        }
+    }
+    
+private:
+    JobLogTailer* m_tailer;
+    int m_rows = 0;
+};
+
+JobLogDialog::JobLogDialog(GitLabApi* gitLabApi, ArtifactDownloader* downloader, const PipelineJob& job,
+                           QWidget* parent)
+    : QDialog(parent)
+    , m_job(job)
+    , m_tailer(new JobLogTailer(gitLabApi, this))
+    , m_model(new JobLogModel(m_tailer, this))
+{
+    setupUi();
+    
+    // 有链接后才显示
+    m_linkWidget = new DownloadLinkWidget(downloader, this);
+    m_linkWidget->setMaximumHeight(180);
+    m_linkWidget->hide();
+    layout()->addWidget(m_linkWidget);
+    connect(m_tailer, &JobLogTailer::artifactLinkFound, this, [this](const BuildArtifact& artifact) {
+        m_linkWidget->addLink(artifact);
+        m_linkWidget->show();
+    });
+    
+    connect(m_tailer, &JobLogTailer::linesAppended, this, &JobLogDialog::onLinesAppended);
+    connect(m_tailer, &JobLogTailer::jobStatusChanged, this, &JobLogDialog::updateStatus);
+    connect(m_tailer, &JobLogTailer::finished, this, &JobLogDialog::updateStatus);
+    connect(m_tailer, &JobLogTailer::errorOccurred, this, [this](const QString& message) {
+        m_statusLabel->setText(QString::fromUtf8("⚠️ %1").arg(message));
+    });
+    
+    if (!m_tailer->start(job.id)) {
+        m_statusLabel->setText(QString::fromUtf8("⚠️ 无法创建临时文件"));
+    }
+}
+
+void JobLogDialog::setupUi() {
+    setWindowTitle(QString::fromUtf8("Job日志 - %1 #%2").arg(m_job.name).arg(m_job.id));
+    resize(960, 640);
+    
+    QVBoxLayout* mainLayout = new QVBoxLayout(this);
+    
+    QHBoxLayout* headerLayout = new QHBoxLayout();
+    m_statusLabel = new QLabel(QString::fromUtf8("正在加载..."), this);
+    headerLayout->addWidget(m_statusLabel, 1);
+    
+    m_followCheck = new QCheckBox(QString::fromUtf8("跟随最新输出"), this);
+    m_followCheck->setChecked(true);
+    headerLayout->addWidget(m_followCheck);
+    
+    QPushButton* browserButton = new QPushButton(QString::fromUtf8("🌐 在浏览器中打开"), this);
+    browserButton->setEnabled(!m_job.webUrl.isEmpty());
+    headerLayout->addWidget(browserButton);
+    mainLayout->addLayout(headerLayout);
+    
+    // 等高行 + 按需取数据：只有可见的行会被读取与解码
+    m_logView = new QListView(this);
+    m_logView->setModel(m_model);
+    m_logView->setUniformItemSizes(true);
+    m_logView->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    m_logView->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    mainLayout->addWidget(m_logView);
+    
+    connect(browserButton, &QPushButton::clicked, this, [this]() {
+        QDesktopServices::openUrl(QUrl(m_job.webUrl));
+    });
+    // 向上滚动时暂停跟随，回到底部时恢复
+    connect(m_logView->verticalScrollBar(), &QScrollBar::valueChanged, this, [this](int value) {
+        m_followCheck->setChecked(value == m_logView->verticalScrollBar()->maximum());
+    });
+}
+
+void JobLogDialog::onLinesAppended(int firstChangedLine, int lineCount) {
+    const bool follow = m_followCheck->isChecked();
+    m_model->linesAppended(firstChangedLine, lineCount);
+    if (follow) {
+        m_logView->scrollToBottom();
+    }
+    updateStatus();
+}
+
+void JobLogDialog::updateStatus() {
+    QString state = m_tailer->jobStatus();
+    if (!m_tailer->isRunning()) {
+        state += QString::fromUtf8("（已停止更新）");
+    }
+    m_statusLabel->setText(QString::fromUtf8("状态: %1 · %2 · %3 行")
+        .arg(state, QLocale().formattedDataSize(m_tailer->size()))
+        .arg(m_tailer->lineCount()));
+}
@@ -0,0 +1,44 @@
+#ifndef JOBLOGDIALOG_H
+#define JOBLOGDIALOG_H
+
+#include <QDialog>
+#include "api/ApiModels.h"
+
+class GitLabApi;
+class JobLogTailer;
+class ArtifactDownloader;
+class DownloadLinkWidget;
+class JobLogModel;
+class QListView;
+class QLabel;
+class QCheckBox;
+
+/**
+ * @brief Job日志查看器
+ * 日志由 JobLogTailer 增量拉取到临时文件，列表按可见行随取随读，不生成完整文本；
+ * Job进行中时自动跟随最新输出，向上滚动查看时暂停跟随。
+ * 日志中出现的产物链接（按配置的产物正则）实时列在下方，可直接交给 ArtifactDownloader 下载。
+ */
+class JobLogDialog : public QDialog {
+    Q_OBJECT
+    
+public:
+    JobLogDialog(GitLabApi* gitLabApi, ArtifactDownloader* downloader, const PipelineJob& job,
+                 QWidget* parent = nullptr);
+    
+private:
+    void setupUi();
+    void onLinesAppended(int firstChangedLine, int lineCount);
+    void updateStatus();
+    
+    PipelineJob m_job;
+    JobLogTailer* m_tailer;
+    JobLogModel* m_model;
+    
+    QListView* m_logView;
+    QLabel* m_statusLabel;
+    QCheckBox* m_followCheck;
+    DownloadLinkWidget* m_linkWidget;
+};
+
+#endif // JOBLOGDIALOG_H
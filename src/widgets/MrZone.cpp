@@ -1,7 +1,10 @@
 #include "MrZone.h"
 #include "service/GitService.h"
+#include "service/ConflictPredictor.h"
 #include "api/GitLabApi.h"
 #include "api/ApiModels.h"  // 新增：为 ProjectMember
+#include "utils/Logger.h"
+#include "utils/TraceRecorder.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QFormLayout>
@@ -21,17 +24,22 @@
 #include <QStyle>
 #include <QStyleOption>
 
-MrZone::MrZone(GitService* gitService, GitLabApi* gitLabApi, QWidget* parent)
+MrZone::MrZone(GitService* gitService, GitLabApi* gitLabApi, ConflictPredictor* conflictPredictor, QWidget* parent)
     : QWidget(parent)
     , m_gitService(gitService)
     , m_gitLabApi(gitLabApi)
+    , m_conflictPredictor(conflictPredictor)
     , m_isLocked(false)
 {
     setupUi();
+    publishTargets();
     
-    // 连接成员列表信号
-    connect(m_gitLabApi, &GitLabApi::projectMembersReceived,
-            this, &MrZone::onProjectMembersReceived);
+    // 预测结果在后台更新，只刷新当前选中目标的标记
+    connect(m_conflictPredictor, &ConflictPredictor::predictionChanged, this, [this](const QString& target) {
+        if (target == m_targetBranchCombo->currentText()) {
+            updateConflictBadge();
+        }
+    });
     
     // 加载项目成员
     loadProjectMembers();
@@ -57,7 +65,16 @@ void MrZone::setupUi() {
     m_targetBranchCombo = new QComboBox(this);
     m_targetBranchCombo->addItem("develop");
     m_targetBranchCombo->addItem("internal");
-    formLayout->addRow(QString::fromUtf8("目标分支:"), m_targetBranchCombo);
+    
+    // 冲突标记
+    m_conflictBadge = new QLabel(this);
+    m_conflictBadge->setStyleSheet("font-size: 11px;");
+    connect(m_targetBranchCombo, &QComboBox::currentTextChanged, this, &MrZone::updateConflictBadge);
+    
+    QHBoxLayout* targetLayout = new QHBoxLayout();
+    targetLayout->addWidget(m_targetBranchCombo, 1);
+    targetLayout->addWidget(m_conflictBadge);
+    formLayout->addRow(QString::fromUtf8("目标分支:"), targetLayout);
     
     // MR标题
     m_titleEdit = new QLineEdit(this);
@@ -202,6 +219,7 @@ void MrZone::setupUi() {
 }
 
 void MrZone::updateForBranch(const QString& currentBranch) {
+    TRACE_SCOPE("ui", "MrZone::updateForBranch");
     m_currentBranch = currentBranch;
     
     // 重新加载成员列表（以防成员变化）
@@ -233,6 +251,7 @@ void MrZone::lockTargetBranch(const QString& branch) {
     m_targetBranchCombo->setEnabled(false);
     m_targetBranchCombo->setStyleSheet("background-color: #FFE6E6;");
     m_isLocked = true;
+    publishTargets();
 }
 
 void MrZone::unlockTargetBranch() {
@@ -242,6 +261,50 @@ void MrZone::unlockTargetBranch() {
     m_targetBranchCombo->setEnabled(true);
     m_targetBranchCombo->setStyleSheet("");
     m_isLocked = false;
+    publishTargets();
+}
+
+void MrZone::publishTargets() {
+    QStringList targets;
+    for (int i = 0; i < m_targetBranchCombo->count(); ++i) {
+        targets.append(m_targetBranchCombo->itemText(i));
+    }
+    m_conflictPredictor->setExtraTargets(targets);
+    updateConflictBadge();
+}
+
+void MrZone::updateConflictBadge() {
+    const QString target = m_targetBranchCombo->currentText();
+    const ConflictPredictor::Prediction prediction = m_conflictPredictor->prediction(target);
+    
+    QString text;
+    QString color = "#666";
+    QString toolTip;
+    switch (prediction.status) {
+    case ConflictPredictor::Status::Pending:
+        text = QString::fromUtf8("⏳ 正在预测冲突…");
+        break;
+    case ConflictPredictor::Status::Clean:
+        text = QString::fromUtf8("✅ 无冲突");
+        color = "#4CAF50";
+        toolTip = QString::fromUtf8("当前分支已提交的内容可以干净地合并到 origin/%1").arg(target);
+        break;
+    case ConflictPredictor::Status::Conflict:
+        text = QString::fromUtf8("⚠️ %1 个文件冲突").arg(prediction.conflictFiles.size());
+        color = "#F44336";
+        toolTip = QString::fromUtf8("与 origin/%1 冲突的文件：\n%2").arg(target, prediction.conflictFiles.join('\n'));
+        break;
+    case ConflictPredictor::Status::Error:
+        text = QString::fromUtf8("❔ 无法预测");
+        toolTip = prediction.errorMessage;
+        break;
+    case ConflictPredictor::Status::Unknown:
+        break;
+    }
+    
+    m_conflictBadge->setText(text);
+    m_conflictBadge->setToolTip(toolTip);
+    m_conflictBadge->setStyleSheet(QString("color: %1; font-size: 11px; font-weight: bold;").arg(color));
 }
 
 void MrZone::onCheckConflictClicked() {
@@ -251,7 +314,7 @@ void MrZone::onCheckConflictClicked() {
     int ret = QMessageBox::question(this, QString::fromUtf8("检查冲突"),
         QString::fromUtf8("将执行以下操作：\n\n"
                          "1. fetch远程%1分支\n"
-                         "2. 尝试合并到当前分支（不提交）\n"
+                         "2. 在后台计算与当前分支的合并结果（不改动工作区）\n"
                          "3. 检测是否有冲突\n\n"
                          "确认继续？").arg(targetBranch),
         QMessageBox::Yes | QMessageBox::No);
@@ -321,12 +384,27 @@ void MrZone::onSubmitClicked() {
         params.description = description;
         params.assigneeIds = assigneeIds;
         
-        m_gitLabApi->createMergeRequest(params);
+        m_gitLabApi->createMergeRequest(params).then(this, [this](const MrResponse& mr) {
+            QMessageBox::information(this, QString::fromUtf8("创建成功"),
+                QString::fromUtf8("合并请求已创建！\n\n编号: #%1\n链接: %2").arg(mr.iid).arg(mr.webUrl));
+        }).onFailed(this, [this](const ApiError& error) {
+            QMessageBox::warning(this, QString::fromUtf8("创建失败"),
+                QString::fromUtf8("创建MR失败：\n\n%1").arg(error.message()));
+        });
     }
 }
 
 void MrZone::loadProjectMembers() {
-    m_gitLabApi->listProjectMembers();
+    m_gitLabApi->listProjectMembers().then(this, [this](QFuture<ProjectMember> future) {
+        try {
+            const QList<ProjectMember> members = future.results();  // 加载失败时抛出 ApiError
+            if (!future.isCanceled()) {
+                onProjectMembersReceived(members);
+            }
+        } catch (const ApiError& error) {
+            LOG_WARNING(QString("获取项目成员失败: %1").arg(error.message()));
+        }
+    });
 }
 
 void MrZone::onProjectMembersReceived(const QList<ProjectMember>& members) {
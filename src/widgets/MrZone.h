@@ -11,6 +11,7 @@ class QLabel;
 class QListWidget;  // 新增
 class GitService;
 class GitLabApi;
+class ConflictPredictor;
 struct ProjectMember;  // 新增
 
 /**
@@ -19,12 +20,14 @@ struct ProjectMember;  // 新增
  * 核心防呆功能：
  * - develop-database分支时，目标分支锁定为develop
  * - 其他分支可选择develop或internal
+ * - 目标分支旁显示后台预测的冲突状态（ConflictPredictor）
  */
 class MrZone : public QWidget {
     Q_OBJECT
     
 public:
-    explicit MrZone(GitService* gitService, GitLabApi* gitLabApi, QWidget* parent = nullptr);
+    explicit MrZone(GitService* gitService, GitLabApi* gitLabApi, ConflictPredictor* conflictPredictor,
+                    QWidget* parent = nullptr);
     
     // 根据当前分支更新UI状态
     void updateForBranch(const QString& currentBranch);
@@ -47,6 +50,8 @@ private:
     void lockTargetBranch(const QString& branch);
     void unlockTargetBranch();
     void loadProjectMembers();
+    void updateConflictBadge();
+    void publishTargets();  // 目标分支列表变化后通知 ConflictPredictor
 
     void showAssigneePopup();
     void hideAssigneePopup();  // 新增：统一隐藏逻辑
@@ -57,8 +62,10 @@ private:
     
     GitService* m_gitService;
     GitLabApi* m_gitLabApi;
+    ConflictPredictor* m_conflictPredictor;
     
     QComboBox* m_targetBranchCombo;
+    QLabel* m_conflictBadge;
     QLineEdit* m_titleEdit;
     QTextEdit* m_descriptionEdit;
     QPushButton* m_checkConflictButton;
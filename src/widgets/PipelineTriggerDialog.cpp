@@ -6,6 +6,7 @@
 #include <QComboBox>
 #include <QLabel>
 #include <QDialogButtonBox>
+#include <QFuture>
 
 PipelineTriggerDialog::PipelineTriggerDialog(GitService* gitService, QWidget* parent)
     : QDialog(parent)
@@ -163,20 +164,26 @@ void PipelineTriggerDialog::setupUi() {
 }
 
 void PipelineTriggerDialog::loadBranches() {
-    // 填充其他分支下拉框
-    QStringList filteredBranches = getFilteredBranches();
-    
-    if (filteredBranches.isEmpty()) {
-        m_otherBranchCombo->addItem(QString::fromUtf8("(无其他可用分支)"));
-        m_otherBranchCombo->setEnabled(false);
-    } else {
-        m_otherBranchCombo->addItem(QString::fromUtf8("-- 请选择 --"));
-        m_otherBranchCombo->addItems(filteredBranches);
-    }
+    // 分支列表在后台加载，对话框先行显示，快捷按钮可立即使用
+    m_otherBranchCombo->addItem(QString::fromUtf8("⏳ 正在加载分支..."));
+    m_otherBranchCombo->setEnabled(false);
+    
+    m_gitService->getAllBranchesAsync().then(this, [this](const QStringList& allBranches) {
+        // 填充其他分支下拉框
+        QStringList filteredBranches = filterBranches(allBranches);
+        m_otherBranchCombo->clear();
+        
+        if (filteredBranches.isEmpty()) {
+            m_otherBranchCombo->addItem(QString::fromUtf8("(无其他可用分支)"));
+        } else {
+            m_otherBranchCombo->addItem(QString::fromUtf8("-- 请选择 --"));
+            m_otherBranchCombo->addItems(filteredBranches);
+            m_otherBranchCombo->setEnabled(true);
+        }
+    });
 }
 
-QStringList PipelineTriggerDialog::getFilteredBranches() {
-    QStringList allBranches = m_gitService->getAllBranches();
+QStringList PipelineTriggerDialog::filterBranches(const QStringList& allBranches) {
     QStringList filtered;
     
     for (const QString& branch : allBranches) {
@@ -33,7 +33,7 @@ private slots:
 private:
     void setupUi();
     void loadBranches();
-    QStringList getFilteredBranches();
+    static QStringList filterBranches(const QStringList& allBranches);
     
     GitService* m_gitService;
     QString m_selectedBranch;